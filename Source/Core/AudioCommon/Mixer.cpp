@@ -12,6 +12,7 @@
 #include "Common/CommonTypes.h"
 #include "Common/Logging/Log.h"
 #include "Common/Swap.h"
+#include "Common/Tracing.h"
 #include "Core/Config/MainSettings.h"
 #include "Core/ConfigManager.h"
 
@@ -146,6 +147,8 @@ unsigned int Mixer::Mix(short* samples, unsigned int num_samples)
   if (!samples)
     return 0;
 
+  TRACE_SCOPE("audio", "Mixer::Mix");
+
   memset(samples, 0, num_samples * 2 * sizeof(short));
 
   if (SConfig::GetInstance().m_audio_stretch)
@@ -46,6 +46,10 @@ struct CPUInfo
   bool bFMA = false;
   bool bFMA4 = false;
   bool bAES = false;
+  // AES instructions on 256-bit registers
+  bool bVAES = false;
+  bool bSHA1 = false;
+  bool bSHA2 = false;
   // FXSAVE/FXRSTOR
   bool bFXSR = false;
   bool bMOVBE = false;
@@ -61,8 +65,6 @@ struct CPUInfo
   bool bFP = false;
   bool bASIMD = false;
   bool bCRC32 = false;
-  bool bSHA1 = false;
-  bool bSHA2 = false;
   bool bAFP = false;  // Alternate floating-point behavior
 
   // Call Detect()
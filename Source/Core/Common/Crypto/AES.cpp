@@ -1,25 +1,411 @@
 // Copyright 2017 Dolphin Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include "Common/Crypto/AES.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <memory>
+
 #include <mbedtls/aes.h>
 
-#include "Common/Crypto/AES.h"
+#include "Common/BitUtils.h"
+#include "Common/CPUDetect.h"
+#include "Common/CommonTypes.h"
+#include "Common/Intrinsics.h"
 
 namespace Common::AES
 {
-std::vector<u8> DecryptEncrypt(const u8* key, u8* iv, const u8* src, size_t size, Mode mode)
+namespace
 {
-  mbedtls_aes_context aes_ctx;
-  std::vector<u8> buffer(size);
+constexpr size_t NUM_ROUND_KEYS = 11;
+
+class ContextGeneric final : public Context
+{
+public:
+  ContextGeneric(Mode mode, const u8* key) : m_mode(mode)
+  {
+    mbedtls_aes_init(&m_context);
+    if (mode == Mode::Encrypt)
+      mbedtls_aes_setkey_enc(&m_context, key, 128);
+    else
+      mbedtls_aes_setkey_dec(&m_context, key, 128);
+  }
+
+  ~ContextGeneric() override { mbedtls_aes_free(&m_context); }
+
+  void Crypt(const u8* iv, u8* iv_out, const u8* in, u8* out, size_t size) const override
+  {
+    std::array<u8, BLOCK_SIZE> iv_copy;
+    std::memcpy(iv_copy.data(), iv, BLOCK_SIZE);
+    mbedtls_aes_crypt_cbc(&m_context,
+                          m_mode == Mode::Encrypt ? MBEDTLS_AES_ENCRYPT : MBEDTLS_AES_DECRYPT,
+                          size, iv_copy.data(), in, out);
+    if (iv_out)
+      std::memcpy(iv_out, iv_copy.data(), BLOCK_SIZE);
+  }
+
+private:
+  Mode m_mode;
+  // mbedtls doesn't modify the context when crypting, but doesn't take it as const either
+  mutable mbedtls_aes_context m_context;
+};
+
+#if defined(_M_X86)
+
+// The key generation assist instruction takes the round constant as an immediate
+template <int round_constant>
+FUNCTION_TARGET_AES __m128i ExpandRoundKey(__m128i key)
+{
+  const __m128i assist =
+      _mm_shuffle_epi32(_mm_aeskeygenassist_si128(key, round_constant), _MM_SHUFFLE(3, 3, 3, 3));
+  key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+  key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+  key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+  return _mm_xor_si128(key, assist);
+}
+
+FUNCTION_TARGET_AES void ExpandKeyAESNI(const u8* key, Mode mode, __m128i* round_keys)
+{
+  round_keys[0] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(key));
+  round_keys[1] = ExpandRoundKey<0x01>(round_keys[0]);
+  round_keys[2] = ExpandRoundKey<0x02>(round_keys[1]);
+  round_keys[3] = ExpandRoundKey<0x04>(round_keys[2]);
+  round_keys[4] = ExpandRoundKey<0x08>(round_keys[3]);
+  round_keys[5] = ExpandRoundKey<0x10>(round_keys[4]);
+  round_keys[6] = ExpandRoundKey<0x20>(round_keys[5]);
+  round_keys[7] = ExpandRoundKey<0x40>(round_keys[6]);
+  round_keys[8] = ExpandRoundKey<0x80>(round_keys[7]);
+  round_keys[9] = ExpandRoundKey<0x1B>(round_keys[8]);
+  round_keys[10] = ExpandRoundKey<0x36>(round_keys[9]);
 
   if (mode == Mode::Encrypt)
-    mbedtls_aes_setkey_enc(&aes_ctx, key, 128);
-  else
-    mbedtls_aes_setkey_dec(&aes_ctx, key, 128);
+    return;
 
-  mbedtls_aes_crypt_cbc(&aes_ctx, mode == Mode::Encrypt ? MBEDTLS_AES_ENCRYPT : MBEDTLS_AES_DECRYPT,
-                        size, iv, src, buffer.data());
+  // The decryption instructions use the equivalent inverse cipher, which takes the round keys in
+  // reverse order and with InvMixColumns applied to all but the first and last
+  __m128i encryption_keys[NUM_ROUND_KEYS];
+  std::copy(round_keys, round_keys + NUM_ROUND_KEYS, encryption_keys);
+  round_keys[0] = encryption_keys[10];
+  for (size_t i = 1; i < NUM_ROUND_KEYS - 1; ++i)
+    round_keys[i] = _mm_aesimc_si128(encryption_keys[NUM_ROUND_KEYS - 1 - i]);
+  round_keys[10] = encryption_keys[0];
+}
+
+FUNCTION_TARGET_AES void EncryptCBCAESNI(const __m128i* round_keys, const u8* iv, u8* iv_out,
+                                         const u8* in, u8* out, size_t size)
+{
+  // Each block depends on the previous one, so there is nothing to interleave
+  __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(iv));
+  for (size_t i = 0; i + BLOCK_SIZE <= size; i += BLOCK_SIZE)
+  {
+    block = _mm_xor_si128(block, _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i)));
+    block = _mm_xor_si128(block, round_keys[0]);
+    for (size_t round = 1; round < NUM_ROUND_KEYS - 1; ++round)
+      block = _mm_aesenc_si128(block, round_keys[round]);
+    block = _mm_aesenclast_si128(block, round_keys[NUM_ROUND_KEYS - 1]);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), block);
+  }
+
+  if (iv_out)
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(iv_out), block);
+}
 
+FUNCTION_TARGET_AES void DecryptCBCAESNI(const __m128i* round_keys, const u8* iv, u8* iv_out,
+                                         const u8* in, u8* out, size_t size)
+{
+  // Unlike encryption, decryption of each block is independent, so several blocks are kept in
+  // flight at once to hide the latency of the AES instructions
+  constexpr size_t BATCH = 8;
+
+  __m128i previous = _mm_loadu_si128(reinterpret_cast<const __m128i*>(iv));
+  size_t i = 0;
+
+  for (; i + BATCH * BLOCK_SIZE <= size; i += BATCH * BLOCK_SIZE)
+  {
+    __m128i ciphertext[BATCH];
+    __m128i blocks[BATCH];
+    for (size_t j = 0; j < BATCH; ++j)
+    {
+      ciphertext[j] =
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i + j * BLOCK_SIZE));
+      blocks[j] = _mm_xor_si128(ciphertext[j], round_keys[0]);
+    }
+    for (size_t round = 1; round < NUM_ROUND_KEYS - 1; ++round)
+    {
+      for (size_t j = 0; j < BATCH; ++j)
+        blocks[j] = _mm_aesdec_si128(blocks[j], round_keys[round]);
+    }
+    for (size_t j = 0; j < BATCH; ++j)
+    {
+      blocks[j] = _mm_aesdeclast_si128(blocks[j], round_keys[NUM_ROUND_KEYS - 1]);
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i + j * BLOCK_SIZE),
+                       _mm_xor_si128(blocks[j], j == 0 ? previous : ciphertext[j - 1]));
+    }
+    previous = ciphertext[BATCH - 1];
+  }
+
+  for (; i + BLOCK_SIZE <= size; i += BLOCK_SIZE)
+  {
+    const __m128i ciphertext = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+    __m128i block = _mm_xor_si128(ciphertext, round_keys[0]);
+    for (size_t round = 1; round < NUM_ROUND_KEYS - 1; ++round)
+      block = _mm_aesdec_si128(block, round_keys[round]);
+    block = _mm_aesdeclast_si128(block, round_keys[NUM_ROUND_KEYS - 1]);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_xor_si128(block, previous));
+    previous = ciphertext;
+  }
+
+  if (iv_out)
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(iv_out), previous);
+}
+
+// Same as DecryptCBCAESNI, but with two blocks per register
+FUNCTION_TARGET_VAES void DecryptCBCVAES(const __m128i* round_keys, const u8* iv, u8* iv_out,
+                                         const u8* in, u8* out, size_t size)
+{
+  constexpr size_t BATCH = 4;
+  constexpr size_t BATCH_SIZE = BATCH * 2 * BLOCK_SIZE;
+
+  __m256i wide_round_keys[NUM_ROUND_KEYS];
+  for (size_t round = 0; round < NUM_ROUND_KEYS; ++round)
+    wide_round_keys[round] = _mm256_broadcastsi128_si256(round_keys[round]);
+
+  __m128i previous = _mm_loadu_si128(reinterpret_cast<const __m128i*>(iv));
+  size_t i = 0;
+
+  for (; i + BATCH_SIZE <= size; i += BATCH_SIZE)
+  {
+    // Everything is loaded before anything is stored, since in and out may be the same
+    __m256i ciphertext[BATCH];
+    __m256i previous_ciphertext[BATCH];
+    __m256i blocks[BATCH];
+    for (size_t j = 0; j < BATCH; ++j)
+    {
+      const u8* ptr = in + i + j * 2 * BLOCK_SIZE;
+      ciphertext[j] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr));
+      if (j == 0)
+      {
+        previous_ciphertext[j] = _mm256_inserti128_si256(
+            _mm256_castsi128_si256(previous), _mm256_castsi256_si128(ciphertext[j]), 1);
+      }
+      else
+      {
+        previous_ciphertext[j] =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr - BLOCK_SIZE));
+      }
+      blocks[j] = _mm256_xor_si256(ciphertext[j], wide_round_keys[0]);
+    }
+    previous = _mm256_extracti128_si256(ciphertext[BATCH - 1], 1);
+
+    for (size_t round = 1; round < NUM_ROUND_KEYS - 1; ++round)
+    {
+      for (size_t j = 0; j < BATCH; ++j)
+        blocks[j] = _mm256_aesdec_epi128(blocks[j], wide_round_keys[round]);
+    }
+    for (size_t j = 0; j < BATCH; ++j)
+    {
+      blocks[j] = _mm256_aesdeclast_epi128(blocks[j], wide_round_keys[NUM_ROUND_KEYS - 1]);
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i + j * 2 * BLOCK_SIZE),
+                          _mm256_xor_si256(blocks[j], previous_ciphertext[j]));
+    }
+  }
+
+  alignas(16) std::array<u8, BLOCK_SIZE> remaining_iv;
+  _mm_store_si128(reinterpret_cast<__m128i*>(remaining_iv.data()), previous);
+  DecryptCBCAESNI(round_keys, remaining_iv.data(), iv_out, in + i, out + i, size - i);
+}
+
+class ContextAESNI final : public Context
+{
+public:
+  ContextAESNI(Mode mode, const u8* key, bool use_vaes) : m_mode(mode), m_use_vaes(use_vaes)
+  {
+    ExpandKeyAESNI(key, mode, m_round_keys);
+  }
+
+  void Crypt(const u8* iv, u8* iv_out, const u8* in, u8* out, size_t size) const override
+  {
+    if (m_mode == Mode::Encrypt)
+      EncryptCBCAESNI(m_round_keys, iv, iv_out, in, out, size);
+    else if (m_use_vaes)
+      DecryptCBCVAES(m_round_keys, iv, iv_out, in, out, size);
+    else
+      DecryptCBCAESNI(m_round_keys, iv, iv_out, in, out, size);
+  }
+
+private:
+  Mode m_mode;
+  bool m_use_vaes;
+  // Vector types lose their alignment attributes as template arguments, so these are C arrays
+  __m128i m_round_keys[NUM_ROUND_KEYS];
+};
+
+#elif defined(_M_ARM_64)
+
+FUNCTION_TARGET_CRYPTO void ExpandKeyARM(const u8* key, Mode mode, uint8x16_t* round_keys)
+{
+  static constexpr std::array<u8, NUM_ROUND_KEYS - 1> ROUND_CONSTANTS{
+      0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x1B, 0x36};
+
+  // Words are kept in memory order, so that the round keys can be loaded directly
+  std::array<u32, NUM_ROUND_KEYS * 4> words;
+  std::memcpy(words.data(), key, KEY_SIZE);
+  for (size_t i = 4; i < words.size(); ++i)
+  {
+    u32 word = words[i - 1];
+    if (i % 4 == 0)
+    {
+      // AESE with a zero round key is SubBytes(ShiftRows(x)), and ShiftRows does nothing when all
+      // four columns are the same, which gives SubWord
+      const uint8x16_t substituted =
+          vaeseq_u8(vreinterpretq_u8_u32(vdupq_n_u32(word)), vdupq_n_u8(0));
+      word = vgetq_lane_u32(vreinterpretq_u32_u8(substituted), 0);
+      word = Common::RotateRight(word, 8) ^ ROUND_CONSTANTS[i / 4 - 1];
+    }
+    words[i] = words[i - 4] ^ word;
+  }
+
+  for (size_t i = 0; i < NUM_ROUND_KEYS; ++i)
+    round_keys[i] = vld1q_u8(reinterpret_cast<const u8*>(&words[i * 4]));
+
+  if (mode == Mode::Encrypt)
+    return;
+
+  // The decryption instructions use the equivalent inverse cipher, which takes the round keys in
+  // reverse order and with InvMixColumns applied to all but the first and last
+  uint8x16_t encryption_keys[NUM_ROUND_KEYS];
+  std::copy(round_keys, round_keys + NUM_ROUND_KEYS, encryption_keys);
+  round_keys[0] = encryption_keys[10];
+  for (size_t i = 1; i < NUM_ROUND_KEYS - 1; ++i)
+    round_keys[i] = vaesimcq_u8(encryption_keys[NUM_ROUND_KEYS - 1 - i]);
+  round_keys[10] = encryption_keys[0];
+}
+
+FUNCTION_TARGET_CRYPTO void EncryptCBCARM(const uint8x16_t* round_keys, const u8* iv, u8* iv_out,
+                                          const u8* in, u8* out, size_t size)
+{
+  uint8x16_t block = vld1q_u8(iv);
+  for (size_t i = 0; i + BLOCK_SIZE <= size; i += BLOCK_SIZE)
+  {
+    block = veorq_u8(block, vld1q_u8(in + i));
+    for (size_t round = 0; round < NUM_ROUND_KEYS - 2; ++round)
+      block = vaesmcq_u8(vaeseq_u8(block, round_keys[round]));
+    block = veorq_u8(vaeseq_u8(block, round_keys[NUM_ROUND_KEYS - 2]),
+                     round_keys[NUM_ROUND_KEYS - 1]);
+    vst1q_u8(out + i, block);
+  }
+
+  if (iv_out)
+    vst1q_u8(iv_out, block);
+}
+
+FUNCTION_TARGET_CRYPTO void DecryptCBCARM(const uint8x16_t* round_keys, const u8* iv, u8* iv_out,
+                                          const u8* in, u8* out, size_t size)
+{
+  uint8x16_t previous = vld1q_u8(iv);
+  for (size_t i = 0; i + BLOCK_SIZE <= size; i += BLOCK_SIZE)
+  {
+    const uint8x16_t ciphertext = vld1q_u8(in + i);
+    uint8x16_t block = ciphertext;
+    for (size_t round = 0; round < NUM_ROUND_KEYS - 2; ++round)
+      block = vaesimcq_u8(vaesdq_u8(block, round_keys[round]));
+    block = veorq_u8(vaesdq_u8(block, round_keys[NUM_ROUND_KEYS - 2]),
+                     round_keys[NUM_ROUND_KEYS - 1]);
+    vst1q_u8(out + i, veorq_u8(block, previous));
+    previous = ciphertext;
+  }
+
+  if (iv_out)
+    vst1q_u8(iv_out, previous);
+}
+
+class ContextARM final : public Context
+{
+public:
+  ContextARM(Mode mode, const u8* key) : m_mode(mode)
+  {
+    ExpandKeyARM(key, mode, m_round_keys);
+  }
+
+  void Crypt(const u8* iv, u8* iv_out, const u8* in, u8* out, size_t size) const override
+  {
+    if (m_mode == Mode::Encrypt)
+      EncryptCBCARM(m_round_keys, iv, iv_out, in, out, size);
+    else
+      DecryptCBCARM(m_round_keys, iv, iv_out, in, out, size);
+  }
+
+private:
+  Mode m_mode;
+  uint8x16_t m_round_keys[NUM_ROUND_KEYS];
+};
+
+#endif
+
+Implementation GetBestImplementation()
+{
+  for (const Implementation implementation :
+       {Implementation::VAES, Implementation::AESNI, Implementation::ARM})
+  {
+    if (IsSupported(implementation))
+      return implementation;
+  }
+  return Implementation::Generic;
+}
+
+std::unique_ptr<Context> CreateContext(Mode mode, const u8* key)
+{
+  return CreateContext(GetBestImplementation(), mode, key);
+}
+}  // namespace
+
+bool IsSupported(Implementation implementation)
+{
+  switch (implementation)
+  {
+  case Implementation::Generic:
+    return true;
+#if defined(_M_X86)
+  case Implementation::AESNI:
+    return cpu_info.bAES;
+  case Implementation::VAES:
+    return cpu_info.bVAES;
+#elif defined(_M_ARM_64)
+  case Implementation::ARM:
+    return cpu_info.bAES;
+#endif
+  default:
+    return false;
+  }
+}
+
+std::unique_ptr<Context> CreateContext(Implementation implementation, Mode mode, const u8* key)
+{
+  if (!IsSupported(implementation))
+    return nullptr;
+
+  switch (implementation)
+  {
+#if defined(_M_X86)
+  case Implementation::AESNI:
+    return std::make_unique<ContextAESNI>(mode, key, false);
+  case Implementation::VAES:
+    return std::make_unique<ContextAESNI>(mode, key, true);
+#elif defined(_M_ARM_64)
+  case Implementation::ARM:
+    return std::make_unique<ContextARM>(mode, key);
+#endif
+  default:
+    return std::make_unique<ContextGeneric>(mode, key);
+  }
+}
+
+std::vector<u8> DecryptEncrypt(const u8* key, u8* iv, const u8* src, size_t size, Mode mode)
+{
+  std::vector<u8> buffer(size);
+  CreateContext(mode, key)->Crypt(iv, iv, src, buffer.data(), size);
   return buffer;
 }
 
@@ -32,4 +418,14 @@ std::vector<u8> Encrypt(const u8* key, u8* iv, const u8* src, size_t size)
 {
   return DecryptEncrypt(key, iv, src, size, Mode::Encrypt);
 }
+
+std::unique_ptr<Context> CreateContextEncrypt(const u8* key)
+{
+  return CreateContext(Mode::Encrypt, key);
+}
+
+std::unique_ptr<Context> CreateContextDecrypt(const u8* key)
+{
+  return CreateContext(Mode::Decrypt, key);
+}
 }  // namespace Common::AES
@@ -3,7 +3,9 @@
 
 #pragma once
 
+#include <array>
 #include <cstddef>
+#include <memory>
 #include <vector>
 
 #include "Common/CommonTypes.h"
@@ -20,4 +22,53 @@ std::vector<u8> DecryptEncrypt(const u8* key, u8* iv, const u8* src, size_t size
 // Convenience functions
 std::vector<u8> Decrypt(const u8* key, u8* iv, const u8* src, size_t size);
 std::vector<u8> Encrypt(const u8* key, u8* iv, const u8* src, size_t size);
+
+constexpr size_t KEY_SIZE = 16;
+constexpr size_t BLOCK_SIZE = 16;
+
+// An AES-128 key, expanded for either encryption or decryption. Uses the AES instructions of the
+// CPU if there are any. Crypt doesn't modify the context, so one context can be used by several
+// threads at once.
+class Context
+{
+public:
+  virtual ~Context() = default;
+
+  // Encrypts or decrypts size bytes in CBC mode. size must be a multiple of BLOCK_SIZE, and in and
+  // out may point to the same buffer. If iv_out isn't nullptr, the IV for continuing after this
+  // data is written to it. iv_out may be the same as iv.
+  virtual void Crypt(const u8* iv, u8* iv_out, const u8* in, u8* out, size_t size) const = 0;
+
+  void Crypt(const u8* iv, const u8* in, u8* out, size_t size) const
+  {
+    Crypt(iv, nullptr, in, out, size);
+  }
+
+  void CryptIvZero(const u8* in, u8* out, size_t size) const
+  {
+    static constexpr std::array<u8, BLOCK_SIZE> iv{};
+    Crypt(iv.data(), nullptr, in, out, size);
+  }
+};
+
+std::unique_ptr<Context> CreateContextEncrypt(const u8* key);
+std::unique_ptr<Context> CreateContextDecrypt(const u8* key);
+
+// The ways a Context can be implemented. The functions above use the fastest one the CPU supports.
+enum class Implementation
+{
+  // mbedtls, which works on any CPU
+  Generic,
+  // AES-NI, decrypting eight blocks at a time
+  AESNI,
+  // AES-NI, decrypting with VAES on 256-bit registers
+  VAES,
+  // The ARMv8 crypto extensions
+  ARM,
+};
+
+bool IsSupported(Implementation implementation);
+// Creates a context with a specific implementation, so that each one can be tested. Returns
+// nullptr if the CPU doesn't support it.
+std::unique_ptr<Context> CreateContext(Implementation implementation, Mode mode, const u8* key);
 }  // namespace Common::AES
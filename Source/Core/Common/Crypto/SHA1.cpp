@@ -0,0 +1,289 @@
+// Copyright 2021 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "Common/Crypto/SHA1.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <utility>
+
+#include <mbedtls/sha1.h>
+
+#include "Common/CPUDetect.h"
+#include "Common/CommonTypes.h"
+#include "Common/Intrinsics.h"
+#include "Common/Swap.h"
+
+namespace Common::SHA1
+{
+namespace
+{
+constexpr size_t BLOCK_LEN = 64;
+
+using State = std::array<u32, 5>;
+using ProcessBlocksFunction = void (*)(State* state, const u8* data, size_t num_blocks);
+
+class ContextMbed final : public Context
+{
+public:
+  ContextMbed()
+  {
+    mbedtls_sha1_init(&m_context);
+    mbedtls_sha1_starts_ret(&m_context);
+  }
+
+  ~ContextMbed() override { mbedtls_sha1_free(&m_context); }
+
+  void Update(const u8* msg, size_t len) override
+  {
+    mbedtls_sha1_update_ret(&m_context, msg, len);
+  }
+
+  Digest Finish() override
+  {
+    Digest digest;
+    mbedtls_sha1_finish_ret(&m_context, digest.data());
+    return digest;
+  }
+
+private:
+  mbedtls_sha1_context m_context;
+};
+
+// Does the buffering and padding for implementations which only process whole blocks
+class BlockContext final : public Context
+{
+public:
+  explicit BlockContext(ProcessBlocksFunction process_blocks) : m_process_blocks(process_blocks)
+  {
+  }
+
+  void Update(const u8* msg, size_t len) override
+  {
+    m_length += len;
+
+    if (m_buffer_used != 0)
+    {
+      const size_t to_copy = std::min(len, BLOCK_LEN - m_buffer_used);
+      std::memcpy(m_buffer.data() + m_buffer_used, msg, to_copy);
+      m_buffer_used += to_copy;
+      msg += to_copy;
+      len -= to_copy;
+
+      if (m_buffer_used != BLOCK_LEN)
+        return;
+
+      m_process_blocks(&m_state, m_buffer.data(), 1);
+      m_buffer_used = 0;
+    }
+
+    const size_t num_blocks = len / BLOCK_LEN;
+    if (num_blocks != 0)
+      m_process_blocks(&m_state, msg, num_blocks);
+
+    m_buffer_used = len % BLOCK_LEN;
+    std::memcpy(m_buffer.data(), msg + num_blocks * BLOCK_LEN, m_buffer_used);
+  }
+
+  Digest Finish() override
+  {
+    const u64 length_bits = Common::swap64(m_length * 8);
+
+    // A 0x80 byte, zeros, and the length in bits, padded to a multiple of the block length
+    std::array<u8, BLOCK_LEN + sizeof(length_bits)> padding{};
+    padding[0] = 0x80;
+    const size_t padding_len =
+        (BLOCK_LEN * 2 - sizeof(length_bits) - m_buffer_used - 1) % BLOCK_LEN + 1;
+    Update(padding.data(), padding_len);
+    Update(reinterpret_cast<const u8*>(&length_bits), sizeof(length_bits));
+
+    Digest digest;
+    for (size_t i = 0; i < m_state.size(); ++i)
+    {
+      const u32 word = Common::swap32(m_state[i]);
+      std::memcpy(&digest[i * sizeof(u32)], &word, sizeof(u32));
+    }
+    return digest;
+  }
+
+private:
+  ProcessBlocksFunction m_process_blocks;
+  State m_state{0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0};
+  std::array<u8, BLOCK_LEN> m_buffer;
+  size_t m_buffer_used = 0;
+  u64 m_length = 0;
+};
+
+#if defined(_M_X86)
+
+// Each step does four rounds. The message schedule for later steps is computed interleaved with
+// the rounds, with w[i % 4] holding the four words used by step i.
+template <size_t i>
+FUNCTION_TARGET_SHA inline void StepSHANI(__m128i* abcd, __m128i* e, __m128i* w)
+{
+  if constexpr (i == 0)
+    e[0] = _mm_add_epi32(e[0], w[0]);
+  else
+    e[i % 2] = _mm_sha1nexte_epu32(e[i % 2], w[i % 4]);
+  e[(i + 1) % 2] = *abcd;
+  if constexpr (i >= 3 && i <= 18)
+    w[(i + 1) % 4] = _mm_sha1msg2_epu32(w[(i + 1) % 4], w[i % 4]);
+  *abcd = _mm_sha1rnds4_epu32(*abcd, e[i % 2], i / 5);
+  if constexpr (i >= 1 && i <= 16)
+    w[(i - 1) % 4] = _mm_sha1msg1_epu32(w[(i - 1) % 4], w[i % 4]);
+  if constexpr (i >= 2 && i <= 17)
+    w[(i - 2) % 4] = _mm_xor_si128(w[(i - 2) % 4], w[i % 4]);
+}
+
+template <size_t... i>
+FUNCTION_TARGET_SHA inline void StepsSHANI(__m128i* abcd, __m128i* e, __m128i* w,
+                                           std::index_sequence<i...>)
+{
+  (StepSHANI<i>(abcd, e, w), ...);
+}
+
+FUNCTION_TARGET_SHA void ProcessBlocksSHANI(State* state, const u8* data, size_t num_blocks)
+{
+  // Converts each big-endian word of a block to native endianness
+  const __m128i byte_swap_mask = _mm_set_epi64x(0x0001020304050607, 0x08090a0b0c0d0e0f);
+
+  // The instructions want the words of the state in reverse order
+  __m128i abcd = _mm_shuffle_epi32(
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(state->data())), _MM_SHUFFLE(0, 1, 2, 3));
+  __m128i e0 = _mm_set_epi32((*state)[4], 0, 0, 0);
+
+  for (size_t block = 0; block < num_blocks; ++block, data += BLOCK_LEN)
+  {
+    const __m128i abcd_save = abcd;
+    const __m128i e0_save = e0;
+
+    // Vector types lose their alignment attributes as template arguments, so these are C arrays
+    __m128i e[2]{e0, {}};
+    __m128i w[4];
+    for (size_t i = 0; i < std::size(w); ++i)
+    {
+      w[i] = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i * 16)),
+                              byte_swap_mask);
+    }
+
+    StepsSHANI(&abcd, e, w, std::make_index_sequence<20>());
+
+    e0 = _mm_sha1nexte_epu32(e[0], e0_save);
+    abcd = _mm_add_epi32(abcd, abcd_save);
+  }
+
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(state->data()),
+                   _mm_shuffle_epi32(abcd, _MM_SHUFFLE(0, 1, 2, 3)));
+  (*state)[4] = _mm_extract_epi32(e0, 3);
+}
+
+bool HasHardwareSupport()
+{
+  return cpu_info.bSHA1 && cpu_info.bSSE4_1;
+}
+
+constexpr ProcessBlocksFunction PROCESS_BLOCKS_HARDWARE = ProcessBlocksSHANI;
+
+#elif defined(_M_ARM_64)
+
+// Each step does four rounds. The message schedule is computed interleaved with the rounds, with
+// w[i % 4] holding the four words used by step i and wk[i % 2] the words plus the round constant.
+template <size_t i>
+FUNCTION_TARGET_CRYPTO inline void StepARM(uint32x4_t* abcd, u32* e, uint32x4_t* w,
+                                           uint32x4_t* wk)
+{
+  static constexpr std::array<u32, 4> ROUND_CONSTANTS{0x5A827999, 0x6ED9EBA1, 0x8F1BBCDC,
+                                                      0xCA62C1D6};
+
+  e[(i + 1) % 2] = vsha1h_u32(vgetq_lane_u32(*abcd, 0));
+  if constexpr (i / 5 == 0)
+    *abcd = vsha1cq_u32(*abcd, e[i % 2], wk[i % 2]);
+  else if constexpr (i / 5 == 2)
+    *abcd = vsha1mq_u32(*abcd, e[i % 2], wk[i % 2]);
+  else
+    *abcd = vsha1pq_u32(*abcd, e[i % 2], wk[i % 2]);
+  if constexpr (i + 2 <= 19)
+    wk[i % 2] = vaddq_u32(w[(i + 2) % 4], vdupq_n_u32(ROUND_CONSTANTS[(i + 2) / 5]));
+  if constexpr (i >= 1 && i + 3 <= 19)
+    w[(i + 3) % 4] = vsha1su1q_u32(w[(i + 3) % 4], w[(i + 2) % 4]);
+  if constexpr (i + 4 <= 19)
+    w[i % 4] = vsha1su0q_u32(w[i % 4], w[(i + 1) % 4], w[(i + 2) % 4]);
+}
+
+template <size_t... i>
+FUNCTION_TARGET_CRYPTO inline void StepsARM(uint32x4_t* abcd, u32* e, uint32x4_t* w,
+                                            uint32x4_t* wk, std::index_sequence<i...>)
+{
+  (StepARM<i>(abcd, e, w, wk), ...);
+}
+
+FUNCTION_TARGET_CRYPTO void ProcessBlocksARM(State* state, const u8* data, size_t num_blocks)
+{
+  uint32x4_t abcd = vld1q_u32(state->data());
+  u32 e0 = (*state)[4];
+
+  for (size_t block = 0; block < num_blocks; ++block, data += BLOCK_LEN)
+  {
+    const uint32x4_t abcd_save = abcd;
+    const u32 e0_save = e0;
+
+    u32 e[2]{e0, 0};
+    uint32x4_t w[4];
+    for (size_t i = 0; i < std::size(w); ++i)
+      w[i] = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(data + i * 16)));
+    uint32x4_t wk[2]{vaddq_u32(w[0], vdupq_n_u32(0x5A827999)),
+                     vaddq_u32(w[1], vdupq_n_u32(0x5A827999))};
+
+    StepsARM(&abcd, e, w, wk, std::make_index_sequence<20>());
+
+    e0 = e[0] + e0_save;
+    abcd = vaddq_u32(abcd, abcd_save);
+  }
+
+  vst1q_u32(state->data(), abcd);
+  (*state)[4] = e0;
+}
+
+bool HasHardwareSupport()
+{
+  return cpu_info.bSHA1;
+}
+
+constexpr ProcessBlocksFunction PROCESS_BLOCKS_HARDWARE = ProcessBlocksARM;
+
+#else
+
+bool HasHardwareSupport()
+{
+  return false;
+}
+
+constexpr ProcessBlocksFunction PROCESS_BLOCKS_HARDWARE = nullptr;
+
+#endif
+}  // namespace
+
+std::unique_ptr<Context> CreateContext()
+{
+  if (HasHardwareSupport())
+    return std::make_unique<BlockContext>(PROCESS_BLOCKS_HARDWARE);
+  return std::make_unique<ContextMbed>();
+}
+
+Digest CalculateDigest(const u8* msg, size_t len)
+{
+  if (HasHardwareSupport())
+  {
+    BlockContext context(PROCESS_BLOCKS_HARDWARE);
+    context.Update(msg, len);
+    return context.Finish();
+  }
+
+  Digest digest;
+  mbedtls_sha1_ret(msg, len, digest.data());
+  return digest;
+}
+}  // namespace Common::SHA1
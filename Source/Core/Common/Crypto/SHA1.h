@@ -0,0 +1,35 @@
+// Copyright 2021 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <memory>
+
+#include "Common/CommonTypes.h"
+
+namespace Common::SHA1
+{
+constexpr size_t DIGEST_LEN = 20;
+using Digest = std::array<u8, DIGEST_LEN>;
+
+// Incremental SHA-1 calculation. Uses the SHA instructions of the CPU if there are any.
+class Context
+{
+public:
+  virtual ~Context() = default;
+  virtual void Update(const u8* msg, size_t len) = 0;
+  virtual Digest Finish() = 0;
+};
+
+std::unique_ptr<Context> CreateContext();
+
+Digest CalculateDigest(const u8* msg, size_t len);
+
+template <typename T>
+Digest CalculateDigest(const T* msg, size_t len)
+{
+  return CalculateDigest(reinterpret_cast<const u8*>(msg), len);
+}
+}  // namespace Common::SHA1
@@ -123,6 +123,7 @@ void FileInfo::AndroidContentInit(const std::string& path)
   m_exists = result != -1;
   m_stat.st_mode = result == -2 ? S_IFDIR : S_IFREG;
   m_stat.st_size = result >= 0 ? result : 0;
+  m_stat.st_mtime = 0;
 }
 #endif
 
@@ -146,6 +147,11 @@ u64 FileInfo::GetSize() const
   return IsFile() ? m_stat.st_size : 0;
 }
 
+s64 FileInfo::GetModificationTime() const
+{
+  return IsFile() ? static_cast<s64>(m_stat.st_mtime) : 0;
+}
+
 // Returns true if the path exists
 bool Exists(const std::string& path)
 {
@@ -950,6 +956,7 @@ static void RebuildUserDirectories(unsigned int dir_index)
     s_user_paths[D_DUMPTEXTURES_IDX] = s_user_paths[D_DUMP_IDX] + DUMP_TEXTURES_DIR DIR_SEP;
     s_user_paths[D_DUMPDSP_IDX] = s_user_paths[D_DUMP_IDX] + DUMP_DSP_DIR DIR_SEP;
     s_user_paths[D_DUMPSSL_IDX] = s_user_paths[D_DUMP_IDX] + DUMP_SSL_DIR DIR_SEP;
+    s_user_paths[D_DUMPTRACES_IDX] = s_user_paths[D_DUMP_IDX] + DUMP_TRACES_DIR DIR_SEP;
     s_user_paths[D_LOGS_IDX] = s_user_paths[D_USER_IDX] + LOGS_DIR DIR_SEP;
     s_user_paths[D_MAILLOGS_IDX] = s_user_paths[D_LOGS_IDX] + MAIL_LOGS_DIR DIR_SEP;
     s_user_paths[D_THEMES_IDX] = s_user_paths[D_USER_IDX] + THEMES_DIR DIR_SEP;
@@ -1018,6 +1025,7 @@ static void RebuildUserDirectories(unsigned int dir_index)
     s_user_paths[D_DUMPTEXTURES_IDX] = s_user_paths[D_DUMP_IDX] + DUMP_TEXTURES_DIR DIR_SEP;
     s_user_paths[D_DUMPDSP_IDX] = s_user_paths[D_DUMP_IDX] + DUMP_DSP_DIR DIR_SEP;
     s_user_paths[D_DUMPSSL_IDX] = s_user_paths[D_DUMP_IDX] + DUMP_SSL_DIR DIR_SEP;
+    s_user_paths[D_DUMPTRACES_IDX] = s_user_paths[D_DUMP_IDX] + DUMP_TRACES_DIR DIR_SEP;
     s_user_paths[F_MEM1DUMP_IDX] = s_user_paths[D_DUMP_IDX] + MEM1_DUMP;
     s_user_paths[F_MEM2DUMP_IDX] = s_user_paths[D_DUMP_IDX] + MEM2_DUMP;
     s_user_paths[F_ARAMDUMP_IDX] = s_user_paths[D_DUMP_IDX] + ARAM_DUMP;
@@ -48,6 +48,7 @@ enum
   D_DUMPTEXTURES_IDX,
   D_DUMPDSP_IDX,
   D_DUMPSSL_IDX,
+  D_DUMPTRACES_IDX,
   D_LOAD_IDX,
   D_LOGS_IDX,
   D_MAILLOGS_IDX,
@@ -111,6 +112,9 @@ public:
   bool IsFile() const;
   // Returns the size of a file (or returns 0 if the path doesn't refer to a file)
   u64 GetSize() const;
+  // Returns when a file was last modified, in seconds since the epoch (or returns 0 if the path
+  // doesn't refer to a file, or if the time isn't known)
+  s64 GetModificationTime() const;
 
 private:
 #ifdef ANDROID
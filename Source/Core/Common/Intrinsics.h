@@ -7,7 +7,7 @@
 
 /**
  * It is assumed that all compilers used to build Dolphin support intrinsics up to and including
- * SSE 4.2 on x86/x64.
+ * AVX2 on x86/x64.
  */
 
 #if defined(__GNUC__) || defined(__clang__)
@@ -27,6 +27,9 @@
  */
 
 #include <x86intrin.h>
+#ifndef __AVX2__
+#define FUNCTION_TARGET_AVX2 [[gnu::target("avx2")]]
+#endif
 #ifndef __SSE4_2__
 #define FUNCTION_TARGET_SSE42 [[gnu::target("sse4.2")]]
 #endif
@@ -39,6 +42,15 @@
 #ifndef __SSE3__
 #define FUNCTION_TARGET_SSE3 [[gnu::target("sse3")]]
 #endif
+#ifndef __AES__
+#define FUNCTION_TARGET_AES [[gnu::target("aes")]]
+#endif
+#if !defined(__VAES__) || !defined(__AVX2__)
+#define FUNCTION_TARGET_VAES [[gnu::target("aes,vaes,avx2")]]
+#endif
+#if !defined(__SHA__) || !defined(__SSE4_1__)
+#define FUNCTION_TARGET_SHA [[gnu::target("sha,sse4.1")]]
+#endif
 
 #elif defined(_MSC_VER) || defined(__INTEL_COMPILER)
 
@@ -51,12 +63,38 @@
 
 #endif  // _M_X86
 
+#if defined(_M_ARM_64)
+
+#ifdef _MSC_VER
+#include <arm64_neon.h>
+#else
+#include <arm_neon.h>
+
+/**
+ * Like on x86, the ARMv8 crypto instructions are enabled per-function so that builds still run on
+ * CPUs without them. Callers must check cpu_info.bAES, bSHA1 or bSHA2 first.
+ */
+#ifndef __ARM_FEATURE_CRYPTO
+#ifdef __clang__
+#define FUNCTION_TARGET_CRYPTO [[gnu::target("crypto")]]
+#else
+#define FUNCTION_TARGET_CRYPTO [[gnu::target("+crypto")]]
+#endif
+#endif
+
+#endif  // _MSC_VER
+
+#endif  // _M_ARM_64
+
 /**
  * Define the FUNCTION_TARGET macros to nothing if they are not needed, or not on an X86 platform.
  * This way when a function is defined with FUNCTION_TARGET you don't need to define a second
  * version without the macro around a #ifdef guard. Be careful when using intrinsics, as all use
  * should still be placed around a #ifdef _M_X86 if the file is compiled on all architectures.
  */
+#ifndef FUNCTION_TARGET_AVX2
+#define FUNCTION_TARGET_AVX2
+#endif
 #ifndef FUNCTION_TARGET_SSE42
 #define FUNCTION_TARGET_SSE42
 #endif
@@ -69,3 +107,15 @@
 #ifndef FUNCTION_TARGET_SSE3
 #define FUNCTION_TARGET_SSE3
 #endif
+#ifndef FUNCTION_TARGET_AES
+#define FUNCTION_TARGET_AES
+#endif
+#ifndef FUNCTION_TARGET_VAES
+#define FUNCTION_TARGET_VAES
+#endif
+#ifndef FUNCTION_TARGET_SHA
+#define FUNCTION_TARGET_SHA
+#endif
+#ifndef FUNCTION_TARGET_CRYPTO
+#define FUNCTION_TARGET_CRYPTO
+#endif
@@ -0,0 +1,89 @@
+// Copyright 2021 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+// a lockless thread-safe,
+// multiple producer, single consumer queue
+
+#include <atomic>
+#include <utility>
+
+namespace Common
+{
+// Push may be called from any number of threads at the same time, while Pop must only be called
+// from a single thread. An element which is being pushed may not be visible to Pop until the push
+// has finished.
+template <typename T>
+class MPSCQueue
+{
+public:
+  MPSCQueue()
+  {
+    m_read_ptr = new ElementPtr();
+    m_write_ptr.store(m_read_ptr);
+  }
+  ~MPSCQueue() { DeleteElements(); }
+
+  MPSCQueue(const MPSCQueue&) = delete;
+  MPSCQueue& operator=(const MPSCQueue&) = delete;
+
+  bool Empty() const { return !m_read_ptr->next.load(std::memory_order_acquire); }
+
+  template <typename Arg>
+  void Push(Arg&& t)
+  {
+    ElementPtr* new_ptr = new ElementPtr();
+    new_ptr->current = std::forward<Arg>(t);
+    // Claim the position at the end of the queue, then link it to the previous element
+    ElementPtr* prev_ptr = m_write_ptr.exchange(new_ptr, std::memory_order_acq_rel);
+    prev_ptr->next.store(new_ptr, std::memory_order_release);
+  }
+
+  bool Pop(T& t)
+  {
+    ElementPtr* next_ptr = m_read_ptr->next.load(std::memory_order_acquire);
+    if (!next_ptr)
+      return false;
+
+    // The element we read from becomes the new (empty) head of the queue
+    t = std::move(next_ptr->current);
+    delete m_read_ptr;
+    m_read_ptr = next_ptr;
+    return true;
+  }
+
+  // not thread-safe
+  void Clear()
+  {
+    DeleteElements();
+    m_read_ptr = new ElementPtr();
+    m_write_ptr.store(m_read_ptr);
+  }
+
+private:
+  // stores an element
+  // and a pointer to the next ElementPtr
+  struct ElementPtr
+  {
+    T current{};
+    std::atomic<ElementPtr*> next{nullptr};
+  };
+
+  void DeleteElements()
+  {
+    ElementPtr* ptr = m_read_ptr;
+    while (ptr)
+    {
+      ElementPtr* next_ptr = ptr->next.load();
+      delete ptr;
+      ptr = next_ptr;
+    }
+  }
+
+  // Only accessed by the consumer
+  ElementPtr* m_read_ptr;
+  // Shared between the producers
+  std::atomic<ElementPtr*> m_write_ptr;
+};
+}  // namespace Common
@@ -5,6 +5,7 @@
 #include "Common/CommonFuncs.h"
 #include "Common/CommonTypes.h"
 #include "Common/StringUtil.h"
+#include "Common/Tracing.h"
 
 #ifdef _WIN32
 #include <Windows.h>
@@ -112,6 +113,7 @@ void SetCurrentThreadName(const char* name)
 {
   SetCurrentThreadNameViaException(name);
   SetCurrentThreadNameViaApi(name);
+  Tracing::SetCurrentThreadName(name);
 }
 
 #else  // !WIN32, so must be POSIX threads
@@ -182,6 +184,7 @@ void SetCurrentThreadName(const char* name)
   // API.
   __itt_thread_set_name(name);
 #endif
+  Tracing::SetCurrentThreadName(name);
 }
 
 #endif
@@ -0,0 +1,198 @@
+// Copyright 2021 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "Common/Tracing.h"
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "Common/FileUtil.h"
+#include "Common/IOFile.h"
+
+namespace Common::Tracing
+{
+namespace
+{
+struct Event
+{
+  const char* category;
+  const char* name;
+  u64 start;
+  u64 end;
+};
+
+struct ThreadBuffer
+{
+  std::mutex mutex;
+  std::vector<Event> events;
+  size_t next = 0;
+  size_t count = 0;
+  u32 thread_id = 0;
+  std::string thread_name;
+  bool thread_alive = true;
+};
+
+// Keeps the buffer alive past the end of the thread, so that its events can still be written out.
+struct ThreadState
+{
+  ~ThreadState()
+  {
+    if (!buffer)
+      return;
+
+    std::lock_guard lk(buffer->mutex);
+    buffer->thread_alive = false;
+  }
+
+  std::shared_ptr<ThreadBuffer> buffer;
+  std::string name;
+};
+
+std::mutex s_buffers_mutex;
+std::vector<std::shared_ptr<ThreadBuffer>> s_buffers;
+u32 s_next_thread_id = 1;
+
+thread_local ThreadState t_state;
+
+const std::chrono::steady_clock::time_point s_epoch = std::chrono::steady_clock::now();
+
+ThreadBuffer& GetThreadBuffer()
+{
+  if (t_state.buffer)
+    return *t_state.buffer;
+
+  auto buffer = std::make_shared<ThreadBuffer>();
+  buffer->events.resize(EVENTS_PER_THREAD);
+
+  std::lock_guard lk(s_buffers_mutex);
+  buffer->thread_id = s_next_thread_id++;
+  buffer->thread_name =
+      t_state.name.empty() ? fmt::format("Thread {}", buffer->thread_id) : t_state.name;
+  s_buffers.push_back(buffer);
+  t_state.buffer = std::move(buffer);
+  return *t_state.buffer;
+}
+
+void AppendEscaped(std::string* out, std::string_view str)
+{
+  for (const char c : str)
+  {
+    if (c == '"' || c == '\\')
+      out->push_back('\\');
+    if (static_cast<unsigned char>(c) >= 0x20)
+      out->push_back(c);
+  }
+}
+}  // Anonymous namespace
+
+std::atomic<bool> detail::s_enabled{false};
+
+u64 detail::GetTimestamp()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() -
+                                                              s_epoch)
+      .count();
+}
+
+void detail::RecordEvent(const char* category, const char* name, u64 start, u64 end)
+{
+  ThreadBuffer& buffer = GetThreadBuffer();
+
+  std::lock_guard lk(buffer.mutex);
+  buffer.events[buffer.next] = {category, name, start, end};
+  buffer.next = (buffer.next + 1) % EVENTS_PER_THREAD;
+  buffer.count = std::min(buffer.count + 1, EVENTS_PER_THREAD);
+}
+
+void Start()
+{
+  std::lock_guard lk(s_buffers_mutex);
+
+  // The events of threads which have exited are from before this trace, so drop their buffers.
+  s_buffers.erase(std::remove_if(s_buffers.begin(), s_buffers.end(),
+                                 [](const std::shared_ptr<ThreadBuffer>& buffer) {
+                                   std::lock_guard buffer_lk(buffer->mutex);
+                                   return !buffer->thread_alive;
+                                 }),
+                  s_buffers.end());
+
+  for (const auto& buffer : s_buffers)
+  {
+    std::lock_guard buffer_lk(buffer->mutex);
+    buffer->next = 0;
+    buffer->count = 0;
+  }
+
+  detail::s_enabled.store(true, std::memory_order_relaxed);
+}
+
+void Stop()
+{
+  detail::s_enabled.store(false, std::memory_order_relaxed);
+}
+
+bool WriteChromeTrace(const std::string& path)
+{
+  std::string json = "{\"traceEvents\":[\n";
+  bool first = true;
+  const auto begin_event = [&] {
+    if (!first)
+      json += ",\n";
+    first = false;
+  };
+
+  {
+    std::lock_guard lk(s_buffers_mutex);
+    for (const auto& buffer : s_buffers)
+    {
+      std::lock_guard buffer_lk(buffer->mutex);
+
+      begin_event();
+      json += fmt::format(
+          R"({{"name":"thread_name","ph":"M","pid":1,"tid":{},"args":{{"name":")",
+          buffer->thread_id);
+      AppendEscaped(&json, buffer->thread_name);
+      json += "\"}}";
+
+      // Oldest event first
+      size_t index = (buffer->next + EVENTS_PER_THREAD - buffer->count) % EVENTS_PER_THREAD;
+      for (size_t i = 0; i < buffer->count; ++i)
+      {
+        const Event& event = buffer->events[index];
+        index = (index + 1) % EVENTS_PER_THREAD;
+
+        // Timestamps are in microseconds
+        begin_event();
+        json += fmt::format(
+            R"({{"name":"{}","cat":"{}","ph":"X","ts":{:.3f},"dur":{:.3f},"pid":1,"tid":{}}})",
+            event.name, event.category, event.start / 1000.0, (event.end - event.start) / 1000.0,
+            buffer->thread_id);
+      }
+    }
+  }
+
+  json += "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+  if (!File::CreateFullPath(path))
+    return false;
+
+  File::IOFile file(path, "wb");
+  return file.WriteString(json);
+}
+
+void SetCurrentThreadName(const char* name)
+{
+  t_state.name = name;
+  if (!t_state.buffer)
+    return;
+
+  std::lock_guard lk(t_state.buffer->mutex);
+  t_state.buffer->thread_name = name;
+}
+}  // namespace Common::Tracing
@@ -0,0 +1,77 @@
+// Copyright 2021 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <string>
+
+#include "Common/CommonTypes.h"
+
+// Records timed events into a ring buffer per thread, which can be written out as a Chrome trace
+// (JSON trace event format) and opened in chrome://tracing or Perfetto. While tracing is disabled,
+// a traced scope costs one relaxed atomic load.
+namespace Common::Tracing
+{
+// The number of events kept per thread. Older events are overwritten.
+constexpr size_t EVENTS_PER_THREAD = 1 << 16;
+
+namespace detail
+{
+extern std::atomic<bool> s_enabled;
+
+u64 GetTimestamp();
+void RecordEvent(const char* category, const char* name, u64 start, u64 end);
+}  // namespace detail
+
+inline bool IsEnabled()
+{
+  return detail::s_enabled.load(std::memory_order_relaxed);
+}
+
+// Discards all recorded events and starts recording.
+void Start();
+void Stop();
+
+// Writes the recorded events of all threads to path. Returns false if the file can't be written.
+bool WriteChromeTrace(const std::string& path);
+
+// Names the current thread in traces. Called by Common::SetCurrentThreadName.
+void SetCurrentThreadName(const char* name);
+
+// Records the time from construction to destruction as an event. category and name must be string
+// literals, as only the pointers are stored.
+class ScopedEvent
+{
+public:
+  ScopedEvent(const char* category, const char* name)
+  {
+    if (IsEnabled())
+    {
+      m_category = category;
+      m_name = name;
+      m_start = detail::GetTimestamp();
+    }
+  }
+
+  ~ScopedEvent()
+  {
+    if (m_name)
+      detail::RecordEvent(m_category, m_name, m_start, detail::GetTimestamp());
+  }
+
+  ScopedEvent(const ScopedEvent&) = delete;
+  ScopedEvent& operator=(const ScopedEvent&) = delete;
+
+private:
+  const char* m_category = nullptr;
+  const char* m_name = nullptr;
+  u64 m_start = 0;
+};
+}  // namespace Common::Tracing
+
+#define TRACE_SCOPE_CONCAT2(a, b) a##b
+#define TRACE_SCOPE_CONCAT(a, b) TRACE_SCOPE_CONCAT2(a, b)
+#define TRACE_SCOPE(category, name)                                                                \
+  Common::Tracing::ScopedEvent TRACE_SCOPE_CONCAT(trace_scope_, __LINE__)(category, name)
@@ -170,6 +170,14 @@ void CPUInfo::Detect()
         bBMI1 = true;
       if ((cpu_id[1] >> 8) & 1)
         bBMI2 = true;
+      // The SHA extensions cover both SHA-1 and SHA-256
+      if ((cpu_id[1] >> 29) & 1)
+      {
+        bSHA1 = true;
+        bSHA2 = true;
+      }
+      if ((cpu_id[2] >> 9) & 1)
+        bVAES = bAVX2 && bAES;
     }
   }
 
@@ -269,6 +277,10 @@ std::string CPUInfo::Summarize()
     sum += ", FMA";
   if (bAES)
     sum += ", AES";
+  if (bVAES)
+    sum += ", VAES";
+  if (bSHA1)
+    sum += ", SHA";
   if (bMOVBE)
     sum += ", MOVBE";
   if (bLongMode)
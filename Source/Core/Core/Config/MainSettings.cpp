@@ -23,6 +23,8 @@ const Info<bool> MAIN_SKIP_IPL{{System::Main, "Core", "SkipIPL"}, true};
 const Info<PowerPC::CPUCore> MAIN_CPU_CORE{{System::Main, "Core", "CPUCore"},
                                            PowerPC::DefaultCPUCore()};
 const Info<bool> MAIN_JIT_FOLLOW_BRANCH{{System::Main, "Core", "JITFollowBranch"}, true};
+const Info<bool> MAIN_JIT_TIERED_COMPILATION{{System::Main, "Core", "JITTieredCompilation"},
+                                             false};
 const Info<bool> MAIN_FASTMEM{{System::Main, "Core", "Fastmem"}, true};
 const Info<bool> MAIN_DSP_HLE{{System::Main, "Core", "DSPHLE"}, true};
 const Info<int> MAIN_TIMING_VARIANCE{{System::Main, "Core", "TimingVariance"}, 40};
@@ -108,6 +110,17 @@ const Info<DiscIO::Region> MAIN_FALLBACK_REGION{{System::Main, "Core", "Fallback
 const Info<bool> MAIN_AUTO_DISC_CHANGE{{System::Main, "Core", "AutoDiscChange"}, false};
 const Info<bool> MAIN_ALLOW_SD_WRITES{{System::Main, "Core", "WiiSDCardAllowWrites"}, true};
 const Info<bool> MAIN_ENABLE_SAVESTATES{{System::Main, "Core", "EnableSaveStates"}, false};
+const Info<bool> MAIN_REWIND_ENABLED{{System::Main, "Core", "RewindEnabled"}, false};
+// Number of frames between rewind snapshots
+const Info<u32> MAIN_REWIND_INTERVAL{{System::Main, "Core", "RewindInterval"}, 6};
+// Memory budget for compressed rewind snapshots, in MiB
+const Info<u32> MAIN_REWIND_BUFFER_SIZE{{System::Main, "Core", "RewindBufferSize"}, 256};
+// Memory budget for decompressed blocks of compressed disc images, in MiB. 0 picks a size based on
+// the amount of RAM
+const Info<u32> MAIN_DISC_CACHE_SIZE{{System::Main, "Core", "DiscCacheSize"}, 0};
+// Number of blocks to decompress ahead of sequential disc reads
+const Info<u32> MAIN_DISC_READ_AHEAD{{System::Main, "Core", "DiscReadAhead"}, 4};
+const Info<bool> MAIN_DISC_READ_TRACE{{System::Main, "Core", "DiscReadTrace"}, false};
 
 // Main.Display
 
@@ -25,6 +25,7 @@ namespace Config
 extern const Info<bool> MAIN_SKIP_IPL;
 extern const Info<PowerPC::CPUCore> MAIN_CPU_CORE;
 extern const Info<bool> MAIN_JIT_FOLLOW_BRANCH;
+extern const Info<bool> MAIN_JIT_TIERED_COMPILATION;
 extern const Info<bool> MAIN_FASTMEM;
 // Should really be in the DSP section, but we're kind of stuck with bad decisions made in the past.
 extern const Info<bool> MAIN_DSP_HLE;
@@ -85,6 +86,12 @@ extern const Info<u32> MAIN_CUSTOM_RTC_VALUE;
 extern const Info<bool> MAIN_AUTO_DISC_CHANGE;
 extern const Info<bool> MAIN_ALLOW_SD_WRITES;
 extern const Info<bool> MAIN_ENABLE_SAVESTATES;
+extern const Info<bool> MAIN_REWIND_ENABLED;
+extern const Info<u32> MAIN_REWIND_INTERVAL;
+extern const Info<u32> MAIN_REWIND_BUFFER_SIZE;
+extern const Info<u32> MAIN_DISC_CACHE_SIZE;
+extern const Info<u32> MAIN_DISC_READ_AHEAD;
+extern const Info<bool> MAIN_DISC_READ_TRACE;
 extern const Info<DiscIO::Region> MAIN_FALLBACK_REGION;
 
 // Main.DSP
@@ -46,10 +46,11 @@ bool IsSettingSaveable(const Config::Location& config_location)
     }
   }
 
-  static constexpr std::array<const Config::Location*, 17> s_setting_saveable = {
+  static constexpr std::array<const Config::Location*, 24> s_setting_saveable = {
       // Main.Core
 
       &Config::MAIN_DEFAULT_ISO.GetLocation(),
+      &Config::MAIN_JIT_TIERED_COMPILATION.GetLocation(),
       &Config::MAIN_MEMCARD_A_PATH.GetLocation(),
       &Config::MAIN_MEMCARD_B_PATH.GetLocation(),
       &Config::MAIN_AUTO_DISC_CHANGE.GetLocation(),
@@ -61,6 +62,12 @@ bool IsSettingSaveable(const Config::Location& config_location)
       &Config::MAIN_MEM2_SIZE.GetLocation(),
       &Config::MAIN_GFX_BACKEND.GetLocation(),
       &Config::MAIN_ENABLE_SAVESTATES.GetLocation(),
+      &Config::MAIN_REWIND_ENABLED.GetLocation(),
+      &Config::MAIN_REWIND_INTERVAL.GetLocation(),
+      &Config::MAIN_REWIND_BUFFER_SIZE.GetLocation(),
+      &Config::MAIN_DISC_CACHE_SIZE.GetLocation(),
+      &Config::MAIN_DISC_READ_AHEAD.GetLocation(),
+      &Config::MAIN_DISC_READ_TRACE.GetLocation(),
       &Config::MAIN_FALLBACK_REGION.GetLocation(),
 
       // Main.Interface
@@ -34,6 +34,7 @@
 #include "Common/StringUtil.h"
 #include "Common/Thread.h"
 #include "Common/Timer.h"
+#include "Common/Tracing.h"
 #include "Common/Version.h"
 
 #include "Core/Boot/Boot.h"
@@ -63,6 +64,7 @@
 #include "Core/PatchEngine.h"
 #include "Core/PowerPC/JitInterface.h"
 #include "Core/PowerPC/PowerPC.h"
+#include "Core/Rewind.h"
 #include "Core/State.h"
 #include "Core/WiiRoot.h"
 
@@ -104,6 +106,7 @@ static bool s_is_started = false;
 static Common::Flag s_is_booting;
 static std::thread s_emu_thread;
 static std::vector<StateChangedCallbackFunc> s_on_state_changed_callbacks;
+static std::function<void()> s_on_frame_presented_callback;
 
 static std::thread s_cpu_thread;
 static bool s_request_refresh_info = false;
@@ -152,6 +155,8 @@ void FrameUpdateOnCPUThread()
 
 void OnFrameEnd()
 {
+  Rewind::OnFrameEnd();
+
 #ifdef USE_MEMORYWATCHER
   if (s_memory_watcher)
     s_memory_watcher->Step();
@@ -761,6 +766,27 @@ void SaveScreenShot(std::string_view name)
   });
 }
 
+void ToggleTracing()
+{
+  if (!Common::Tracing::IsEnabled())
+  {
+    Common::Tracing::Start();
+    DisplayMessage("Started recording trace", 2000);
+    return;
+  }
+
+  Common::Tracing::Stop();
+
+  const std::time_t cur_time = std::time(nullptr);
+  const std::string path =
+      fmt::format("{}{}_{:%Y-%m-%d_%H-%M-%S}.json", File::GetUserPath(D_DUMPTRACES_IDX),
+                  SConfig::GetInstance().GetGameID(), *std::localtime(&cur_time));
+  if (Common::Tracing::WriteChromeTrace(path))
+    DisplayMessage(fmt::format("Saved trace to {}", path), 4000);
+  else
+    DisplayMessage(fmt::format("Failed to save trace to {}", path), 4000);
+}
+
 void RequestRefreshInfo()
 {
   s_request_refresh_info = true;
@@ -887,6 +913,14 @@ void Callback_FramePresented(double actual_emulation_speed)
 
   s_drawn_frame++;
   s_stop_frame_step.store(true);
+
+  if (s_on_frame_presented_callback)
+    s_on_frame_presented_callback();
+}
+
+void SetOnFramePresentedCallback(std::function<void()> callback)
+{
+  s_on_frame_presented_callback = std::move(callback);
 }
 
 // Called from VideoInterface::Update (CPU thread) at emulated field boundaries
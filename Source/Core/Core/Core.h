@@ -30,6 +30,10 @@ double GetActualEmulationSpeed();
 void Callback_FramePresented(double actual_emulation_speed = 1.0);
 void Callback_NewField();
 
+// Sets a function which is called on the GPU thread each time a new frame has been presented.
+// Must not be changed while emulation is running.
+void SetOnFramePresentedCallback(std::function<void()> callback);
+
 enum class State
 {
   Uninitialized,
@@ -116,6 +120,9 @@ State GetState();
 void SaveScreenShot();
 void SaveScreenShot(std::string_view name);
 
+// Starts recording a trace, or stops it and writes it to the traces dump folder.
+void ToggleTracing();
+
 // This displays messages in a user-visible way.
 void DisplayMessage(std::string message, int time_in_ms);
 
@@ -4,7 +4,6 @@
 #include "Core/CoreTiming.h"
 
 #include <algorithm>
-#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -14,7 +13,8 @@
 #include "Common/Assert.h"
 #include "Common/ChunkFile.h"
 #include "Common/Logging/Log.h"
-#include "Common/SPSCQueue.h"
+#include "Common/MPSCQueue.h"
+#include "Common/Tracing.h"
 
 #include "Core/ConfigManager.h"
 #include "Core/Core.h"
@@ -29,6 +29,8 @@ struct EventType
 {
   TimedCallback callback;
   const std::string* name;
+  // Positions in s_event_queue of the queued events of this type, in no particular order
+  std::vector<size_t> queued_events;
 };
 
 struct Event
@@ -37,6 +39,8 @@ struct Event
   u64 fifo_order;
   u64 userdata;
   EventType* type;
+  // Position of this event in type->queued_events
+  size_t type_index;
 };
 
 // Sort by time, unless the times are the same, in which case sort by the order added to the queue
@@ -54,14 +58,15 @@ static bool operator<(const Event& left, const Event& right)
 static std::unordered_map<std::string, EventType> s_event_types;
 
 // STATE_TO_SAVE
-// The queue is a min-heap using std::make_heap/push_heap/pop_heap.
-// We don't use std::priority_queue because we need to be able to serialize, unserialize and
-// erase arbitrary events (RemoveEvent()) regardless of the queue order. These aren't accomodated
-// by the standard adaptor class.
+// The queue is a binary min-heap. Every event type keeps track of where its events are in the
+// heap, so that RemoveEvent() can erase them without searching or rebuilding the whole heap.
+// We don't use std::priority_queue or std::push_heap because we need to be able to serialize,
+// unserialize and erase arbitrary events regardless of the queue order, and the standard
+// algorithms can't tell us where elements have been moved to.
 static std::vector<Event> s_event_queue;
 static u64 s_event_fifo_id;
-static std::mutex s_ts_write_lock;
-static Common::SPSCQueue<Event, false> s_ts_queue;
+// Events scheduled from other threads, which are moved into s_event_queue by MoveEvents()
+static Common::MPSCQueue<Event> s_ts_queue;
 
 static float s_last_OC_factor;
 static constexpr int MAX_SLICE_LENGTH = 20000;
@@ -98,6 +103,101 @@ static int CyclesToDowncount(int cycles)
   return static_cast<int>(cycles * s_last_OC_factor);
 }
 
+// Moves an event to the given position in the queue, and updates the index of its type.
+static void PlaceEvent(size_t index, Event&& ev)
+{
+  ev.type->queued_events[ev.type_index] = index;
+  s_event_queue[index] = std::move(ev);
+}
+
+static void SiftUp(size_t index)
+{
+  Event ev = std::move(s_event_queue[index]);
+  while (index > 0)
+  {
+    const size_t parent = (index - 1) / 2;
+    if (!(ev < s_event_queue[parent]))
+      break;
+    PlaceEvent(index, std::move(s_event_queue[parent]));
+    index = parent;
+  }
+  PlaceEvent(index, std::move(ev));
+}
+
+static void SiftDown(size_t index)
+{
+  const size_t size = s_event_queue.size();
+  Event ev = std::move(s_event_queue[index]);
+  while (true)
+  {
+    size_t child = index * 2 + 1;
+    if (child >= size)
+      break;
+    if (child + 1 < size && s_event_queue[child + 1] < s_event_queue[child])
+      ++child;
+    if (!(s_event_queue[child] < ev))
+      break;
+    PlaceEvent(index, std::move(s_event_queue[child]));
+    index = child;
+  }
+  PlaceEvent(index, std::move(ev));
+}
+
+static void PushEvent(Event&& ev)
+{
+  ev.type_index = ev.type->queued_events.size();
+  ev.type->queued_events.push_back(s_event_queue.size());
+  s_event_queue.emplace_back(std::move(ev));
+  SiftUp(s_event_queue.size() - 1);
+}
+
+static Event PopEvent(size_t index)
+{
+  Event ev = std::move(s_event_queue[index]);
+
+  // Take the event out of its type's index
+  std::vector<size_t>& queued_events = ev.type->queued_events;
+  const size_t moved_index = queued_events.back();
+  queued_events[ev.type_index] = moved_index;
+  s_event_queue[moved_index].type_index = ev.type_index;
+  queued_events.pop_back();
+
+  // Fill the hole with the last event of the heap
+  const size_t last = s_event_queue.size() - 1;
+  if (index != last)
+  {
+    PlaceEvent(index, std::move(s_event_queue[last]));
+    s_event_queue.pop_back();
+    if (index > 0 && s_event_queue[index] < s_event_queue[(index - 1) / 2])
+      SiftUp(index);
+    else
+      SiftDown(index);
+  }
+  else
+  {
+    s_event_queue.pop_back();
+  }
+
+  return ev;
+}
+
+// Restores the heap property and the event type indices after s_event_queue was modified
+// as a whole.
+static void RebuildEventQueue()
+{
+  for (auto& event_type : s_event_types)
+    event_type.second.queued_events.clear();
+
+  std::make_heap(s_event_queue.begin(), s_event_queue.end(), std::greater<Event>());
+
+  for (size_t i = 0; i < s_event_queue.size(); ++i)
+  {
+    Event& ev = s_event_queue[i];
+    ev.type_index = ev.type->queued_events.size();
+    ev.type->queued_events.push_back(i);
+  }
+}
+
 EventType* RegisterEvent(const std::string& name, TimedCallback callback)
 {
   // check for existing type with same name.
@@ -107,7 +207,7 @@ EventType* RegisterEvent(const std::string& name, TimedCallback callback)
              "during Init to avoid breaking save states.",
              name.c_str());
 
-  auto info = s_event_types.emplace(name, EventType{callback, nullptr});
+  auto info = s_event_types.emplace(name, EventType{callback, nullptr, {}});
   EventType* event_type = &info.first->second;
   event_type->name = &info.first->first;
   return event_type;
@@ -140,7 +240,6 @@ void Init()
 
 void Shutdown()
 {
-  std::lock_guard lk(s_ts_write_lock);
   MoveEvents();
   ClearPendingEvents();
   UnregisterAllEvents();
@@ -148,7 +247,6 @@ void Shutdown()
 
 void DoState(PointerWrap& p)
 {
-  std::lock_guard lk(s_ts_write_lock);
   p.Do(g.slice_length);
   p.Do(g.global_timer);
   p.Do(s_idled_cycles);
@@ -200,7 +298,7 @@ void DoState(PointerWrap& p)
   // The exact layout of the heap in memory is implementation defined, therefore it is platform
   // and library version specific.
   if (p.GetMode() == PointerWrap::MODE_READ)
-    std::make_heap(s_event_queue.begin(), s_event_queue.end(), std::greater<Event>());
+    RebuildEventQueue();
 }
 
 // This should only be called from the CPU thread. If you are calling
@@ -224,6 +322,8 @@ u64 GetIdleTicks()
 void ClearPendingEvents()
 {
   s_event_queue.clear();
+  for (auto& event_type : s_event_types)
+    event_type.second.queued_events.clear();
 }
 
 void ScheduleEvent(s64 cycles_into_future, EventType* event_type, u64 userdata, FromThread from)
@@ -251,8 +351,7 @@ void ScheduleEvent(s64 cycles_into_future, EventType* event_type, u64 userdata,
     if (!s_is_global_timer_sane)
       ForceExceptionCheck(cycles_into_future);
 
-    s_event_queue.emplace_back(Event{timeout, s_event_fifo_id++, userdata, event_type});
-    std::push_heap(s_event_queue.begin(), s_event_queue.end(), std::greater<Event>());
+    PushEvent(Event{timeout, s_event_fifo_id++, userdata, event_type, 0});
   }
   else
   {
@@ -264,22 +363,14 @@ void ScheduleEvent(s64 cycles_into_future, EventType* event_type, u64 userdata,
                     *event_type->name);
     }
 
-    std::lock_guard lk(s_ts_write_lock);
-    s_ts_queue.Push(Event{g.global_timer + cycles_into_future, 0, userdata, event_type});
+    s_ts_queue.Push(Event{g.global_timer + cycles_into_future, 0, userdata, event_type, 0});
   }
 }
 
 void RemoveEvent(EventType* event_type)
 {
-  auto itr = std::remove_if(s_event_queue.begin(), s_event_queue.end(),
-                            [&](const Event& e) { return e.type == event_type; });
-
-  // Removing random items breaks the invariant so we have to re-establish it.
-  if (itr != s_event_queue.end())
-  {
-    s_event_queue.erase(itr, s_event_queue.end());
-    std::make_heap(s_event_queue.begin(), s_event_queue.end(), std::greater<Event>());
-  }
+  while (!event_type->queued_events.empty())
+    PopEvent(event_type->queued_events.back());
 }
 
 void RemoveAllEvents(EventType* event_type)
@@ -305,13 +396,14 @@ void MoveEvents()
   for (Event ev; s_ts_queue.Pop(ev);)
   {
     ev.fifo_order = s_event_fifo_id++;
-    s_event_queue.emplace_back(std::move(ev));
-    std::push_heap(s_event_queue.begin(), s_event_queue.end(), std::greater<Event>());
+    PushEvent(std::move(ev));
   }
 }
 
 void Advance()
 {
+  TRACE_SCOPE("cpu", "CoreTiming::Advance");
+
   MoveEvents();
 
   int cyclesExecuted = g.slice_length - DowncountToCycles(PowerPC::ppcState.downcount);
@@ -324,9 +416,7 @@ void Advance()
 
   while (!s_event_queue.empty() && s_event_queue.front().time <= g.global_timer)
   {
-    Event evt = std::move(s_event_queue.front());
-    std::pop_heap(s_event_queue.begin(), s_event_queue.end(), std::greater<Event>());
-    s_event_queue.pop_back();
+    Event evt = PopEvent(0);
     evt.type->callback(evt.userdata, g.global_timer - evt.time);
   }
 
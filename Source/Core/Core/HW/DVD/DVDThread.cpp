@@ -3,24 +3,33 @@
 
 #include "Core/HW/DVD/DVDThread.h"
 
+#include <condition_variable>
+#include <ctime>
 #include <map>
 #include <memory>
 #include <mutex>
 #include <optional>
+#include <string>
 #include <thread>
 #include <utility>
 #include <vector>
 
+#include <fmt/chrono.h>
+#include <fmt/format.h>
+
 #include "Common/ChunkFile.h"
 #include "Common/CommonTypes.h"
 #include "Common/Event.h"
+#include "Common/FileUtil.h"
 #include "Common/Flag.h"
+#include "Common/IOFile.h"
 #include "Common/Logging/Log.h"
 #include "Common/MsgHandler.h"
 #include "Common/SPSCQueue.h"
 #include "Common/Thread.h"
 #include "Common/Timer.h"
 
+#include "Core/Config/MainSettings.h"
 #include "Core/ConfigManager.h"
 #include "Core/Core.h"
 #include "Core/CoreTiming.h"
@@ -30,6 +39,7 @@
 #include "Core/HW/SystemTimers.h"
 #include "Core/IOS/ES/Formats.h"
 
+#include "DiscIO/Blob.h"
 #include "DiscIO/Enums.h"
 #include "DiscIO/Volume.h"
 
@@ -61,8 +71,13 @@ struct ReadRequest
 
 using ReadResult = std::pair<ReadRequest, std::vector<u8>>;
 
+// Adjacent requests (such as the chunks DVDInterface splits a read into) are read from the disc
+// as one, up to this many bytes at a time. Larger reads would delay the first chunk's result.
+constexpr u32 MAX_COALESCED_READ_LENGTH = 0x100000;
+
 static void StartDVDThread();
 static void StopDVDThread();
+static void ConfigureBlobReader();
 
 static void DVDThread();
 static void WaitUntilIdle();
@@ -78,28 +93,46 @@ static u64 s_next_id = 0;
 
 static std::thread s_dvd_thread;
 static Common::Event s_request_queue_expanded;    // Is set by CPU thread
-static Common::Event s_result_queue_expanded;     // Is set by DVD thread
 static Common::Flag s_dvd_thread_exiting(false);  // Is set by CPU thread
 
 static Common::SPSCQueue<ReadRequest, false> s_request_queue;
-static Common::SPSCQueue<ReadResult, false> s_result_queue;
+
+// Results are keyed by request ID, since they can be finished in a different order than the
+// DVD thread produces them. Guarded by s_result_mutex.
+static std::mutex s_result_mutex;
+static std::condition_variable s_result_map_expanded;  // Is notified by DVD thread
 static std::map<u64, ReadResult> s_result_map;
 
 static std::unique_ptr<DiscIO::Volume> s_disc;
 
+// Applied to the blob reader of every disc that is inserted
+static u64 s_decompressed_cache_size = 0;
+static u32 s_read_ahead_blocks = 0;
+
+// Only accessed by the DVD thread, or while it is idle
+static bool s_read_trace_enabled = false;
+static File::IOFile s_read_trace;
+static u64 s_read_trace_start_us = 0;
+
 void Start()
 {
   s_finish_read = CoreTiming::RegisterEvent("FinishReadDVDThread", FinishRead);
 
   s_request_queue_expanded.Reset();
-  s_result_queue_expanded.Reset();
   s_request_queue.Clear();
-  s_result_queue.Clear();
+  s_result_map.clear();
 
   // This is reset on every launch for determinism, but it doesn't matter
   // much, because this will never get exposed to the emulated game.
   s_next_id = 0;
 
+  const u32 cache_size_mib = Config::Get(Config::MAIN_DISC_CACHE_SIZE);
+  s_decompressed_cache_size = cache_size_mib == 0 ? DiscIO::GetDefaultDecompressedCacheSize() :
+                                                    u64(cache_size_mib) << 20;
+  s_read_ahead_blocks = Config::Get(Config::MAIN_DISC_READ_AHEAD);
+  ConfigureBlobReader();
+  s_read_trace_enabled = Config::Get(Config::MAIN_DISC_READ_TRACE);
+
   StartDVDThread();
 }
 
@@ -114,6 +147,7 @@ void Stop()
 {
   StopDVDThread();
   s_disc.reset();
+  s_read_trace.Close();
 }
 
 static void StopDVDThread()
@@ -136,14 +170,7 @@ void DoState(PointerWrap& p)
   // won't be touching anything while this function runs.
   WaitUntilIdle();
 
-  // Move all results from s_result_queue to s_result_map because
-  // PointerWrap::Do supports std::map but not Common::SPSCQueue.
-  // This won't affect the behavior of FinishRead.
-  ReadResult result;
-  while (s_result_queue.Pop(result))
-    s_result_map.emplace(result.first.id, std::move(result));
-
-  // Both queues are now empty, so we don't need to savestate them.
+  // The request queue is now empty, so we don't need to savestate it.
   p.Do(s_result_map);
   p.Do(s_next_id);
 
@@ -173,10 +200,24 @@ void DoState(PointerWrap& p)
   // was made. Handling that properly may be more effort than it's worth.
 }
 
+// Lets the reader of the disc use the cache size and read-ahead depth meant for emulation.
+// Must only be called while the DVD thread is idle.
+static void ConfigureBlobReader()
+{
+  if (!s_disc)
+    return;
+
+  DiscIO::BlobReader& blob = s_disc->GetBlobReader();
+  blob.SetDecompressedCacheSize(s_decompressed_cache_size);
+  blob.SetReadAheadBlocks(s_read_ahead_blocks);
+}
+
 void SetDisc(std::unique_ptr<DiscIO::Volume> disc)
 {
   WaitUntilIdle();
   s_disc = std::move(disc);
+  ConfigureBlobReader();
+  s_read_trace.Close();
 }
 
 bool HasDisc()
@@ -246,8 +287,11 @@ void WaitUntilIdle()
 {
   ASSERT(Core::IsCPUThread());
 
-  while (!s_request_queue.Empty())
-    s_result_queue_expanded.Wait();
+  s_request_queue_expanded.Set();
+  {
+    std::unique_lock lock(s_result_mutex);
+    s_result_map_expanded.wait(lock, [] { return s_request_queue.Empty(); });
+  }
 
   StopDVDThread();
   StartDVDThread();
@@ -289,44 +333,33 @@ static void StartReadInternal(bool copy_to_ram, u32 output_address, u64 dvd_offs
   request.realtime_started_us = Common::Timer::GetTimeUs();
 
   s_request_queue.Push(std::move(request));
-  s_request_queue_expanded.Set();
+
+  // DVDInterface splits a read into chunks where all but the last use NoReply. Waking the
+  // DVD thread only once the last chunk is queued lets it read all of them in one go.
+  if (reply_type != DVDInterface::ReplyType::NoReply)
+    s_request_queue_expanded.Set();
 
   CoreTiming::ScheduleEvent(ticks_until_completion, s_finish_read, id);
 }
 
 static void FinishRead(u64 id, s64 cycles_late)
 {
-  // We can't simply pop s_result_queue and always get the ReadResult
-  // we want, because the DVD thread may add ReadResults to the queue
-  // in a different order than we want to get them. What we do instead
-  // is to pop the queue until we find the ReadResult we want (the one
-  // whose ID matches userdata), which means we may end up popping
-  // ReadResults that we don't want. We can't add those unwanted results
-  // back to the queue, because the queue can only have one writer.
-  // Instead, we add them to a map that only is used by the CPU thread.
-  // When this function is called again later, it will check the map for
-  // the wanted ReadResult before it starts searching through the queue.
+  // Completion is scheduled on CoreTiming, so if the DVD thread hasn't read
+  // the data by now, we have to wait for it to keep the timing deterministic.
+  if (!s_request_queue.Empty())
+    s_request_queue_expanded.Set();
+
   ReadResult result;
-  auto it = s_result_map.find(id);
-  if (it != s_result_map.end())
   {
+    std::unique_lock lock(s_result_mutex);
+    auto it = s_result_map.end();
+    s_result_map_expanded.wait(lock, [&] {
+      it = s_result_map.find(id);
+      return it != s_result_map.end();
+    });
     result = std::move(it->second);
     s_result_map.erase(it);
   }
-  else
-  {
-    while (true)
-    {
-      while (!s_result_queue.Pop(result))
-        s_result_queue_expanded.Wait();
-
-      if (result.first.id == id)
-        break;
-      else
-        s_result_map.emplace(result.first.id, std::move(result));
-    }
-  }
-  // We have now obtained the right ReadResult.
 
   const ReadRequest& request = result.first;
   const std::vector<u8>& buffer = result.second;
@@ -361,10 +394,104 @@ static void FinishRead(u64 id, s64 cycles_late)
   DVDInterface::FinishExecutingCommand(request.reply_type, interrupt, cycles_late, buffer);
 }
 
+// Writes one line per read, which DolphinNoGUI's --replay_disc_trace can play back:
+// <microseconds since the first read> <partition offset or -> <offset> <length>
+static void RecordRead(const ReadRequest& request)
+{
+  if (!s_read_trace.IsOpen())
+  {
+    const std::time_t cur_time = std::time(nullptr);
+    const std::string path =
+        fmt::format("{}{}_{:%Y-%m-%d_%H-%M-%S}_disc.txt", File::GetUserPath(D_DUMPTRACES_IDX),
+                    s_disc->GetGameID(), *std::localtime(&cur_time));
+    if (!File::CreateFullPath(path) || !s_read_trace.Open(path, "w"))
+    {
+      ERROR_LOG_FMT(DVDINTERFACE, "Could not open {} for writing the disc read trace", path);
+      s_read_trace_enabled = false;
+      return;
+    }
+
+    s_read_trace_start_us = request.realtime_started_us;
+  }
+
+  const std::string partition = request.partition == DiscIO::PARTITION_NONE ?
+                                    "-" :
+                                    fmt::format("{:x}", request.partition.offset);
+  s_read_trace.WriteString(fmt::format("{} {} {:x} {:x}\n",
+                                       request.realtime_started_us - s_read_trace_start_us,
+                                       partition, request.dvd_offset, request.length));
+}
+
+// Pops a request along with the queued requests which continue where it ends
+static bool PopAdjacentRequests(std::vector<ReadRequest>* requests)
+{
+  requests->clear();
+
+  ReadRequest request;
+  if (!s_request_queue.Pop(request))
+    return false;
+
+  const DiscIO::Partition partition = request.partition;
+  u64 end_offset = request.dvd_offset + request.length;
+  u64 total_length = request.length;
+  requests->push_back(std::move(request));
+
+  while (!s_request_queue.Empty())
+  {
+    const ReadRequest& next = s_request_queue.Front();
+    if (next.partition != partition || next.dvd_offset != end_offset ||
+        total_length + next.length > MAX_COALESCED_READ_LENGTH)
+    {
+      break;
+    }
+
+    end_offset += next.length;
+    total_length += next.length;
+    s_request_queue.Pop(request);
+    requests->push_back(std::move(request));
+  }
+
+  return true;
+}
+
+static std::vector<std::vector<u8>> ReadRequests(const std::vector<ReadRequest>& requests)
+{
+  std::vector<std::vector<u8>> buffers(requests.size());
+
+  if (requests.size() > 1)
+  {
+    const ReadRequest& first = requests.front();
+    const ReadRequest& last = requests.back();
+    std::vector<u8> buffer(last.dvd_offset + last.length - first.dvd_offset);
+    if (s_disc->Read(first.dvd_offset, buffer.size(), buffer.data(), first.partition))
+    {
+      for (size_t i = 0; i < requests.size(); ++i)
+      {
+        const u8* data = buffer.data() + (requests[i].dvd_offset - first.dvd_offset);
+        buffers[i].assign(data, data + requests[i].length);
+      }
+      return buffers;
+    }
+
+    // Read the requests one by one instead, so that only the ones which actually
+    // can't be read get reported as errors
+  }
+
+  for (size_t i = 0; i < requests.size(); ++i)
+  {
+    const ReadRequest& request = requests[i];
+    buffers[i].resize(request.length);
+    if (!s_disc->Read(request.dvd_offset, request.length, buffers[i].data(), request.partition))
+      buffers[i].resize(0);
+  }
+  return buffers;
+}
+
 static void DVDThread()
 {
   Common::SetCurrentThreadName("DVD thread");
 
+  std::vector<ReadRequest> requests;
   while (true)
   {
     s_request_queue_expanded.Wait();
@@ -372,19 +499,30 @@ static void DVDThread()
     if (s_dvd_thread_exiting.IsSet())
       return;
 
-    ReadRequest request;
-    while (s_request_queue.Pop(request))
+    while (PopAdjacentRequests(&requests))
     {
-      FileMonitor::Log(*s_disc, request.partition, request.dvd_offset);
-
-      std::vector<u8> buffer(request.length);
-      if (!s_disc->Read(request.dvd_offset, request.length, buffer.data(), request.partition))
-        buffer.resize(0);
-
-      request.realtime_done_us = Common::Timer::GetTimeUs();
-
-      s_result_queue.Push(ReadResult(std::move(request), std::move(buffer)));
-      s_result_queue_expanded.Set();
+      for (const ReadRequest& request : requests)
+        FileMonitor::Log(*s_disc, request.partition, request.dvd_offset);
+
+      std::vector<std::vector<u8>> buffers = ReadRequests(requests);
+
+      const u64 realtime_done_us = Common::Timer::GetTimeUs();
+      for (ReadRequest& request : requests)
+      {
+        request.realtime_done_us = realtime_done_us;
+        if (s_read_trace_enabled)
+          RecordRead(request);
+      }
+
+      {
+        std::lock_guard lock(s_result_mutex);
+        for (size_t i = 0; i < requests.size(); ++i)
+        {
+          const u64 id = requests[i].id;
+          s_result_map.emplace(id, ReadResult(std::move(requests[i]), std::move(buffers[i])));
+        }
+      }
+      s_result_map_expanded.notify_one();
 
       if (s_dvd_thread_exiting.IsSet())
         return;
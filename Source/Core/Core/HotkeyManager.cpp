@@ -23,7 +23,7 @@
 #include "InputCommon/GCPadStatus.h"
 
 // clang-format off
-constexpr std::array<const char*, 126> s_hotkey_labels{{
+constexpr std::array<const char*, 128> s_hotkey_labels{{
     _trans("Open"),
     _trans("Change Disc"),
     _trans("Eject Disc"),
@@ -37,6 +37,7 @@ constexpr std::array<const char*, 126> s_hotkey_labels{{
     _trans("Unlock Cursor"),
     _trans("Activate NetPlay Chat"),
     _trans("Control NetPlay Golf Mode"),
+    _trans("Toggle Trace Recording"),
 
     _trans("Volume Down"),
     _trans("Volume Up"),
@@ -176,6 +177,7 @@ constexpr std::array<const char*, 126> s_hotkey_labels{{
     _trans("Save Oldest State"),
     _trans("Undo Load State"),
     _trans("Undo Save State"),
+    _trans("Rewind"),
     _trans("Save State"),
     _trans("Load State"),
 }};
@@ -310,7 +312,7 @@ struct HotkeyGroupInfo
 };
 
 constexpr std::array<HotkeyGroupInfo, NUM_HOTKEY_GROUPS> s_groups_info = {
-    {{_trans("General"), HK_OPEN, HK_REQUEST_GOLF_CONTROL},
+    {{_trans("General"), HK_OPEN, HK_TOGGLE_TRACING},
      {_trans("Volume"), HK_VOLUME_DOWN, HK_VOLUME_TOGGLE_MUTE},
      {_trans("Emulation Speed"), HK_DECREASE_EMULATION_SPEED, HK_TOGGLE_THROTTLE},
      {_trans("Frame Advance"), HK_FRAME_ADVANCE, HK_FRAME_ADVANCE_RESET_SPEED},
@@ -31,6 +31,7 @@ enum Hotkey
   HK_UNLOCK_CURSOR,
   HK_ACTIVATE_CHAT,
   HK_REQUEST_GOLF_CONTROL,
+  HK_TOGGLE_TRACING,
 
   HK_VOLUME_DOWN,
   HK_VOLUME_UP,
@@ -161,6 +162,7 @@ enum Hotkey
   HK_SAVE_FIRST_STATE,
   HK_UNDO_LOAD_STATE,
   HK_UNDO_SAVE_STATE,
+  HK_REWIND,
   HK_SAVE_STATE_FILE,
   HK_LOAD_STATE_FILE,
 
@@ -3,6 +3,7 @@
 
 #include "Core/PowerPC/Jit64/Jit.h"
 
+#include <algorithm>
 #include <map>
 #include <sstream>
 #include <string>
@@ -16,6 +17,7 @@
 #endif
 
 #include "Common/CommonTypes.h"
+#include "Common/Config/Config.h"
 #include "Common/GekkoDisassembler.h"
 #include "Common/IOFile.h"
 #include "Common/Logging/Log.h"
@@ -24,6 +26,7 @@
 #include "Common/StringUtil.h"
 #include "Common/Swap.h"
 #include "Common/x64ABI.h"
+#include "Core/Config/MainSettings.h"
 #include "Core/Core.h"
 #include "Core/CoreTiming.h"
 #include "Core/HLE/HLE.h"
@@ -359,6 +362,15 @@ void Jit64::Init()
                               !SConfig::GetInstance().bEnableDebugging;
   m_cleanup_after_stackfault = false;
 
+  m_enable_tiered_compilation = Config::Get(Config::MAIN_JIT_TIERED_COMPILATION) &&
+                                !SConfig::GetInstance().bEnableDebugging;
+  if (m_enable_tiered_compilation)
+  {
+    const std::string profile_cache_filename = JitProfileCache::GetFileNameForRunningGame();
+    if (!profile_cache_filename.empty())
+      m_profile_cache.Open(profile_cache_filename);
+  }
+
   m_stack = nullptr;
   if (m_enable_blr_optimization)
     AllocStack();
@@ -412,6 +424,7 @@ void Jit64::Shutdown()
   blocks.Shutdown();
   m_far_code.Shutdown();
   m_const_pool.Shutdown();
+  m_profile_cache.Close();
 }
 
 void Jit64::FallBackToInterpreter(UGeckoInstruction inst)
@@ -803,10 +816,45 @@ void Jit64::Jit(u32 em_address, bool clear_cache_and_retry_on_failure)
     }
   }
 
+  bool hot = false;
+  const JitProfileCache::BlockProfile* profile = nullptr;
+  if (m_enable_tiered_compilation)
+  {
+    hot = js.hotBlockAddresses.count(em_address) != 0;
+    if (!hot)
+    {
+      // Blocks which were hot the last time this game ran skip the cold tier
+      profile = m_profile_cache.Find(em_address, MSR.Hex & JitBaseBlockCache::JIT_CACHE_MSR_MASK);
+      hot = profile != nullptr;
+    }
+    SetCompilationTier(hot, &block_size);
+  }
+
   // Analyze the block, collect all instructions it is made of (including inlining,
   // if that is enabled), reorder instructions for optimal performance, and join joinable
   // instructions.
-  const u32 nextPC = analyzer.Analyze(em_address, &code_block, &m_code_buffer, block_size);
+  u32 nextPC = analyzer.Analyze(em_address, &code_block, &m_code_buffer, block_size);
+
+  JitProfileCache::BlockProfile new_profile{};
+  if (hot && !code_block.m_memory_exception)
+  {
+    new_profile =
+        JitProfileCache::CreateProfile(code_block, m_code_buffer, HOT_BRANCH_FOLLOWING_THRESHOLD);
+    if (!profile || new_profile == *profile)
+    {
+      js.hotBlockAddresses.insert(em_address);
+    }
+    else
+    {
+      // The code has changed since the profile was stored, so start over with the cold tier.
+      // The profile is dropped so that the next compile doesn't analyze the block twice again.
+      m_profile_cache.Remove(em_address, MSR.Hex & JitBaseBlockCache::JIT_CACHE_MSR_MASK);
+      profile = nullptr;
+      hot = false;
+      SetCompilationTier(false, &block_size);
+      nextPC = analyzer.Analyze(em_address, &code_block, &m_code_buffer, block_size);
+    }
+  }
 
   if (code_block.m_memory_exception)
   {
@@ -844,6 +892,9 @@ void Jit64::Jit(u32 em_address, bool clear_cache_and_retry_on_failure)
       b->far_end = far_end;
 
       blocks.FinalizeBlock(*b, jo.enableBlocklink, code_block.m_physical_addresses);
+
+      if (hot)
+        m_profile_cache.Store(em_address, b->msrBits, new_profile);
       return;
     }
   }
@@ -864,6 +915,16 @@ void Jit64::Jit(u32 em_address, bool clear_cache_and_retry_on_failure)
   std::exit(-1);
 }
 
+void Jit64::SetCompilationTier(bool hot, std::size_t* block_size)
+{
+  // Cold blocks don't follow branches and end early, which keeps them small and quick to compile.
+  analyzer.SetBranchFollowingThreshold(hot ? HOT_BRANCH_FOLLOWING_THRESHOLD :
+                                             COLD_BRANCH_FOLLOWING_THRESHOLD);
+  js.registerLookahead = hot ? HOT_REGISTER_LOOKAHEAD : COLD_REGISTER_LOOKAHEAD;
+  if (!hot)
+    *block_size = std::min(*block_size, COLD_BLOCK_SIZE);
+}
+
 bool Jit64::SetEmitterStateToFreeCodeRegion()
 {
   // Find the largest free memory blocks and set code emitters to point at them.
@@ -921,6 +982,24 @@ bool Jit64::DoJit(u32 em_address, JitBlock* b, u32 nextPC)
     ADD(64, MDisp(ABI_PARAM1, offset), Imm8(1));
     ABI_CallFunction(QueryPerformanceCounter);
   }
+
+  // Count the executions of cold blocks, and recompile them once they turn out to be hot.
+  if (m_enable_tiered_compilation && js.hotBlockAddresses.count(em_address) == 0)
+  {
+    b->tier_up_countdown = HOT_BLOCK_THRESHOLD;
+    MOV(64, R(RSCRATCH), ImmPtr(&b->tier_up_countdown));
+    SUB(32, MatR(RSCRATCH), Imm8(1));
+    FixupBranch hot = J_CC(CC_Z, true);
+
+    SwitchToFarCode();
+    SetJumpTarget(hot);
+    MOV(32, PPCSTATE(pc), Imm32(em_address));
+    ABI_PushRegistersAndAdjustStack({}, 0);
+    ABI_CallFunction(JitInterface::CompileHotBlock);
+    ABI_PopRegistersAndAdjustStack({}, 0);
+    JMP(asm_routines.dispatcher_no_check, true);
+    SwitchToNearCode();
+  }
 #if defined(_DEBUG) || defined(DEBUGFAST) || defined(NAN_CHECK)
   // should help logged stack-traces become more accurate
   MOV(32, PPCSTATE(pc), Imm32(js.blockStart));
@@ -31,6 +31,7 @@
 #include "Core/PowerPC/Jit64Common/TrampolineCache.h"
 #include "Core/PowerPC/JitCommon/JitBase.h"
 #include "Core/PowerPC/JitCommon/JitCache.h"
+#include "Core/PowerPC/JitCommon/JitProfileCache.h"
 
 namespace PPCAnalyst
 {
@@ -60,6 +61,9 @@ public:
   void Jit(u32 em_address, bool clear_cache_and_retry_on_failure);
   bool DoJit(u32 em_address, JitBlock* b, u32 nextPC);
 
+  // Sets up the analyzer and register caches for compiling a cold or hot block.
+  void SetCompilationTier(bool hot, std::size_t* block_size);
+
   // Finds a free memory region and sets the near and far code emitters to point at that region.
   // Returns false if no free memory region can be found for either of the two.
   bool SetEmitterStateToFreeCodeRegion();
@@ -265,6 +269,18 @@ private:
 
   Jit64AsmRoutineManager asm_routines{*this};
 
+  // With tiered compilation, blocks are first compiled with fewer optimizations, and blocks
+  // which are executed HOT_BLOCK_THRESHOLD times get recompiled with more optimizations.
+  static constexpr u32 HOT_BLOCK_THRESHOLD = 4096;
+  // Hot blocks may use the whole code buffer
+  static constexpr std::size_t COLD_BLOCK_SIZE = 64;
+  static constexpr u32 COLD_BRANCH_FOLLOWING_THRESHOLD = 0;
+  static constexpr u32 HOT_BRANCH_FOLLOWING_THRESHOLD = 4;
+  static constexpr int COLD_REGISTER_LOOKAHEAD = 64;
+  static constexpr int HOT_REGISTER_LOOKAHEAD = 256;
+  bool m_enable_tiered_compilation;
+  JitProfileCache m_profile_cache;
+
   bool m_enable_blr_optimization;
   bool m_cleanup_after_stackfault;
   u8* m_stack;
@@ -102,9 +102,14 @@ protected:
 
     JitBlock* curBlock;
 
+    // How many instructions ahead the register caches look when choosing a register to spill
+    int registerLookahead = 64;
+
     std::unordered_set<u32> fifoWriteAddresses;
     std::unordered_set<u32> pairedQuantizeAddresses;
     std::unordered_set<u32> noSpeculativeConstantsAddresses;
+    // Blocks which have been executed often enough to be recompiled with more optimizations
+    std::unordered_set<u32> hotBlockAddresses;
   };
 
   PPCAnalyst::CodeBlock code_block;
@@ -12,7 +12,6 @@
 #include <array>
 #include <cstring>
 #include <functional>
-#include <map>
 #include <set>
 #include <utility>
 
@@ -33,8 +32,9 @@ using namespace Gen;
 
 bool JitBlock::OverlapsPhysicalRange(u32 address, u32 length) const
 {
-  return physical_addresses.lower_bound(address) !=
-         physical_addresses.lower_bound(address + length);
+  const auto begin =
+      std::lower_bound(physical_addresses.begin(), physical_addresses.end(), address);
+  return begin != physical_addresses.end() && u64(*begin) < u64(address) + length;
 }
 
 JitBaseBlockCache::JitBaseBlockCache(JitBase& jit) : m_jit{jit}
@@ -64,14 +64,23 @@ void JitBaseBlockCache::Clear()
 #endif
   m_jit.js.fifoWriteAddresses.clear();
   m_jit.js.pairedQuantizeAddresses.clear();
+  m_jit.js.hotBlockAddresses.clear();
   for (auto& e : block_map)
   {
-    DestroyBlock(e.second);
+    for (JitBlock* block = e.second; block; block = block->next_at_address)
+      DestroyBlock(*block);
   }
   block_map.clear();
   links_to.clear();
   block_range_map.clear();
 
+  m_free_blocks.clear();
+  for (auto& slab : m_block_slabs)
+  {
+    for (size_t i = 0; i < BLOCK_SLAB_SIZE; ++i)
+      m_free_blocks.push_back(&slab[i]);
+  }
+
   valid_block.ClearAll();
 
   fast_block_map.fill(nullptr);
@@ -91,21 +100,145 @@ JitBlock** JitBaseBlockCache::GetFastBlockMap()
 void JitBaseBlockCache::RunOnBlocks(std::function<void(const JitBlock&)> f)
 {
   for (const auto& e : block_map)
-    f(e.second);
+  {
+    for (const JitBlock* block = e.second; block; block = block->next_at_address)
+      f(*block);
+  }
 }
 
 JitBlock* JitBaseBlockCache::AllocateBlock(u32 em_address)
 {
+  if (m_free_blocks.empty())
+  {
+    auto& slab = m_block_slabs.emplace_back(std::make_unique<JitBlock[]>(BLOCK_SLAB_SIZE));
+    for (size_t i = BLOCK_SLAB_SIZE; i-- > 0;)
+      m_free_blocks.push_back(&slab[i]);
+  }
+
+  JitBlock& b = *m_free_blocks.back();
+  m_free_blocks.pop_back();
+
+  // Reset the block, but keep the memory allocated by its vectors for reuse
+  static_cast<JitBlockData&>(b) = {};
+  b.linkData.clear();
+  b.physical_addresses.clear();
+  b.profile_data = {};
+  b.tier_up_countdown = 0;
+
   u32 physicalAddress = PowerPC::JitCache_TranslateAddress(em_address).address;
-  JitBlock& b = block_map.emplace(physicalAddress, JitBlock())->second;
   b.effectiveAddress = em_address;
   b.physicalAddress = physicalAddress;
   b.msrBits = MSR.Hex & JIT_CACHE_MSR_MASK;
-  b.linkData.clear();
   b.fast_block_map_index = 0;
+
+  JitBlock*& first = block_map[physicalAddress];
+  b.next_at_address = first;
+  first = &b;
+
   return &b;
 }
 
+void JitBaseBlockCache::FreeBlock(JitBlock& block)
+{
+  RemoveFromBlockMap(block);
+  m_free_blocks.push_back(&block);
+}
+
+void JitBaseBlockCache::RemoveFromBlockMap(JitBlock& block)
+{
+  const auto it = block_map.find(block.physicalAddress);
+  if (it == block_map.end())
+    return;
+
+  for (JitBlock** b = &it->second; *b; b = &(*b)->next_at_address)
+  {
+    if (*b == &block)
+    {
+      *b = block.next_at_address;
+      break;
+    }
+  }
+  block.next_at_address = nullptr;
+
+  if (!it->second)
+    block_map.erase(it);
+}
+
+void JitBaseBlockCache::AddLinksTo(JitBlock& block)
+{
+  for (auto& e : block.linkData)
+  {
+    JitBlock::LinkData*& first = links_to[e.exitAddress];
+    e.source = &block;
+    e.prev_to_address = nullptr;
+    e.next_to_address = first;
+    if (first)
+      first->prev_to_address = &e;
+    first = &e;
+  }
+}
+
+void JitBaseBlockCache::RemoveLinksTo(JitBlock& block)
+{
+  for (auto& e : block.linkData)
+  {
+    if (e.prev_to_address)
+    {
+      e.prev_to_address->next_to_address = e.next_to_address;
+    }
+    else
+    {
+      // Only the first entry of each list has no previous entry, but this exit might also not
+      // be in any list if the block was never finalized or block linking is disabled.
+      const auto it = links_to.find(e.exitAddress);
+      if (it == links_to.end() || it->second != &e)
+        continue;
+
+      if (e.next_to_address)
+        it->second = e.next_to_address;
+      else
+        links_to.erase(it);
+    }
+
+    if (e.next_to_address)
+      e.next_to_address->prev_to_address = e.prev_to_address;
+
+    e.prev_to_address = nullptr;
+    e.next_to_address = nullptr;
+  }
+}
+
+void JitBaseBlockCache::RemoveFromBlockRangeMap(JitBlock& block, u32 current_range)
+{
+  const u32 range_mask = ~(BLOCK_RANGE_MAP_ELEMENTS - 1);
+  u32 previous_range = 0;
+  bool first = true;
+  for (u32 addr : block.physical_addresses)
+  {
+    const u32 range = addr & range_mask;
+    if (!first && range == previous_range)
+      continue;
+    first = false;
+    previous_range = range;
+
+    const auto it = block_range_map.find(range);
+    if (it == block_range_map.end())
+      continue;
+
+    std::vector<JitBlock*>& blocks = it->second;
+    const auto block_it = std::find(blocks.begin(), blocks.end(), &block);
+    if (block_it != blocks.end())
+    {
+      *block_it = blocks.back();
+      blocks.pop_back();
+    }
+
+    // The caller drops the macro block it is iterating over itself once it's done with it
+    if (blocks.empty() && range != current_range)
+      block_range_map.erase(it);
+  }
+}
+
 void JitBaseBlockCache::FinalizeBlock(JitBlock& block, bool block_link,
                                       const std::set<u32>& physical_addresses)
 {
@@ -113,22 +246,28 @@ void JitBaseBlockCache::FinalizeBlock(JitBlock& block, bool block_link,
   fast_block_map[index] = &block;
   block.fast_block_map_index = index;
 
-  block.physical_addresses = physical_addresses;
+  block.physical_addresses.assign(physical_addresses.begin(), physical_addresses.end());
 
-  u32 range_mask = ~(BLOCK_RANGE_MAP_ELEMENTS - 1);
+  const u32 range_mask = ~(BLOCK_RANGE_MAP_ELEMENTS - 1);
+  std::vector<JitBlock*>* range_blocks = nullptr;
+  u32 previous_range = 0;
   for (u32 addr : physical_addresses)
   {
     valid_block.Set(addr / 32);
-    block_range_map[addr & range_mask].insert(&block);
-  }
 
-  if (block_link)
-  {
-    for (const auto& e : block.linkData)
+    // The addresses are sorted, so each macro block only needs to be looked up once
+    const u32 range = addr & range_mask;
+    if (!range_blocks || range != previous_range)
     {
-      links_to[e.exitAddress].insert(&block);
+      range_blocks = &block_range_map[range];
+      range_blocks->push_back(&block);
+      previous_range = range;
     }
+  }
 
+  if (block_link)
+  {
+    AddLinksTo(block);
     LinkBlock(block);
   }
 
@@ -159,12 +298,14 @@ JitBlock* JitBaseBlockCache::GetBlockFromStartAddress(u32 addr, u32 msr)
     translated_addr = translated.address;
   }
 
-  auto iter = block_map.equal_range(translated_addr);
-  for (; iter.first != iter.second; iter.first++)
+  const auto iter = block_map.find(translated_addr);
+  if (iter == block_map.end())
+    return nullptr;
+
+  for (JitBlock* b = iter->second; b; b = b->next_at_address)
   {
-    JitBlock& b = iter.first->second;
-    if (b.effectiveAddress == addr && b.msrBits == (msr & JIT_CACHE_MSR_MASK))
-      return &b;
+    if (b->effectiveAddress == addr && b->msrBits == (msr & JIT_CACHE_MSR_MASK))
+      return b;
   }
 
   return nullptr;
@@ -215,6 +356,7 @@ void JitBaseBlockCache::InvalidateICache(u32 address, u32 length, bool forced)
       {
         m_jit.js.fifoWriteAddresses.erase(i);
         m_jit.js.pairedQuantizeAddresses.erase(i);
+        m_jit.js.hotBlockAddresses.erase(i);
       }
     }
   }
@@ -222,50 +364,60 @@ void JitBaseBlockCache::InvalidateICache(u32 address, u32 length, bool forced)
 
 void JitBaseBlockCache::ErasePhysicalRange(u32 address, u32 length)
 {
-  // Iterate over all macro blocks which overlap the given range.
-  u32 range_mask = ~(BLOCK_RANGE_MAP_ELEMENTS - 1);
-  auto start = block_range_map.lower_bound(address & range_mask);
-  auto end = block_range_map.lower_bound(address + length);
-  while (start != end)
+  // Find all macro blocks which overlap the given range. Large ranges are usually sparse,
+  // so walk whichever of the range and the map has fewer entries.
+  const u32 range_mask = ~(BLOCK_RANGE_MAP_ELEMENTS - 1);
+  const u64 range_begin = address & range_mask;
+  const u64 range_end = u64(address) + length;
+  m_erase_ranges.clear();
+  if ((range_end - range_begin) / BLOCK_RANGE_MAP_ELEMENTS <= block_range_map.size())
   {
+    for (u64 range = range_begin; range < range_end; range += BLOCK_RANGE_MAP_ELEMENTS)
+    {
+      if (block_range_map.count(static_cast<u32>(range)))
+        m_erase_ranges.push_back(static_cast<u32>(range));
+    }
+  }
+  else
+  {
+    for (const auto& e : block_range_map)
+    {
+      if (e.first >= range_begin && e.first < range_end)
+        m_erase_ranges.push_back(e.first);
+    }
+  }
+
+  for (u32 range : m_erase_ranges)
+  {
+    const auto it = block_range_map.find(range);
+    if (it == block_range_map.end())
+      continue;
+
     // Iterate over all blocks in the macro block.
-    auto iter = start->second.begin();
-    while (iter != start->second.end())
+    std::vector<JitBlock*>& blocks = it->second;
+    size_t i = 0;
+    while (i < blocks.size())
     {
-      JitBlock* block = *iter;
+      JitBlock* block = blocks[i];
       if (block->OverlapsPhysicalRange(address, length))
       {
-        // If the block overlaps, also remove all other occupied slots in the other macro blocks.
-        // This will leak empty macro blocks, but they may be reused or cleared later on.
-        for (u32 addr : block->physical_addresses)
-          if ((addr & range_mask) != start->first)
-            block_range_map[addr & range_mask].erase(block);
+        // Remove the block from all macro blocks, including this one. This moves another block
+        // into slot i, so i is not advanced.
+        RemoveFromBlockRangeMap(*block, range);
 
         // And remove the block.
         DestroyBlock(*block);
-        auto block_map_iter = block_map.equal_range(block->physicalAddress);
-        while (block_map_iter.first != block_map_iter.second)
-        {
-          if (&block_map_iter.first->second == block)
-          {
-            block_map.erase(block_map_iter.first);
-            break;
-          }
-          block_map_iter.first++;
-        }
-        iter = start->second.erase(iter);
+        FreeBlock(*block);
       }
       else
       {
-        iter++;
+        i++;
       }
     }
 
     // If the macro block is empty, drop it.
-    if (start->second.empty())
-      start = block_range_map.erase(start);
-    else
-      start++;
+    if (blocks.empty())
+      block_range_map.erase(it);
   }
 }
 
@@ -302,10 +454,17 @@ void JitBaseBlockCache::LinkBlock(JitBlock& block)
   if (it == links_to.end())
     return;
 
-  for (JitBlock* b2 : it->second)
+  for (JitBlock::LinkData* e = it->second; e; e = e->next_to_address)
   {
-    if (block.msrBits == b2->msrBits)
-      LinkBlockExits(*b2);
+    if (e->linkStatus || block.msrBits != e->source->msrBits)
+      continue;
+
+    JitBlock* destinationBlock = GetBlockFromStartAddress(e->exitAddress, e->source->msrBits);
+    if (destinationBlock)
+    {
+      WriteLinkBlock(*e, destinationBlock);
+      e->linkStatus = true;
+    }
   }
 }
 
@@ -321,19 +480,13 @@ void JitBaseBlockCache::UnlinkBlock(const JitBlock& block)
   const auto it = links_to.find(block.effectiveAddress);
   if (it == links_to.end())
     return;
-  for (JitBlock* sourceBlock : it->second)
+  for (JitBlock::LinkData* e = it->second; e; e = e->next_to_address)
   {
-    if (sourceBlock->msrBits != block.msrBits)
+    if (e->source->msrBits != block.msrBits)
       continue;
 
-    for (auto& e : sourceBlock->linkData)
-    {
-      if (e.exitAddress == block.effectiveAddress)
-      {
-        WriteLinkBlock(e, nullptr);
-        e.linkStatus = false;
-      }
-    }
+    WriteLinkBlock(*e, nullptr);
+    e->linkStatus = false;
   }
 }
 
@@ -345,15 +498,7 @@ void JitBaseBlockCache::DestroyBlock(JitBlock& block)
   UnlinkBlock(block);
 
   // Delete linking addresses
-  for (const auto& e : block.linkData)
-  {
-    auto it = links_to.find(e.exitAddress);
-    if (it == links_to.end())
-      continue;
-    it->second.erase(&block);
-    if (it->second.empty())
-      links_to.erase(it);
-  }
+  RemoveLinksTo(block);
 
   // Raise an signal if we are going to call this block again
   WriteDestroyBlock(block);
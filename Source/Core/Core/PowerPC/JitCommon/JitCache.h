@@ -7,12 +7,10 @@
 #include <bitset>
 #include <cstring>
 #include <functional>
-#include <map>
 #include <memory>
 #include <set>
 #include <type_traits>
 #include <unordered_map>
-#include <unordered_set>
 #include <vector>
 
 #include "Common/CommonTypes.h"
@@ -75,11 +73,20 @@ struct JitBlock : public JitBlockData
     u32 exitAddress;
     bool linkStatus;  // is it already linked?
     bool call;
+
+    // Intrusive list of all exits of finalized blocks which jump to the same exitAddress.
+    // This is managed by JitBaseBlockCache and only valid between FinalizeBlock and DestroyBlock.
+    JitBlock* source = nullptr;
+    LinkData* prev_to_address = nullptr;
+    LinkData* next_to_address = nullptr;
   };
   std::vector<LinkData> linkData;
 
-  // This set stores all physical addresses of all occupied instructions.
-  std::set<u32> physical_addresses;
+  // This sorted vector stores all physical addresses of all occupied instructions.
+  std::vector<u32> physical_addresses;
+
+  // Intrusive list of all blocks with the same physical start address, see block_map.
+  JitBlock* next_at_address = nullptr;
 
   // Block profiling data, structure is inlined in Jit.cpp
   struct ProfileData
@@ -90,6 +97,10 @@ struct JitBlock : public JitBlockData
     u64 ticStart;
     u64 ticStop;
   } profile_data = {};
+
+  // The number of executions left before this block gets recompiled as a hot block.
+  // Only used by JITs which support tiered compilation.
+  u32 tier_up_countdown = 0;
 };
 
 typedef void (*CompiledCode)();
@@ -181,19 +192,35 @@ private:
   // Fast but risky block lookup based on fast_block_map.
   size_t FastLookupIndexForAddress(u32 address);
 
+  void AddLinksTo(JitBlock& block);
+  void RemoveLinksTo(JitBlock& block);
+  // Macro blocks that become empty are dropped, except for current_range.
+  void RemoveFromBlockRangeMap(JitBlock& block, u32 current_range);
+  void RemoveFromBlockMap(JitBlock& block);
+  void FreeBlock(JitBlock& block);
+
   // links_to hold all exit points of all valid blocks in a reverse way.
   // It is used to query all blocks which links to an address.
-  std::unordered_map<u32, std::unordered_set<JitBlock*>> links_to;  // destination_PC -> number
+  std::unordered_map<u32, JitBlock::LinkData*> links_to;  // destination_PC -> first exit
 
   // Map indexed by the physical address of the entry point.
   // This is used to query the block based on the current PC in a slow way.
-  std::multimap<u32, JitBlock> block_map;  // start_addr -> block
+  std::unordered_map<u32, JitBlock*> block_map;  // start_addr -> first block
 
   // Range of overlapping code indexed by a masked physical address.
   // This is used for invalidation of memory regions. The range is grouped
   // in macro blocks of each 0x100 bytes.
   static constexpr u32 BLOCK_RANGE_MAP_ELEMENTS = 0x100;
-  std::map<u32, std::unordered_set<JitBlock*>> block_range_map;
+  std::unordered_map<u32, std::vector<JitBlock*>> block_range_map;
+
+  // Blocks are allocated in slabs, so that their addresses stay the same for as long as they
+  // exist, and destroyed blocks are kept in a free list for reuse.
+  static constexpr size_t BLOCK_SLAB_SIZE = 0x400;
+  std::vector<std::unique_ptr<JitBlock[]>> m_block_slabs;
+  std::vector<JitBlock*> m_free_blocks;
+
+  // Scratch space for ErasePhysicalRange
+  std::vector<u32> m_erase_ranges;
 
   // This bitsets shows which cachelines overlap with any blocks.
   // It is used to provide a fast way to query if no icache invalidation is needed.
@@ -0,0 +1,128 @@
+// Copyright 2021 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "Core/PowerPC/JitCommon/JitProfileCache.h"
+
+#include <xxhash.h>
+
+#include "Common/CommonPaths.h"
+#include "Common/FileUtil.h"
+#include "Common/Logging/Log.h"
+#include "Core/ConfigManager.h"
+
+class JitProfileCache::Reader final : public LinearDiskCacheReader<DiskKey, BlockProfile>
+{
+public:
+  explicit Reader(JitProfileCache& cache) : m_cache(cache) {}
+
+  void Read(const DiskKey& key, const BlockProfile* value, u32 value_size) override
+  {
+    // Profiles which are stored later replace the ones stored earlier, and empty entries remove
+    // them
+    if (value_size == 0)
+      m_cache.m_profiles.erase(MakeKey(key.address, key.msr_bits));
+    else if (value_size == 1)
+      m_cache.m_profiles[MakeKey(key.address, key.msr_bits)] = *value;
+  }
+
+private:
+  JitProfileCache& m_cache;
+};
+
+JitProfileCache::~JitProfileCache()
+{
+  Close();
+}
+
+void JitProfileCache::Open(const std::string& filename)
+{
+  Close();
+
+  Reader reader(*this);
+  m_disk_cache.OpenAndRead(filename, reader);
+  m_is_open = true;
+
+  INFO_LOG_FMT(DYNA_REC, "Loaded {} block profiles from {}", m_profiles.size(), filename);
+}
+
+void JitProfileCache::Close()
+{
+  if (!m_is_open)
+    return;
+
+  m_disk_cache.Sync();
+  m_disk_cache.Close();
+  m_profiles.clear();
+  m_is_open = false;
+}
+
+const JitProfileCache::BlockProfile* JitProfileCache::Find(u32 address, u32 msr_bits) const
+{
+  const auto it = m_profiles.find(MakeKey(address, msr_bits));
+  return it != m_profiles.end() ? &it->second : nullptr;
+}
+
+void JitProfileCache::Store(u32 address, u32 msr_bits, const BlockProfile& profile)
+{
+  const auto [it, inserted] = m_profiles.try_emplace(MakeKey(address, msr_bits), profile);
+  if (!inserted)
+  {
+    if (it->second == profile)
+      return;
+    it->second = profile;
+  }
+
+  if (m_is_open)
+    m_disk_cache.Append({address, msr_bits}, &profile, 1);
+}
+
+void JitProfileCache::Remove(u32 address, u32 msr_bits)
+{
+  const auto it = m_profiles.find(MakeKey(address, msr_bits));
+  if (it == m_profiles.end())
+    return;
+
+  if (m_is_open)
+    m_disk_cache.Append({address, msr_bits}, &it->second, 0);
+  m_profiles.erase(it);
+}
+
+JitProfileCache::BlockProfile JitProfileCache::CreateProfile(const PPCAnalyst::CodeBlock& block,
+                                                             const PPCAnalyst::CodeBuffer& buffer,
+                                                             u32 branch_following_threshold)
+{
+  u64 hash = 0;
+  for (u32 i = 0; i < block.m_num_instructions; ++i)
+  {
+    const u32 op[2] = {buffer[i].address, buffer[i].inst.hex};
+    hash = XXH64(op, sizeof(op), hash);
+  }
+
+  BlockProfile profile{};
+  profile.code_hash = hash;
+  profile.num_instructions = block.m_num_instructions;
+  profile.branch_following_threshold = branch_following_threshold;
+  profile.gpr_inputs = block.m_gpr_inputs.m_val;
+  return profile;
+}
+
+std::string JitProfileCache::GetFileNameForRunningGame()
+{
+  const std::string& game_id = SConfig::GetInstance().GetGameID();
+  if (game_id.empty())
+    return {};
+
+  return File::GetUserPath(D_CACHE_IDX) + game_id + ".jitprofile";
+}
+
+bool operator==(const JitProfileCache::BlockProfile& a, const JitProfileCache::BlockProfile& b)
+{
+  return a.code_hash == b.code_hash && a.num_instructions == b.num_instructions &&
+         a.branch_following_threshold == b.branch_following_threshold &&
+         a.gpr_inputs == b.gpr_inputs;
+}
+
+bool operator!=(const JitProfileCache::BlockProfile& a, const JitProfileCache::BlockProfile& b)
+{
+  return !(a == b);
+}
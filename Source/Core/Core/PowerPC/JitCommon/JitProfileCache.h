@@ -0,0 +1,72 @@
+// Copyright 2021 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <string>
+#include <unordered_map>
+
+#include "Common/CommonTypes.h"
+#include "Common/LinearDiskCache.h"
+#include "Core/PowerPC/PPCAnalyst.h"
+
+// Remembers the blocks of a game which turned out to be hot, along with a summary of how they were
+// analyzed, so that JITs with tiered compilation can compile them with the hot tier right away the
+// next time the game runs.
+class JitProfileCache
+{
+public:
+  struct BlockProfile
+  {
+    // Hash of the addresses and instructions of the analyzed block
+    u64 code_hash;
+    u32 num_instructions;
+    u32 branch_following_threshold;
+    // Which registers the block reads before defining them
+    u32 gpr_inputs;
+    u32 reserved;
+  };
+
+  JitProfileCache() = default;
+  ~JitProfileCache();
+
+  JitProfileCache(const JitProfileCache&) = delete;
+  JitProfileCache& operator=(const JitProfileCache&) = delete;
+
+  // Loads the profiles stored in filename. New profiles are appended to the same file.
+  void Open(const std::string& filename);
+  void Close();
+  bool IsOpen() const { return m_is_open; }
+
+  const BlockProfile* Find(u32 address, u32 msr_bits) const;
+  void Store(u32 address, u32 msr_bits, const BlockProfile& profile);
+  // Forgets a profile which no longer matches the code at its address, also in the file.
+  void Remove(u32 address, u32 msr_bits);
+
+  size_t GetProfileCount() const { return m_profiles.size(); }
+
+  static BlockProfile CreateProfile(const PPCAnalyst::CodeBlock& block,
+                                    const PPCAnalyst::CodeBuffer& buffer,
+                                    u32 branch_following_threshold);
+
+  // Returns the file used for the profiles of the game which is currently running.
+  static std::string GetFileNameForRunningGame();
+
+private:
+  struct DiskKey
+  {
+    u32 address;
+    u32 msr_bits;
+  };
+
+  class Reader;
+
+  static u64 MakeKey(u32 address, u32 msr_bits) { return u64(msr_bits) << 32 | address; }
+
+  std::unordered_map<u64, BlockProfile> m_profiles;
+  LinearDiskCache<DiskKey, BlockProfile> m_disk_cache;
+  bool m_is_open = false;
+};
+
+bool operator==(const JitProfileCache::BlockProfile& a, const JitProfileCache::BlockProfile& b);
+bool operator!=(const JitProfileCache::BlockProfile& a, const JitProfileCache::BlockProfile& b);
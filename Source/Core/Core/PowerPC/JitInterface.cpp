@@ -261,6 +261,15 @@ void CompileExceptionCheck(ExceptionType type)
   }
 }
 
+void CompileHotBlock()
+{
+  if (!g_jit)
+    return;
+
+  if (g_jit->js.hotBlockAddresses.insert(PC).second)
+    g_jit->GetBlockCache()->InvalidateICache(PC, 4, true);
+}
+
 void Shutdown()
 {
   if (g_jit)
@@ -65,6 +65,9 @@ void InvalidateICache(u32 address, u32 size, bool forced);
 
 void CompileExceptionCheck(ExceptionType type);
 
+// Recompiles the block at PC with the optimizations used for frequently executed code.
+void CompileHotBlock();
+
 /// used for the page fault unit test, don't use outside of tests!
 void SetJit(JitBase* jit);
 
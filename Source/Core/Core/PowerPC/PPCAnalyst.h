@@ -214,6 +214,10 @@ public:
   void SetOption(AnalystOption option) { m_options |= option; }
   void ClearOption(AnalystOption option) { m_options &= ~(option); }
   bool HasOption(AnalystOption option) const { return !!(m_options & option); }
+
+  // The maximum number of unconditional branches which are followed within a block
+  // when OPTION_BRANCH_FOLLOW is set.
+  void SetBranchFollowingThreshold(u32 threshold) { m_branch_following_threshold = threshold; }
   u32 Analyze(u32 address, CodeBlock* block, CodeBuffer* buffer, std::size_t block_size);
 
 private:
@@ -231,6 +235,7 @@ private:
 
   // Options
   u32 m_options = 0;
+  u32 m_branch_following_threshold = 2;
 };
 
 void FindFunctions(u32 startAddr, u32 endAddr, PPCSymbolDB* func_db);
@@ -0,0 +1,362 @@
+// Copyright 2021 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "Core/Rewind.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <utility>
+
+#include <zstd.h>
+
+#include "Common/Logging/Log.h"
+#include "Common/WorkQueueThread.h"
+#include "Core/Config/MainSettings.h"
+#include "Core/Core.h"
+#include "Core/NetPlayProto.h"
+#include "Core/State.h"
+
+namespace Rewind
+{
+constexpr int ZSTD_COMPRESSION_LEVEL = 1;
+
+// Captures are skipped while this many snapshots are still waiting to be compressed,
+// so that a slow host doesn't pile up uncompressed states in memory
+constexpr u32 MAX_PENDING_SNAPSHOTS = 2;
+
+static std::optional<std::vector<u8>> Compress(const std::vector<u8>& data)
+{
+  std::vector<u8> compressed(ZSTD_compressBound(data.size()));
+  const size_t compressed_size = ZSTD_compress(compressed.data(), compressed.size(), data.data(),
+                                               data.size(), ZSTD_COMPRESSION_LEVEL);
+  if (ZSTD_isError(compressed_size))
+  {
+    ERROR_LOG_FMT(CORE, "Rewind: Failed to compress a snapshot: {}",
+                  ZSTD_getErrorName(compressed_size));
+    return std::nullopt;
+  }
+
+  compressed.resize(compressed_size);
+  compressed.shrink_to_fit();
+  return compressed;
+}
+
+static std::optional<std::vector<u8>> Decompress(const std::vector<u8>& compressed)
+{
+  const unsigned long long size = ZSTD_getFrameContentSize(compressed.data(), compressed.size());
+  if (size == ZSTD_CONTENTSIZE_ERROR || size == ZSTD_CONTENTSIZE_UNKNOWN)
+  {
+    ERROR_LOG_FMT(CORE, "Rewind: Snapshot has no valid frame header");
+    return std::nullopt;
+  }
+
+  std::vector<u8> data(static_cast<size_t>(size));
+  const size_t result =
+      ZSTD_decompress(data.data(), data.size(), compressed.data(), compressed.size());
+  if (ZSTD_isError(result) || result != data.size())
+  {
+    ERROR_LOG_FMT(CORE, "Rewind: Failed to decompress a snapshot: {}",
+                  ZSTD_isError(result) ? ZSTD_getErrorName(result) : "wrong size");
+    return std::nullopt;
+  }
+
+  return data;
+}
+
+SnapshotRing::SnapshotRing(size_t memory_budget) : m_memory_budget(memory_budget)
+{
+}
+
+void SnapshotRing::Push(const std::vector<u8>& state, const State::StateSections& sections)
+{
+  Snapshot snapshot;
+  snapshot.is_keyframe =
+      m_keyframe.empty() || m_snapshots_since_keyframe + 1 >= KEYFRAME_INTERVAL;
+
+  std::optional<std::vector<u8>> data =
+      Compress(snapshot.is_keyframe ?
+                   state :
+                   State::CreateDelta(m_keyframe, m_keyframe_sections, state, sections));
+  if (!data)
+    return;
+  snapshot.data = std::move(*data);
+
+  if (snapshot.is_keyframe)
+  {
+    snapshot.sections = sections;
+    m_keyframe = state;
+    m_keyframe_sections = sections;
+    m_snapshots_since_keyframe = 0;
+  }
+  else
+  {
+    ++m_snapshots_since_keyframe;
+  }
+
+  m_memory_usage += snapshot.data.size();
+  m_snapshots.push_back(std::move(snapshot));
+
+  while (m_memory_usage > m_memory_budget)
+  {
+    const size_t old_count = m_snapshots.size();
+    DropOldestKeyframeGroup();
+    if (m_snapshots.size() == old_count)
+      break;
+  }
+}
+
+void SnapshotRing::DropOldestKeyframeGroup()
+{
+  // Deltas can't be decompressed without their keyframe, so they are dropped along with it.
+  // The group containing the newest snapshot is always kept.
+  const auto next_keyframe =
+      std::find_if(m_snapshots.begin() + 1, m_snapshots.end(),
+                   [](const Snapshot& snapshot) { return snapshot.is_keyframe; });
+  if (next_keyframe == m_snapshots.end())
+    return;
+
+  for (auto it = m_snapshots.begin(); it != next_keyframe; ++it)
+    m_memory_usage -= it->data.size();
+  m_snapshots.erase(m_snapshots.begin(), next_keyframe);
+}
+
+bool SnapshotRing::Pop(std::vector<u8>* state)
+{
+  if (m_snapshots.empty())
+    return false;
+
+  Snapshot snapshot = std::move(m_snapshots.back());
+  m_snapshots.pop_back();
+  m_memory_usage -= snapshot.data.size();
+
+  if (!snapshot.is_keyframe)
+  {
+    --m_snapshots_since_keyframe;
+
+    // A snapshot that can't be restored is dropped, and the older ones stay usable
+    const std::optional<std::vector<u8>> delta = Decompress(snapshot.data);
+    if (!delta || !State::ApplyDelta(m_keyframe, *delta, state))
+    {
+      ERROR_LOG_FMT(CORE, "Rewind: Dropped a snapshot which couldn't be restored");
+      return false;
+    }
+    return true;
+  }
+
+  *state = std::move(m_keyframe);
+
+  // The deltas that come before this keyframe refer to the previous one
+  const auto previous_keyframe =
+      std::find_if(m_snapshots.rbegin(), m_snapshots.rend(),
+                   [](const Snapshot& s) { return s.is_keyframe; });
+  std::optional<std::vector<u8>> keyframe;
+  if (previous_keyframe != m_snapshots.rend())
+  {
+    keyframe = Decompress(previous_keyframe->data);
+    if (!keyframe)
+    {
+      // None of the older snapshots can be restored without the keyframe they were taken after
+      ERROR_LOG_FMT(CORE, "Rewind: Dropped {} snapshots whose keyframe couldn't be restored",
+                    m_snapshots.size());
+    }
+  }
+
+  if (keyframe)
+  {
+    m_keyframe = std::move(*keyframe);
+    m_keyframe_sections = previous_keyframe->sections;
+    m_snapshots_since_keyframe = previous_keyframe - m_snapshots.rbegin();
+  }
+  else
+  {
+    Clear();
+  }
+
+  return true;
+}
+
+void SnapshotRing::Clear()
+{
+  m_snapshots.clear();
+  m_keyframe.clear();
+  m_keyframe_sections.clear();
+  m_snapshots_since_keyframe = 0;
+  m_memory_usage = 0;
+}
+
+struct PendingSnapshot
+{
+  u64 generation;
+  std::vector<u8> state;
+  State::StateSections sections;
+};
+
+static bool s_enabled;
+static u32 s_interval;
+static u32 s_frames_until_snapshot;
+
+static std::mutex s_ring_mutex;
+static std::unique_ptr<SnapshotRing> s_ring;
+// Incremented whenever the ring is rewound, so that snapshots captured before that are discarded.
+// Atomic so that the CPU thread doesn't have to wait for a compression holding s_ring_mutex.
+static std::atomic<u64> s_generation;
+
+static Common::WorkQueueThread<PendingSnapshot> s_compress_thread;
+static std::atomic<u32> s_pending_snapshots;
+
+// A state buffer that has already been compressed, reused to avoid reallocating on every capture
+static std::mutex s_spare_buffer_mutex;
+static std::vector<u8> s_spare_buffer;
+
+static std::atomic<u64> s_captures;
+static std::atomic<u64> s_total_capture_time_us;
+static std::atomic<u64> s_max_capture_time_us;
+
+static void CompressSnapshot(PendingSnapshot snapshot)
+{
+  {
+    std::lock_guard lk(s_ring_mutex);
+    if (s_ring && snapshot.generation == s_generation)
+      s_ring->Push(snapshot.state, snapshot.sections);
+  }
+
+  --s_pending_snapshots;
+
+  std::lock_guard lk(s_spare_buffer_mutex);
+  s_spare_buffer = std::move(snapshot.state);
+}
+
+void Init()
+{
+  s_enabled = Config::Get(Config::MAIN_REWIND_ENABLED);
+  if (!s_enabled)
+    return;
+
+  s_interval = std::max<u32>(Config::Get(Config::MAIN_REWIND_INTERVAL), 1);
+  s_frames_until_snapshot = s_interval;
+
+  s_captures = 0;
+  s_total_capture_time_us = 0;
+  s_max_capture_time_us = 0;
+
+  {
+    std::lock_guard lk(s_ring_mutex);
+    s_ring = std::make_unique<SnapshotRing>(size_t(Config::Get(Config::MAIN_REWIND_BUFFER_SIZE))
+                                            << 20);
+    ++s_generation;
+  }
+
+  s_compress_thread.Reset(CompressSnapshot);
+}
+
+void Shutdown()
+{
+  if (!s_enabled)
+    return;
+
+  s_enabled = false;
+  s_compress_thread.Cancel();
+
+  const Statistics statistics = GetStatistics();
+  INFO_LOG_FMT(CORE,
+               "Rewind: {} snapshots captured, {} us average and {} us max on the CPU thread",
+               statistics.captures, statistics.average_capture_time_us,
+               statistics.max_capture_time_us);
+
+  {
+    std::lock_guard lk(s_ring_mutex);
+    s_ring.reset();
+  }
+
+  {
+    std::lock_guard lk(s_spare_buffer_mutex);
+    std::vector<u8>().swap(s_spare_buffer);
+  }
+
+  s_pending_snapshots = 0;
+}
+
+void OnFrameEnd()
+{
+  if (!s_enabled || NetPlay::IsNetPlayRunning())
+    return;
+
+  if (--s_frames_until_snapshot != 0)
+    return;
+  s_frames_until_snapshot = s_interval;
+
+  if (s_pending_snapshots.load() >= MAX_PENDING_SNAPSHOTS)
+    return;
+
+  const auto start = std::chrono::steady_clock::now();
+
+  PendingSnapshot snapshot;
+  {
+    std::lock_guard lk(s_spare_buffer_mutex);
+    snapshot.state = std::move(s_spare_buffer);
+  }
+  State::SaveToBuffer(snapshot.state, &snapshot.sections);
+
+  const u64 capture_time_us = std::chrono::duration_cast<std::chrono::microseconds>(
+                                  std::chrono::steady_clock::now() - start)
+                                  .count();
+  ++s_captures;
+  s_total_capture_time_us += capture_time_us;
+  if (capture_time_us > s_max_capture_time_us)
+    s_max_capture_time_us = capture_time_us;
+
+  snapshot.generation = s_generation.load();
+  ++s_pending_snapshots;
+  s_compress_thread.EmplaceItem(std::move(snapshot));
+}
+
+bool StepBack()
+{
+  if (!s_enabled || NetPlay::IsNetPlayRunning())
+    return false;
+
+  bool success = false;
+  Core::RunOnCPUThread(
+      [&success] {
+        std::vector<u8> state;
+        ++s_generation;
+        {
+          std::lock_guard lk(s_ring_mutex);
+          if (!s_ring || !s_ring->Pop(&state))
+            return;
+        }
+
+        State::LoadFromBuffer(state);
+        s_frames_until_snapshot = s_interval;
+        success = true;
+      },
+      true);
+
+  return success;
+}
+
+Statistics GetStatistics()
+{
+  Statistics statistics{};
+
+  {
+    std::lock_guard lk(s_ring_mutex);
+    if (s_ring)
+    {
+      statistics.snapshot_count = s_ring->GetSnapshotCount();
+      statistics.memory_usage = s_ring->GetMemoryUsage();
+    }
+  }
+
+  statistics.captures = s_captures.load();
+  if (statistics.captures != 0)
+    statistics.average_capture_time_us = s_total_capture_time_us.load() / statistics.captures;
+  statistics.max_capture_time_us = s_max_capture_time_us.load();
+
+  return statistics;
+}
+}  // namespace Rewind
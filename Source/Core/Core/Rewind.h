@@ -0,0 +1,79 @@
+// Copyright 2021 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+// Continuous rewind support, built on in-memory savestates.
+
+#pragma once
+
+#include <cstddef>
+#include <deque>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Core/State.h"
+
+namespace Rewind
+{
+// Holds compressed savestates in the order they were pushed, and drops the oldest ones once the
+// total size exceeds the memory budget. Every KEYFRAME_INTERVAL-th snapshot is stored in full,
+// and the snapshots in between are stored as deltas (see State::CreateDelta) against it.
+class SnapshotRing
+{
+public:
+  static constexpr size_t KEYFRAME_INTERVAL = 30;
+
+  explicit SnapshotRing(size_t memory_budget);
+
+  // Compresses the state and adds it as the newest snapshot. The sections are the ones filled in
+  // by State::SaveToBuffer.
+  void Push(const std::vector<u8>& state, const State::StateSections& sections);
+  // Removes the newest snapshot and decompresses it into state. Returns false if the ring is empty
+  // or if the snapshot couldn't be restored, in which case the snapshot is dropped anyway.
+  bool Pop(std::vector<u8>* state);
+  void Clear();
+
+  size_t GetSnapshotCount() const { return m_snapshots.size(); }
+  size_t GetMemoryUsage() const { return m_memory_usage; }
+
+private:
+  struct Snapshot
+  {
+    std::vector<u8> data;
+    bool is_keyframe;
+    // Only stored for keyframes
+    State::StateSections sections;
+  };
+
+  void DropOldestKeyframeGroup();
+
+  std::deque<Snapshot> m_snapshots;
+  // Uncompressed copy of the newest keyframe in m_snapshots
+  std::vector<u8> m_keyframe;
+  State::StateSections m_keyframe_sections;
+  size_t m_snapshots_since_keyframe = 0;
+  size_t m_memory_budget;
+  size_t m_memory_usage = 0;
+};
+
+struct Statistics
+{
+  size_t snapshot_count;
+  size_t memory_usage;
+  u64 captures;
+  // Time spent on the CPU thread serializing a snapshot
+  u64 average_capture_time_us;
+  u64 max_capture_time_us;
+};
+
+void Init();
+void Shutdown();
+
+// Called on the CPU thread at the end of every emulated frame.
+// Captures a snapshot every MAIN_REWIND_INTERVAL frames, which is compressed on a worker thread.
+void OnFrameEnd();
+
+// Loads the newest snapshot and removes it from the ring. Can be called from any thread.
+bool StepBack();
+
+Statistics GetStatistics();
+}  // namespace Rewind
@@ -3,8 +3,12 @@
 
 #include "Core/State.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cstring>
 #include <lzo/lzo1x.h>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <thread>
@@ -12,6 +16,7 @@
 #include <vector>
 
 #include <fmt/format.h>
+#include <zstd.h>
 
 #include "Common/ChunkFile.h"
 #include "Common/CommonTypes.h"
@@ -36,6 +41,8 @@
 #include "Core/NetPlayClient.h"
 #include "Core/PowerPC/PowerPC.h"
 
+#include "DiscIO/MultithreadedCompressor.h"
+
 #include "VideoCommon/FrameDump.h"
 #include "VideoCommon/OnScreenDisplay.h"
 #include "VideoCommon/VideoBackendBase.h"
@@ -52,12 +59,39 @@ static const u32 IN_LEN = 128 * 1024u;
 
 static const u32 OUT_LEN = IN_LEN + (IN_LEN / 16) + 64 + 3;
 
+// Only used for loading states that were compressed with LZO by older versions of Dolphin
 static unsigned char __LZO_MMODEL out[OUT_LEN];
 
-#define HEAP_ALLOC(var, size)                                                                      \
-  lzo_align_t __LZO_MMODEL var[((size) + (sizeof(lzo_align_t) - 1)) / sizeof(lzo_align_t)]
+// Compressed states start with a StateHeader whose size is 0, followed by a StateExtendedHeader.
+// Uncompressed states also have a size of 0, but they continue with the state version cookie
+// (0xBAADBABE + STATE_VERSION), which can never be equal to COMPRESSED_STATE_MAGIC.
+constexpr u32 COMPRESSED_STATE_MAGIC = 0x5453445A;  // "ZDST"
+constexpr u32 COMPRESSED_STATE_VERSION = 1;
+
+// The state is split into blocks of this size which are compressed independently of each other,
+// so that both compression and decompression can be spread across several threads.
+constexpr u32 COMPRESSED_BLOCK_SIZE = 1024 * 1024;
+constexpr int ZSTD_COMPRESSION_LEVEL = 1;
+
+// Far larger than any real state. Headers claiming more than this are treated as corrupt rather
+// than trusted with an allocation of that size.
+constexpr u64 MAX_UNCOMPRESSED_STATE_SIZE = 0x40000000;
 
-static HEAP_ALLOC(wrkmem, LZO1X_1_MEM_COMPRESS);
+enum class StateCompression : u32
+{
+  Zstd = 1,
+};
+
+// Each block is stored as a u32 containing its compressed size followed by the compressed data.
+// All blocks except the last one decompress to exactly block_size bytes.
+struct StateExtendedHeader
+{
+  u32 magic;
+  u32 version;
+  StateCompression compression;
+  u32 block_size;
+  u64 uncompressed_size;
+};
 
 static AfterLoadCallbackFunc s_on_after_load_callback;
 
@@ -91,6 +125,22 @@ static const std::map<u32, std::pair<std::string, std::string>> s_old_versions =
     {38, {"4.0-4963", "4.0-5267"}}, {39, {"4.0-5279", "4.0-5525"}}, {40, {"4.0-5531", "4.0-5809"}},
     {41, {"4.0-5811", "4.0-5923"}}, {42, {"4.0-5925", "4.0-5946"}}};
 
+constexpr u32 DELTA_STATE_MAGIC = 0x544C4544;  // "DELT"
+constexpr u32 DELTA_PAGE_SIZE = 0x1000;
+
+// A delta state consists of this header, the start offsets of each section in the keyframe and in
+// the state (as pairs of u64), and the pages that differ from the keyframe. Pages are counted from
+// the start of their section and are stored as a u32 section index, a u32 page index and the page
+// data. Only the last page of a section can be shorter than page_size.
+struct DeltaStateHeader
+{
+  u32 magic;
+  u32 page_size;
+  u64 keyframe_size;
+  u64 state_size;
+  u64 section_count;
+};
+
 enum
 {
   STATE_NONE = 0,
@@ -145,8 +195,17 @@ static bool DoStateVersion(PointerWrap& p, std::string* version_created_by)
   return true;
 }
 
-static void DoState(PointerWrap& p)
+static void DoState(PointerWrap& p, StateSections* sections = nullptr)
 {
+  u8* const start = *p.ptr;
+  const auto begin_section = [&] {
+    if (sections)
+      sections->push_back(static_cast<u64>(*p.ptr - start));
+  };
+  if (sections)
+    sections->clear();
+  begin_section();
+
   std::string version_created_by;
   if (!DoStateVersion(p, &version_created_by))
   {
@@ -193,23 +252,29 @@ static void DoState(PointerWrap& p)
   // state load, and the frame number must be up-to-date.
   Movie::DoState(p);
   p.DoMarker("Movie");
+  begin_section();
 
   // Begin with video backend, so that it gets a chance to clear its caches and writeback modified
   // things to RAM
   g_video_backend->DoState(p);
   p.DoMarker("video_backend");
+  begin_section();
 
   PowerPC::DoState(p);
   p.DoMarker("PowerPC");
+  begin_section();
   // CoreTiming needs to be restored before restoring Hardware because
   // the controller code might need to schedule an event if the controller has changed.
   CoreTiming::DoState(p);
   p.DoMarker("CoreTiming");
+  begin_section();
   HW::DoState(p);
   p.DoMarker("HW");
+  begin_section();
   if (SConfig::GetInstance().bWii)
     Wiimote::DoState(p);
   p.DoMarker("Wiimote");
+  begin_section();
   Gecko::DoState(p);
   p.DoMarker("Gecko");
 }
@@ -231,7 +296,7 @@ void LoadFromBuffer(std::vector<u8>& buffer)
       true);
 }
 
-void SaveToBuffer(std::vector<u8>& buffer)
+void SaveToBuffer(std::vector<u8>& buffer, StateSections* sections)
 {
   Core::RunOnCPUThread(
       [&] {
@@ -244,11 +309,153 @@ void SaveToBuffer(std::vector<u8>& buffer)
 
         ptr = &buffer[0];
         p.SetMode(PointerWrap::MODE_WRITE);
-        DoState(p);
+        DoState(p, sections);
       },
       true);
 }
 
+// Sections must start at 0 and be in ascending order within the buffer
+static bool AreSectionsValid(const StateSections& sections, u64 size)
+{
+  if (sections.empty() || sections[0] != 0)
+    return false;
+  for (size_t i = 1; i < sections.size(); ++i)
+  {
+    if (sections[i] < sections[i - 1])
+      return false;
+  }
+  return sections.back() <= size;
+}
+
+static u64 GetSectionEnd(const StateSections& sections, size_t index, u64 size)
+{
+  return index + 1 < sections.size() ? sections[index + 1] : size;
+}
+
+std::vector<u8> CreateDelta(const std::vector<u8>& keyframe, const StateSections& keyframe_sections,
+                            const std::vector<u8>& state, const StateSections& state_sections)
+{
+  // Without matching sections, the buffers are compared as a whole
+  const StateSections whole_buffer{0};
+  const bool use_sections = keyframe_sections.size() == state_sections.size() &&
+                            AreSectionsValid(keyframe_sections, keyframe.size()) &&
+                            AreSectionsValid(state_sections, state.size());
+  const StateSections& key_sections = use_sections ? keyframe_sections : whole_buffer;
+  const StateSections& sections = use_sections ? state_sections : whole_buffer;
+
+  DeltaStateHeader header{};
+  header.magic = DELTA_STATE_MAGIC;
+  header.page_size = DELTA_PAGE_SIZE;
+  header.keyframe_size = keyframe.size();
+  header.state_size = state.size();
+  header.section_count = sections.size();
+
+  std::vector<u8> delta(sizeof(DeltaStateHeader) + sections.size() * 2 * sizeof(u64));
+  std::memcpy(delta.data(), &header, sizeof(DeltaStateHeader));
+  for (size_t i = 0; i < sections.size(); ++i)
+  {
+    u8* const offsets = delta.data() + sizeof(DeltaStateHeader) + i * 2 * sizeof(u64);
+    std::memcpy(offsets, &key_sections[i], sizeof(u64));
+    std::memcpy(offsets + sizeof(u64), &sections[i], sizeof(u64));
+  }
+
+  for (u32 section = 0; section < sections.size(); ++section)
+  {
+    const u8* const key_data = keyframe.data() + key_sections[section];
+    const u8* const data = state.data() + sections[section];
+    const size_t key_size =
+        GetSectionEnd(key_sections, section, keyframe.size()) - key_sections[section];
+    const size_t size = GetSectionEnd(sections, section, state.size()) - sections[section];
+
+    for (size_t offset = 0; offset < size; offset += DELTA_PAGE_SIZE)
+    {
+      const size_t page_size = std::min<size_t>(DELTA_PAGE_SIZE, size - offset);
+      if (offset + page_size <= key_size &&
+          std::memcmp(data + offset, key_data + offset, page_size) == 0)
+      {
+        continue;
+      }
+
+      const u32 page_index = static_cast<u32>(offset / DELTA_PAGE_SIZE);
+      const size_t position = delta.size();
+      delta.resize(position + 2 * sizeof(u32) + page_size);
+      std::memcpy(delta.data() + position, &section, sizeof(u32));
+      std::memcpy(delta.data() + position + sizeof(u32), &page_index, sizeof(u32));
+      std::memcpy(delta.data() + position + 2 * sizeof(u32), data + offset, page_size);
+    }
+  }
+
+  return delta;
+}
+
+bool ApplyDelta(const std::vector<u8>& keyframe, const std::vector<u8>& delta,
+                std::vector<u8>* state)
+{
+  DeltaStateHeader header;
+  if (delta.size() < sizeof(DeltaStateHeader))
+    return false;
+  std::memcpy(&header, delta.data(), sizeof(DeltaStateHeader));
+
+  if (header.magic != DELTA_STATE_MAGIC || header.page_size == 0 ||
+      header.keyframe_size != keyframe.size() ||
+      header.state_size > MAX_UNCOMPRESSED_STATE_SIZE || header.section_count == 0 ||
+      header.section_count > (delta.size() - sizeof(DeltaStateHeader)) / (2 * sizeof(u64)))
+  {
+    return false;
+  }
+
+  StateSections key_sections(static_cast<size_t>(header.section_count));
+  StateSections sections(static_cast<size_t>(header.section_count));
+  size_t position = sizeof(DeltaStateHeader);
+  for (size_t i = 0; i < sections.size(); ++i)
+  {
+    std::memcpy(&key_sections[i], delta.data() + position, sizeof(u64));
+    std::memcpy(&sections[i], delta.data() + position + sizeof(u64), sizeof(u64));
+    position += 2 * sizeof(u64);
+  }
+  if (!AreSectionsValid(key_sections, keyframe.size()) ||
+      !AreSectionsValid(sections, header.state_size))
+  {
+    return false;
+  }
+
+  state->resize(static_cast<size_t>(header.state_size));
+  for (size_t section = 0; section < sections.size(); ++section)
+  {
+    const u64 key_size =
+        GetSectionEnd(key_sections, section, keyframe.size()) - key_sections[section];
+    const u64 size = GetSectionEnd(sections, section, state->size()) - sections[section];
+    std::memcpy(state->data() + sections[section], keyframe.data() + key_sections[section],
+                static_cast<size_t>(std::min(key_size, size)));
+  }
+
+  while (position < delta.size())
+  {
+    u32 section;
+    u32 page_index;
+    if (delta.size() - position < 2 * sizeof(u32))
+      return false;
+    std::memcpy(&section, delta.data() + position, sizeof(u32));
+    std::memcpy(&page_index, delta.data() + position + sizeof(u32), sizeof(u32));
+    position += 2 * sizeof(u32);
+
+    if (section >= sections.size())
+      return false;
+    const u64 size = GetSectionEnd(sections, section, state->size()) - sections[section];
+    const u64 offset = u64(page_index) * header.page_size;
+    if (offset >= size)
+      return false;
+
+    const size_t page_size = static_cast<size_t>(std::min<u64>(header.page_size, size - offset));
+    if (delta.size() - position < page_size)
+      return false;
+    std::memcpy(state->data() + sections[section] + offset, delta.data() + position, page_size);
+    position += page_size;
+  }
+
+  return true;
+}
+
 // return state number not in map
 static int GetEmptySlot(std::map<double, int> m)
 {
@@ -304,6 +511,168 @@ struct CompressAndDumpState_args
   bool wait;
 };
 
+struct ZstdCCtxDeleter
+{
+  void operator()(ZSTD_CCtx* context) const { ZSTD_freeCCtx(context); }
+};
+
+struct CompressBlockParameters
+{
+  const u8* data;
+  size_t size;
+};
+
+bool WriteCompressedState(File::IOFile& f, const u8* data, size_t size)
+{
+  StateExtendedHeader extended_header{};
+  extended_header.magic = COMPRESSED_STATE_MAGIC;
+  extended_header.version = COMPRESSED_STATE_VERSION;
+  extended_header.compression = StateCompression::Zstd;
+  extended_header.block_size = COMPRESSED_BLOCK_SIZE;
+  extended_header.uncompressed_size = size;
+  if (!f.WriteArray(&extended_header, 1))
+    return false;
+
+  using CompressThreadState = std::unique_ptr<ZSTD_CCtx, ZstdCCtxDeleter>;
+  using DiscIO::ConversionResultCode;
+
+  const auto set_up_compress_thread_state = [](CompressThreadState* state) {
+    state->reset(ZSTD_createCCtx());
+    return *state ? ConversionResultCode::Success : ConversionResultCode::InternalError;
+  };
+
+  const auto compress = [](CompressThreadState* state, CompressBlockParameters parameters)
+      -> DiscIO::ConversionResult<std::vector<u8>> {
+    std::vector<u8> block(sizeof(u32) + ZSTD_compressBound(parameters.size));
+    const size_t compressed_size =
+        ZSTD_compressCCtx(state->get(), block.data() + sizeof(u32), block.size() - sizeof(u32),
+                          parameters.data, parameters.size, ZSTD_COMPRESSION_LEVEL);
+    if (ZSTD_isError(compressed_size))
+      return ConversionResultCode::InternalError;
+
+    const u32 compressed_size_u32 = static_cast<u32>(compressed_size);
+    std::memcpy(block.data(), &compressed_size_u32, sizeof(u32));
+    block.resize(sizeof(u32) + compressed_size);
+    return block;
+  };
+
+  const auto output = [&f](std::vector<u8> block) {
+    return f.WriteBytes(block.data(), block.size()) ? ConversionResultCode::Success :
+                                                      ConversionResultCode::WriteFailed;
+  };
+
+  DiscIO::MultithreadedCompressor<CompressThreadState, CompressBlockParameters, std::vector<u8>>
+      compressor(set_up_compress_thread_state, compress, output);
+
+  for (size_t i = 0; i < size; i += COMPRESSED_BLOCK_SIZE)
+  {
+    compressor.CompressAndWrite({data + i, std::min<size_t>(COMPRESSED_BLOCK_SIZE, size - i)});
+    if (compressor.GetStatus() != ConversionResultCode::Success)
+      break;
+  }
+
+  compressor.Shutdown();
+
+  return compressor.GetStatus() == ConversionResultCode::Success;
+}
+
+bool IsCompressedState(File::IOFile& f)
+{
+  const u64 position = f.Tell();
+  u32 magic;
+  const bool is_compressed = f.ReadArray(&magic, 1) && magic == COMPRESSED_STATE_MAGIC;
+  f.Seek(position, SEEK_SET);
+  return is_compressed;
+}
+
+bool ReadCompressedState(File::IOFile& f, std::vector<u8>* buffer)
+{
+  StateExtendedHeader header;
+  if (!f.ReadArray(&header, 1))
+    return false;
+
+  if (header.magic != COMPRESSED_STATE_MAGIC || header.version != COMPRESSED_STATE_VERSION ||
+      header.compression != StateCompression::Zstd || header.block_size == 0 ||
+      header.uncompressed_size > MAX_UNCOMPRESSED_STATE_SIZE)
+  {
+    return false;
+  }
+
+  const u64 position = f.Tell();
+  const u64 file_size = f.GetSize();
+  if (position > file_size)
+    return false;
+
+  std::vector<u8> compressed(static_cast<size_t>(file_size - position));
+  if (!f.ReadBytes(compressed.data(), compressed.size()))
+    return false;
+
+  // Every block takes at least the space of its size field
+  const u64 block_count_u64 =
+      (header.uncompressed_size + header.block_size - 1) / header.block_size;
+  if (block_count_u64 > compressed.size() / sizeof(u32))
+    return false;
+
+  // Find where each block starts, so that the blocks can be decompressed in any order
+  const size_t block_count = static_cast<size_t>(block_count_u64);
+  std::vector<size_t> block_offsets(block_count);
+  size_t offset = 0;
+  for (size_t i = 0; i < block_count; ++i)
+  {
+    u32 block_compressed_size;
+    if (compressed.size() - offset < sizeof(u32))
+      return false;
+    std::memcpy(&block_compressed_size, compressed.data() + offset, sizeof(u32));
+    offset += sizeof(u32);
+
+    if (compressed.size() - offset < block_compressed_size)
+      return false;
+    block_offsets[i] = offset;
+    offset += block_compressed_size;
+  }
+
+  buffer->resize(static_cast<size_t>(header.uncompressed_size));
+
+  std::atomic<size_t> next_block = 0;
+  std::atomic<bool> success = true;
+
+  const auto decompress_blocks = [&] {
+    ZSTD_DCtx* const context = ZSTD_createDCtx();
+    if (!context)
+    {
+      success.store(false);
+      return;
+    }
+
+    for (size_t i = next_block++; i < block_count && success.load(); i = next_block++)
+    {
+      const size_t block_start = i * header.block_size;
+      const size_t block_size = std::min<size_t>(header.block_size, buffer->size() - block_start);
+      const size_t compressed_block_size =
+          (i + 1 < block_count ? block_offsets[i + 1] - sizeof(u32) : offset) - block_offsets[i];
+
+      const size_t result =
+          ZSTD_decompressDCtx(context, buffer->data() + block_start, block_size,
+                              compressed.data() + block_offsets[i], compressed_block_size);
+      if (ZSTD_isError(result) || result != block_size)
+        success.store(false);
+    }
+
+    ZSTD_freeDCtx(context);
+  };
+
+  const size_t thread_count =
+      std::min<size_t>(block_count, std::max(1u, std::thread::hardware_concurrency()));
+  std::vector<std::thread> threads;
+  for (size_t i = 1; i < thread_count; ++i)
+    threads.emplace_back(decompress_blocks);
+  decompress_blocks();
+  for (std::thread& thread : threads)
+    thread.join();
+
+  return success.load();
+}
+
 static void CompressAndDumpState(CompressAndDumpState_args save_args)
 {
   std::lock_guard lk(*save_args.buffer_mutex);
@@ -357,39 +726,17 @@ static void CompressAndDumpState(CompressAndDumpState_args save_args)
   // Setting up the header
   StateHeader header{};
   SConfig::GetInstance().GetGameID().copy(header.gameID, std::size(header.gameID));
-  header.size = s_use_compression ? (u32)buffer_size : 0;
+  header.size = 0;
   header.time = Common::Timer::GetDoubleTime();
 
   f.WriteArray(&header, 1);
 
-  if (header.size != 0)  // non-zero header size means the state is compressed
+  if (s_use_compression)
   {
-    lzo_uint i = 0;
-    while (true)
+    if (!WriteCompressedState(f, buffer_data, buffer_size))
     {
-      lzo_uint32 cur_len = 0;
-      lzo_uint out_len = 0;
-
-      if ((i + IN_LEN) >= buffer_size)
-      {
-        cur_len = (lzo_uint32)(buffer_size - i);
-      }
-      else
-      {
-        cur_len = IN_LEN;
-      }
-
-      if (lzo1x_1_compress(buffer_data + i, cur_len, out, &out_len, wrkmem) != LZO_E_OK)
-        PanicAlertFmtT("Internal LZO Error - compression failed");
-
-      // The size of the data to write is 'out_len'
-      f.WriteArray((lzo_uint32*)&out_len, 1);
-      f.WriteBytes(out, out_len);
-
-      if (cur_len != IN_LEN)
-        break;
-
-      i += cur_len;
+      Core::DisplayMessage("Could not save state", 2000);
+      return;
     }
   }
   else  // uncompressed
@@ -503,7 +850,7 @@ static void LoadFileStateData(const std::string& filename, std::vector<u8>& ret_
 
   std::vector<u8> buffer;
 
-  if (header.size != 0)  // non-zero size means the state is compressed
+  if (header.size != 0)  // non-zero size means the state was compressed with LZO
   {
     Core::DisplayMessage("Decompressing State...", 500);
 
@@ -532,15 +879,29 @@ static void LoadFileStateData(const std::string& filename, std::vector<u8>& ret_
       i += new_len;
     }
   }
-  else  // uncompressed
+  else
   {
-    const auto size = static_cast<size_t>(f.GetSize() - sizeof(StateHeader));
-    buffer.resize(size);
+    if (IsCompressedState(f))
+    {
+      Core::DisplayMessage("Decompressing State...", 500);
 
-    if (!f.ReadBytes(&buffer[0], size))
+      if (!ReadCompressedState(f, &buffer))
+      {
+        PanicAlertFmtT("Internal zstd Error - decompression failed\n"
+                       "Try loading the state again");
+        return;
+      }
+    }
+    else  // uncompressed
     {
-      PanicAlertFmt("Error reading bytes: {0}", size);
-      return;
+      const auto size = static_cast<size_t>(f.GetSize() - sizeof(StateHeader));
+      buffer.resize(size);
+
+      if (!f.ReadBytes(&buffer[0], size))
+      {
+        PanicAlertFmt("Error reading bytes: {0}", size);
+        return;
+      }
     }
   }
 
@@ -11,6 +11,11 @@
 
 #include "Common/CommonTypes.h"
 
+namespace File
+{
+class IOFile;
+}
+
 namespace State
 {
 // number of states
@@ -49,9 +54,30 @@ void Load(int slot);
 void SaveAs(const std::string& filename, bool wait = false);
 void LoadAs(const std::string& filename);
 
-void SaveToBuffer(std::vector<u8>& buffer);
+// Start offsets of the top-level sections (PowerPC, CoreTiming, HW...) in a state buffer
+using StateSections = std::vector<u64>;
+
+void SaveToBuffer(std::vector<u8>& buffer, StateSections* sections = nullptr);
 void LoadFromBuffer(std::vector<u8>& buffer);
 
+// Delta states only contain the pages of a state buffer that differ from a keyframe state buffer
+// (created with SaveToBuffer), which makes them much smaller when keeping many states around.
+// Pages are compared section by section, so that a section changing its size (like the list of
+// CoreTiming events) doesn't shift the memory in the sections after it. If the sections don't
+// match, the buffers are compared as a whole. The same keyframe must be passed in to ApplyDelta,
+// which returns false if the delta is malformed or wasn't created against the given keyframe.
+std::vector<u8> CreateDelta(const std::vector<u8>& keyframe, const StateSections& keyframe_sections,
+                            const std::vector<u8>& state, const StateSections& state_sections);
+bool ApplyDelta(const std::vector<u8>& keyframe, const std::vector<u8>& delta,
+                std::vector<u8>* state);
+
+// The compressed format of state files, which follows the StateHeader: an extended header and
+// blocks of the state that are zstd-compressed independently of each other. Both functions work
+// at the current position of the file. ReadCompressedState returns false if the data is malformed.
+bool WriteCompressedState(File::IOFile& f, const u8* data, size_t size);
+bool IsCompressedState(File::IOFile& f);
+bool ReadCompressedState(File::IOFile& f, std::vector<u8>* buffer);
+
 void LoadLastSaved(int i = 1);
 void SaveFirstSaved();
 void UndoSaveState();
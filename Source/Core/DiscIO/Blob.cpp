@@ -11,6 +11,8 @@
 #include "Common/CDUtils.h"
 #include "Common/CommonTypes.h"
 #include "Common/IOFile.h"
+#include "Common/Logging/Log.h"
+#include "Common/MemoryUtil.h"
 #include "Common/MsgHandler.h"
 
 #include "DiscIO/Blob.h"
@@ -57,11 +59,9 @@ std::string GetName(BlobType blob_type, bool translate)
 void SectorReader::SetSectorSize(int blocksize)
 {
   m_block_size = std::max(blocksize, 0);
-  for (auto& cache_entry : m_cache)
-  {
-    cache_entry.Reset();
-    cache_entry.data.resize(m_chunk_blocks * m_block_size);
-  }
+  m_cache.SetEntrySize(m_chunk_blocks * m_block_size);
+  m_cache.Clear();
+  UpdateCacheCapacity();
 }
 
 void SectorReader::SetChunkSize(int block_cnt)
@@ -73,55 +73,46 @@ void SectorReader::SetChunkSize(int block_cnt)
 
 SectorReader::~SectorReader()
 {
+  const BlockCache::Stats& stats = m_cache.GetStats();
+  DEBUG_LOG_FMT(DISCIO, "Block cache: {} hits, {} misses, {} evictions", stats.hits, stats.misses,
+                stats.evictions);
 }
 
-const SectorReader::Cache* SectorReader::FindCacheLine(u64 block_num)
+void SectorReader::UpdateCacheCapacity()
 {
-  auto itr = std::find_if(m_cache.begin(), m_cache.end(),
-                          [&](const Cache& entry) { return entry.Contains(block_num); });
-  if (itr == m_cache.end())
-    return nullptr;
-
-  itr->MarkUsed();
-  return &*itr;
+  m_cache_size = GetDecompressedCacheSize();
+  const u64 chunk_size = m_cache.GetEntrySize();
+  const u64 chunks = chunk_size == 0 ? 0 : m_cache_size / chunk_size;
+  m_cache.SetCapacity(static_cast<size_t>(std::max<u64>(chunks, MIN_CACHE_CHUNKS)));
 }
 
-SectorReader::Cache* SectorReader::GetEmptyCacheLine()
+const BlockCache::Entry* SectorReader::GetCacheLine(u64 block_num)
 {
-  Cache* oldest = &m_cache[0];
-  // Find the Least Recently Used cache line to replace.
-  std::for_each(m_cache.begin() + 1, m_cache.end(), [&](Cache& line) {
-    if (line.IsLessRecentlyUsedThan(*oldest))
-    {
-      oldest->ShiftLRU();
-      oldest = &line;
-      return;
-    }
-    line.ShiftLRU();
-  });
-  oldest->Reset();
-  return oldest;
-}
+  // We only read aligned chunks, this avoids duplicate overlapping entries.
+  const u64 chunk_idx = block_num / m_chunk_blocks;
 
-const SectorReader::Cache* SectorReader::GetCacheLine(u64 block_num)
-{
-  if (auto entry = FindCacheLine(block_num))
-    return entry;
+  const BlockCache::Entry* entry = m_cache.Find(chunk_idx);
+  if (!entry)
+  {
+    // Cache miss. Fault in the missing entry.
+    if (m_cache_size != GetDecompressedCacheSize())
+      UpdateCacheCapacity();
 
-  // Cache miss. Fault in the missing entry.
-  Cache* cache = GetEmptyCacheLine();
-  // We only read aligned chunks, this avoids duplicate overlapping entries.
-  u64 chunk_idx = block_num / m_chunk_blocks;
-  u32 blocks_read = ReadChunk(cache->data.data(), chunk_idx);
-  if (!blocks_read)
-    return nullptr;
-  cache->Fill(chunk_idx * m_chunk_blocks, blocks_read);
+    BlockCache::Entry* new_entry = m_cache.Insert(chunk_idx);
+    new_entry->valid_count = ReadChunk(new_entry->data.data(), chunk_idx);
+    if (!new_entry->valid_count)
+    {
+      m_cache.Erase(chunk_idx);
+      return nullptr;
+    }
+    entry = new_entry;
+  }
 
   // Secondary check for out-of-bounds read.
   // If we got less than m_chunk_blocks, we may still have missed.
   // We do this after the cache fill since the cache line itself is
   // fine, the problem is being asked to read past the end of the disk.
-  return cache->Contains(block_num) ? cache : nullptr;
+  return block_num - chunk_idx * m_chunk_blocks < entry->valid_count ? entry : nullptr;
 }
 
 bool SectorReader::Read(u64 offset, u64 size, u8* out_ptr)
@@ -137,13 +128,14 @@ bool SectorReader::Read(u64 offset, u64 size, u8* out_ptr)
   {
     block = offset / m_block_size;
 
-    const Cache* cache = GetCacheLine(block);
+    const BlockCache::Entry* cache = GetCacheLine(block);
     if (!cache)
       return false;
 
     // Cache entries are aligned chunks, we may not want to read from the start
-    u32 read_offset = static_cast<u32>(block - cache->block_idx) * m_block_size + position_in_block;
-    u32 can_read = m_block_size * cache->num_blocks - read_offset;
+    u32 read_offset = static_cast<u32>(block - cache->index * m_chunk_blocks) * m_block_size +
+                      position_in_block;
+    u32 can_read = m_block_size * cache->valid_count - read_offset;
     u32 was_read = static_cast<u32>(std::min<u64>(can_read, remain));
 
     std::copy(cache->data.begin() + read_offset, cache->data.begin() + read_offset + was_read,
@@ -247,4 +239,12 @@ std::unique_ptr<BlobReader> CreateBlobReader(const std::string& filename)
   }
 }
 
+u64 GetDefaultDecompressedCacheSize()
+{
+  // 1/64 of the physical memory, so 256 MiB with 16 GiB of RAM
+  constexpr u64 MIN_SIZE = 32 << 20;
+  constexpr u64 MAX_SIZE = 512 << 20;
+  return std::clamp<u64>(Common::MemPhysical() / 64, MIN_SIZE, MAX_SIZE);
+}
+
 }  // namespace DiscIO
@@ -22,6 +22,7 @@
 
 #include "Common/CommonTypes.h"
 #include "Common/Swap.h"
+#include "DiscIO/BlockCache.h"
 
 namespace DiscIO
 {
@@ -80,8 +81,22 @@ public:
     return false;
   }
 
+  // How many bytes of decompressed blocks a reader of a compressed format may keep in memory, and
+  // how many blocks it may decompress on worker threads ahead of sequential reads. These can be
+  // changed between reads. By default, nothing is read ahead and the caches are as small as they
+  // can be (one chunk for WIA and RVZ, a few chunks for SectorReader), which suits one-off reads
+  // like the ones the game list does.
+  void SetDecompressedCacheSize(u64 bytes) { m_decompressed_cache_size = bytes; }
+  u64 GetDecompressedCacheSize() const { return m_decompressed_cache_size; }
+  void SetReadAheadBlocks(u32 blocks) { m_read_ahead_blocks = blocks; }
+  u32 GetReadAheadBlocks() const { return m_read_ahead_blocks; }
+
 protected:
   BlobReader() {}
+
+private:
+  u64 m_decompressed_cache_size = 0;
+  u32 m_read_ahead_blocks = 0;
 };
 
 // Provides caching and byte-operation-to-block-operations facilities.
@@ -94,6 +109,8 @@ public:
 
   bool Read(u64 offset, u64 size, u8* out_ptr) override;
 
+  const BlockCache::Stats& GetCacheStats() const { return m_cache.GetStats(); }
+
 protected:
   void SetSectorSize(int blocksize);
   int GetSectorSize() const { return m_block_size; }
@@ -113,52 +130,12 @@ protected:
   virtual bool ReadMultipleAlignedBlocks(u64 block_num, u64 num_blocks, u8* out_ptr);
 
 private:
-  struct Cache
-  {
-    std::vector<u8> data;
-    u64 block_idx = 0;
-    u32 num_blocks = 0;
-
-    // [Pseudo-] Least Recently Used Shift Register
-    // When an empty cache line is needed, the line with the lowest value
-    // is taken and reset; the LRU register is then shifted down 1 place
-    // on all lines (low bit discarded). When a line is used, the high bit
-    // is set marking it as most recently used.
-    u32 lru_sreg = 0;
-
-    void Reset()
-    {
-      block_idx = 0;
-      num_blocks = 0;
-      lru_sreg = 0;
-    }
-    void Fill(u64 block, u32 count)
-    {
-      block_idx = block;
-      num_blocks = count;
-      // NOTE: Setting only the high bit means the newest line will
-      //   be selected for eviction if every line in the cache was
-      //   touched. This gives MRU behavior which is probably
-      //   desirable in that case.
-      MarkUsed();
-    }
-    bool Contains(u64 block) const { return block >= block_idx && block - block_idx < num_blocks; }
-    void MarkUsed() { lru_sreg |= 0x80000000; }
-    void ShiftLRU() { lru_sreg >>= 1; }
-    bool IsLessRecentlyUsedThan(const Cache& other) const { return lru_sreg < other.lru_sreg; }
-  };
-
-  // Gets the cache line that contains the given block, or nullptr.
-  // NOTE: The cache record only lasts until it expires (next GetEmptyCacheLine)
-  const Cache* FindCacheLine(u64 block_num);
-
-  // Finds the least recently used cache line, resets and returns it.
-  Cache* GetEmptyCacheLine();
-
-  // Combines FindCacheLine with GetEmptyCacheLine and ReadChunk.
-  // Always returns a valid cache line (loading the data if needed).
-  // May return nullptr only if the cache missed and the read failed.
-  const Cache* GetCacheLine(u64 block_num);
+  // Gets the cache entry of the chunk that contains the given block, reading the chunk if it isn't
+  // cached. The entry only lasts until the next call. Returns nullptr if reading failed.
+  const BlockCache::Entry* GetCacheLine(u64 block_num);
+
+  // Sizes the cache according to GetDecompressedCacheSize.
+  void UpdateCacheCapacity();
 
   // Read all bytes from a chunk of blocks into a buffer.
   // Returns the number of blocks read (may be less than m_chunk_blocks
@@ -166,15 +143,20 @@ private:
   // evenly divisible into chunks). Returns zero if it fails.
   u32 ReadChunk(u8* buffer, u64 chunk_num);
 
-  static constexpr int CACHE_LINES = 32;
+  // The cache never holds fewer chunks than this, no matter what GetDecompressedCacheSize says
+  static constexpr size_t MIN_CACHE_CHUNKS = 32;
   u32 m_block_size = 0;    // Bytes in a sector/block
   u32 m_chunk_blocks = 1;  // Number of sectors/blocks in a chunk
-  std::array<Cache, CACHE_LINES> m_cache;
+  BlockCache m_cache{0, MIN_CACHE_CHUNKS};
+  u64 m_cache_size = 0;  // The GetDecompressedCacheSize value m_cache was last sized for
 };
 
 // Factory function - examines the path to choose the right type of BlobReader, and returns one.
 std::unique_ptr<BlobReader> CreateBlobReader(const std::string& filename);
 
+// A decompressed cache size for emulation that scales with the amount of physical memory.
+u64 GetDefaultDecompressedCacheSize();
+
 using CompressCB = std::function<bool(const std::string& text, float percent)>;
 
 bool ConvertToGCZ(BlobReader* infile, const std::string& infile_path,
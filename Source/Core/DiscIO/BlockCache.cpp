@@ -0,0 +1,103 @@
+// Copyright 2021 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "DiscIO/BlockCache.h"
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+namespace DiscIO
+{
+BlockCache::BlockCache(size_t entry_size, size_t capacity)
+    : m_entry_size(entry_size), m_capacity(std::max<size_t>(capacity, 1))
+{
+  m_map.reserve(m_capacity);
+}
+
+void BlockCache::SetEntrySize(size_t entry_size)
+{
+  if (m_entry_size == entry_size)
+    return;
+
+  Clear();
+  m_entry_size = entry_size;
+  m_spare_buffer = {};
+}
+
+void BlockCache::SetCapacity(size_t capacity)
+{
+  m_capacity = std::max<size_t>(capacity, 1);
+  while (m_entries.size() > m_capacity)
+    Evict();
+}
+
+BlockCache::Entry* BlockCache::Find(u64 index)
+{
+  const auto it = m_map.find(index);
+  if (it == m_map.end())
+  {
+    ++m_stats.misses;
+    return nullptr;
+  }
+
+  ++m_stats.hits;
+  m_entries.splice(m_entries.begin(), m_entries, it->second);
+  return &*it->second;
+}
+
+BlockCache::Entry* BlockCache::Insert(u64 index)
+{
+  const auto it = m_map.find(index);
+  if (it != m_map.end())
+  {
+    m_entries.splice(m_entries.begin(), m_entries, it->second);
+    return &*it->second;
+  }
+
+  if (m_entries.size() >= m_capacity)
+  {
+    // Reuse the least recently used entry, buffer and all
+    Entry& entry = m_entries.back();
+    m_map.erase(entry.index);
+    ++m_stats.evictions;
+    m_entries.splice(m_entries.begin(), m_entries, std::prev(m_entries.end()));
+  }
+  else
+  {
+    m_entries.emplace_front();
+    m_entries.front().data = std::move(m_spare_buffer);
+    m_entries.front().data.resize(m_entry_size);
+  }
+
+  Entry& entry = m_entries.front();
+  entry.index = index;
+  entry.valid_count = 0;
+  m_map.emplace(index, m_entries.begin());
+  return &entry;
+}
+
+void BlockCache::Erase(u64 index)
+{
+  const auto it = m_map.find(index);
+  if (it == m_map.end())
+    return;
+
+  m_spare_buffer = std::move(it->second->data);
+  m_entries.erase(it->second);
+  m_map.erase(it);
+}
+
+void BlockCache::Clear()
+{
+  m_entries.clear();
+  m_map.clear();
+}
+
+void BlockCache::Evict()
+{
+  m_map.erase(m_entries.back().index);
+  m_entries.pop_back();
+  ++m_stats.evictions;
+}
+}  // namespace DiscIO
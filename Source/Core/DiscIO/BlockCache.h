@@ -0,0 +1,79 @@
+// Copyright 2021 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <cstddef>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+
+namespace DiscIO
+{
+// A cache of equally sized pieces of data (for instance decompressed blocks), looked up by an
+// index. When full, the least recently used entry is evicted, and its buffer is reused for the
+// entry that replaces it.
+class BlockCache
+{
+public:
+  struct Entry
+  {
+    u64 index;
+    // Always entry_size bytes
+    std::vector<u8> data;
+    // How much of data is valid, in whatever unit the owner wants
+    u32 valid_count = 0;
+  };
+
+  struct Stats
+  {
+    u64 hits = 0;
+    u64 misses = 0;
+    u64 evictions = 0;
+  };
+
+  BlockCache(size_t entry_size, size_t capacity);
+
+  // Clears the cache if entry_size changes.
+  void SetEntrySize(size_t entry_size);
+  size_t GetEntrySize() const { return m_entry_size; }
+
+  // Evicts entries if there are more than the new capacity. The capacity is at least 1.
+  void SetCapacity(size_t capacity);
+  size_t GetCapacity() const { return m_capacity; }
+
+  size_t GetSize() const { return m_entries.size(); }
+
+  // Returns nullptr if the index isn't cached. The returned pointer is valid until the next call
+  // of Insert, SetEntrySize, SetCapacity or Clear.
+  Entry* Find(u64 index);
+
+  // Returns an entry for the index, which the caller is expected to fill. If the index is already
+  // cached, its existing entry is returned. The returned pointer is valid until the next call of
+  // Insert, SetEntrySize, SetCapacity or Clear.
+  Entry* Insert(u64 index);
+
+  // For discarding an entry that Insert returned but which couldn't be filled.
+  void Erase(u64 index);
+
+  void Clear();
+
+  const Stats& GetStats() const { return m_stats; }
+
+private:
+  void Evict();
+
+  size_t m_entry_size;
+  size_t m_capacity;
+
+  // Most recently used first
+  std::list<Entry> m_entries;
+  std::unordered_map<u64, std::list<Entry>::iterator> m_map;
+  // A buffer from an erased entry, kept so that the next Insert doesn't need to allocate
+  std::vector<u8> m_spare_buffer;
+
+  Stats m_stats;
+};
+}  // namespace DiscIO
@@ -11,6 +11,7 @@
 #include <cstring>
 #include <memory>
 #include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -31,6 +32,10 @@
 
 namespace DiscIO
 {
+// Sequential reads decompress up to this much at once, so that several blocks can be decompressed
+// in parallel
+constexpr u32 PARALLEL_DECOMPRESSION_SIZE = 0x20000;
+
 bool IsGCZBlob(File::IOFile& file);
 
 CompressedBlobReader::CompressedBlobReader(File::IOFile file, const std::string& filename)
@@ -86,20 +91,57 @@ u64 CompressedBlobReader::GetBlockCompressedSize(u64 block_num) const
   return 0;
 }
 
+u64 CompressedBlobReader::GetParallelBlockCount() const
+{
+  if (m_header.block_size == 0)
+    return 1;
+  return std::max<u64>(1, PARALLEL_DECOMPRESSION_SIZE / m_header.block_size);
+}
+
 bool CompressedBlobReader::GetBlock(u64 block_num, u8* out_ptr)
 {
-  bool uncompressed = false;
-  u32 comp_block_size = (u32)GetBlockCompressedSize(block_num);
-  u64 offset = m_block_pointers[block_num] + m_data_offset;
+  // The block may have been decompressed along with the one before it
+  if (block_num >= m_read_ahead_first_block &&
+      block_num - m_read_ahead_first_block < m_read_ahead_num_blocks)
+  {
+    const u8* block = m_read_ahead_buffer.data() +
+                      (block_num - m_read_ahead_first_block) * m_header.block_size;
+    std::copy(block, block + m_header.block_size, out_ptr);
+    m_next_sequential_block = block_num + 1;
+    return true;
+  }
 
-  if (offset & (1ULL << 63))
+  // Decompressing the following blocks ahead of time is only worth it for sequential reads, and
+  // only if they can be decompressed in parallel. Otherwise, a cache miss decompresses one block.
+  const bool sequential = block_num == m_next_sequential_block;
+  m_next_sequential_block = block_num + 1;
+  if (sequential && GetReadAheadBlocks() != 0 && std::thread::hardware_concurrency() > 1)
   {
-    if (comp_block_size != m_header.block_size)
-      ERROR_LOG_FMT(DISCIO, "Uncompressed block with wrong size");
-    uncompressed = true;
-    offset &= ~(1ULL << 63);
+    const u64 num_blocks = std::min<u64>({GetParallelBlockCount(), u64(GetReadAheadBlocks()) + 1,
+                                          m_header.num_blocks - block_num});
+    if (num_blocks > 1)
+    {
+      m_read_ahead_num_blocks = 0;
+      m_read_ahead_buffer.resize(num_blocks * m_header.block_size);
+      if (ReadMultipleAlignedBlocks(block_num, num_blocks, m_read_ahead_buffer.data()))
+      {
+        m_read_ahead_first_block = block_num;
+        m_read_ahead_num_blocks = num_blocks;
+        std::copy(m_read_ahead_buffer.begin(), m_read_ahead_buffer.begin() + m_header.block_size,
+                  out_ptr);
+        return true;
+      }
+    }
   }
 
+  return ReadBlock(block_num, out_ptr);
+}
+
+bool CompressedBlobReader::ReadBlock(u64 block_num, u8* out_ptr)
+{
+  const u32 comp_block_size = static_cast<u32>(GetBlockCompressedSize(block_num));
+  const u64 offset = (m_block_pointers[block_num] & ~(1ULL << 63)) + m_data_offset;
+
   // clear unused part of zlib buffer. maybe this can be deleted when it works fully.
   memset(&m_zlib_buffer[comp_block_size], 0, m_zlib_buffer.size() - comp_block_size);
 
@@ -112,8 +154,122 @@ bool CompressedBlobReader::GetBlock(u64 block_num, u8* out_ptr)
     return false;
   }
 
+  return DecompressBlock(block_num, m_zlib_buffer.data(), out_ptr);
+}
+
+bool CompressedBlobReader::ReadMultipleAlignedBlocks(u64 block_num, u64 num_blocks, u8* out_ptr)
+{
+  // Reads one block at a time, without going through GetBlock's read-ahead
+  const auto read_blocks_serially = [&] {
+    for (u64 i = 0; i < num_blocks; ++i)
+    {
+      if (!ReadBlock(block_num + i, out_ptr + i * m_header.block_size))
+        return false;
+    }
+    return true;
+  };
+
+  // SectorReader reads single blocks through here, which is where reading ahead can pay off
+  if (num_blocks == 1)
+    return GetBlock(block_num, out_ptr);
+
+  if (num_blocks == 0 || block_num + num_blocks > m_header.num_blocks)
+    return read_blocks_serially();
+
+  // ConvertToGCZ writes the blocks in order, so the compressed data of consecutive blocks is
+  // normally contiguous and can be read all at once
+  const u64 first_offset = m_block_pointers[block_num] & ~(1ULL << 63);
+  u64 end_offset = first_offset;
+  for (u64 i = block_num; i < block_num + num_blocks; ++i)
+  {
+    if ((m_block_pointers[i] & ~(1ULL << 63)) != end_offset)
+      return read_blocks_serially();
+    end_offset += GetBlockCompressedSize(i);
+  }
+
+  m_batch_buffer.resize(end_offset - first_offset);
+  m_file.Seek(first_offset + m_data_offset, SEEK_SET);
+  if (!m_file.ReadBytes(m_batch_buffer.data(), m_batch_buffer.size()))
+  {
+    ERROR_LOG_FMT(DISCIO, "The disc image \"{}\" is truncated, some of the data is missing.",
+                  m_file_name);
+    m_file.Clear();
+    return false;
+  }
+
+  if (m_workers.empty())
+  {
+    const u64 threads = std::max<unsigned int>(1, std::thread::hardware_concurrency());
+    const u64 workers = std::min<u64>(threads, GetParallelBlockCount()) - 1;
+    for (u64 i = 0; i < workers; ++i)
+    {
+      m_workers.push_back(std::make_unique<Common::WorkQueueThread<DecompressionBatch*>>(
+          [this](DecompressionBatch* batch) {
+            DecompressBatchBlocks(batch);
+            ReleaseBatch(batch);
+          }));
+    }
+  }
+
+  DecompressionBatch batch;
+  batch.first_block = block_num;
+  batch.num_blocks = num_blocks;
+  batch.compressed_data = m_batch_buffer.data();
+  batch.compressed_data_offset = first_offset;
+  batch.out_ptr = out_ptr;
+
+  // This thread decompresses blocks too, so one block is left for it
+  const u64 workers = std::min<u64>(m_workers.size(), num_blocks - 1);
+  batch.users = static_cast<u32>(workers) + 1;
+  for (u64 i = 0; i < workers; ++i)
+    m_workers[i]->EmplaceItem(&batch);
+
+  DecompressBatchBlocks(&batch);
+  ReleaseBatch(&batch);
+
+  // The workers must be done with the batch before it goes out of scope
+  std::unique_lock lk(m_batch_mutex);
+  m_batch_released_cv.wait(lk, [&batch] { return batch.users == 0; });
+
+  return !batch.failed.load();
+}
+
+void CompressedBlobReader::DecompressBatchBlocks(DecompressionBatch* batch) const
+{
+  while (true)
+  {
+    const u64 i = batch->next_block.fetch_add(1);
+    if (i >= batch->num_blocks)
+      return;
+
+    const u64 block_num = batch->first_block + i;
+    const u64 offset = (m_block_pointers[block_num] & ~(1ULL << 63)) -
+                       batch->compressed_data_offset;
+    if (!DecompressBlock(block_num, batch->compressed_data + offset,
+                         batch->out_ptr + i * m_header.block_size))
+    {
+      batch->failed.store(true);
+    }
+  }
+}
+
+void CompressedBlobReader::ReleaseBatch(DecompressionBatch* batch)
+{
+  std::lock_guard lk(m_batch_mutex);
+  if (--batch->users == 0)
+    m_batch_released_cv.notify_one();
+}
+
+bool CompressedBlobReader::DecompressBlock(u64 block_num, const u8* in_ptr, u8* out_ptr) const
+{
+  const u32 comp_block_size = static_cast<u32>(GetBlockCompressedSize(block_num));
+  const bool uncompressed = (m_block_pointers[block_num] & (1ULL << 63)) != 0;
+
+  if (uncompressed && comp_block_size != m_header.block_size)
+    ERROR_LOG_FMT(DISCIO, "Uncompressed block with wrong size");
+
   // First, check hash.
-  const u32 block_hash = Common::HashAdler32(m_zlib_buffer.data(), comp_block_size);
+  const u32 block_hash = Common::HashAdler32(in_ptr, comp_block_size);
   if (block_hash != m_hashes[block_num])
   {
     ERROR_LOG_FMT(DISCIO,
@@ -124,12 +280,12 @@ bool CompressedBlobReader::GetBlock(u64 block_num, u8* out_ptr)
 
   if (uncompressed)
   {
-    std::copy(m_zlib_buffer.begin(), m_zlib_buffer.begin() + comp_block_size, out_ptr);
+    std::copy(in_ptr, in_ptr + comp_block_size, out_ptr);
   }
   else
   {
     z_stream z = {};
-    z.next_in = m_zlib_buffer.data();
+    z.next_in = const_cast<u8*>(in_ptr);
     z.avail_in = comp_block_size;
     if (z.avail_in > m_header.block_size)
     {
@@ -194,8 +350,7 @@ static ConversionResultCode SetUpCompressThreadState(CompressThreadState* state)
 
 static ConversionResult<OutputParameters> Compress(CompressThreadState* state,
                                                    CompressParameters parameters, int block_size,
-                                                   std::vector<u32>* hashes, int* num_stored,
-                                                   int* num_compressed)
+                                                   std::vector<u32>* hashes)
 {
   state->compressed_buffer.resize(block_size);
 
@@ -219,14 +374,12 @@ static ConversionResult<OutputParameters> Compress(CompressThreadState* state,
   if ((status != Z_STREAM_END) || (state->z.avail_out < 10))
   {
     // let's store uncompressed
-    ++*num_stored;
     output_parameters = OutputParameters{std::move(parameters.data), parameters.block_number, false,
                                          parameters.inpos};
   }
   else
   {
     // let's store compressed
-    ++*num_compressed;
     output_parameters = OutputParameters{std::move(state->compressed_buffer),
                                          parameters.block_number, true, parameters.inpos};
   }
@@ -239,8 +392,15 @@ static ConversionResult<OutputParameters> Compress(CompressThreadState* state,
 
 static ConversionResultCode Output(OutputParameters parameters, File::IOFile* outfile,
                                    u64* position, std::vector<u64>* offsets, int progress_monitor,
-                                   u32 num_blocks, CompressCB callback)
+                                   u32 num_blocks, int* num_stored, int* num_compressed,
+                                   CompressCB callback)
 {
+  // This runs on the output thread only, unlike Compress
+  if (parameters.compressed)
+    ++*num_compressed;
+  else
+    ++*num_stored;
+
   u64 offset = *position;
   if (!parameters.compressed)
     offset |= 0x8000000000000000ULL;
@@ -312,13 +472,12 @@ bool ConvertToGCZ(BlobReader* infile, const std::string& infile_path,
   int progress_monitor = std::max<int>(1, header.num_blocks / 1000);
 
   const auto compress = [&](CompressThreadState* state, CompressParameters parameters) {
-    return Compress(state, std::move(parameters), block_size, &hashes, &num_stored,
-                    &num_compressed);
+    return Compress(state, std::move(parameters), block_size, &hashes);
   };
 
   const auto output = [&](OutputParameters parameters) {
     return Output(std::move(parameters), &outfile, &position, &offsets, progress_monitor,
-                  header.num_blocks, callback);
+                  header.num_blocks, &num_stored, &num_compressed, callback);
   };
 
   MultithreadedCompressor<CompressThreadState, CompressParameters, OutputParameters> compressor(
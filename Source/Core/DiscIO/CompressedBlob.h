@@ -12,12 +12,17 @@
 
 #pragma once
 
+#include <atomic>
+#include <condition_variable>
+#include <limits>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
 #include "Common/CommonTypes.h"
 #include "Common/IOFile.h"
+#include "Common/WorkQueueThread.h"
 #include "DiscIO/Blob.h"
 
 namespace DiscIO
@@ -61,10 +66,35 @@ public:
 
   u64 GetBlockCompressedSize(u64 block_num) const;
   bool GetBlock(u64 block_num, u8* out_ptr) override;
+  bool ReadMultipleAlignedBlocks(u64 block_num, u64 num_blocks, u8* out_ptr) override;
 
 private:
+  // Consecutive blocks that are being decompressed by the reading thread and the workers together
+  struct DecompressionBatch
+  {
+    u64 first_block;
+    u64 num_blocks;
+    const u8* compressed_data;
+    u64 compressed_data_offset;
+    u8* out_ptr;
+
+    std::atomic<u64> next_block = 0;
+    std::atomic<bool> failed = false;
+
+    // The number of threads that may still access this batch. Protected by m_batch_mutex
+    u32 users = 0;
+  };
+
   CompressedBlobReader(File::IOFile file, const std::string& filename);
 
+  // The number of blocks that are decompressed in parallel when reading sequentially
+  u64 GetParallelBlockCount() const;
+  // Reads and decompresses a single block
+  bool ReadBlock(u64 block_num, u8* out_ptr);
+  bool DecompressBlock(u64 block_num, const u8* in_ptr, u8* out_ptr) const;
+  void DecompressBatchBlocks(DecompressionBatch* batch) const;
+  void ReleaseBatch(DecompressionBatch* batch);
+
   CompressedBlobHeader m_header;
   std::vector<u64> m_block_pointers;
   std::vector<u32> m_hashes;
@@ -73,6 +103,18 @@ private:
   u64 m_file_size;
   std::vector<u8> m_zlib_buffer;
   std::string m_file_name;
+
+  // Blocks that GetBlock decompressed along with an earlier block of a sequential read
+  std::vector<u8> m_read_ahead_buffer;
+  u64 m_read_ahead_first_block = 0;
+  u64 m_read_ahead_num_blocks = 0;
+  u64 m_next_sequential_block = std::numeric_limits<u64>::max();
+
+  // Created on the first read of more than one block
+  std::vector<std::unique_ptr<Common::WorkQueueThread<DecompressionBatch*>>> m_workers;
+  std::vector<u8> m_batch_buffer;
+  std::mutex m_batch_mutex;
+  std::condition_variable m_batch_released_cv;
 };
 
 }  // namespace DiscIO
@@ -143,6 +143,7 @@ public:
   // Size on disc (compressed size)
   virtual u64 GetRawSize() const = 0;
   virtual const BlobReader& GetBlobReader() const = 0;
+  virtual BlobReader& GetBlobReader() = 0;
 
   // This hash is intended to be (but is not guaranteed to be):
   // 1. Identical for discs with no differences that affect netplay/TAS sync
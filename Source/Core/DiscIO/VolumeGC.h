@@ -49,6 +49,7 @@ public:
   bool IsSizeAccurate() const override;
   u64 GetRawSize() const override;
   const BlobReader& GetBlobReader() const override;
+  BlobReader& GetBlobReader() override;
 
   std::array<u8, 20> GetSyncHash() const override;
 
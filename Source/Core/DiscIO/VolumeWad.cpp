@@ -343,6 +343,11 @@ const BlobReader& VolumeWAD::GetBlobReader() const
   return *m_reader;
 }
 
+BlobReader& VolumeWAD::GetBlobReader()
+{
+  return *m_reader;
+}
+
 std::array<u8, 20> VolumeWAD::GetSyncHash() const
 {
   // We can skip hashing the contents since the TMD contains hashes of the contents.
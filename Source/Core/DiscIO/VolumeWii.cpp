@@ -16,12 +16,13 @@
 #include <utility>
 #include <vector>
 
-#include <mbedtls/aes.h>
 #include <mbedtls/sha1.h>
 
 #include "Common/Align.h"
 #include "Common/Assert.h"
 #include "Common/CommonTypes.h"
+#include "Common/Crypto/AES.h"
+#include "Common/Crypto/SHA1.h"
 #include "Common/Logging/Log.h"
 #include "Common/Swap.h"
 
@@ -124,14 +125,11 @@ VolumeWii::VolumeWii(std::unique_ptr<BlobReader> reader)
         return h3_table;
       };
 
-      auto get_key = [this, partition]() -> std::unique_ptr<mbedtls_aes_context> {
+      auto get_key = [this, partition]() -> std::unique_ptr<Common::AES::Context> {
         const IOS::ES::TicketReader& ticket = *m_partitions[partition].ticket;
         if (!ticket.IsValid())
           return nullptr;
-        const std::array<u8, AES_KEY_SIZE> key = ticket.GetTitleKey();
-        std::unique_ptr<mbedtls_aes_context> aes_context = std::make_unique<mbedtls_aes_context>();
-        mbedtls_aes_setkey_dec(aes_context.get(), key.data(), 128);
-        return aes_context;
+        return Common::AES::CreateContextDecrypt(ticket.GetTitleKey().data());
       };
 
       auto get_file_system = [this, partition]() -> std::unique_ptr<FileSystem> {
@@ -144,7 +142,7 @@ VolumeWii::VolumeWii(std::unique_ptr<BlobReader> reader)
       };
 
       m_partitions.emplace(
-          partition, PartitionDetails{Common::Lazy<std::unique_ptr<mbedtls_aes_context>>(get_key),
+          partition, PartitionDetails{Common::Lazy<std::unique_ptr<Common::AES::Context>>(get_key),
                                       Common::Lazy<IOS::ES::TicketReader>(get_ticket),
                                       Common::Lazy<IOS::ES::TMDReader>(get_tmd),
                                       Common::Lazy<std::vector<u8>>(get_cert_chain),
@@ -179,7 +177,7 @@ bool VolumeWii::Read(u64 offset, u64 length, u8* buffer, const Partition& partit
                           buffer);
   }
 
-  mbedtls_aes_context* aes_context = partition_details.key->get();
+  const Common::AES::Context* aes_context = partition_details.key->get();
   if (!aes_context)
     return false;
 
@@ -198,7 +196,7 @@ bool VolumeWii::Read(u64 offset, u64 length, u8* buffer, const Partition& partit
         return false;
 
       // Decrypt the block's data
-      DecryptBlockData(read_buffer.data(), m_last_decrypted_block_data, aes_context);
+      DecryptBlockData(read_buffer.data(), m_last_decrypted_block_data, *aes_context);
       m_last_decrypted_block = block_offset_on_disc;
     }
 
@@ -360,6 +358,11 @@ const BlobReader& VolumeWii::GetBlobReader() const
   return *m_reader;
 }
 
+BlobReader& VolumeWii::GetBlobReader()
+{
+  return *m_reader;
+}
+
 std::array<u8, 20> VolumeWii::GetSyncHash() const
 {
   mbedtls_sha1_context context;
@@ -406,9 +409,7 @@ bool VolumeWii::CheckH3TableIntegrity(const Partition& partition) const
   if (contents.size() != 1)
     return false;
 
-  std::array<u8, 20> h3_table_sha1;
-  mbedtls_sha1_ret(h3_table.data(), h3_table.size(), h3_table_sha1.data());
-  return h3_table_sha1 == contents[0].sha1;
+  return Common::SHA1::CalculateDigest(h3_table.data(), h3_table.size()) == contents[0].sha1;
 }
 
 bool VolumeWii::CheckBlockIntegrity(u64 block_index, const u8* encrypted_data,
@@ -422,38 +423,37 @@ bool VolumeWii::CheckBlockIntegrity(u64 block_index, const u8* encrypted_data,
   if (block_index / BLOCKS_PER_GROUP * SHA1_SIZE >= partition_details.h3_table->size())
     return false;
 
-  mbedtls_aes_context* aes_context = partition_details.key->get();
+  const Common::AES::Context* aes_context = partition_details.key->get();
   if (!aes_context)
     return false;
 
   HashBlock hashes;
-  DecryptBlockHashes(encrypted_data, &hashes, aes_context);
+  DecryptBlockHashes(encrypted_data, &hashes, *aes_context);
 
   u8 cluster_data[BLOCK_DATA_SIZE];
-  DecryptBlockData(encrypted_data, cluster_data, aes_context);
+  DecryptBlockData(encrypted_data, cluster_data, *aes_context);
 
   for (u32 hash_index = 0; hash_index < 31; ++hash_index)
   {
-    u8 h0_hash[SHA1_SIZE];
-    mbedtls_sha1_ret(cluster_data + hash_index * 0x400, 0x400, h0_hash);
-    if (memcmp(h0_hash, hashes.h0[hash_index], SHA1_SIZE))
+    const auto h0_hash = Common::SHA1::CalculateDigest(cluster_data + hash_index * 0x400, 0x400);
+    if (memcmp(h0_hash.data(), hashes.h0[hash_index], SHA1_SIZE))
       return false;
   }
 
-  u8 h1_hash[SHA1_SIZE];
-  mbedtls_sha1_ret(reinterpret_cast<u8*>(hashes.h0), sizeof(hashes.h0), h1_hash);
-  if (memcmp(h1_hash, hashes.h1[block_index % 8], SHA1_SIZE))
+  const auto h1_hash = Common::SHA1::CalculateDigest(hashes.h0, sizeof(hashes.h0));
+  if (memcmp(h1_hash.data(), hashes.h1[block_index % 8], SHA1_SIZE))
     return false;
 
-  u8 h2_hash[SHA1_SIZE];
-  mbedtls_sha1_ret(reinterpret_cast<u8*>(hashes.h1), sizeof(hashes.h1), h2_hash);
-  if (memcmp(h2_hash, hashes.h2[block_index / 8 % 8], SHA1_SIZE))
+  const auto h2_hash = Common::SHA1::CalculateDigest(hashes.h1, sizeof(hashes.h1));
+  if (memcmp(h2_hash.data(), hashes.h2[block_index / 8 % 8], SHA1_SIZE))
     return false;
 
-  u8 h3_hash[SHA1_SIZE];
-  mbedtls_sha1_ret(reinterpret_cast<u8*>(hashes.h2), sizeof(hashes.h2), h3_hash);
-  if (memcmp(h3_hash, partition_details.h3_table->data() + block_index / 64 * SHA1_SIZE, SHA1_SIZE))
+  const auto h3_hash = Common::SHA1::CalculateDigest(hashes.h2, sizeof(hashes.h2));
+  if (memcmp(h3_hash.data(), partition_details.h3_table->data() + block_index / 64 * SHA1_SIZE,
+             SHA1_SIZE))
+  {
     return false;
+  }
 
   return true;
 }
@@ -492,14 +492,17 @@ bool VolumeWii::HashGroup(const std::array<u8, BLOCK_DATA_SIZE> in[BLOCKS_PER_GR
       {
         // H0 hashes
         for (size_t j = 0; j < 31; ++j)
-          mbedtls_sha1_ret(in[i].data() + j * 0x400, 0x400, out[i].h0[j]);
+        {
+          const auto h0_hash = Common::SHA1::CalculateDigest(in[i].data() + j * 0x400, 0x400);
+          std::memcpy(out[i].h0[j], h0_hash.data(), SHA1_SIZE);
+        }
 
         // H0 padding
         std::memset(out[i].padding_0, 0, sizeof(HashBlock::padding_0));
 
         // H1 hash
-        mbedtls_sha1_ret(reinterpret_cast<u8*>(out[i].h0), sizeof(HashBlock::h0),
-                         out[h1_base].h1[i - h1_base]);
+        const auto h1_hash = Common::SHA1::CalculateDigest(out[i].h0, sizeof(HashBlock::h0));
+        std::memcpy(out[h1_base].h1[i - h1_base], h1_hash.data(), SHA1_SIZE);
       }
 
       if (i % 8 == 7)
@@ -517,8 +520,8 @@ bool VolumeWii::HashGroup(const std::array<u8, BLOCK_DATA_SIZE> in[BLOCKS_PER_GR
             std::memcpy(out[h1_base + j].h1, out[h1_base].h1, sizeof(HashBlock::h1));
 
           // H2 hash
-          mbedtls_sha1_ret(reinterpret_cast<u8*>(out[i].h1), sizeof(HashBlock::h1),
-                           out[0].h2[h1_base / 8]);
+          const auto h2_hash = Common::SHA1::CalculateDigest(out[i].h1, sizeof(HashBlock::h1));
+          std::memcpy(out[0].h2[h1_base / 8], h2_hash.data(), SHA1_SIZE);
         }
 
         if (i == BLOCKS_PER_GROUP - 1)
@@ -548,7 +551,7 @@ bool VolumeWii::HashGroup(const std::array<u8, BLOCK_DATA_SIZE> in[BLOCKS_PER_GR
 
 bool VolumeWii::EncryptGroup(
     u64 offset, u64 partition_data_offset, u64 partition_data_decrypted_size,
-    const std::array<u8, AES_KEY_SIZE>& key, BlobReader* blob,
+    const Common::AES::Context& aes_context, BlobReader* blob,
     std::array<u8, GROUP_TOTAL_SIZE>* out,
     const std::function<void(HashBlock hash_blocks[BLOCKS_PER_GROUP])>& hash_exception_callback)
 {
@@ -583,9 +586,6 @@ bool VolumeWii::EncryptGroup(
 
   std::vector<std::future<void>> encryption_futures(threads);
 
-  mbedtls_aes_context aes_context;
-  mbedtls_aes_setkey_enc(&aes_context, key.data(), 128);
-
   for (size_t i = 0; i < threads; ++i)
   {
     encryption_futures[i] = std::async(
@@ -595,13 +595,10 @@ bool VolumeWii::EncryptGroup(
           {
             u8* out_ptr = out->data() + j * BLOCK_TOTAL_SIZE;
 
-            u8 iv[16] = {};
-            mbedtls_aes_crypt_cbc(&aes_context, MBEDTLS_AES_ENCRYPT, BLOCK_HEADER_SIZE, iv,
-                                  reinterpret_cast<u8*>(&unencrypted_hashes[j]), out_ptr);
-
-            std::memcpy(iv, out_ptr + 0x3D0, sizeof(iv));
-            mbedtls_aes_crypt_cbc(&aes_context, MBEDTLS_AES_ENCRYPT, BLOCK_DATA_SIZE, iv,
-                                  unencrypted_data[j].data(), out_ptr + BLOCK_HEADER_SIZE);
+            aes_context.CryptIvZero(reinterpret_cast<u8*>(&unencrypted_hashes[j]), out_ptr,
+                                    BLOCK_HEADER_SIZE);
+            aes_context.Crypt(out_ptr + 0x3D0, unencrypted_data[j].data(),
+                              out_ptr + BLOCK_HEADER_SIZE, BLOCK_DATA_SIZE);
           }
         },
         i * BLOCKS_PER_GROUP / threads, (i + 1) * BLOCKS_PER_GROUP / threads);
@@ -613,20 +610,15 @@ bool VolumeWii::EncryptGroup(
   return true;
 }
 
-void VolumeWii::DecryptBlockHashes(const u8* in, HashBlock* out, mbedtls_aes_context* aes_context)
+void VolumeWii::DecryptBlockHashes(const u8* in, HashBlock* out,
+                                   const Common::AES::Context& aes_context)
 {
-  std::array<u8, 16> iv;
-  iv.fill(0);
-  mbedtls_aes_crypt_cbc(aes_context, MBEDTLS_AES_DECRYPT, sizeof(HashBlock), iv.data(), in,
-                        reinterpret_cast<u8*>(out));
+  aes_context.CryptIvZero(in, reinterpret_cast<u8*>(out), sizeof(HashBlock));
 }
 
-void VolumeWii::DecryptBlockData(const u8* in, u8* out, mbedtls_aes_context* aes_context)
+void VolumeWii::DecryptBlockData(const u8* in, u8* out, const Common::AES::Context& aes_context)
 {
-  std::array<u8, 16> iv;
-  std::copy(&in[0x3d0], &in[0x3e0], iv.data());
-  mbedtls_aes_crypt_cbc(aes_context, MBEDTLS_AES_DECRYPT, BLOCK_DATA_SIZE, iv.data(),
-                        &in[BLOCK_HEADER_SIZE], out);
+  aes_context.Crypt(&in[0x3d0], &in[BLOCK_HEADER_SIZE], out, BLOCK_DATA_SIZE);
 }
 
 }  // namespace DiscIO
@@ -11,9 +11,8 @@
 #include <string>
 #include <vector>
 
-#include <mbedtls/aes.h>
-
 #include "Common/CommonTypes.h"
+#include "Common/Crypto/AES.h"
 #include "Common/Lazy.h"
 #include "Core/IOS/ES/Formats.h"
 #include "DiscIO/Filesystem.h"
@@ -91,6 +90,7 @@ public:
   bool IsSizeAccurate() const override;
   u64 GetRawSize() const override;
   const BlobReader& GetBlobReader() const override;
+  BlobReader& GetBlobReader() override;
   std::array<u8, 20> GetSyncHash() const override;
 
   // The in parameter can either contain all the data to begin with,
@@ -102,13 +102,14 @@ public:
                         const std::function<bool(size_t block)>& read_function = {});
 
   static bool EncryptGroup(u64 offset, u64 partition_data_offset, u64 partition_data_decrypted_size,
-                           const std::array<u8, AES_KEY_SIZE>& key, BlobReader* blob,
+                           const Common::AES::Context& aes_context, BlobReader* blob,
                            std::array<u8, GROUP_TOTAL_SIZE>* out,
                            const std::function<void(HashBlock hash_blocks[BLOCKS_PER_GROUP])>&
                                hash_exception_callback = {});
 
-  static void DecryptBlockHashes(const u8* in, HashBlock* out, mbedtls_aes_context* aes_context);
-  static void DecryptBlockData(const u8* in, u8* out, mbedtls_aes_context* aes_context);
+  static void DecryptBlockHashes(const u8* in, HashBlock* out,
+                                 const Common::AES::Context& aes_context);
+  static void DecryptBlockData(const u8* in, u8* out, const Common::AES::Context& aes_context);
 
 protected:
   u32 GetOffsetShift() const override { return 2; }
@@ -116,7 +117,7 @@ protected:
 private:
   struct PartitionDetails
   {
-    Common::Lazy<std::unique_ptr<mbedtls_aes_context>> key;
+    Common::Lazy<std::unique_ptr<Common::AES::Context>> key;
     Common::Lazy<IOS::ES::TicketReader> ticket;
     Common::Lazy<IOS::ES::TMDReader> tmd;
     Common::Lazy<std::vector<u8>> cert_chain;
@@ -15,12 +15,13 @@
 #include <utility>
 
 #include <fmt/format.h>
-#include <mbedtls/sha1.h>
 #include <zstd.h>
 
 #include "Common/Align.h"
 #include "Common/Assert.h"
 #include "Common/CommonTypes.h"
+#include "Common/Crypto/AES.h"
+#include "Common/Crypto/SHA1.h"
 #include "Common/FileUtil.h"
 #include "Common/IOFile.h"
 #include "Common/Logging/Log.h"
@@ -76,13 +77,19 @@ std::pair<int, int> GetAllowedCompressionLevels(WIARVZCompressionType compressio
 
 template <bool RVZ>
 WIARVZFileReader<RVZ>::WIARVZFileReader(File::IOFile file, const std::string& path)
-    : m_file(std::move(file)), m_encryption_cache(this)
+    : m_file(std::move(file)), m_path(path), m_encryption_cache(this)
 {
+  m_recent_group_indices.fill(std::numeric_limits<u64>::max());
   m_valid = Initialize(path);
 }
 
 template <bool RVZ>
-WIARVZFileReader<RVZ>::~WIARVZFileReader() = default;
+WIARVZFileReader<RVZ>::~WIARVZFileReader()
+{
+  // The workers access the members of this object, so they must be stopped first
+  for (std::unique_ptr<ReadAheadWorker>& worker : m_read_ahead_workers)
+    worker->thread.Cancel();
+}
 
 template <bool RVZ>
 bool WIARVZFileReader<RVZ>::Initialize(const std::string& path)
@@ -106,9 +113,8 @@ bool WIARVZFileReader<RVZ>::Initialize(const std::string& path)
     return false;
   }
 
-  SHA1 header_1_actual_hash;
-  mbedtls_sha1_ret(reinterpret_cast<const u8*>(&m_header_1), sizeof(m_header_1) - sizeof(SHA1),
-                   header_1_actual_hash.data());
+  const SHA1 header_1_actual_hash =
+      Common::SHA1::CalculateDigest(&m_header_1, sizeof(m_header_1) - sizeof(SHA1));
   if (m_header_1.header_1_hash != header_1_actual_hash)
     return false;
 
@@ -127,8 +133,8 @@ bool WIARVZFileReader<RVZ>::Initialize(const std::string& path)
   if (!m_file.ReadBytes(header_2.data(), header_2.size()))
     return false;
 
-  SHA1 header_2_actual_hash;
-  mbedtls_sha1_ret(header_2.data(), header_2.size(), header_2_actual_hash.data());
+  const SHA1 header_2_actual_hash =
+      Common::SHA1::CalculateDigest(header_2.data(), header_2.size());
   if (m_header_1.header_2_hash != header_2_actual_hash)
     return false;
 
@@ -165,9 +171,8 @@ bool WIARVZFileReader<RVZ>::Initialize(const std::string& path)
   if (!m_file.ReadBytes(partition_entries.data(), partition_entries.size()))
     return false;
 
-  SHA1 partition_entries_actual_hash;
-  mbedtls_sha1_ret(reinterpret_cast<const u8*>(partition_entries.data()), partition_entries.size(),
-                   partition_entries_actual_hash.data());
+  const SHA1 partition_entries_actual_hash =
+      Common::SHA1::CalculateDigest(partition_entries.data(), partition_entries.size());
   if (m_header_2.partition_entries_hash != partition_entries_actual_hash)
     return false;
 
@@ -208,9 +213,9 @@ bool WIARVZFileReader<RVZ>::Initialize(const std::string& path)
   const u32 number_of_raw_data_entries = Common::swap32(m_header_2.number_of_raw_data_entries);
   m_raw_data_entries.resize(number_of_raw_data_entries);
   Chunk& raw_data_entries =
-      ReadCompressedData(Common::swap64(m_header_2.raw_data_entries_offset),
-                         Common::swap32(m_header_2.raw_data_entries_size),
-                         number_of_raw_data_entries * sizeof(RawDataEntry), m_compression_type);
+      ReadCompressedData({Common::swap64(m_header_2.raw_data_entries_offset),
+                          Common::swap32(m_header_2.raw_data_entries_size),
+                          number_of_raw_data_entries * sizeof(RawDataEntry), m_compression_type});
   if (!raw_data_entries.ReadAll(&m_raw_data_entries))
     return false;
 
@@ -225,9 +230,9 @@ bool WIARVZFileReader<RVZ>::Initialize(const std::string& path)
   const u32 number_of_group_entries = Common::swap32(m_header_2.number_of_group_entries);
   m_group_entries.resize(number_of_group_entries);
   Chunk& group_entries =
-      ReadCompressedData(Common::swap64(m_header_2.group_entries_offset),
-                         Common::swap32(m_header_2.group_entries_size),
-                         number_of_group_entries * sizeof(GroupEntry), m_compression_type);
+      ReadCompressedData({Common::swap64(m_header_2.group_entries_offset),
+                          Common::swap32(m_header_2.group_entries_size),
+                          number_of_group_entries * sizeof(GroupEntry), m_compression_type});
   if (!group_entries.ReadAll(&m_group_entries))
     return false;
 
@@ -495,6 +500,8 @@ bool WIARVZFileReader<RVZ>::ReadFromGroups(u64* offset, u64* size, u8** out_ptr,
   data_offset -= skipped_data;
   data_size += skipped_data;
 
+  const u64 full_chunk_size = chunk_size;
+
   const u64 start_group_index = (*offset - data_offset) / chunk_size;
   for (u64 i = start_group_index; i < number_of_groups && (*size) > 0; ++i)
   {
@@ -502,42 +509,27 @@ bool WIARVZFileReader<RVZ>::ReadFromGroups(u64* offset, u64* size, u8** out_ptr,
     if (total_group_index >= m_group_entries.size())
       return false;
 
-    const GroupEntry group = m_group_entries[total_group_index];
     const u64 group_offset_in_data = i * chunk_size;
     const u64 offset_in_group = *offset - group_offset_in_data - data_offset;
 
     chunk_size = std::min(chunk_size, data_size - group_offset_in_data);
 
     const u64 bytes_to_read = std::min(chunk_size - offset_in_group, *size);
-    u32 group_data_size = Common::swap32(group.data_size);
-
-    WIARVZCompressionType compression_type = m_compression_type;
-    u32 rvz_packed_size = 0;
-    if constexpr (RVZ)
-    {
-      if ((group_data_size & 0x80000000) == 0)
-        compression_type = WIARVZCompressionType::None;
 
-      group_data_size &= 0x7FFFFFFF;
-
-      rvz_packed_size = Common::swap32(group.rvz_packed_size);
-    }
+    const std::optional<ChunkLocation> location = GetGroupChunkLocation(
+        total_group_index, group_offset_in_data, chunk_size, exception_lists);
 
-    if (group_data_size == 0)
+    if (!location)
     {
       std::memset(*out_ptr, 0, bytes_to_read);
     }
     else
     {
-      const u64 group_offset_in_file = static_cast<u64>(Common::swap32(group.data_offset)) << 2;
-
-      Chunk& chunk =
-          ReadCompressedData(group_offset_in_file, group_data_size, chunk_size, compression_type,
-                             exception_lists, rvz_packed_size, group_offset_in_data);
+      Chunk& chunk = ReadCompressedData(*location);
 
       if (!chunk.Read(offset_in_group, bytes_to_read, *out_ptr))
       {
-        m_cached_chunk_offset = std::numeric_limits<u64>::max();  // Invalidate the cache
+        EvictChunk(location->offset_in_file);
         return false;
       }
 
@@ -552,6 +544,19 @@ bool WIARVZFileReader<RVZ>::ReadFromGroups(u64* offset, u64* size, u8** out_ptr,
       }
     }
 
+    if (std::find(m_recent_group_indices.begin(), m_recent_group_indices.end(),
+                  total_group_index) == m_recent_group_indices.end())
+    {
+      if (IsSequentialRead(total_group_index))
+      {
+        QueueReadAhead(i, full_chunk_size, data_offset, data_size, group_index, number_of_groups,
+                       exception_lists);
+      }
+
+      m_recent_group_indices[m_next_recent_group_index] = total_group_index;
+      m_next_recent_group_index = (m_next_recent_group_index + 1) % m_recent_group_indices.size();
+    }
+
     *offset += bytes_to_read;
     *size -= bytes_to_read;
     *out_ptr += bytes_to_read;
@@ -560,25 +565,65 @@ bool WIARVZFileReader<RVZ>::ReadFromGroups(u64* offset, u64* size, u8** out_ptr,
   return true;
 }
 
+template <bool RVZ>
+std::optional<typename WIARVZFileReader<RVZ>::ChunkLocation>
+WIARVZFileReader<RVZ>::GetGroupChunkLocation(u64 total_group_index, u64 group_offset_in_data,
+                                             u64 decompressed_size, u32 exception_lists) const
+{
+  const GroupEntry group = m_group_entries[total_group_index];
+  u32 group_data_size = Common::swap32(group.data_size);
+
+  WIARVZCompressionType compression_type = m_compression_type;
+  u32 rvz_packed_size = 0;
+  if constexpr (RVZ)
+  {
+    if ((group_data_size & 0x80000000) == 0)
+      compression_type = WIARVZCompressionType::None;
+
+    group_data_size &= 0x7FFFFFFF;
+
+    rvz_packed_size = Common::swap32(group.rvz_packed_size);
+  }
+
+  if (group_data_size == 0)
+    return std::nullopt;
+
+  const u64 group_offset_in_file = static_cast<u64>(Common::swap32(group.data_offset)) << 2;
+
+  return ChunkLocation{group_offset_in_file, group_data_size, decompressed_size,
+                       compression_type,     exception_lists, rvz_packed_size,
+                       group_offset_in_data};
+}
+
 template <bool RVZ>
 typename WIARVZFileReader<RVZ>::Chunk&
-WIARVZFileReader<RVZ>::ReadCompressedData(u64 offset_in_file, u64 compressed_size,
-                                          u64 decompressed_size,
-                                          WIARVZCompressionType compression_type,
-                                          u32 exception_lists, u32 rvz_packed_size, u64 data_offset)
+WIARVZFileReader<RVZ>::ReadCompressedData(const ChunkLocation& location)
 {
-  if (offset_in_file == m_cached_chunk_offset)
-    return m_cached_chunk;
+  TakeReadAheadChunks(location.offset_in_file);
 
+  const auto it = m_cached_chunk_map.find(location.offset_in_file);
+  if (it != m_cached_chunk_map.end())
+  {
+    m_cached_chunks.splice(m_cached_chunks.begin(), m_cached_chunks, it->second);
+    return it->second->second;
+  }
+
+  return CacheChunk(location.offset_in_file, CreateChunk(&m_file, location));
+}
+
+template <bool RVZ>
+typename WIARVZFileReader<RVZ>::Chunk
+WIARVZFileReader<RVZ>::CreateChunk(File::IOFile* file, const ChunkLocation& location) const
+{
   std::unique_ptr<Decompressor> decompressor;
-  switch (compression_type)
+  switch (location.compression_type)
   {
   case WIARVZCompressionType::None:
     decompressor = std::make_unique<NoneDecompressor>();
     break;
   case WIARVZCompressionType::Purge:
-    decompressor = std::make_unique<PurgeDecompressor>(rvz_packed_size == 0 ? decompressed_size :
-                                                                              rvz_packed_size);
+    decompressor = std::make_unique<PurgeDecompressor>(
+        location.rvz_packed_size == 0 ? location.decompressed_size : location.rvz_packed_size);
     break;
   case WIARVZCompressionType::Bzip2:
     decompressor = std::make_unique<Bzip2Decompressor>();
@@ -596,13 +641,166 @@ WIARVZFileReader<RVZ>::ReadCompressedData(u64 offset_in_file, u64 compressed_siz
     break;
   }
 
-  const bool compressed_exception_lists = compression_type > WIARVZCompressionType::Purge;
+  const bool compressed_exception_lists =
+      location.compression_type > WIARVZCompressionType::Purge;
+
+  return Chunk(file, location.offset_in_file, location.compressed_size, location.decompressed_size,
+               location.exception_lists, compressed_exception_lists, location.rvz_packed_size,
+               location.data_offset, std::move(decompressor));
+}
+
+template <bool RVZ>
+typename WIARVZFileReader<RVZ>::Chunk& WIARVZFileReader<RVZ>::CacheChunk(u64 offset_in_file,
+                                                                         Chunk chunk)
+{
+  EvictChunk(offset_in_file);
+
+  m_cached_chunks_memory_usage += chunk.GetMemoryUsage();
+  m_cached_chunks.emplace_front(offset_in_file, std::move(chunk));
+  m_cached_chunk_map.emplace(offset_in_file, m_cached_chunks.begin());
+
+  const u64 cache_size = GetDecompressedCacheSize();
+  while (m_cached_chunks.size() > 1 && m_cached_chunks_memory_usage > cache_size)
+    EvictChunk(m_cached_chunks.back().first);
 
-  m_cached_chunk =
-      Chunk(&m_file, offset_in_file, compressed_size, decompressed_size, exception_lists,
-            compressed_exception_lists, rvz_packed_size, data_offset, std::move(decompressor));
-  m_cached_chunk_offset = offset_in_file;
-  return m_cached_chunk;
+  return m_cached_chunks.front().second;
+}
+
+template <bool RVZ>
+void WIARVZFileReader<RVZ>::EvictChunk(u64 offset_in_file)
+{
+  const auto it = m_cached_chunk_map.find(offset_in_file);
+  if (it == m_cached_chunk_map.end())
+    return;
+
+  m_cached_chunks_memory_usage -= it->second->second.GetMemoryUsage();
+  m_cached_chunks.erase(it->second);
+  m_cached_chunk_map.erase(it);
+}
+
+template <bool RVZ>
+bool WIARVZFileReader<RVZ>::IsSequentialRead(u64 total_group_index) const
+{
+  return total_group_index != 0 &&
+         std::find(m_recent_group_indices.begin(), m_recent_group_indices.end(),
+                   total_group_index - 1) != m_recent_group_indices.end();
+}
+
+template <bool RVZ>
+void WIARVZFileReader<RVZ>::QueueReadAhead(u64 i, u64 chunk_size, u64 data_offset, u64 data_size,
+                                           u32 group_index, u32 number_of_groups,
+                                           u32 exception_lists)
+{
+  constexpr size_t READ_AHEAD_WORKERS = 2;
+
+  const u64 read_ahead_blocks = GetReadAheadBlocks();
+  for (u64 j = i + 1; j < number_of_groups && j <= i + read_ahead_blocks; ++j)
+  {
+    const u64 total_group_index = group_index + j;
+    if (total_group_index >= m_group_entries.size())
+      return;
+
+    const u64 group_offset_in_data = j * chunk_size;
+    if (group_offset_in_data >= data_size)
+      return;
+
+    const std::optional<ChunkLocation> location =
+        GetGroupChunkLocation(total_group_index, group_offset_in_data,
+                              std::min(chunk_size, data_size - group_offset_in_data),
+                              exception_lists);
+    if (!location || m_cached_chunk_map.count(location->offset_in_file))
+      continue;
+
+    {
+      std::lock_guard lk(m_read_ahead_mutex);
+      if (m_read_ahead_pending.count(location->offset_in_file) ||
+          m_read_ahead_done.count(location->offset_in_file))
+      {
+        continue;
+      }
+      m_read_ahead_pending.emplace(location->offset_in_file, false);
+    }
+
+    if (m_read_ahead_workers.size() < READ_AHEAD_WORKERS)
+    {
+      auto worker = std::make_unique<ReadAheadWorker>();
+      ReadAheadWorker* worker_ptr = worker.get();
+      worker->thread.Reset([this, worker_ptr](ChunkLocation chunk_location) {
+        ReadAheadChunk(worker_ptr, chunk_location);
+      });
+      m_read_ahead_workers.push_back(std::move(worker));
+    }
+
+    m_read_ahead_workers[m_next_read_ahead_worker]->thread.EmplaceItem(*location);
+    m_next_read_ahead_worker = (m_next_read_ahead_worker + 1) % READ_AHEAD_WORKERS;
+  }
+}
+
+template <bool RVZ>
+void WIARVZFileReader<RVZ>::ReadAheadChunk(ReadAheadWorker* worker, const ChunkLocation& location)
+{
+  {
+    std::lock_guard lk(m_read_ahead_mutex);
+    const auto it = m_read_ahead_pending.find(location.offset_in_file);
+
+    // The reader has already taken over this chunk
+    if (it == m_read_ahead_pending.end())
+      return;
+
+    it->second = true;
+  }
+
+  // Each worker has its own file handle so that it doesn't have to share the seek position
+  if (!worker->file.IsOpen())
+    worker->file.Open(m_path, "rb");
+
+  Chunk chunk = CreateChunk(&worker->file, location);
+  const bool success = chunk.DecompressAll();
+
+  {
+    std::lock_guard lk(m_read_ahead_mutex);
+    m_read_ahead_pending.erase(location.offset_in_file);
+    if (success)
+      m_read_ahead_done.emplace(location.offset_in_file, std::move(chunk));
+  }
+  m_read_ahead_done_cv.notify_all();
+}
+
+template <bool RVZ>
+void WIARVZFileReader<RVZ>::TakeReadAheadChunks(u64 offset_in_file)
+{
+  std::map<u64, Chunk> done_chunks;
+  {
+    std::unique_lock lk(m_read_ahead_mutex);
+
+    const auto pending_it = m_read_ahead_pending.find(offset_in_file);
+    if (pending_it != m_read_ahead_pending.end())
+    {
+      // If no worker has started on the chunk yet, decompressing it here is faster than waiting
+      if (!pending_it->second)
+        m_read_ahead_pending.erase(pending_it);
+      else
+        m_read_ahead_done_cv.wait(lk, [&] { return !m_read_ahead_pending.count(offset_in_file); });
+    }
+
+    if (m_read_ahead_done.empty())
+      return;
+
+    done_chunks.swap(m_read_ahead_done);
+  }
+
+  // Add the requested chunk last so that caching the others can't evict it
+  std::optional<Chunk> requested_chunk;
+  for (auto& [chunk_offset, chunk] : done_chunks)
+  {
+    if (chunk_offset == offset_in_file)
+      requested_chunk = std::move(chunk);
+    else
+      CacheChunk(chunk_offset, std::move(chunk));
+  }
+
+  if (requested_chunk)
+    CacheChunk(offset_in_file, std::move(*requested_chunk));
 }
 
 template <bool RVZ>
@@ -752,6 +950,17 @@ bool WIARVZFileReader<RVZ>::Chunk::Read(u64 offset, u64 size, u8* out_ptr)
   return true;
 }
 
+template <bool RVZ>
+bool WIARVZFileReader<RVZ>::Chunk::DecompressAll()
+{
+  const size_t size = m_out.data.size() - m_out_bytes_allocated_for_exceptions;
+  if (size == 0)
+    return true;
+
+  u8 last_byte;
+  return Read(size - 1, 1, &last_byte);
+}
+
 template <bool RVZ>
 bool WIARVZFileReader<RVZ>::Chunk::Decompress()
 {
@@ -1320,8 +1529,8 @@ WIARVZFileReader<RVZ>::ProcessAndCompress(CompressThreadState* state, CompressPa
   {
     const PartitionEntry& partition_entry = partition_entries[parameters.data_entry->index];
 
-    mbedtls_aes_context aes_context;
-    mbedtls_aes_setkey_dec(&aes_context, partition_entry.partition_key.data(), 128);
+    const std::unique_ptr<Common::AES::Context> aes_context =
+        Common::AES::CreateContextDecrypt(partition_entry.partition_key.data());
 
     const u64 groups = Common::AlignUp(parameters.data.size(), VolumeWii::GROUP_TOTAL_SIZE) /
                        VolumeWii::GROUP_TOTAL_SIZE;
@@ -1390,7 +1599,7 @@ WIARVZFileReader<RVZ>::ProcessAndCompress(CompressThreadState* state, CompressPa
           {
             const u64 offset_of_block = offset_of_group + j * VolumeWii::BLOCK_TOTAL_SIZE;
             VolumeWii::DecryptBlockData(parameters.data.data() + offset_of_block,
-                                        state->decryption_buffer[j].data(), &aes_context);
+                                        state->decryption_buffer[j].data(), *aes_context);
           }
           else
           {
@@ -1415,7 +1624,7 @@ WIARVZFileReader<RVZ>::ProcessAndCompress(CompressThreadState* state, CompressPa
 
           VolumeWii::HashBlock hashes;
           VolumeWii::DecryptBlockHashes(parameters.data.data() + offset_of_block, &hashes,
-                                        &aes_context);
+                                        *aes_context);
 
           const auto compare_hash = [&](size_t offset_in_block) {
             ASSERT(offset_in_block + sizeof(SHA1) <= VolumeWii::BLOCK_HEADER_SIZE);
@@ -1993,9 +2202,9 @@ WIARVZFileReader<RVZ>::Convert(BlobReader* infile, const VolumeDisc* infile_volu
   header_2.partition_entries_offset = Common::swap64(partition_entries_offset);
 
   if (partition_entries.data() == nullptr)
-    partition_entries.reserve(1);  // Avoid a crash in mbedtls_sha1_ret
-  mbedtls_sha1_ret(reinterpret_cast<const u8*>(partition_entries.data()), partition_entries_size,
-                   header_2.partition_entries_hash.data());
+    partition_entries.reserve(1);  // Avoid passing a null pointer to CalculateDigest
+  header_2.partition_entries_hash =
+      Common::SHA1::CalculateDigest(partition_entries.data(), partition_entries_size);
 
   header_2.number_of_raw_data_entries = Common::swap32(static_cast<u32>(raw_data_entries.size()));
   header_2.raw_data_entries_offset = Common::swap64(raw_data_entries_offset);
@@ -2011,12 +2220,11 @@ WIARVZFileReader<RVZ>::Convert(BlobReader* infile, const VolumeDisc* infile_volu
   header_1.version_compatible =
       Common::swap32(RVZ ? RVZ_VERSION_WRITE_COMPATIBLE : WIA_VERSION_WRITE_COMPATIBLE);
   header_1.header_2_size = Common::swap32(sizeof(WIAHeader2));
-  mbedtls_sha1_ret(reinterpret_cast<const u8*>(&header_2), sizeof(header_2),
-                   header_1.header_2_hash.data());
+  header_1.header_2_hash = Common::SHA1::CalculateDigest(&header_2, sizeof(header_2));
   header_1.iso_file_size = Common::swap64(infile->GetDataSize());
   header_1.wia_file_size = Common::swap64(outfile->GetSize());
-  mbedtls_sha1_ret(reinterpret_cast<const u8*>(&header_1), offsetof(WIAHeader1, header_1_hash),
-                   header_1.header_1_hash.data());
+  header_1.header_1_hash =
+      Common::SHA1::CalculateDigest(&header_1, offsetof(WIAHeader1, header_1_hash));
 
   if (!outfile->Seek(0, SEEK_SET))
     return ConversionResultCode::WriteFailed;
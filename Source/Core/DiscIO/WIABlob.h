@@ -4,16 +4,23 @@
 #pragma once
 
 #include <array>
+#include <condition_variable>
 #include <limits>
+#include <list>
 #include <map>
 #include <memory>
 #include <mutex>
+#include <optional>
+#include <string>
 #include <type_traits>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "Common/CommonTypes.h"
 #include "Common/IOFile.h"
 #include "Common/Swap.h"
+#include "Common/WorkQueueThread.h"
 #include "DiscIO/Blob.h"
 #include "DiscIO/MultithreadedCompressor.h"
 #include "DiscIO/WIACompression.h"
@@ -186,6 +193,11 @@ private:
 
     bool Read(u64 offset, u64 size, u8* out_ptr);
 
+    // Decompresses the whole chunk, so that reading from it no longer accesses the file
+    bool DecompressAll();
+
+    size_t GetMemoryUsage() const { return m_in.data.size() + m_out.data.size(); }
+
     // This can only be called once at least one byte of data has been read
     void GetHashExceptions(std::vector<HashExceptionEntry>* exception_list,
                            u64 exception_list_index, u16 additional_offset) const;
@@ -220,6 +232,24 @@ private:
     u64 m_data_offset = 0;
   };
 
+  // Everything that's needed to read a chunk from the file
+  struct ChunkLocation
+  {
+    u64 offset_in_file;
+    u64 compressed_size;
+    u64 decompressed_size;
+    WIARVZCompressionType compression_type;
+    u32 exception_lists = 0;
+    u32 rvz_packed_size = 0;
+    u64 data_offset = 0;
+  };
+
+  struct ReadAheadWorker
+  {
+    File::IOFile file;
+    Common::WorkQueueThread<ChunkLocation> thread;
+  };
+
   explicit WIARVZFileReader(File::IOFile file, const std::string& path);
   bool Initialize(const std::string& path);
   bool HasDataOverlap() const;
@@ -229,9 +259,27 @@ private:
   bool ReadFromGroups(u64* offset, u64* size, u8** out_ptr, u64 chunk_size, u32 sector_size,
                       u64 data_offset, u64 data_size, u32 group_index, u32 number_of_groups,
                       u32 exception_lists);
-  Chunk& ReadCompressedData(u64 offset_in_file, u64 compressed_size, u64 decompressed_size,
-                            WIARVZCompressionType compression_type, u32 exception_lists = 0,
-                            u32 rvz_packed_size = 0, u64 data_offset = 0);
+  // Returns std::nullopt if the group contains only zeroes
+  std::optional<ChunkLocation> GetGroupChunkLocation(u64 total_group_index,
+                                                     u64 group_offset_in_data,
+                                                     u64 decompressed_size,
+                                                     u32 exception_lists) const;
+  Chunk& ReadCompressedData(const ChunkLocation& location);
+  Chunk CreateChunk(File::IOFile* file, const ChunkLocation& location) const;
+  Chunk& CacheChunk(u64 offset_in_file, Chunk chunk);
+  void EvictChunk(u64 offset_in_file);
+
+  // Returns whether one of the most recently read groups comes right before the given group
+  bool IsSequentialRead(u64 total_group_index) const;
+
+  // Queues the groups after the given group in the same data entry for decompression on the
+  // read-ahead workers.
+  void QueueReadAhead(u64 i, u64 chunk_size, u64 data_offset, u64 data_size, u32 group_index,
+                      u32 number_of_groups, u32 exception_lists);
+  void ReadAheadChunk(ReadAheadWorker* worker, const ChunkLocation& location);
+  // Moves the chunks that the workers have finished into the cache. If a worker is busy with the
+  // given chunk, this waits for it first.
+  void TakeReadAheadChunks(u64 offset_in_file);
 
   static bool ApplyHashExceptions(const std::vector<HashExceptionEntry>& exception_list,
                                   VolumeWii::HashBlock hash_blocks[VolumeWii::BLOCKS_PER_GROUP]);
@@ -242,10 +290,12 @@ private:
   {
     // This is a workaround for an ICE in Visual Studio 16.10.0 when making an ARM64 Release build.
     // Once the ICE has been fixed upstream, we can move partition_key inside the tie.
+    // The other members only decide the order when the partition keys are equal.
 #define COMPARE_TIED(op)                                                                           \
-  (partition_key op other.partition_key) &&                                                        \
-      std::tie(data_size, encrypted, value)                                                        \
-          op std::tie(other.data_size, other.encrypted, other.value)
+  (partition_key != other.partition_key ?                                                          \
+       partition_key op other.partition_key :                                                      \
+       std::tie(data_size, encrypted, value)                                                       \
+           op std::tie(other.data_size, other.encrypted, other.value))
 
     bool operator==(const ReuseID& other) const { return COMPARE_TIED(==); }
     bool operator<(const ReuseID& other) const { return COMPARE_TIED(<); }
@@ -355,8 +405,29 @@ private:
   WIARVZCompressionType m_compression_type;
 
   File::IOFile m_file;
-  Chunk m_cached_chunk;
-  u64 m_cached_chunk_offset = std::numeric_limits<u64>::max();
+  std::string m_path;
+
+  // Decompressed chunks by offset in the file, most recently used first. The size is limited by
+  // GetDecompressedCacheSize, but the most recently used chunk is always kept.
+  std::list<std::pair<u64, Chunk>> m_cached_chunks;
+  std::unordered_map<u64, typename std::list<std::pair<u64, Chunk>>::iterator> m_cached_chunk_map;
+  size_t m_cached_chunks_memory_usage = 0;
+
+  // Tracking a few groups lets reads of several files that are streamed at once (such as music
+  // and video) all count as sequential
+  std::array<u64, 4> m_recent_group_indices;
+  size_t m_next_recent_group_index = 0;
+
+  // Only the thread calling Read touches the cache above. The workers hand finished chunks over
+  // through m_read_ahead_done.
+  std::vector<std::unique_ptr<ReadAheadWorker>> m_read_ahead_workers;
+  size_t m_next_read_ahead_worker = 0;
+  std::mutex m_read_ahead_mutex;
+  std::condition_variable m_read_ahead_done_cv;
+  // Whether a worker has started on the chunk, by offset in the file
+  std::map<u64, bool> m_read_ahead_pending;
+  std::map<u64, Chunk> m_read_ahead_done;
+
   WiiEncryptionCache m_encryption_cache;
 
   std::vector<HashExceptionEntry> m_exception_list;
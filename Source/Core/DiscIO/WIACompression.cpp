@@ -13,11 +13,11 @@
 
 #include <bzlib.h>
 #include <lzma.h>
-#include <mbedtls/sha1.h>
 #include <zstd.h>
 
 #include "Common/Assert.h"
 #include "Common/CommonTypes.h"
+#include "Common/Crypto/SHA1.h"
 #include "Common/MathUtil.h"
 #include "Common/Swap.h"
 #include "DiscIO/LaggedFibonacciGenerator.h"
@@ -48,7 +48,6 @@ bool NoneDecompressor::Decompress(const DecompressionBuffer& in, DecompressionBu
 
 PurgeDecompressor::PurgeDecompressor(u64 decompressed_size) : m_decompressed_size(decompressed_size)
 {
-  mbedtls_sha1_init(&m_sha1_context);
 }
 
 bool PurgeDecompressor::Decompress(const DecompressionBuffer& in, DecompressionBuffer* out,
@@ -56,10 +55,10 @@ bool PurgeDecompressor::Decompress(const DecompressionBuffer& in, DecompressionB
 {
   if (!m_started)
   {
-    mbedtls_sha1_starts_ret(&m_sha1_context);
+    m_sha1_context = Common::SHA1::CreateContext();
 
     // Include the exception lists in the SHA-1 calculation (but not in the compression...)
-    mbedtls_sha1_update_ret(&m_sha1_context, in.data.data(), *in_bytes_read);
+    m_sha1_context->Update(in.data.data(), *in_bytes_read);
 
     m_started = true;
   }
@@ -79,8 +78,7 @@ bool PurgeDecompressor::Decompress(const DecompressionBuffer& in, DecompressionB
 
       if (m_out_bytes_written == m_decompressed_size && in.bytes_written == in.data.size())
       {
-        SHA1 actual_hash;
-        mbedtls_sha1_finish_ret(&m_sha1_context, actual_hash.data());
+        const SHA1 actual_hash = m_sha1_context->Finish();
 
         SHA1 expected_hash;
         std::memcpy(expected_hash.data(), in.data.data() + *in_bytes_read, expected_hash.size());
@@ -102,7 +100,7 @@ bool PurgeDecompressor::Decompress(const DecompressionBuffer& in, DecompressionB
 
       std::memcpy(reinterpret_cast<u8*>(&m_segment) + m_segment_bytes_written,
                   in.data.data() + *in_bytes_read, bytes_to_copy);
-      mbedtls_sha1_update_ret(&m_sha1_context, in.data.data() + *in_bytes_read, bytes_to_copy);
+      m_sha1_context->Update(in.data.data() + *in_bytes_read, bytes_to_copy);
 
       *in_bytes_read += bytes_to_copy;
       m_bytes_read += bytes_to_copy;
@@ -134,7 +132,7 @@ bool PurgeDecompressor::Decompress(const DecompressionBuffer& in, DecompressionB
 
       std::memcpy(out->data.data() + out->bytes_written, in.data.data() + *in_bytes_read,
                   bytes_to_copy);
-      mbedtls_sha1_update_ret(&m_sha1_context, in.data.data() + *in_bytes_read, bytes_to_copy);
+      m_sha1_context->Update(in.data.data() + *in_bytes_read, bytes_to_copy);
 
       *in_bytes_read += bytes_to_copy;
       m_bytes_read += bytes_to_copy;
@@ -435,10 +433,7 @@ bool RVZPackDecompressor::Done() const
 
 Compressor::~Compressor() = default;
 
-PurgeCompressor::PurgeCompressor()
-{
-  mbedtls_sha1_init(&m_sha1_context);
-}
+PurgeCompressor::PurgeCompressor() = default;
 
 PurgeCompressor::~PurgeCompressor() = default;
 
@@ -447,14 +442,14 @@ bool PurgeCompressor::Start(std::optional<u64> size)
   m_buffer.clear();
   m_bytes_written = 0;
 
-  mbedtls_sha1_starts_ret(&m_sha1_context);
+  m_sha1_context = Common::SHA1::CreateContext();
 
   return true;
 }
 
 bool PurgeCompressor::AddPrecedingDataOnlyForPurgeHashing(const u8* data, size_t size)
 {
-  mbedtls_sha1_update_ret(&m_sha1_context, data, size);
+  m_sha1_context->Update(data, size);
   return true;
 }
 
@@ -517,9 +512,10 @@ bool PurgeCompressor::Compress(const u8* data, size_t size)
 
 bool PurgeCompressor::End()
 {
-  mbedtls_sha1_update_ret(&m_sha1_context, m_buffer.data(), m_bytes_written);
+  m_sha1_context->Update(m_buffer.data(), m_bytes_written);
 
-  mbedtls_sha1_finish_ret(&m_sha1_context, m_buffer.data() + m_bytes_written);
+  const SHA1 hash = m_sha1_context->Finish();
+  std::memcpy(m_buffer.data() + m_bytes_written, hash.data(), hash.size());
   m_bytes_written += sizeof(SHA1);
 
   ASSERT(m_bytes_written <= m_buffer.size());
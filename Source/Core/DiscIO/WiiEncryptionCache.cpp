@@ -40,6 +40,12 @@ WiiEncryptionCache::EncryptGroup(u64 offset, u64 partition_data_offset,
 
   if (m_cached_offset != group_offset_on_disc)
   {
+    if (!m_aes_context || m_aes_context_key != key)
+    {
+      m_aes_context = Common::AES::CreateContextEncrypt(key.data());
+      m_aes_context_key = key;
+    }
+
     std::function<void(VolumeWii::HashBlock * hash_blocks)> hash_exception_callback_2;
 
     if (hash_exception_callback)
@@ -52,8 +58,8 @@ WiiEncryptionCache::EncryptGroup(u64 offset, u64 partition_data_offset,
     }
 
     if (!VolumeWii::EncryptGroup(group_offset_in_partition, partition_data_offset,
-                                 partition_data_decrypted_size, key, m_blob, m_cache.get(),
-                                 hash_exception_callback_2))
+                                 partition_data_decrypted_size, *m_aes_context, m_blob,
+                                 m_cache.get(), hash_exception_callback_2))
     {
       m_cached_offset = std::numeric_limits<u64>::max();  // Invalidate the cache
       return nullptr;
@@ -8,6 +8,7 @@
 #include <memory>
 
 #include "Common/CommonTypes.h"
+#include "Common/Crypto/AES.h"
 #include "DiscIO/VolumeWii.h"
 
 namespace DiscIO
@@ -51,6 +52,10 @@ private:
   BlobReader* m_blob;
   std::unique_ptr<std::array<u8, VolumeWii::GROUP_TOTAL_SIZE>> m_cache;
   u64 m_cached_offset;
+
+  // Expanding the key is only done when the key changes
+  std::unique_ptr<Common::AES::Context> m_aes_context;
+  Key m_aes_context_key;
 };
 
 }  // namespace DiscIO
@@ -0,0 +1,175 @@
+// Copyright 2021 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "DolphinNoGUI/DiscTraceReplay.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <numeric>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <picojson.h>
+
+#include "Common/CommonTypes.h"
+#include "Common/Config/Config.h"
+#include "Common/FileUtil.h"
+#include "Common/StringUtil.h"
+#include "Core/Config/MainSettings.h"
+#include "DiscIO/Blob.h"
+#include "DiscIO/BlockCache.h"
+#include "DiscIO/Volume.h"
+
+namespace DiscTraceReplay
+{
+namespace
+{
+struct TracedRead
+{
+  u64 time_us;
+  DiscIO::Partition partition;
+  u64 offset;
+  u64 length;
+};
+
+std::optional<std::vector<TracedRead>> LoadTrace(const std::string& path)
+{
+  std::string contents;
+  if (!File::ReadFileToString(path, contents))
+    return std::nullopt;
+
+  std::vector<TracedRead> reads;
+  for (const std::string& line : SplitString(contents, '\n'))
+  {
+    if (line.empty())
+      continue;
+
+    const std::vector<std::string> fields = SplitString(line, ' ');
+    if (fields.size() != 4)
+      return std::nullopt;
+
+    TracedRead read{0, DiscIO::PARTITION_NONE, 0, 0};
+    if (fields[1] != "-")
+    {
+      u64 partition_offset;
+      if (!TryParse(fields[1], &partition_offset, 16))
+        return std::nullopt;
+      read.partition = DiscIO::Partition(partition_offset);
+    }
+
+    if (!TryParse(fields[0], &read.time_us, 10) || !TryParse(fields[2], &read.offset, 16) ||
+        !TryParse(fields[3], &read.length, 16))
+    {
+      return std::nullopt;
+    }
+
+    reads.push_back(read);
+  }
+
+  return reads;
+}
+
+// Nearest-rank percentile of an already sorted, non-empty list
+double GetPercentile(const std::vector<double>& sorted, double percentile)
+{
+  const size_t rank = static_cast<size_t>(std::ceil(percentile / 100.0 * sorted.size()));
+  return sorted[std::clamp<size_t>(rank, 1, sorted.size()) - 1];
+}
+}  // namespace
+
+std::optional<std::string> Replay(const std::string& disc_path, const std::string& trace_path)
+{
+  const std::optional<std::vector<TracedRead>> reads = LoadTrace(trace_path);
+  if (!reads)
+  {
+    fprintf(stderr, "Could not load the disc read trace %s\n", trace_path.c_str());
+    return std::nullopt;
+  }
+
+  const u32 cache_size_mib = Config::Get(Config::MAIN_DISC_CACHE_SIZE);
+  const u32 read_ahead_blocks = Config::Get(Config::MAIN_DISC_READ_AHEAD);
+  const u64 cache_size = cache_size_mib == 0 ? DiscIO::GetDefaultDecompressedCacheSize() :
+                                               u64(cache_size_mib) << 20;
+
+  std::unique_ptr<DiscIO::Volume> volume = DiscIO::CreateVolume(disc_path);
+  if (!volume)
+  {
+    fprintf(stderr, "Could not open the disc image %s\n", disc_path.c_str());
+    return std::nullopt;
+  }
+  volume->GetBlobReader().SetDecompressedCacheSize(cache_size);
+  volume->GetBlobReader().SetReadAheadBlocks(read_ahead_blocks);
+
+  std::vector<u8> buffer;
+  std::vector<double> read_times_ms;
+  read_times_ms.reserve(reads->size());
+  u64 bytes_read = 0;
+  u64 failed_reads = 0;
+
+  const auto start = std::chrono::steady_clock::now();
+  for (const TracedRead& read : *reads)
+  {
+    // Waiting between reads like the game did gives read-ahead the same amount of time to work
+    std::this_thread::sleep_until(start + std::chrono::microseconds(read.time_us));
+
+    buffer.resize(read.length);
+    const auto read_start = std::chrono::steady_clock::now();
+    if (volume->Read(read.offset, read.length, buffer.data(), read.partition))
+      bytes_read += read.length;
+    else
+      ++failed_reads;
+    read_times_ms.push_back(std::chrono::duration<double, std::milli>(
+                                std::chrono::steady_clock::now() - read_start)
+                                .count());
+  }
+
+  // Only GCZ and drives go through SectorReader's cache
+  std::optional<DiscIO::BlockCache::Stats> cache_stats;
+  const DiscIO::BlobReader& blob = volume->GetBlobReader();
+  if (const auto* sector_reader = dynamic_cast<const DiscIO::SectorReader*>(&blob))
+    cache_stats = sector_reader->GetCacheStats();
+
+  volume.reset();
+
+  picojson::object results;
+  results["disc"] = picojson::value(disc_path);
+  results["trace"] = picojson::value(trace_path);
+  results["cache_size_mib"] = picojson::value(static_cast<double>(cache_size >> 20));
+  results["read_ahead_blocks"] = picojson::value(static_cast<double>(read_ahead_blocks));
+  results["reads"] = picojson::value(static_cast<double>(read_times_ms.size()));
+  results["failed_reads"] = picojson::value(static_cast<double>(failed_reads));
+  results["bytes"] = picojson::value(static_cast<double>(bytes_read));
+
+  if (cache_stats)
+  {
+    picojson::object cache;
+    cache["hits"] = picojson::value(static_cast<double>(cache_stats->hits));
+    cache["misses"] = picojson::value(static_cast<double>(cache_stats->misses));
+    cache["evictions"] = picojson::value(static_cast<double>(cache_stats->evictions));
+    results["block_cache"] = picojson::value(std::move(cache));
+  }
+
+  if (!read_times_ms.empty())
+  {
+    std::vector<double> sorted = read_times_ms;
+    std::sort(sorted.begin(), sorted.end());
+    const double total = std::accumulate(sorted.begin(), sorted.end(), 0.0);
+
+    picojson::object read_time;
+    read_time["total"] = picojson::value(total);
+    read_time["mean"] = picojson::value(total / sorted.size());
+    read_time["median"] = picojson::value(GetPercentile(sorted, 50));
+    read_time["p90"] = picojson::value(GetPercentile(sorted, 90));
+    read_time["p99"] = picojson::value(GetPercentile(sorted, 99));
+    read_time["worst"] = picojson::value(sorted.back());
+    results["read_time_ms"] = picojson::value(std::move(read_time));
+  }
+
+  return picojson::value(std::move(results)).serialize(true);
+}
+}  // namespace DiscTraceReplay
@@ -0,0 +1,15 @@
+// Copyright 2021 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <optional>
+#include <string>
+
+namespace DiscTraceReplay
+{
+// Plays back a disc read trace (as recorded with the DiscReadTrace setting) against a disc image,
+// keeping the timing of the recorded reads, and returns how long the reads took as JSON. Returns
+// std::nullopt if the disc image or the trace can't be read.
+std::optional<std::string> Replay(const std::string& disc_path, const std::string& trace_path);
+}  // namespace DiscTraceReplay
@@ -0,0 +1,110 @@
+// Copyright 2021 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "DolphinNoGUI/FifoBenchmark.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <utility>
+
+#include <picojson.h>
+
+#include "Common/Config/Config.h"
+#include "Core/Config/MainSettings.h"
+#include "Core/FifoPlayer/FifoPlayer.h"
+#include "VideoCommon/Statistics.h"
+
+namespace
+{
+// Nearest-rank percentile of an already sorted, non-empty list
+double GetPercentile(const std::vector<double>& sorted, double percentile)
+{
+  const size_t rank = static_cast<size_t>(std::ceil(percentile / 100.0 * sorted.size()));
+  return sorted[std::clamp<size_t>(rank, 1, sorted.size()) - 1];
+}
+}  // namespace
+
+FifoBenchmark::FifoBenchmark(std::string path, u32 loops, std::function<void()> on_finished)
+    : m_path(std::move(path)), m_loops(loops), m_on_finished(std::move(on_finished))
+{
+}
+
+void FifoBenchmark::OnFramePresented()
+{
+  if (m_finished)
+    return;
+
+  const auto now = std::chrono::steady_clock::now();
+
+  // The first frame only starts the clock, as its time includes booting.
+  if (!m_last_frame_time)
+  {
+    const FifoPlayer& player = FifoPlayer::GetInstance();
+    const u32 frames_per_loop = player.GetFrameRangeEnd() - player.GetFrameRangeStart() + 1;
+    m_frames_to_measure = m_loops * frames_per_loop;
+    m_frame_times_ms.reserve(m_frames_to_measure);
+    m_draw_calls.reserve(m_frames_to_measure);
+    m_last_frame_time = now;
+    return;
+  }
+
+  m_frame_times_ms.push_back(
+      std::chrono::duration<double, std::milli>(now - *m_last_frame_time).count());
+  m_draw_calls.push_back(g_stats.last_frame.num_draw_calls);
+  m_last_frame_time = now;
+
+  // The shader cache resets these when it is shut down, so take them while it's still running.
+  m_vertex_shaders_created = g_stats.num_vertex_shaders_created;
+  m_pixel_shaders_created = g_stats.num_pixel_shaders_created;
+
+  if (m_frame_times_ms.size() >= m_frames_to_measure)
+  {
+    m_finished = true;
+    m_on_finished();
+  }
+}
+
+std::string FifoBenchmark::GetResultsJSON() const
+{
+  picojson::object results;
+  results["file"] = picojson::value(m_path);
+  results["video_backend"] = picojson::value(Config::Get(Config::MAIN_GFX_BACKEND));
+  results["loops"] = picojson::value(static_cast<double>(m_loops));
+  results["frames"] = picojson::value(static_cast<double>(m_frame_times_ms.size()));
+  results["completed"] = picojson::value(m_finished);
+
+  if (!m_frame_times_ms.empty())
+  {
+    std::vector<double> sorted = m_frame_times_ms;
+    std::sort(sorted.begin(), sorted.end());
+    const double total = std::accumulate(sorted.begin(), sorted.end(), 0.0);
+    const double mean = total / sorted.size();
+
+    picojson::object frame_time;
+    frame_time["mean"] = picojson::value(mean);
+    frame_time["median"] = picojson::value(GetPercentile(sorted, 50));
+    frame_time["p90"] = picojson::value(GetPercentile(sorted, 90));
+    frame_time["p95"] = picojson::value(GetPercentile(sorted, 95));
+    frame_time["p99"] = picojson::value(GetPercentile(sorted, 99));
+    frame_time["worst"] = picojson::value(sorted.back());
+    results["frame_time_ms"] = picojson::value(std::move(frame_time));
+    results["fps"] = picojson::value(mean > 0.0 ? 1000.0 / mean : 0.0);
+
+    const double total_draw_calls = std::accumulate(m_draw_calls.begin(), m_draw_calls.end(), 0.0);
+    picojson::object draw_calls;
+    draw_calls["total"] = picojson::value(total_draw_calls);
+    draw_calls["mean_per_frame"] = picojson::value(total_draw_calls / m_draw_calls.size());
+    draw_calls["max_per_frame"] =
+        picojson::value(static_cast<double>(*std::max_element(m_draw_calls.begin(),
+                                                              m_draw_calls.end())));
+    results["draw_calls"] = picojson::value(std::move(draw_calls));
+  }
+
+  picojson::object shaders;
+  shaders["vertex"] = picojson::value(static_cast<double>(m_vertex_shaders_created));
+  shaders["pixel"] = picojson::value(static_cast<double>(m_pixel_shaders_created));
+  results["shaders_compiled"] = picojson::value(std::move(shaders));
+
+  return picojson::value(std::move(results)).serialize(true);
+}
@@ -0,0 +1,41 @@
+// Copyright 2021 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+
+// Plays back a FIFO log a given number of times and measures how long each frame takes to be
+// presented, for comparing the performance of the video backends between builds.
+class FifoBenchmark
+{
+public:
+  // on_finished is called on the GPU thread once enough frames have been presented.
+  FifoBenchmark(std::string path, u32 loops, std::function<void()> on_finished);
+
+  // Must be called on the GPU thread after each presented frame.
+  void OnFramePresented();
+
+  // Must only be called once emulation has stopped.
+  std::string GetResultsJSON() const;
+
+private:
+  std::string m_path;
+  u32 m_loops;
+  std::function<void()> m_on_finished;
+
+  u32 m_frames_to_measure = 0;
+  bool m_finished = false;
+  std::optional<std::chrono::steady_clock::time_point> m_last_frame_time;
+
+  std::vector<double> m_frame_times_ms;
+  std::vector<int> m_draw_calls;
+  int m_vertex_shaders_created = 0;
+  int m_pixel_shaders_created = 0;
+};
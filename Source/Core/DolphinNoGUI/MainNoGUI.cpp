@@ -9,6 +9,7 @@
 #include <cstring>
 #include <signal.h>
 #include <string>
+#include <variant>
 #include <vector>
 
 #ifndef _WIN32
@@ -17,12 +18,18 @@
 #include <Windows.h>
 #endif
 
+#include "Common/Config/Config.h"
+#include "Common/IOFile.h"
 #include "Common/StringUtil.h"
 #include "Core/Boot/Boot.h"
 #include "Core/BootManager.h"
+#include "Core/Config/GraphicsSettings.h"
+#include "Core/ConfigManager.h"
 #include "Core/Core.h"
 #include "Core/DolphinAnalytics.h"
 #include "Core/Host.h"
+#include "DolphinNoGUI/DiscTraceReplay.h"
+#include "DolphinNoGUI/FifoBenchmark.h"
 
 #include "UICommon/CommandLineParse.h"
 #ifdef USE_DISCORD_PRESENCE
@@ -123,6 +130,13 @@ static std::unique_ptr<Platform> GetPlatform(const optparse::Values& options)
 {
   std::string platform_name = static_cast<const char*>(options.get("platform"));
 
+  // Benchmarks shouldn't be limited by presenting to a window, and precompiling doesn't need one
+  if (platform_name.empty() &&
+      (options.is_set("benchmark") || static_cast<bool>(options.get("precompile_shaders"))))
+  {
+    platform_name = "headless";
+  }
+
 #if HAVE_X11
   if (platform_name == "x11" || platform_name.empty())
     return Platform::CreateX11Platform();
@@ -144,6 +158,51 @@ static std::unique_ptr<Platform> GetPlatform(const optparse::Values& options)
   return nullptr;
 }
 
+// Compiles the shared shader cache of the selected video backend without running a game.
+static int PrecompileShaders(const optparse::Values& options)
+{
+  s_platform = GetPlatform(options);
+  if (!s_platform || !s_platform->Init())
+  {
+    fprintf(stderr, "No platform found, or failed to initialize.\n");
+    return 1;
+  }
+
+  Config::SetCurrent(Config::GFX_SHADER_CACHE, true);
+  Config::SetCurrent(Config::GFX_SHARED_SHADER_CACHE, true);
+  const bool success =
+      VideoBackendBase::PrecompileSharedShaderCache(s_platform->GetWindowSystemInfo());
+  s_platform.reset();
+
+  if (!success)
+  {
+    fprintf(stderr, "Failed to initialize the video backend.\n");
+    return 1;
+  }
+
+  return 0;
+}
+
+// Writes benchmark results to the file given with --benchmark_output, or to standard output.
+static bool WriteBenchmarkResults(const optparse::Values& options, const std::string& results)
+{
+  if (!options.is_set("benchmark_output"))
+  {
+    fputs(results.c_str(), stdout);
+    return true;
+  }
+
+  const std::string output_path = static_cast<const char*>(options.get("benchmark_output"));
+  File::IOFile file(output_path, "wb");
+  if (!file.WriteString(results))
+  {
+    fprintf(stderr, "Could not write the benchmark results to %s\n", output_path.c_str());
+    return false;
+  }
+
+  return true;
+}
+
 int main(int argc, char* argv[])
 {
   auto parser = CommandLineParse::CreateParser(CommandLineParse::ParserOptions::OmitGUIOptions);
@@ -165,9 +224,31 @@ int main(int argc, char* argv[])
             "win32"
 #endif
       });
+  parser->add_option("--benchmark")
+      .action("store")
+      .type("int")
+      .metavar("<loops>")
+      .help("Play back a FIFO log this many times at unlimited speed, then print frame statistics "
+            "as JSON");
+  parser->add_option("--benchmark_output")
+      .action("store")
+      .metavar("<file>")
+      .type("string")
+      .help("Write the benchmark results to a file instead of standard output");
+  parser->add_option("--replay_disc_trace")
+      .action("store")
+      .metavar("<file>")
+      .type("string")
+      .help("Play back a disc read trace against the given disc image without running the game, "
+            "then print read timings as JSON");
+  parser->add_option("--precompile_shaders")
+      .action("store_true")
+      .help("Compile the pipelines of all games that were played into the shared shader cache of "
+            "the video backend, then exit");
 
   optparse::Values& options = CommandLineParse::ParseArguments(parser.get(), argc, argv);
   std::vector<std::string> args = parser->args();
+  const bool precompile_shaders = static_cast<bool>(options.get("precompile_shaders"));
 
   std::optional<std::string> save_state_path;
   if (options.is_set("save_state"))
@@ -177,6 +258,7 @@ int main(int argc, char* argv[])
 
   std::unique_ptr<BootParameters> boot;
   bool game_specified = false;
+  std::string game_path;
   if (options.is_set("exec"))
   {
     const std::list<std::string> paths_list = options.all("exec");
@@ -184,6 +266,7 @@ int main(int argc, char* argv[])
                                          std::make_move_iterator(std::end(paths_list))};
     boot = BootParameters::GenerateFromFile(paths, save_state_path);
     game_specified = true;
+    game_path = paths.front();
   }
   else if (options.is_set("nand_title"))
   {
@@ -200,15 +283,31 @@ int main(int argc, char* argv[])
   else if (args.size())
   {
     boot = BootParameters::GenerateFromFile(args.front(), save_state_path);
+    game_path = args.front();
     args.erase(args.begin());
     game_specified = true;
   }
-  else
+  else if (!precompile_shaders)
   {
     parser->print_help();
     return 0;
   }
 
+  std::unique_ptr<FifoBenchmark> benchmark;
+  if (options.is_set("benchmark"))
+  {
+    const int loops = static_cast<int>(options.get("benchmark"));
+    const auto* dff = boot ? std::get_if<BootParameters::DFF>(&boot->parameters) : nullptr;
+    if (!dff || loops <= 0)
+    {
+      fprintf(stderr, "Benchmarking requires a FIFO log and a positive number of loops.\n");
+      return 1;
+    }
+
+    benchmark = std::make_unique<FifoBenchmark>(dff->dff_path, static_cast<u32>(loops),
+                                                [] { s_platform->Stop(); });
+  }
+
   std::string user_directory;
   if (options.is_set("user"))
     user_directory = static_cast<const char*>(options.get("user"));
@@ -216,6 +315,21 @@ int main(int argc, char* argv[])
   UICommon::SetUserDirectory(user_directory);
   UICommon::Init();
 
+  if (precompile_shaders)
+  {
+    const int result = PrecompileShaders(options);
+    UICommon::Shutdown();
+    return result;
+  }
+
+  if (options.is_set("replay_disc_trace"))
+  {
+    const std::optional<std::string> results = DiscTraceReplay::Replay(
+        game_path, static_cast<const char*>(options.get("replay_disc_trace")));
+    UICommon::Shutdown();
+    return results && WriteBenchmarkResults(options, *results + '\n') ? 0 : 1;
+  }
+
   s_platform = GetPlatform(options);
   if (!s_platform || !s_platform->Init())
   {
@@ -249,6 +363,17 @@ int main(int argc, char* argv[])
 
   DolphinAnalytics::Instance().ReportDolphinStart("nogui");
 
+  // These are saved along with the rest of SConfig, so they are restored after the benchmark.
+  const float emulation_speed = SConfig::GetInstance().m_EmulationSpeed;
+  const bool loop_fifo_replay = SConfig::GetInstance().bLoopFifoReplay;
+  if (benchmark)
+  {
+    SConfig::GetInstance().m_EmulationSpeed = 0.0f;
+    SConfig::GetInstance().bLoopFifoReplay = true;
+    Config::SetCurrent(Config::GFX_VSYNC, false);
+    Core::SetOnFramePresentedCallback([&benchmark] { benchmark->OnFramePresented(); });
+  }
+
   if (!BootManager::BootCore(std::move(boot), s_platform->GetWindowSystemInfo()))
   {
     fprintf(stderr, "Could not boot the specified file\n");
@@ -263,6 +388,16 @@ int main(int argc, char* argv[])
   Core::Stop();
 
   Core::Shutdown();
+
+  if (benchmark)
+  {
+    Core::SetOnFramePresentedCallback(nullptr);
+    SConfig::GetInstance().m_EmulationSpeed = emulation_speed;
+    SConfig::GetInstance().bLoopFifoReplay = loop_fifo_replay;
+
+    if (!WriteBenchmarkResults(options, benchmark->GetResultsJSON() + '\n'))
+      return 1;
+  }
   s_platform.reset();
   UICommon::Shutdown();
 
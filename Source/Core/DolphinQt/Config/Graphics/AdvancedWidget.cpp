@@ -68,6 +68,8 @@ void AdvancedWidget::CreateWidgets()
   m_load_custom_textures = new GraphicsBool(tr("Load Custom Textures"), Config::GFX_HIRES_TEXTURES);
   m_prefetch_custom_textures =
       new GraphicsBool(tr("Prefetch Custom Textures"), Config::GFX_CACHE_HIRES_TEXTURES);
+  m_convert_custom_textures =
+      new GraphicsBool(tr("Convert Custom Textures"), Config::GFX_CONVERT_HIRES_TEXTURES);
   m_dump_efb_target = new GraphicsBool(tr("Dump EFB Target"), Config::GFX_DUMP_EFB_TARGET);
   m_dump_xfb_target = new GraphicsBool(tr("Dump XFB Target"), Config::GFX_DUMP_XFB_TARGET);
   m_disable_vram_copies =
@@ -75,6 +77,7 @@ void AdvancedWidget::CreateWidgets()
 
   utility_layout->addWidget(m_load_custom_textures, 0, 0);
   utility_layout->addWidget(m_prefetch_custom_textures, 0, 1);
+  utility_layout->addWidget(m_convert_custom_textures, 2, 0);
 
   utility_layout->addWidget(m_disable_vram_copies, 1, 0);
 
@@ -163,6 +166,7 @@ void AdvancedWidget::ConnectWidgets()
 void AdvancedWidget::LoadSettings()
 {
   m_prefetch_custom_textures->setEnabled(Config::Get(Config::GFX_HIRES_TEXTURES));
+  m_convert_custom_textures->setEnabled(Config::Get(Config::GFX_HIRES_TEXTURES));
   m_dump_bitrate->setEnabled(!Config::Get(Config::GFX_USE_FFV1));
 
   m_enable_prog_scan->setChecked(Config::Get(Config::SYSCONF_PROGRESSIVE_SCAN));
@@ -173,6 +177,7 @@ void AdvancedWidget::LoadSettings()
 void AdvancedWidget::SaveSettings()
 {
   m_prefetch_custom_textures->setEnabled(Config::Get(Config::GFX_HIRES_TEXTURES));
+  m_convert_custom_textures->setEnabled(Config::Get(Config::GFX_HIRES_TEXTURES));
   m_dump_bitrate->setEnabled(!Config::Get(Config::GFX_USE_FFV1));
 
   Config::SetBase(Config::SYSCONF_PROGRESSIVE_SCAN, m_enable_prog_scan->isChecked());
@@ -230,6 +235,12 @@ void AdvancedWidget::AddDescriptions()
       "Caches custom textures to system RAM on startup.<br><br>This can require exponentially "
       "more RAM but fixes possible stuttering.<br><br><dolphin_emphasis>If unsure, leave this "
       "unchecked.</dolphin_emphasis>");
+  static const char TR_CONVERT_CUSTOM_TEXTURE_DESCRIPTION[] = QT_TR_NOOP(
+      "Converts the custom textures of the game into a single file in User/Cache/HiresTextures/ "
+      "once, and loads them from it from then on. This avoids decoding PNG files every time the "
+      "game starts.<br><br>Textures without alpha are compressed to DXT1, others to DXT5, "
+      "which lowers their quality slightly.<br><br><dolphin_emphasis>If unsure, leave this "
+      "unchecked.</dolphin_emphasis>");
   static const char TR_DUMP_EFB_DESCRIPTION[] =
       QT_TR_NOOP("Dumps the contents of EFB copies to User/Dump/Textures/.<br><br "
                  "/><dolphin_emphasis>If unsure, leave this "
@@ -292,6 +303,7 @@ void AdvancedWidget::AddDescriptions()
   m_dump_base_textures->SetDescription(tr(TR_DUMP_BASE_TEXTURE_DESCRIPTION));
   m_load_custom_textures->SetDescription(tr(TR_LOAD_CUSTOM_TEXTURE_DESCRIPTION));
   m_prefetch_custom_textures->SetDescription(tr(TR_CACHE_CUSTOM_TEXTURE_DESCRIPTION));
+  m_convert_custom_textures->SetDescription(tr(TR_CONVERT_CUSTOM_TEXTURE_DESCRIPTION));
   m_dump_efb_target->SetDescription(tr(TR_DUMP_EFB_DESCRIPTION));
   m_dump_xfb_target->SetDescription(tr(TR_DUMP_XFB_DESCRIPTION));
   m_disable_vram_copies->SetDescription(tr(TR_DISABLE_VRAM_COPIES_DESCRIPTION));
@@ -38,6 +38,7 @@ private:
 
   // Utility
   GraphicsBool* m_prefetch_custom_textures;
+  GraphicsBool* m_convert_custom_textures;
   GraphicsBool* m_dump_efb_target;
   GraphicsBool* m_dump_xfb_target;
   GraphicsBool* m_disable_vram_copies;
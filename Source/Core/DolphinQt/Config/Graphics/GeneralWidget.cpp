@@ -127,6 +127,9 @@ void GeneralWidget::CreateWidgets()
   m_wait_for_shaders = new GraphicsBool(tr("Compile Shaders Before Starting"),
                                         Config::GFX_WAIT_FOR_SHADERS_BEFORE_STARTING);
   shader_compilation_layout->addWidget(m_wait_for_shaders);
+  m_shared_shader_cache =
+      new GraphicsBool(tr("Share Shader Cache Between Games"), Config::GFX_SHARED_SHADER_CACHE);
+  shader_compilation_layout->addWidget(m_shared_shader_cache, 2, 1);
   shader_compilation_box->setLayout(shader_compilation_layout);
 
   main_layout->addWidget(m_video_box);
@@ -269,6 +272,13 @@ void GeneralWidget::AddDescriptions()
                  "two or fewer cores, it is recommended to enable this option, as a large shader "
                  "queue may reduce frame rates.<br><br><dolphin_emphasis>Otherwise, if "
                  "unsure, leave this unchecked.</dolphin_emphasis>");
+  static const char TR_SHARED_SHADER_CACHE_DESCRIPTION[] =
+      QT_TR_NOOP("Keeps one shader cache for all games instead of one per game, so that shaders "
+                 "compiled for any game can be reused by the others. All cached shaders are "
+                 "loaded when a game starts, which takes more memory and time the more games "
+                 "have been played. The cache can be compiled ahead of time with "
+                 "dolphin-emu-nogui --precompile_shaders.<br><br><dolphin_emphasis>If unsure, "
+                 "leave this unchecked.</dolphin_emphasis>");
 
   m_backend_combo->SetTitle(tr("Backend"));
   m_backend_combo->SetDescription(tr(TR_BACKEND_DESCRIPTION));
@@ -304,6 +314,8 @@ void GeneralWidget::AddDescriptions()
   m_shader_compilation_mode[3]->SetDescription(tr(TR_SHADER_COMPILE_SKIP_DRAWING_DESCRIPTION));
 
   m_wait_for_shaders->SetDescription(tr(TR_SHADER_COMPILE_BEFORE_START_DESCRIPTION));
+
+  m_shared_shader_cache->SetDescription(tr(TR_SHARED_SHADER_CACHE_DESCRIPTION));
 }
 
 void GeneralWidget::OnBackendChanged(const QString& backend_name)
@@ -57,6 +57,7 @@ private:
   GraphicsBool* m_render_main_window;
   std::array<GraphicsRadioInt*, 4> m_shader_compilation_mode{};
   GraphicsBool* m_wait_for_shaders;
+  GraphicsBool* m_shared_shader_cache;
 
   X11Utils::XRRConfiguration* m_xrr_config;
 };
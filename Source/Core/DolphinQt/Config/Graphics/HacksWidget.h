@@ -42,6 +42,7 @@ private:
   GraphicsBool* m_disable_bounding_box;
   GraphicsBool* m_vertex_rounding;
   GraphicsBool* m_save_texture_cache_state;
+  GraphicsBool* m_vertex_loader_cache;
   GraphicsBool* m_defer_efb_copies;
 
   void CreateWidgets();
@@ -25,6 +25,7 @@
 #include "Core/IOS/IOS.h"
 #include "Core/IOS/USB/Bluetooth/BTBase.h"
 #include "Core/IOS/USB/Bluetooth/BTReal.h"
+#include "Core/Rewind.h"
 #include "Core/State.h"
 #include "Core/WiiUtils.h"
 
@@ -225,6 +226,9 @@ void HotkeyScheduler::Run()
       if (IsHotkey(HK_REQUEST_GOLF_CONTROL))
         emit RequestGolfControl();
 
+      if (IsHotkey(HK_TOGGLE_TRACING))
+        Core::ToggleTracing();
+
       // Recording
       if (IsHotkey(HK_START_RECORDING))
         emit StartRecording();
@@ -573,6 +577,9 @@ void HotkeyScheduler::Run()
     if (IsHotkey(HK_UNDO_SAVE_STATE))
       emit StateSaveUndo();
 
+    if (IsHotkey(HK_REWIND))
+      Rewind::StepBack();
+
     if (IsHotkey(HK_LOAD_STATE_FILE))
       emit StateLoadFile();
 
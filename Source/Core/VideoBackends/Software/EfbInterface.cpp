@@ -9,7 +9,9 @@
 #include <cstring>
 #include <vector>
 
+#include "Common/CPUDetect.h"
 #include "Common/CommonTypes.h"
+#include "Common/Intrinsics.h"
 #include "Common/Logging/Log.h"
 
 #include "VideoBackends/Software/CopyRegion.h"
@@ -36,6 +38,20 @@ static inline u32 GetDepthOffset(u16 x, u16 y)
   return (x + y * EFB_WIDTH) * 3 + depth_buffer_start;
 }
 
+// Pixels are packed into 3 bytes. Only those bytes are ever touched, so that neighbouring pixels
+// can be written concurrently by different rasterizer threads.
+static inline u32 LoadPixel(u32 offset)
+{
+  u32 value = 0;
+  std::memcpy(&value, &efb[offset], 3);
+  return value;
+}
+
+static inline void StorePixel(u32 offset, u32 value)
+{
+  std::memcpy(&efb[offset], &value, 3);
+}
+
 static void SetPixelAlphaOnly(u32 offset, u8 a)
 {
   switch (bpmem.zcontrol.pixel_format)
@@ -48,10 +64,9 @@ static void SetPixelAlphaOnly(u32 offset, u8 a)
   case PixelFormat::RGBA6_Z24:
   {
     u32 a32 = a;
-    u32* dst = (u32*)&efb[offset];
-    u32 val = *dst & 0xffffffc0;
+    u32 val = LoadPixel(offset) & 0xffffffc0;
     val |= (a32 >> 2) & 0x0000003f;
-    *dst = val;
+    StorePixel(offset, val);
   }
   break;
   default:
@@ -68,31 +83,24 @@ static void SetPixelColorOnly(u32 offset, u8* rgb)
   case PixelFormat::Z24:
   {
     u32 src = *(u32*)rgb;
-    u32* dst = (u32*)&efb[offset];
-    u32 val = *dst & 0xff000000;
-    val |= src >> 8;
-    *dst = val;
+    StorePixel(offset, src >> 8);
   }
   break;
   case PixelFormat::RGBA6_Z24:
   {
     u32 src = *(u32*)rgb;
-    u32* dst = (u32*)&efb[offset];
-    u32 val = *dst & 0xff00003f;
+    u32 val = LoadPixel(offset) & 0x0000003f;
     val |= (src >> 4) & 0x00000fc0;  // blue
     val |= (src >> 6) & 0x0003f000;  // green
     val |= (src >> 8) & 0x00fc0000;  // red
-    *dst = val;
+    StorePixel(offset, val);
   }
   break;
   case PixelFormat::RGB565_Z16:
   {
     INFO_LOG_FMT(VIDEO, "RGB565_Z16 is not supported correctly yet");
     u32 src = *(u32*)rgb;
-    u32* dst = (u32*)&efb[offset];
-    u32 val = *dst & 0xff000000;
-    val |= src >> 8;
-    *dst = val;
+    StorePixel(offset, src >> 8);
   }
   break;
   default:
@@ -109,32 +117,25 @@ static void SetPixelAlphaColor(u32 offset, u8* color)
   case PixelFormat::Z24:
   {
     u32 src = *(u32*)color;
-    u32* dst = (u32*)&efb[offset];
-    u32 val = *dst & 0xff000000;
-    val |= src >> 8;
-    *dst = val;
+    StorePixel(offset, src >> 8);
   }
   break;
   case PixelFormat::RGBA6_Z24:
   {
     u32 src = *(u32*)color;
-    u32* dst = (u32*)&efb[offset];
-    u32 val = *dst & 0xff000000;
+    u32 val = 0;
     val |= (src >> 2) & 0x0000003f;  // alpha
     val |= (src >> 4) & 0x00000fc0;  // blue
     val |= (src >> 6) & 0x0003f000;  // green
     val |= (src >> 8) & 0x00fc0000;  // red
-    *dst = val;
+    StorePixel(offset, val);
   }
   break;
   case PixelFormat::RGB565_Z16:
   {
     INFO_LOG_FMT(VIDEO, "RGB565_Z16 is not supported correctly yet");
     u32 src = *(u32*)color;
-    u32* dst = (u32*)&efb[offset];
-    u32 val = *dst & 0xff000000;
-    val |= src >> 8;
-    *dst = val;
+    StorePixel(offset, src >> 8);
   }
   break;
   default:
@@ -145,8 +146,7 @@ static void SetPixelAlphaColor(u32 offset, u8* color)
 
 static u32 GetPixelColor(u32 offset)
 {
-  u32 src;
-  std::memcpy(&src, &efb[offset], sizeof(u32));
+  const u32 src = LoadPixel(offset);
 
   switch (bpmem.zcontrol.pixel_format)
   {
@@ -178,19 +178,13 @@ static void SetPixelDepth(u32 offset, u32 depth)
   case PixelFormat::RGBA6_Z24:
   case PixelFormat::Z24:
   {
-    u32* dst = (u32*)&efb[offset];
-    u32 val = *dst & 0xff000000;
-    val |= depth & 0x00ffffff;
-    *dst = val;
+    StorePixel(offset, depth & 0x00ffffff);
   }
   break;
   case PixelFormat::RGB565_Z16:
   {
     INFO_LOG_FMT(VIDEO, "RGB565_Z16 is not supported correctly yet");
-    u32* dst = (u32*)&efb[offset];
-    u32 val = *dst & 0xff000000;
-    val |= depth & 0x00ffffff;
-    *dst = val;
+    StorePixel(offset, depth & 0x00ffffff);
   }
   break;
   default:
@@ -209,13 +203,13 @@ static u32 GetPixelDepth(u32 offset)
   case PixelFormat::RGBA6_Z24:
   case PixelFormat::Z24:
   {
-    depth = (*(u32*)&efb[offset]) & 0x00ffffff;
+    depth = LoadPixel(offset);
   }
   break;
   case PixelFormat::RGB565_Z16:
   {
     INFO_LOG_FMT(VIDEO, "RGB565_Z16 is not supported correctly yet");
-    depth = (*(u32*)&efb[offset]) & 0x00ffffff;
+    depth = LoadPixel(offset);
   }
   break;
   default:
@@ -308,11 +302,45 @@ static u32 GetDestinationFactor(u8* srcClr, u8* dstClr, DstBlendFactor mode)
   return 0;
 }
 
+#ifdef _M_X86
+FUNCTION_TARGET_SSR41
+static void BlendColor_SSE41(u8* srcClr, u8* dstClr, u32 srcFactor, u32 dstFactor)
+{
+  u32 src;
+  u32 dst;
+  std::memcpy(&src, srcClr, sizeof(u32));
+  std::memcpy(&dst, dstClr, sizeof(u32));
+
+  // All four components at once, with the same rounding as the scalar loop below
+  __m128i sf = _mm_cvtepu8_epi32(_mm_cvtsi32_si128(srcFactor));
+  __m128i df = _mm_cvtepu8_epi32(_mm_cvtsi32_si128(dstFactor));
+  sf = _mm_add_epi32(sf, _mm_srli_epi32(sf, 7));
+  df = _mm_add_epi32(df, _mm_srli_epi32(df, 7));
+
+  const __m128i src_color = _mm_cvtepu8_epi32(_mm_cvtsi32_si128(src));
+  const __m128i dst_color = _mm_cvtepu8_epi32(_mm_cvtsi32_si128(dst));
+  __m128i color = _mm_add_epi32(_mm_mullo_epi32(src_color, sf), _mm_mullo_epi32(dst_color, df));
+  color = _mm_min_epu32(_mm_srli_epi32(color, 8), _mm_set1_epi32(255));
+  color = _mm_packus_epi16(_mm_packus_epi32(color, color), color);
+
+  dst = static_cast<u32>(_mm_cvtsi128_si32(color));
+  std::memcpy(dstClr, &dst, sizeof(u32));
+}
+#endif
+
 static void BlendColor(u8* srcClr, u8* dstClr)
 {
   u32 srcFactor = GetSourceFactor(srcClr, dstClr, bpmem.blendmode.srcfactor);
   u32 dstFactor = GetDestinationFactor(srcClr, dstClr, bpmem.blendmode.dstfactor);
 
+#ifdef _M_X86
+  if (cpu_info.bSSE4_1)
+  {
+    BlendColor_SSE41(srcClr, dstClr, srcFactor, dstFactor);
+    return;
+  }
+#endif
+
   for (int i = 0; i < 4; i++)
   {
     // add MSB of factors to make their range 0 -> 256
@@ -699,16 +727,16 @@ void ResetPerfQuery()
   perf_values = {};
 }
 
-void IncPerfCounterQuadCount(PerfQueryType type)
+void AddPerfCounterPixels(PerfQueryType type, u32 count)
 {
   // NOTE: hardware doesn't process individual pixels but quads instead.
   // Current software renderer architecture works on pixels though, so
   // we have this "quad" hack here to only increment the registers on
-  // every fourth rendered pixel
+  // every third rendered pixel. The remainder is carried over, which makes
+  // the result independent of how the pixel counts were split up.
   static u32 quad[PQ_NUM_MEMBERS];
-  if (++quad[type] != 3)
-    return;
-  quad[type] = 0;
-  ++perf_values[type];
+  const u32 total = quad[type] + count;
+  quad[type] = total % 3;
+  perf_values[type] += total / 3;
 }
 }  // namespace EfbInterface
@@ -4,12 +4,22 @@
 #include "VideoBackends/Software/Rasterizer.h"
 
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <condition_variable>
 #include <cstring>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
 
+#include "Common/CPUDetect.h"
 #include "Common/CommonTypes.h"
+#include "Common/Thread.h"
 #include "VideoBackends/Software/EfbInterface.h"
 #include "VideoBackends/Software/NativeVertexFormat.h"
 #include "VideoBackends/Software/Tev.h"
+#include "VideoCommon/BoundingBox.h"
 #include "VideoCommon/PerfQueryBase.h"
 #include "VideoCommon/Statistics.h"
 #include "VideoCommon/VideoCommon.h"
@@ -20,22 +30,87 @@ namespace Rasterizer
 {
 static constexpr int BLOCK_SIZE = 2;
 
+// Triangles are binned into screen tiles and each tile is rasterized by exactly one thread. Tiles
+// are aligned to whole blocks, so no EFB pixel is ever touched by two threads at once, and every
+// tile draws its triangles in submission order. The resulting EFB is therefore the same no matter
+// how many threads are used.
+static constexpr s32 TILE_SIZE = 32;
+static constexpr s32 TILES_X = (EFB_WIDTH + TILE_SIZE - 1) / TILE_SIZE;
+static constexpr s32 TILES_Y = (EFB_HEIGHT + TILE_SIZE - 1) / TILE_SIZE;
+static_assert(TILE_SIZE % BLOCK_SIZE == 0, "Tiles must not split blocks");
+
+struct TriangleSetup
+{
+  Slope ZSlope;
+  Slope WSlope;
+  Slope ColorSlopes[2][4];
+  Slope TexSlopes[8][3];
+
+  s32 vertex0X;
+  s32 vertex0Y;
+  float vertexOffsetX;
+  float vertexOffsetY;
+
+  // Half-edge constants and deltas in 28.4 fixed point
+  s32 C1, C2, C3;
+  s32 DX12, DX23, DX31;
+  s32 DY12, DY23, DY31;
+
+  // Scissored bounding rectangle in pixels
+  s32 minx, maxx, miny, maxy;
+};
+
+// State owned by a single rasterizer thread
+struct RasterContext
+{
+  Tev tev;
+  RasterBlock rasterBlock;
+  const TriangleSetup* tri;
+};
+
 static Slope ZSlope;
-static Slope WSlope;
-static Slope ColorSlopes[2][4];
-static Slope TexSlopes[8][3];
 
-static s32 vertex0X;
-static s32 vertex0Y;
-static float vertexOffsetX;
-static float vertexOffsetY;
+static std::vector<TriangleSetup> s_triangles;
+static std::array<std::vector<u32>, TILES_X * TILES_Y> s_tile_bins;
+
+// Context 0 belongs to the thread submitting primitives (the GPU thread), the rest to the workers.
+static std::vector<std::unique_ptr<RasterContext>> s_contexts;
+static std::vector<std::thread> s_worker_threads;
+static std::mutex s_worker_mutex;
+static std::condition_variable s_worker_wake;
+static std::condition_variable s_worker_done;
+static u64 s_work_generation;
+static u32 s_workers_busy;
+static bool s_workers_exit;
+static std::atomic<u32> s_next_tile;
+
+static void WorkerThread(RasterContext* context);
 
-static Tev tev;
-static RasterBlock rasterBlock;
+static u32 GetNumThreads()
+{
+  if (g_ActiveConfig.iSWRasterizerThreads > 0)
+    return static_cast<u32>(g_ActiveConfig.iSWRasterizerThreads);
+
+  return static_cast<u32>(std::max(cpu_info.num_cores, 1));
+}
 
 void Init()
 {
-  tev.Init();
+  Shutdown();
+
+  const u32 num_threads = GetNumThreads();
+  for (u32 i = 0; i < num_threads; i++)
+  {
+    s_contexts.push_back(std::make_unique<RasterContext>());
+    s_contexts.back()->tev.Init();
+  }
+
+  // Workers start out having seen generation 0, so no work may be pending from before
+  s_work_generation = 0;
+  s_workers_busy = 0;
+  s_workers_exit = false;
+  for (u32 i = 1; i < num_threads; i++)
+    s_worker_threads.emplace_back(WorkerThread, s_contexts[i].get());
 
   // Set initial z reference plane in the unlikely case that zfreeze is enabled when drawing the
   // first primitive.
@@ -44,6 +119,24 @@ void Init()
   ZSlope.f0 = 1.f;
 }
 
+void Shutdown()
+{
+  {
+    std::lock_guard lk(s_worker_mutex);
+    s_workers_exit = true;
+  }
+  s_worker_wake.notify_all();
+
+  for (std::thread& thread : s_worker_threads)
+    thread.join();
+
+  s_worker_threads.clear();
+  s_contexts.clear();
+  s_triangles.clear();
+  for (std::vector<u32>& bin : s_tile_bins)
+    bin.clear();
+}
+
 // Returns approximation of log2(f) in s28.4
 // results are close enough to use for LOD
 static s32 FixedLog2(float f)
@@ -68,32 +161,37 @@ static inline int iround(float x)
 
 void SetTevReg(int reg, int comp, s16 color)
 {
-  tev.SetRegColor(reg, comp, color);
+  for (auto& context : s_contexts)
+    context->tev.SetRegColor(reg, comp, color);
 }
 
-static void Draw(s32 x, s32 y, s32 xi, s32 yi)
+static void Draw(RasterContext& ctx, s32 x, s32 y, s32 xi, s32 yi)
 {
-  INCSTAT(g_stats.this_frame.rasterized_pixels);
+  const TriangleSetup& tri = *ctx.tri;
+  Tev& tev = ctx.tev;
+
+  tev.Counters.rasterized_pixels++;
 
-  float dx = vertexOffsetX + (float)(x - vertex0X);
-  float dy = vertexOffsetY + (float)(y - vertex0Y);
+  float dx = tri.vertexOffsetX + (float)(x - tri.vertex0X);
+  float dy = tri.vertexOffsetY + (float)(y - tri.vertex0Y);
 
-  s32 z = (s32)std::clamp<float>(ZSlope.GetValue(dx, dy), 0.0f, 16777215.0f);
+  s32 z = (s32)std::clamp<float>(tri.ZSlope.GetValue(dx, dy), 0.0f, 16777215.0f);
 
   if (bpmem.UseEarlyDepthTest() && g_ActiveConfig.bZComploc)
   {
     // TODO: Test if perf regs are incremented even if test is disabled
-    EfbInterface::IncPerfCounterQuadCount(PQ_ZCOMP_INPUT_ZCOMPLOC);
+    tev.Counters.perf_pixels[PQ_ZCOMP_INPUT_ZCOMPLOC]++;
     if (bpmem.zmode.testenable)
     {
       // early z
       if (!EfbInterface::ZCompare(x, y, z))
         return;
     }
-    EfbInterface::IncPerfCounterQuadCount(PQ_ZCOMP_OUTPUT_ZCOMPLOC);
+    tev.Counters.perf_pixels[PQ_ZCOMP_OUTPUT_ZCOMPLOC]++;
   }
 
-  RasterBlockPixel& pixel = rasterBlock.Pixel[xi][yi];
+  const RasterBlock& rasterBlock = ctx.rasterBlock;
+  const RasterBlockPixel& pixel = rasterBlock.Pixel[xi][yi];
 
   tev.Position[0] = x;
   tev.Position[1] = y;
@@ -104,7 +202,7 @@ static void Draw(s32 x, s32 y, s32 xi, s32 yi)
   {
     for (int comp = 0; comp < 4; comp++)
     {
-      u16 color = (u16)ColorSlopes[i][comp].GetValue(dx, dy);
+      u16 color = (u16)tri.ColorSlopes[i][comp].GetValue(dx, dy);
 
       // clamp color value to 0
       u16 mask = ~(color >> 8);
@@ -136,16 +234,16 @@ static void Draw(s32 x, s32 y, s32 xi, s32 yi)
   tev.Draw();
 }
 
-static void InitTriangle(float X1, float Y1, s32 xi, s32 yi)
+static void InitTriangle(TriangleSetup* tri, float X1, float Y1, s32 xi, s32 yi)
 {
-  vertex0X = xi;
-  vertex0Y = yi;
+  tri->vertex0X = xi;
+  tri->vertex0Y = yi;
 
   // adjust a little less than 0.5
   const float adjust = 0.495f;
 
-  vertexOffsetX = ((float)xi - X1) + adjust;
-  vertexOffsetY = ((float)yi - Y1) + adjust;
+  tri->vertexOffsetX = ((float)xi - X1) + adjust;
+  tri->vertexOffsetY = ((float)yi - Y1) + adjust;
 }
 
 static void InitSlope(Slope* slope, float f1, float f2, float f3, float DX31, float DX12,
@@ -161,7 +259,8 @@ static void InitSlope(Slope* slope, float f1, float f2, float f3, float DX31, fl
   slope->f0 = f1;
 }
 
-static inline void CalculateLOD(s32* lodp, bool* linear, u32 texmap, u32 texcoord)
+static inline void CalculateLOD(const RasterBlock& rasterBlock, s32* lodp, bool* linear,
+                                u32 texmap, u32 texcoord)
 {
   const FourTexUnits& texUnit = bpmem.tex[(texmap >> 2) & 1];
   const u8 subTexmap = texmap & 3;
@@ -174,17 +273,17 @@ static inline void CalculateLOD(s32* lodp, bool* linear, u32 texmap, u32 texcoor
   float sDelta, tDelta;
   if (tm0.diag_lod == LODType::Diagonal)
   {
-    float* uv0 = rasterBlock.Pixel[0][0].Uv[texcoord];
-    float* uv1 = rasterBlock.Pixel[1][1].Uv[texcoord];
+    const float* uv0 = rasterBlock.Pixel[0][0].Uv[texcoord];
+    const float* uv1 = rasterBlock.Pixel[1][1].Uv[texcoord];
 
     sDelta = fabsf(uv0[0] - uv1[0]);
     tDelta = fabsf(uv0[1] - uv1[1]);
   }
   else
   {
-    float* uv0 = rasterBlock.Pixel[0][0].Uv[texcoord];
-    float* uv1 = rasterBlock.Pixel[1][0].Uv[texcoord];
-    float* uv2 = rasterBlock.Pixel[0][1].Uv[texcoord];
+    const float* uv0 = rasterBlock.Pixel[0][0].Uv[texcoord];
+    const float* uv1 = rasterBlock.Pixel[1][0].Uv[texcoord];
+    const float* uv2 = rasterBlock.Pixel[0][1].Uv[texcoord];
 
     sDelta = std::max(fabsf(uv0[0] - uv1[0]), fabsf(uv0[0] - uv2[0]));
     tDelta = std::max(fabsf(uv0[1] - uv1[1]), fabsf(uv0[1] - uv2[1]));
@@ -210,30 +309,33 @@ static inline void CalculateLOD(s32* lodp, bool* linear, u32 texmap, u32 texcoor
   *lodp = lod;
 }
 
-static void BuildBlock(s32 blockX, s32 blockY)
+static void BuildBlock(RasterContext& ctx, s32 blockX, s32 blockY)
 {
+  const TriangleSetup& tri = *ctx.tri;
+  RasterBlock& rasterBlock = ctx.rasterBlock;
+
   for (s32 yi = 0; yi < BLOCK_SIZE; yi++)
   {
     for (s32 xi = 0; xi < BLOCK_SIZE; xi++)
     {
       RasterBlockPixel& pixel = rasterBlock.Pixel[xi][yi];
 
-      float dx = vertexOffsetX + (float)(xi + blockX - vertex0X);
-      float dy = vertexOffsetY + (float)(yi + blockY - vertex0Y);
+      float dx = tri.vertexOffsetX + (float)(xi + blockX - tri.vertex0X);
+      float dy = tri.vertexOffsetY + (float)(yi + blockY - tri.vertex0Y);
 
-      float invW = 1.0f / WSlope.GetValue(dx, dy);
+      float invW = 1.0f / tri.WSlope.GetValue(dx, dy);
       pixel.InvW = invW;
 
       // tex coords
       for (unsigned int i = 0; i < bpmem.genMode.numtexgens; i++)
       {
         float projection = invW;
-        float q = TexSlopes[i][2].GetValue(dx, dy) * invW;
+        float q = tri.TexSlopes[i][2].GetValue(dx, dy) * invW;
         if (q != 0.0f)
           projection = invW / q;
 
-        pixel.Uv[i][0] = TexSlopes[i][0].GetValue(dx, dy) * projection;
-        pixel.Uv[i][1] = TexSlopes[i][1].GetValue(dx, dy) * projection;
+        pixel.Uv[i][0] = tri.TexSlopes[i][0].GetValue(dx, dy) * projection;
+        pixel.Uv[i][1] = tri.TexSlopes[i][1].GetValue(dx, dy) * projection;
       }
     }
   }
@@ -246,7 +348,8 @@ static void BuildBlock(s32 blockX, s32 blockY)
     u32 texcoord = indref & 3;
     indref >>= 3;
 
-    CalculateLOD(&rasterBlock.IndirectLod[i], &rasterBlock.IndirectLinear[i], texmap, texcoord);
+    CalculateLOD(rasterBlock, &rasterBlock.IndirectLod[i], &rasterBlock.IndirectLinear[i], texmap,
+                 texcoord);
   }
 
   for (unsigned int i = 0; i <= bpmem.genMode.numtevstages; i++)
@@ -258,7 +361,8 @@ static void BuildBlock(s32 blockX, s32 blockY)
       u32 texmap = order.getTexMap(stageOdd);
       u32 texcoord = order.getTexCoord(stageOdd);
 
-      CalculateLOD(&rasterBlock.TextureLod[i], &rasterBlock.TextureLinear[i], texmap, texcoord);
+      CalculateLOD(rasterBlock, &rasterBlock.TextureLod[i], &rasterBlock.TextureLinear[i], texmap,
+                   texcoord);
     }
   }
 }
@@ -289,15 +393,6 @@ void DrawTriangleFrontFace(const OutputVertexData* v0, const OutputVertexData* v
   const s32 DY23 = Y2 - Y3;
   const s32 DY31 = Y3 - Y1;
 
-  // Fixed-pos32 deltas
-  const s32 FDX12 = DX12 * 16;
-  const s32 FDX23 = DX23 * 16;
-  const s32 FDX31 = DX31 * 16;
-
-  const s32 FDY12 = DY12 * 16;
-  const s32 FDY23 = DY23 * 16;
-  const s32 FDY31 = DY31 * 16;
-
   // Bounding rectangle
   s32 minx = (std::min(std::min(X1, X2), X3) + 0xF) >> 4;
   s32 maxx = (std::max(std::max(X1, X2), X3) + 0xF) >> 4;
@@ -332,6 +427,8 @@ void DrawTriangleFrontFace(const OutputVertexData* v0, const OutputVertexData* v
   if (minx >= maxx || miny >= maxy)
     return;
 
+  TriangleSetup& tri = s_triangles.emplace_back();
+
   // Setup slopes
   float fltx1 = v0->screenPosition.x;
   float flty1 = v0->screenPosition.y;
@@ -340,11 +437,11 @@ void DrawTriangleFrontFace(const OutputVertexData* v0, const OutputVertexData* v
   float fltdy12 = flty1 - v1->screenPosition.y;
   float fltdy31 = v2->screenPosition.y - flty1;
 
-  InitTriangle(fltx1, flty1, (X1 + 0xF) >> 4, (Y1 + 0xF) >> 4);
+  InitTriangle(&tri, fltx1, flty1, (X1 + 0xF) >> 4, (Y1 + 0xF) >> 4);
 
   float w[3] = {1.0f / v0->projectedPosition.w, 1.0f / v1->projectedPosition.w,
                 1.0f / v2->projectedPosition.w};
-  InitSlope(&WSlope, w[0], w[1], w[2], fltdx31, fltdx12, fltdy12, fltdy31);
+  InitSlope(&tri.WSlope, w[0], w[1], w[2], fltdx31, fltdx12, fltdy12, fltdy31);
 
   // TODO: The zfreeze emulation is not quite correct, yet!
   // Many things might prevent us from reaching this line (culling, clipping, scissoring).
@@ -355,37 +452,86 @@ void DrawTriangleFrontFace(const OutputVertexData* v0, const OutputVertexData* v
   if (!bpmem.genMode.zfreeze || !g_ActiveConfig.bZFreeze)
     InitSlope(&ZSlope, v0->screenPosition[2], v1->screenPosition[2], v2->screenPosition[2], fltdx31,
               fltdx12, fltdy12, fltdy31);
+  tri.ZSlope = ZSlope;
 
   for (unsigned int i = 0; i < bpmem.genMode.numcolchans; i++)
   {
     for (int comp = 0; comp < 4; comp++)
-      InitSlope(&ColorSlopes[i][comp], v0->color[i][comp], v1->color[i][comp], v2->color[i][comp],
-                fltdx31, fltdx12, fltdy12, fltdy31);
+      InitSlope(&tri.ColorSlopes[i][comp], v0->color[i][comp], v1->color[i][comp],
+                v2->color[i][comp], fltdx31, fltdx12, fltdy12, fltdy31);
   }
 
   for (unsigned int i = 0; i < bpmem.genMode.numtexgens; i++)
   {
     for (int comp = 0; comp < 3; comp++)
-      InitSlope(&TexSlopes[i][comp], v0->texCoords[i][comp] * w[0], v1->texCoords[i][comp] * w[1],
-                v2->texCoords[i][comp] * w[2], fltdx31, fltdx12, fltdy12, fltdy31);
+      InitSlope(&tri.TexSlopes[i][comp], v0->texCoords[i][comp] * w[0],
+                v1->texCoords[i][comp] * w[1], v2->texCoords[i][comp] * w[2], fltdx31, fltdx12,
+                fltdy12, fltdy31);
   }
 
   // Half-edge constants
-  s32 C1 = DY12 * X1 - DX12 * Y1;
-  s32 C2 = DY23 * X2 - DX23 * Y2;
-  s32 C3 = DY31 * X3 - DX31 * Y3;
+  tri.C1 = DY12 * X1 - DX12 * Y1;
+  tri.C2 = DY23 * X2 - DX23 * Y2;
+  tri.C3 = DY31 * X3 - DX31 * Y3;
 
   // Correct for fill convention
   if (DY12 < 0 || (DY12 == 0 && DX12 > 0))
-    C1++;
+    tri.C1++;
   if (DY23 < 0 || (DY23 == 0 && DX23 > 0))
-    C2++;
+    tri.C2++;
   if (DY31 < 0 || (DY31 == 0 && DX31 > 0))
-    C3++;
+    tri.C3++;
+
+  tri.DX12 = DX12;
+  tri.DX23 = DX23;
+  tri.DX31 = DX31;
+  tri.DY12 = DY12;
+  tri.DY23 = DY23;
+  tri.DY31 = DY31;
+
+  // Start in corner of 2x2 block
+  tri.minx = minx & ~(BLOCK_SIZE - 1);
+  tri.maxx = maxx;
+  tri.miny = miny & ~(BLOCK_SIZE - 1);
+  tri.maxy = maxy;
+
+  // Bin the triangle into every tile its bounding rectangle touches
+  const u32 index = static_cast<u32>(s_triangles.size() - 1);
+  for (s32 tile_y = tri.miny / TILE_SIZE; tile_y <= (maxy - 1) / TILE_SIZE; tile_y++)
+  {
+    for (s32 tile_x = tri.minx / TILE_SIZE; tile_x <= (maxx - 1) / TILE_SIZE; tile_x++)
+      s_tile_bins[tile_y * TILES_X + tile_x].push_back(index);
+  }
+}
 
-  // Start in corner of 8x8 block
-  minx &= ~(BLOCK_SIZE - 1);
-  miny &= ~(BLOCK_SIZE - 1);
+static void RasterizeTriangle(RasterContext& ctx, s32 tile_x, s32 tile_y)
+{
+  const TriangleSetup& tri = *ctx.tri;
+
+  const s32 C1 = tri.C1;
+  const s32 C2 = tri.C2;
+  const s32 C3 = tri.C3;
+  const s32 DX12 = tri.DX12;
+  const s32 DX23 = tri.DX23;
+  const s32 DX31 = tri.DX31;
+  const s32 DY12 = tri.DY12;
+  const s32 DY23 = tri.DY23;
+  const s32 DY31 = tri.DY31;
+
+  // Fixed-pos32 deltas
+  const s32 FDX12 = DX12 * 16;
+  const s32 FDX23 = DX23 * 16;
+  const s32 FDX31 = DX31 * 16;
+
+  const s32 FDY12 = DY12 * 16;
+  const s32 FDY23 = DY23 * 16;
+  const s32 FDY31 = DY31 * 16;
+
+  // Only visit the blocks which lie within this tile
+  const s32 minx = std::max(tri.minx, tile_x * TILE_SIZE);
+  const s32 maxx = std::min(tri.maxx, (tile_x + 1) * TILE_SIZE);
+  const s32 miny = std::max(tri.miny, tile_y * TILE_SIZE);
+  const s32 maxy = std::min(tri.maxy, (tile_y + 1) * TILE_SIZE);
 
   // Loop through blocks
   for (s32 y = miny; y < maxy; y += BLOCK_SIZE)
@@ -421,7 +567,7 @@ void DrawTriangleFrontFace(const OutputVertexData* v0, const OutputVertexData* v
       if (a == 0x0 || b == 0x0 || c == 0x0)
         continue;
 
-      BuildBlock(x, y);
+      BuildBlock(ctx, x, y);
 
       // Accept whole block when totally covered
       if (a == 0xF && b == 0xF && c == 0xF)
@@ -430,7 +576,7 @@ void DrawTriangleFrontFace(const OutputVertexData* v0, const OutputVertexData* v
         {
           for (s32 ix = 0; ix < BLOCK_SIZE; ix++)
           {
-            Draw(x + ix, y + iy, ix, iy);
+            Draw(ctx, x + ix, y + iy, ix, iy);
           }
         }
       }
@@ -450,7 +596,7 @@ void DrawTriangleFrontFace(const OutputVertexData* v0, const OutputVertexData* v
           {
             if (CX1 > 0 && CX2 > 0 && CX3 > 0)
             {
-              Draw(x + ix, y + iy, ix, iy);
+              Draw(ctx, x + ix, y + iy, ix, iy);
             }
 
             CX1 -= FDY12;
@@ -466,4 +612,103 @@ void DrawTriangleFrontFace(const OutputVertexData* v0, const OutputVertexData* v
     }
   }
 }
+
+static void RasterizeTiles(RasterContext& ctx)
+{
+  const u32 num_tiles = static_cast<u32>(s_tile_bins.size());
+  for (u32 tile = s_next_tile++; tile < num_tiles; tile = s_next_tile++)
+  {
+    const s32 tile_x = static_cast<s32>(tile) % TILES_X;
+    const s32 tile_y = static_cast<s32>(tile) / TILES_X;
+    for (u32 index : s_tile_bins[tile])
+    {
+      ctx.tri = &s_triangles[index];
+      RasterizeTriangle(ctx, tile_x, tile_y);
+    }
+  }
+}
+
+static void WorkerThread(RasterContext* context)
+{
+  Common::SetCurrentThreadName("SW Rasterizer Worker");
+
+  u64 last_generation = 0;
+  while (true)
+  {
+    {
+      std::unique_lock lk(s_worker_mutex);
+      s_worker_wake.wait(
+          lk, [&] { return s_workers_exit || s_work_generation != last_generation; });
+      if (s_workers_exit)
+        return;
+      last_generation = s_work_generation;
+    }
+
+    RasterizeTiles(*context);
+
+    {
+      std::lock_guard lk(s_worker_mutex);
+      if (--s_workers_busy == 0)
+        s_worker_done.notify_one();
+    }
+  }
+}
+
+static void MergeCounters(Tev::PixelCounters& counters)
+{
+  ADDSTAT(g_stats.this_frame.rasterized_pixels, counters.rasterized_pixels);
+  ADDSTAT(g_stats.this_frame.tev_pixels_in, counters.tev_pixels_in);
+  ADDSTAT(g_stats.this_frame.tev_pixels_out, counters.tev_pixels_out);
+
+  for (u32 i = 0; i < PQ_NUM_MEMBERS; i++)
+  {
+    if (counters.perf_pixels[i] != 0)
+      EfbInterface::AddPerfCounterPixels(static_cast<PerfQueryType>(i), counters.perf_pixels[i]);
+  }
+
+  if (counters.bbox_left <= counters.bbox_right)
+  {
+    BoundingBox::Update(counters.bbox_left, counters.bbox_right, counters.bbox_top,
+                        counters.bbox_bottom);
+  }
+
+  counters = {};
+}
+
+void Flush()
+{
+  if (s_triangles.empty())
+    return;
+
+  s_next_tile = 0;
+
+  // Tev dumps write to shared debug buffers, so keep those on a single thread.
+  const bool use_workers = !s_worker_threads.empty() && !g_ActiveConfig.bDumpTevStages &&
+                           !g_ActiveConfig.bDumpTevTextureFetches;
+  if (use_workers)
+  {
+    {
+      std::lock_guard lk(s_worker_mutex);
+      s_workers_busy = static_cast<u32>(s_worker_threads.size());
+      s_work_generation++;
+    }
+    s_worker_wake.notify_all();
+
+    RasterizeTiles(*s_contexts[0]);
+
+    std::unique_lock lk(s_worker_mutex);
+    s_worker_done.wait(lk, [] { return s_workers_busy == 0; });
+  }
+  else
+  {
+    RasterizeTiles(*s_contexts[0]);
+  }
+
+  for (auto& context : s_contexts)
+    MergeCounters(context->tev.Counters);
+
+  s_triangles.clear();
+  for (std::vector<u32>& bin : s_tile_bins)
+    bin.clear();
+}
 }  // namespace Rasterizer
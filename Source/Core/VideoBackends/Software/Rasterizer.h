@@ -10,10 +10,15 @@ struct OutputVertexData;
 namespace Rasterizer
 {
 void Init();
+void Shutdown();
 
+// Sets up the triangle and bins it into screen tiles. Nothing is drawn until Flush() is called.
 void DrawTriangleFrontFace(const OutputVertexData* v0, const OutputVertexData* v1,
                            const OutputVertexData* v2);
 
+// Rasterizes all binned triangles, spread across the rasterizer threads.
+void Flush();
+
 void SetTevReg(int reg, int comp, s16 color);
 
 struct Slope
@@ -91,6 +91,8 @@ void SWVertexLoader::DrawCurrentBatch(u32 base_index, u32 num_indices, u32 base_
     INCSTAT(g_stats.this_frame.num_vertices_loaded)
   }
 
+  Rasterizer::Flush();
+
   DebugUtil::OnObjectEnd();
 }
 
@@ -11,12 +11,11 @@
 #include "Common/CommonTypes.h"
 #include "VideoBackends/Software/DebugUtil.h"
 #include "VideoBackends/Software/EfbInterface.h"
+#include "VideoBackends/Software/TevCombiner.h"
 #include "VideoBackends/Software/TextureSampler.h"
 
-#include "VideoCommon/BoundingBox.h"
 #include "VideoCommon/PerfQueryBase.h"
 #include "VideoCommon/PixelShaderManager.h"
-#include "VideoCommon/Statistics.h"
 #include "VideoCommon/VideoCommon.h"
 #include "VideoCommon/VideoConfig.h"
 #include "VideoCommon/XFMemory.h"
@@ -227,7 +226,8 @@ void Tev::SetRasColor(RasColorChan colorChan, int swaptable)
   }
 }
 
-void Tev::DrawColorRegular(const TevStageCombiner::ColorCombiner& cc, const InputRegType inputs[4])
+void Tev::DrawColorRegular(const TevStageCombiner::ColorCombiner& cc, const InputRegType inputs[4],
+                           s16* out)
 {
   for (int i = BLU_C; i <= RED_C; i++)
   {
@@ -246,11 +246,12 @@ void Tev::DrawColorRegular(const TevStageCombiner::ColorCombiner& cc, const Inpu
                  temp;
     result = result >> m_ScaleRShiftLUT[u32(cc.scale.Value())];
 
-    Reg[u32(cc.dest.Value())][i] = result;
+    out[i] = result;
   }
 }
 
-void Tev::DrawColorCompare(const TevStageCombiner::ColorCombiner& cc, const InputRegType inputs[4])
+void Tev::DrawColorCompare(const TevStageCombiner::ColorCombiner& cc, const InputRegType inputs[4],
+                           s16* out)
 {
   for (int i = BLU_C; i <= RED_C; i++)
   {
@@ -283,13 +284,14 @@ void Tev::DrawColorCompare(const TevStageCombiner::ColorCombiner& cc, const Inpu
     }
 
     if (cc.comparison == TevComparison::GT)
-      Reg[u32(cc.dest.Value())][i] = inputs[i].d + ((a > b) ? inputs[i].c : 0);
+      out[i] = inputs[i].d + ((a > b) ? inputs[i].c : 0);
     else
-      Reg[u32(cc.dest.Value())][i] = inputs[i].d + ((a == b) ? inputs[i].c : 0);
+      out[i] = inputs[i].d + ((a == b) ? inputs[i].c : 0);
   }
 }
 
-void Tev::DrawAlphaRegular(const TevStageCombiner::AlphaCombiner& ac, const InputRegType inputs[4])
+void Tev::DrawAlphaRegular(const TevStageCombiner::AlphaCombiner& ac, const InputRegType inputs[4],
+                           s16* out)
 {
   const InputRegType& InputReg = inputs[ALP_C];
 
@@ -305,10 +307,11 @@ void Tev::DrawAlphaRegular(const TevStageCombiner::AlphaCombiner& ac, const Inpu
       temp;
   result = result >> m_ScaleRShiftLUT[u32(ac.scale.Value())];
 
-  Reg[u32(ac.dest.Value())][ALP_C] = result;
+  out[ALP_C] = result;
 }
 
-void Tev::DrawAlphaCompare(const TevStageCombiner::AlphaCombiner& ac, const InputRegType inputs[4])
+void Tev::DrawAlphaCompare(const TevStageCombiner::AlphaCombiner& ac, const InputRegType inputs[4],
+                           s16* out)
 {
   u32 a, b;
   switch (ac.compare_mode)
@@ -339,9 +342,42 @@ void Tev::DrawAlphaCompare(const TevStageCombiner::AlphaCombiner& ac, const Inpu
   }
 
   if (ac.comparison == TevComparison::GT)
-    Reg[u32(ac.dest.Value())][ALP_C] = inputs[ALP_C].d + ((a > b) ? inputs[ALP_C].c : 0);
+    out[ALP_C] = inputs[ALP_C].d + ((a > b) ? inputs[ALP_C].c : 0);
   else
-    Reg[u32(ac.dest.Value())][ALP_C] = inputs[ALP_C].d + ((a == b) ? inputs[ALP_C].c : 0);
+    out[ALP_C] = inputs[ALP_C].d + ((a == b) ? inputs[ALP_C].c : 0);
+}
+
+void Tev::CombineScalar(const TevCombiner::Operands& ops, const TevStageCombiner::ColorCombiner& cc,
+                        const TevStageCombiner::AlphaCombiner& ac, s16* out)
+{
+  InputRegType inputs[4];
+  for (int i = 0; i < 4; i++)
+  {
+    inputs[i].a = ops.a[i];
+    inputs[i].b = ops.b[i];
+    inputs[i].c = ops.c[i];
+    inputs[i].d = ops.d[i];
+  }
+
+  // Invalid compare modes leave the destination registers as they were
+  for (int i = BLU_C; i <= RED_C; i++)
+    out[i] = Reg[u32(cc.dest.Value())][i];
+  out[ALP_C] = Reg[u32(ac.dest.Value())][ALP_C];
+
+  if (cc.bias != TevBias::Compare)
+    DrawColorRegular(cc, inputs, out);
+  else
+    DrawColorCompare(cc, inputs, out);
+
+  for (int i = BLU_C; i <= RED_C; i++)
+    out[i] = cc.clamp ? Clamp255(out[i]) : Clamp1024(out[i]);
+
+  if (ac.bias != TevBias::Compare)
+    DrawAlphaRegular(ac, inputs, out);
+  else
+    DrawAlphaCompare(ac, inputs, out);
+
+  out[ALP_C] = ac.clamp ? Clamp255(out[ALP_C]) : Clamp1024(out[ALP_C]);
 }
 
 static bool AlphaCompare(int alpha, int ref, CompareMode comp)
@@ -543,7 +579,7 @@ void Tev::Draw()
   ASSERT(Position[0] >= 0 && Position[0] < s32(EFB_WIDTH));
   ASSERT(Position[1] >= 0 && Position[1] < s32(EFB_HEIGHT));
 
-  INCSTAT(g_stats.this_frame.tev_pixels_in);
+  Counters.tev_pixels_in++;
 
   // initial color values
   for (int i = 0; i < 4; i++)
@@ -653,46 +689,30 @@ void Tev::Draw()
     SetRasColor(order.getColorChan(stageOdd), ac.rswap * 2);
 
     // combine inputs
-    InputRegType inputs[4];
+    TevCombiner::Operands ops;
     for (int i = 0; i < 3; i++)
     {
-      inputs[BLU_C + i].a = *m_ColorInputLUT[u32(cc.a.Value())][i];
-      inputs[BLU_C + i].b = *m_ColorInputLUT[u32(cc.b.Value())][i];
-      inputs[BLU_C + i].c = *m_ColorInputLUT[u32(cc.c.Value())][i];
-      inputs[BLU_C + i].d = *m_ColorInputLUT[u32(cc.d.Value())][i];
-    }
-    inputs[ALP_C].a = *m_AlphaInputLUT[u32(ac.a.Value())];
-    inputs[ALP_C].b = *m_AlphaInputLUT[u32(ac.b.Value())];
-    inputs[ALP_C].c = *m_AlphaInputLUT[u32(ac.c.Value())];
-    inputs[ALP_C].d = *m_AlphaInputLUT[u32(ac.d.Value())];
-
-    if (cc.bias != TevBias::Compare)
-      DrawColorRegular(cc, inputs);
-    else
-      DrawColorCompare(cc, inputs);
-
-    if (cc.clamp)
-    {
-      Reg[u32(cc.dest.Value())][RED_C] = Clamp255(Reg[u32(cc.dest.Value())][RED_C]);
-      Reg[u32(cc.dest.Value())][GRN_C] = Clamp255(Reg[u32(cc.dest.Value())][GRN_C]);
-      Reg[u32(cc.dest.Value())][BLU_C] = Clamp255(Reg[u32(cc.dest.Value())][BLU_C]);
-    }
-    else
-    {
-      Reg[u32(cc.dest.Value())][RED_C] = Clamp1024(Reg[u32(cc.dest.Value())][RED_C]);
-      Reg[u32(cc.dest.Value())][GRN_C] = Clamp1024(Reg[u32(cc.dest.Value())][GRN_C]);
-      Reg[u32(cc.dest.Value())][BLU_C] = Clamp1024(Reg[u32(cc.dest.Value())][BLU_C]);
+      ops.a[BLU_C + i] = *m_ColorInputLUT[u32(cc.a.Value())][i];
+      ops.b[BLU_C + i] = *m_ColorInputLUT[u32(cc.b.Value())][i];
+      ops.c[BLU_C + i] = *m_ColorInputLUT[u32(cc.c.Value())][i];
+      ops.d[BLU_C + i] = *m_ColorInputLUT[u32(cc.d.Value())][i];
     }
-
-    if (ac.bias != TevBias::Compare)
-      DrawAlphaRegular(ac, inputs);
+    ops.a[ALP_C] = *m_AlphaInputLUT[u32(ac.a.Value())];
+    ops.b[ALP_C] = *m_AlphaInputLUT[u32(ac.b.Value())];
+    ops.c[ALP_C] = *m_AlphaInputLUT[u32(ac.c.Value())];
+    ops.d[ALP_C] = *m_AlphaInputLUT[u32(ac.d.Value())];
+
+    // Evaluate both combiners for all components at once, unless one of them uses compare mode
+    s16 result[4];
+    if (cc.bias != TevBias::Compare && ac.bias != TevBias::Compare)
+      TevCombiner::CombineRegular(ops, cc, ac, result);
     else
-      DrawAlphaCompare(ac, inputs);
+      CombineScalar(ops, cc, ac, result);
 
-    if (ac.clamp)
-      Reg[u32(ac.dest.Value())][ALP_C] = Clamp255(Reg[u32(ac.dest.Value())][ALP_C]);
-    else
-      Reg[u32(ac.dest.Value())][ALP_C] = Clamp1024(Reg[u32(ac.dest.Value())][ALP_C]);
+    Reg[u32(cc.dest.Value())][RED_C] = result[RED_C];
+    Reg[u32(cc.dest.Value())][GRN_C] = result[GRN_C];
+    Reg[u32(cc.dest.Value())][BLU_C] = result[BLU_C];
+    Reg[u32(ac.dest.Value())][ALP_C] = result[ALP_C];
 
 #if ALLOW_TEV_DUMPS
     if (g_ActiveConfig.bDumpTevStages)
@@ -829,18 +849,20 @@ void Tev::Draw()
   if (late_ztest && bpmem.zmode.testenable)
   {
     // TODO: Check against hw if these values get incremented even if depth testing is disabled
-    EfbInterface::IncPerfCounterQuadCount(PQ_ZCOMP_INPUT);
+    Counters.perf_pixels[PQ_ZCOMP_INPUT]++;
 
     if (!EfbInterface::ZCompare(Position[0], Position[1], Position[2]))
       return;
 
-    EfbInterface::IncPerfCounterQuadCount(PQ_ZCOMP_OUTPUT);
+    Counters.perf_pixels[PQ_ZCOMP_OUTPUT]++;
   }
 
   // The GC/Wii GPU rasterizes in 2x2 pixel groups, so bounding box values will be rounded to the
   // extents of these groups, rather than the exact pixel.
-  BoundingBox::Update(static_cast<u16>(Position[0] & ~1), static_cast<u16>(Position[0] | 1),
-                      static_cast<u16>(Position[1] & ~1), static_cast<u16>(Position[1] | 1));
+  Counters.bbox_left = std::min(Counters.bbox_left, static_cast<u16>(Position[0] & ~1));
+  Counters.bbox_right = std::max(Counters.bbox_right, static_cast<u16>(Position[0] | 1));
+  Counters.bbox_top = std::min(Counters.bbox_top, static_cast<u16>(Position[1] & ~1));
+  Counters.bbox_bottom = std::max(Counters.bbox_bottom, static_cast<u16>(Position[1] | 1));
 
 #if ALLOW_TEV_DUMPS
   if (g_ActiveConfig.bDumpTevStages)
@@ -862,8 +884,8 @@ void Tev::Draw()
   }
 #endif
 
-  INCSTAT(g_stats.this_frame.tev_pixels_out);
-  EfbInterface::IncPerfCounterQuadCount(PQ_BLEND_INPUT);
+  Counters.tev_pixels_out++;
+  Counters.perf_pixels[PQ_BLEND_INPUT]++;
 
   EfbInterface::BlendTev(Position[0], Position[1], output);
 }
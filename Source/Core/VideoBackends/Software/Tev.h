@@ -3,7 +3,12 @@
 
 #pragma once
 
+#include <array>
+
+#include "Common/CommonTypes.h"
+#include "VideoBackends/Software/TevCombiner.h"
 #include "VideoCommon/BPMemory.h"
+#include "VideoCommon/PerfQueryBase.h"
 
 class Tev
 {
@@ -58,14 +63,32 @@ class Tev
 
   void SetRasColor(RasColorChan colorChan, int swaptable);
 
-  void DrawColorRegular(const TevStageCombiner::ColorCombiner& cc, const InputRegType inputs[4]);
-  void DrawColorCompare(const TevStageCombiner::ColorCombiner& cc, const InputRegType inputs[4]);
-  void DrawAlphaRegular(const TevStageCombiner::AlphaCombiner& ac, const InputRegType inputs[4]);
-  void DrawAlphaCompare(const TevStageCombiner::AlphaCombiner& ac, const InputRegType inputs[4]);
+  void DrawColorRegular(const TevStageCombiner::ColorCombiner& cc, const InputRegType inputs[4],
+                        s16* out);
+  void DrawColorCompare(const TevStageCombiner::ColorCombiner& cc, const InputRegType inputs[4],
+                        s16* out);
+  void DrawAlphaRegular(const TevStageCombiner::AlphaCombiner& ac, const InputRegType inputs[4],
+                        s16* out);
+  void DrawAlphaCompare(const TevStageCombiner::AlphaCombiner& ac, const InputRegType inputs[4],
+                        s16* out);
 
   void Indirect(unsigned int stageNum, s32 s, s32 t);
 
 public:
+  // Statistics gathered by this unit. Every rasterizer thread owns its own Tev, so these are
+  // accumulated locally and folded into the global counters once a batch has been drawn.
+  struct PixelCounters
+  {
+    u32 rasterized_pixels = 0;
+    u32 tev_pixels_in = 0;
+    u32 tev_pixels_out = 0;
+    std::array<u32, PQ_NUM_MEMBERS> perf_pixels{};
+    u16 bbox_left = 0xFFFF;
+    u16 bbox_right = 0;
+    u16 bbox_top = 0xFFFF;
+    u16 bbox_bottom = 0;
+  };
+
   s32 Position[3];
   u8 Color[2][4];  // must be RGBA for correct swap table ordering
   TextureCoordinateType Uv[8];
@@ -87,4 +110,11 @@ public:
   void Draw();
 
   void SetRegColor(int reg, int comp, s16 color);
+
+  // Evaluates the combiners of a stage one component at a time, compare modes included, and
+  // writes the clamped results in ABGR order. TevCombiner's implementations must match this.
+  void CombineScalar(const TevCombiner::Operands& ops, const TevStageCombiner::ColorCombiner& cc,
+                     const TevStageCombiner::AlphaCombiner& ac, s16* out);
+
+  PixelCounters Counters;
 };
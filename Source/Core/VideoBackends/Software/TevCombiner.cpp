@@ -0,0 +1,147 @@
+// Copyright 2021 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "VideoBackends/Software/TevCombiner.h"
+
+#include <algorithm>
+
+#include "Common/CPUDetect.h"
+#include "Common/CommonTypes.h"
+#include "Common/Intrinsics.h"
+
+namespace TevCombiner
+{
+// Indexed by TevBias and TevScale respectively
+constexpr s32 BIAS[4] = {0, 128, -128, 0};
+constexpr u32 SCALE_LSHIFT[4] = {0, 1, 2, 0};
+constexpr u32 SCALE_RSHIFT[4] = {0, 0, 0, 1};
+
+constexpr int ALP_C = 0;
+constexpr int BLU_C = 1;
+constexpr int RED_C = 3;
+
+static s32 SignExtend11(s16 value)
+{
+  return static_cast<s32>(static_cast<u32>(value) << 21) >> 21;
+}
+
+static s16 Clamp(s32 value, bool clamp)
+{
+  const s16 in = static_cast<s16>(value);
+  return clamp ? std::clamp<s16>(in, 0, 255) : std::clamp<s16>(in, -1024, 1023);
+}
+
+void CombineRegular_Generic(const Operands& ops, const TevStageCombiner::ColorCombiner& cc,
+                            const TevStageCombiner::AlphaCombiner& ac, s16* out)
+{
+  const u32 color_lshift = SCALE_LSHIFT[u32(cc.scale.Value())];
+  const u32 color_rshift = SCALE_RSHIFT[u32(cc.scale.Value())];
+  for (int i = BLU_C; i <= RED_C; i++)
+  {
+    const s32 a = ops.a[i] & 0xFF;
+    const s32 b = ops.b[i] & 0xFF;
+    const s32 c = (ops.c[i] & 0xFF) + ((ops.c[i] & 0xFF) >> 7);
+    const s32 d = SignExtend11(ops.d[i]);
+
+    s32 temp = a * (256 - c) + (b * c);
+    temp <<= color_lshift;
+    temp += (cc.scale == TevScale::Divide2) ? 0 : (cc.op == TevOp::Sub) ? 127 : 128;
+    temp >>= 8;
+    temp = cc.op == TevOp::Sub ? -temp : temp;
+
+    s32 result = ((d + BIAS[u32(cc.bias.Value())]) << color_lshift) + temp;
+    result = result >> color_rshift;
+
+    out[i] = Clamp(result, cc.clamp);
+  }
+
+  const u32 alpha_lshift = SCALE_LSHIFT[u32(ac.scale.Value())];
+  const u32 alpha_rshift = SCALE_RSHIFT[u32(ac.scale.Value())];
+  const s32 a = ops.a[ALP_C] & 0xFF;
+  const s32 b = ops.b[ALP_C] & 0xFF;
+  const s32 c = (ops.c[ALP_C] & 0xFF) + ((ops.c[ALP_C] & 0xFF) >> 7);
+  const s32 d = SignExtend11(ops.d[ALP_C]);
+
+  s32 temp = a * (256 - c) + (b * c);
+  temp <<= alpha_lshift;
+  temp += (ac.scale != TevScale::Divide2) ? 0 : (ac.op == TevOp::Sub) ? 127 : 128;
+  temp = ac.op == TevOp::Sub ? (-temp >> 8) : (temp >> 8);
+
+  s32 result = ((d + BIAS[u32(ac.bias.Value())]) << alpha_lshift) + temp;
+  result = result >> alpha_rshift;
+
+  out[ALP_C] = Clamp(result, ac.clamp);
+}
+
+#ifdef _M_X86
+FUNCTION_TARGET_SSR41
+void CombineRegular_SSE41(const Operands& ops, const TevStageCombiner::ColorCombiner& cc,
+                          const TevStageCombiner::AlphaCombiner& ac, s16* out)
+{
+  const u32 color_scale = u32(cc.scale.Value());
+  const u32 alpha_scale = u32(ac.scale.Value());
+  const bool color_sub = cc.op == TevOp::Sub;
+  const bool alpha_sub = ac.op == TevOp::Sub;
+
+  // Per-lane parameters, lane 0 is alpha and lanes 1-3 are blue, green and red
+  const auto per_lane = [](s32 alpha, s32 color) {
+    return _mm_setr_epi32(alpha, color, color, color);
+  };
+  const __m128i lshift_mul =
+      per_lane(1 << SCALE_LSHIFT[alpha_scale], 1 << SCALE_LSHIFT[color_scale]);
+  const __m128i round = per_lane((ac.scale != TevScale::Divide2) ? 0 : alpha_sub ? 127 : 128,
+                                 (cc.scale == TevScale::Divide2) ? 0 : color_sub ? 127 : 128);
+  const __m128i sub_mask = per_lane(alpha_sub ? -1 : 0, color_sub ? -1 : 0);
+  const __m128i rshift_mask =
+      per_lane(SCALE_RSHIFT[alpha_scale] ? -1 : 0, SCALE_RSHIFT[color_scale] ? -1 : 0);
+  const __m128i bias = per_lane(BIAS[u32(ac.bias.Value())], BIAS[u32(cc.bias.Value())]);
+  const __m128i clamp_min = per_lane(ac.clamp ? 0 : -1024, cc.clamp ? 0 : -1024);
+  const __m128i clamp_max = per_lane(ac.clamp ? 255 : 1023, cc.clamp ? 255 : 1023);
+
+  const __m128i byte_mask = _mm_set1_epi32(0xFF);
+  const __m128i a = _mm_and_si128(
+      _mm_cvtepi16_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(ops.a))), byte_mask);
+  const __m128i b = _mm_and_si128(
+      _mm_cvtepi16_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(ops.b))), byte_mask);
+  __m128i c = _mm_and_si128(
+      _mm_cvtepi16_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(ops.c))), byte_mask);
+  c = _mm_add_epi32(c, _mm_srli_epi32(c, 7));
+  __m128i d = _mm_cvtepi16_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(ops.d)));
+  d = _mm_srai_epi32(_mm_slli_epi32(d, 21), 21);
+
+  __m128i temp = _mm_add_epi32(_mm_mullo_epi32(a, _mm_sub_epi32(_mm_set1_epi32(256), c)),
+                               _mm_mullo_epi32(b, c));
+  temp = _mm_add_epi32(_mm_mullo_epi32(temp, lshift_mul), round);
+
+  // The color combiner negates after shifting, the alpha combiner before.
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i shifted = _mm_srai_epi32(temp, 8);
+  const __m128i negated = _mm_blend_epi16(_mm_sub_epi32(zero, shifted),
+                                          _mm_srai_epi32(_mm_sub_epi32(zero, temp), 8), 0x03);
+  temp = _mm_blendv_epi8(shifted, negated, sub_mask);
+
+  __m128i result = _mm_add_epi32(_mm_mullo_epi32(_mm_add_epi32(d, bias), lshift_mul), temp);
+  result = _mm_blendv_epi8(result, _mm_srai_epi32(result, 1), rshift_mask);
+
+  // Truncate to 16 bits like the TEV registers do before clamping.
+  result = _mm_srai_epi32(_mm_slli_epi32(result, 16), 16);
+  result = _mm_min_epi32(_mm_max_epi32(result, clamp_min), clamp_max);
+
+  _mm_storel_epi64(reinterpret_cast<__m128i*>(out), _mm_packs_epi32(result, result));
+}
+#endif
+
+void CombineRegular(const Operands& ops, const TevStageCombiner::ColorCombiner& cc,
+                    const TevStageCombiner::AlphaCombiner& ac, s16* out)
+{
+#ifdef _M_X86
+  if (cpu_info.bSSE4_1)
+  {
+    CombineRegular_SSE41(ops, cc, ac, out);
+    return;
+  }
+#endif
+
+  CombineRegular_Generic(ops, cc, ac, out);
+}
+}  // namespace TevCombiner
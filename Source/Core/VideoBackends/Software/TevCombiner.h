@@ -0,0 +1,35 @@
+// Copyright 2021 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "Common/CommonTypes.h"
+#include "VideoCommon/BPMemory.h"
+
+// Evaluates the regular (non-compare) color and alpha combiners of a TEV stage for all four
+// components of a pixel at once. The generic implementation is the bit-exact reference for the
+// SIMD implementations.
+namespace TevCombiner
+{
+// Combiner operands in ABGR order, as read from the TEV registers. They are truncated to the
+// hardware input widths (8 bits for a/b/c, signed 11 bits for d) by the combiner.
+struct Operands
+{
+  s16 a[4];
+  s16 b[4];
+  s16 c[4];
+  s16 d[4];
+};
+
+// Writes the clamped results in ABGR order. The color combiner produces the blue, green and red
+// components, the alpha combiner the alpha component. Neither may use TevBias::Compare.
+void CombineRegular(const Operands& ops, const TevStageCombiner::ColorCombiner& cc,
+                    const TevStageCombiner::AlphaCombiner& ac, s16* out);
+
+void CombineRegular_Generic(const Operands& ops, const TevStageCombiner::ColorCombiner& cc,
+                            const TevStageCombiner::AlphaCombiner& ac, s16* out);
+#ifdef _M_X86
+void CombineRegular_SSE41(const Operands& ops, const TevStageCombiner::ColorCombiner& cc,
+                          const TevStageCombiner::AlphaCombiner& ac, s16* out);
+#endif
+}  // namespace TevCombiner
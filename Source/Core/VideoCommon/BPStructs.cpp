@@ -663,9 +663,18 @@ static void BPWritten(const BPCmd& bp)
   case BPMEM_TX_SETIMAGE1_4:
   case BPMEM_TX_SETIMAGE2:
   case BPMEM_TX_SETIMAGE2_4:
+    TextureCacheBase::InvalidateAllBindPoints();
+    return;
   case BPMEM_TX_SETIMAGE3:
   case BPMEM_TX_SETIMAGE3_4:
     TextureCacheBase::InvalidateAllBindPoints();
+    // The address is usually written last, so the texture can be decoded ahead of the draw
+    if (bp.changes && g_texture_cache)
+    {
+      g_texture_cache->PrefetchTexture((bp.address & 0xFC) == BPMEM_TX_SETIMAGE3 ?
+                                           bp.address - BPMEM_TX_SETIMAGE3 :
+                                           bp.address - BPMEM_TX_SETIMAGE3_4 + 4);
+    }
     return;
   // -------------------------------
   // Set a TLUT
@@ -0,0 +1,86 @@
+// Copyright 2021 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "VideoCommon/DisplayListCache.h"
+
+#include <utility>
+
+#include "VideoCommon/DataReader.h"
+#include "VideoCommon/OpcodeDecoding.h"
+
+// The cache is emptied once it holds this many lists, so lists which are only called once can't
+// make it grow without bound.
+constexpr size_t MAX_ENTRIES = 4096;
+
+bool DisplayListCache::DecodeCommand(const u8* list_start, const u8* start, const u8* end,
+                                     Command* command)
+{
+  DataReader src(const_cast<u8*>(start), const_cast<u8*>(end));
+  *command = {};
+  command->opcode = src.Read<u8>();
+
+  switch (command->opcode)
+  {
+  case OpcodeDecoder::GX_NOP:
+  case OpcodeDecoder::GX_UNKNOWN_RESET:
+  case OpcodeDecoder::GX_CMD_CALL_DL:  // Display lists can't call other display lists
+  case OpcodeDecoder::GX_CMD_UNKNOWN_METRICS:
+  case OpcodeDecoder::GX_CMD_INVL_VC:
+    command->opcode = OpcodeDecoder::GX_NOP;
+    return true;
+
+  case OpcodeDecoder::GX_LOAD_CP_REG:
+    command->sub_cmd = src.Read<u8>();
+    command->value = src.Read<u32>();
+    return true;
+
+  case OpcodeDecoder::GX_LOAD_XF_REG:
+  {
+    const u32 cmd2 = src.Read<u32>();
+    command->count = static_cast<u16>(((cmd2 >> 16) & 15) + 1);
+    command->value = cmd2 & 0xFFFF;
+    command->data_offset = static_cast<u32>(src.GetPointer() - list_start);
+    command->data_size = command->count * sizeof(u32);
+    return true;
+  }
+
+  case OpcodeDecoder::GX_LOAD_INDX_A:
+  case OpcodeDecoder::GX_LOAD_INDX_B:
+  case OpcodeDecoder::GX_LOAD_INDX_C:
+  case OpcodeDecoder::GX_LOAD_INDX_D:
+  case OpcodeDecoder::GX_LOAD_BP_REG:
+    command->value = src.Read<u32>();
+    return true;
+
+  default:
+    if ((command->opcode & 0xC0) != 0x80)
+      return false;
+
+    command->count = src.Read<u16>();
+    command->data_offset = static_cast<u32>(src.GetPointer() - list_start);
+    command->data_size = static_cast<u32>(end - src.GetPointer());
+    return true;
+  }
+}
+
+const DisplayListCache::Entry* DisplayListCache::Find(u32 address, u32 size, u64 hash,
+                                                      u64 cp_state_hash) const
+{
+  const auto iter = m_entries.find(GetKey(address, size));
+  if (iter == m_entries.end() || iter->second.hash != hash ||
+      iter->second.cp_state_hash != cp_state_hash)
+  {
+    return nullptr;
+  }
+
+  return &iter->second;
+}
+
+void DisplayListCache::Insert(u32 address, u32 size, Entry entry)
+{
+  const u64 key = GetKey(address, size);
+  if (m_entries.size() >= MAX_ENTRIES && !m_entries.count(key))
+    m_entries.clear();
+
+  m_entries[key] = std::move(entry);
+}
@@ -0,0 +1,61 @@
+// Copyright 2021 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+
+// Keeps display lists in decoded form, so that a list which is called again with the same contents
+// can be replayed without decoding its opcodes. How many bytes the vertices of a primitive take up
+// depends on the vertex descriptor and the VATs, so a decoded list is only valid if those are the
+// same when it is called as when it was recorded.
+class DisplayListCache
+{
+public:
+  // One command of a display list, with its arguments already read out.
+  struct Command
+  {
+    u8 opcode;
+    // The CP register for GX_LOAD_CP_REG
+    u8 sub_cmd;
+    // The number of vertices of a primitive, or the number of words of an XF load
+    u16 count;
+    // The register value, the XF address, or the argument of an indexed XF load
+    u32 value;
+    // Where the vertices or XF data start within the list, and how many bytes they take up
+    u32 data_offset;
+    u32 data_size;
+  };
+
+  struct Entry
+  {
+    u64 hash = 0;
+    u64 cp_state_hash = 0;
+    u32 cycles = 0;
+    std::vector<Command> commands;
+  };
+
+  // Turns the opcode at [start, end) within the list beginning at list_start into a command.
+  // Opcodes without side effects become GX_NOP. Returns false if the opcode is unknown.
+  static bool DecodeCommand(const u8* list_start, const u8* start, const u8* end,
+                            Command* command);
+
+  // Returns the entry for the list at address if it was recorded with the same contents and CP
+  // state, or nullptr.
+  const Entry* Find(u32 address, u32 size, u64 hash, u64 cp_state_hash) const;
+
+  void Insert(u32 address, u32 size, Entry entry);
+
+  void Clear() { m_entries.clear(); }
+
+  size_t GetEntryCount() const { return m_entries.size(); }
+
+private:
+  static u64 GetKey(u32 address, u32 size) { return (u64(address) << 32) | size; }
+
+  std::unordered_map<u64, Entry> m_entries;
+};
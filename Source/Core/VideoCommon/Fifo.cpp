@@ -13,6 +13,7 @@
 #include "Common/FPURoundMode.h"
 #include "Common/MemoryUtil.h"
 #include "Common/MsgHandler.h"
+#include "Common/Tracing.h"
 
 #include "Core/ConfigManager.h"
 #include "Core/CoreTiming.h"
@@ -32,6 +33,9 @@ namespace Fifo
 {
 static constexpr u32 FIFO_SIZE = 2 * 1024 * 1024;
 static constexpr int GPU_TIME_SLOT_SIZE = 1000;
+// In deterministic GPU thread mode, the CPU thread waits for the GPU thread once this much
+// preprocessed data hasn't been seen by the GPU thread yet.
+static constexpr size_t MAX_DETERMINISTIC_GPU_SKEW = FIFO_SIZE / 4;
 
 static Common::BlockingLoop s_gpu_mainloop;
 
@@ -159,6 +163,8 @@ void SyncGPU(SyncGPUReason reason, bool may_move_read_ptr)
 {
   if (s_use_deterministic_gpu_thread)
   {
+    // Make sure the GPU thread has seen all the data that has been preprocessed so far
+    s_gpu_mainloop.Wakeup();
     s_gpu_mainloop.Wait();
     if (!s_gpu_mainloop.IsRunning())
       return;
@@ -244,7 +250,8 @@ static void ReadDataFromFifo(u32 readPtr)
 }
 
 // The deterministic_gpu_thread version.
-static void ReadDataFromFifoOnCPU(u32 readPtr)
+// The GPU thread is not woken up here; RunGpuOnCpu hands over the data once per time slot.
+static void ReadDataFromFifoOnCPU(u32 readPtr, u32* cycles)
 {
   constexpr size_t len = 32;
   u8* write_ptr = s_video_buffer_write_ptr;
@@ -274,7 +281,7 @@ static void ReadDataFromFifoOnCPU(u32 readPtr)
   }
   Memory::CopyFromEmu(s_video_buffer_write_ptr, readPtr, len);
   s_video_buffer_pp_read_ptr = OpcodeDecoder::Run<true>(
-      DataReader(s_video_buffer_pp_read_ptr, write_ptr + len), nullptr, false);
+      DataReader(s_video_buffer_pp_read_ptr, write_ptr + len), cycles, false);
   // This would have to be locked if the GPU thread didn't spin.
   s_video_buffer_write_ptr = write_ptr + len;
 }
@@ -307,6 +314,8 @@ void RunGpuLoop()
         if (!s_emu_running_state.IsSet())
           return;
 
+        TRACE_SCOPE("gpu", "RunGpuLoop");
+
         if (s_use_deterministic_gpu_thread)
         {
           // All the fifo/CP stuff is on the CPU.  We just need to run the opcode decoder.
@@ -319,6 +328,12 @@ void RunGpuLoop()
                 OpcodeDecoder::Run(DataReader(s_video_buffer_read_ptr, write_ptr), nullptr, false);
             s_video_buffer_seen_ptr = write_ptr;
           }
+          else
+          {
+            // The CPU thread wakes us up once per time slot with new data, so sleep until then
+            // instead of polling the write pointer.
+            s_gpu_mainloop.AllowSleep();
+          }
         }
         else
         {
@@ -446,15 +461,31 @@ static int RunGpuOnCpu(int ticks)
 {
   CommandProcessor::SCPFifoStruct& fifo = CommandProcessor::fifo;
   bool reset_simd_state = false;
+  bool wake_gpu_thread = false;
   int available_ticks = int(ticks * SConfig::GetInstance().fSyncGpuOverclock) + s_sync_ticks.load();
+
+  // Bound how far the GPU thread can fall behind. This only depends on the host's speed, and the
+  // GPU thread never feeds anything back to the CPU thread outside of SyncGPU, so it doesn't
+  // affect determinism.
+  if (s_use_deterministic_gpu_thread &&
+      static_cast<size_t>(s_video_buffer_write_ptr.load() - s_video_buffer_seen_ptr.load()) >
+          MAX_DETERMINISTIC_GPU_SKEW)
+  {
+    s_gpu_mainloop.Wait();
+  }
+
   while (fifo.bFF_GPReadEnable.load(std::memory_order_relaxed) &&
          fifo.CPReadWriteDistance.load(std::memory_order_relaxed) && !AtBreakpoint() &&
          available_ticks >= 0)
   {
     if (s_use_deterministic_gpu_thread)
     {
-      ReadDataFromFifoOnCPU(fifo.CPReadPointer.load(std::memory_order_relaxed));
-      s_gpu_mainloop.Wakeup();
+      // The preprocessor computes the same cycle counts as the GPU would, so the CPU consumes
+      // the FIFO at the same rate as in single core mode.
+      u32 cycles = 0;
+      ReadDataFromFifoOnCPU(fifo.CPReadPointer.load(std::memory_order_relaxed), &cycles);
+      available_ticks -= cycles;
+      wake_gpu_thread = true;
     }
     else
     {
@@ -487,6 +518,10 @@ static int RunGpuOnCpu(int ticks)
 
   CommandProcessor::SetCPStatusFromGPU();
 
+  // Hand the whole chunk over to the GPU thread at once
+  if (wake_gpu_thread)
+    s_gpu_mainloop.Wakeup();
+
   if (reset_simd_state)
   {
     FPURoundMode::LoadSIMDState();
@@ -0,0 +1,592 @@
+// Copyright 2021 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "VideoCommon/HiresTexturePack.h"
+
+#include <algorithm>
+#include <array>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <utility>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "Common/Align.h"
+#include "Common/FileUtil.h"
+#include "Common/StringUtil.h"
+#include "VideoCommon/AbstractTexture.h"
+
+namespace
+{
+constexpr u32 PACK_MAGIC = 0x4B505444;  // "DTPK"
+constexpr u32 PACK_VERSION = 1;
+constexpr u64 LEVEL_ALIGNMENT = 16;
+
+struct PackHeader
+{
+  u32 magic;
+  u32 version;
+  u64 fingerprint;
+  u64 index_offset;
+  u64 index_size;
+  u32 texture_count;
+  u32 pad;
+};
+static_assert(sizeof(PackHeader) == 40);
+
+#pragma pack(push, 1)
+struct PackLevel
+{
+  u32 format;
+  u32 width;
+  u32 height;
+  u32 row_length;
+  u64 offset;
+  u64 size;
+};
+#pragma pack(pop)
+
+template <typename T>
+void Append(std::vector<u8>* buffer, const T& value)
+{
+  const size_t offset = buffer->size();
+  buffer->resize(offset + sizeof(T));
+  std::memcpy(buffer->data() + offset, &value, sizeof(T));
+}
+
+// Reads from the index, failing instead of reading past its end
+class IndexReader
+{
+public:
+  IndexReader(const u8* data, size_t size) : m_data(data), m_end(data + size) {}
+
+  template <typename T>
+  bool Read(T* value)
+  {
+    return ReadBytes(value, sizeof(T));
+  }
+
+  bool ReadBytes(void* dst, size_t size)
+  {
+    if (static_cast<size_t>(m_end - m_data) < size)
+      return false;
+    std::memcpy(dst, m_data, size);
+    m_data += size;
+    return true;
+  }
+
+private:
+  const u8* m_data;
+  const u8* m_end;
+};
+
+// Checks that a level read from the index has a format the loaders produce, and enough data for
+// its dimensions, so that uploading it doesn't read past the end of the level
+bool IsValidLevel(const PackLevel& level)
+{
+  const auto format = static_cast<AbstractTextureFormat>(level.format);
+  switch (format)
+  {
+  case AbstractTextureFormat::RGBA8:
+  case AbstractTextureFormat::DXT1:
+  case AbstractTextureFormat::DXT3:
+  case AbstractTextureFormat::DXT5:
+  case AbstractTextureFormat::BPTC:
+    break;
+  default:
+    return false;
+  }
+
+  const u32 block_size = AbstractTexture::GetBlockSizeForFormat(format);
+  if (level.width == 0 || level.height == 0 || level.row_length < level.width ||
+      level.row_length > UINT32_MAX - block_size)
+  {
+    return false;
+  }
+
+  const u64 rows = (u64{level.height} + block_size - 1) / block_size;
+  const u64 stride = AbstractTexture::CalculateStrideForFormat(
+      format, Common::AlignUp(level.row_length, block_size));
+  return level.size >= stride * rows;
+}
+
+u16 EncodeRGB565(int r, int g, int b)
+{
+  return static_cast<u16>(((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3));
+}
+
+std::array<int, 3> DecodeRGB565(u16 color)
+{
+  const int r = (color >> 11) & 0x1F;
+  const int g = (color >> 5) & 0x3F;
+  const int b = color & 0x1F;
+  return {(r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2)};
+}
+
+void EncodeColorBlock(u8* dst, const u8* src, u32 src_stride)
+{
+  // The endpoints are the corners of the bounding box of the colors, inset by 1/16th of its size
+  // so that outliers don't take up the whole range. This is what real-time encoders do, and is
+  // good enough for the kind of textures packs contain.
+  std::array<int, 3> min_color{255, 255, 255};
+  std::array<int, 3> max_color{0, 0, 0};
+  for (u32 y = 0; y < 4; ++y)
+  {
+    for (u32 x = 0; x < 4; ++x)
+    {
+      const u8* texel = src + y * src_stride + x * 4;
+      for (int c = 0; c < 3; ++c)
+      {
+        min_color[c] = std::min<int>(min_color[c], texel[c]);
+        max_color[c] = std::max<int>(max_color[c], texel[c]);
+      }
+    }
+  }
+  for (int c = 0; c < 3; ++c)
+  {
+    const int inset = (max_color[c] - min_color[c]) >> 4;
+    min_color[c] += inset;
+    max_color[c] -= inset;
+  }
+
+  // Use the diagonal of the box the colors are spread along, by flipping red and blue when they
+  // go the opposite way of green.
+  std::array<int, 3> sum{};
+  for (u32 i = 0; i < 16; ++i)
+  {
+    for (int c = 0; c < 3; ++c)
+      sum[c] += src[(i / 4) * src_stride + (i % 4) * 4 + c];
+  }
+  int covariance_rg = 0;
+  int covariance_bg = 0;
+  for (u32 i = 0; i < 16; ++i)
+  {
+    const u8* texel = src + (i / 4) * src_stride + (i % 4) * 4;
+    const int g = texel[1] * 16 - sum[1];
+    covariance_rg += (texel[0] * 16 - sum[0]) / 16 * g / 16;
+    covariance_bg += (texel[2] * 16 - sum[2]) / 16 * g / 16;
+  }
+  if (covariance_rg < 0)
+    std::swap(min_color[0], max_color[0]);
+  if (covariance_bg < 0)
+    std::swap(min_color[2], max_color[2]);
+
+  u16 color0 = EncodeRGB565(max_color[0], max_color[1], max_color[2]);
+  u16 color1 = EncodeRGB565(min_color[0], min_color[1], min_color[2]);
+  // color0 has to be greater than color1 for four color blocks
+  if (color0 < color1)
+    std::swap(color0, color1);
+
+  u32 indices = 0;
+  if (color0 != color1)
+  {
+    const std::array<int, 3> c0 = DecodeRGB565(color0);
+    const std::array<int, 3> c1 = DecodeRGB565(color1);
+    std::array<std::array<int, 3>, 4> palette;
+    for (int c = 0; c < 3; ++c)
+    {
+      palette[0][c] = c0[c];
+      palette[1][c] = c1[c];
+      palette[2][c] = (2 * c0[c] + c1[c]) / 3;
+      palette[3][c] = (c0[c] + 2 * c1[c]) / 3;
+    }
+
+    for (u32 i = 0; i < 16; ++i)
+    {
+      const u8* texel = src + (i / 4) * src_stride + (i % 4) * 4;
+      u32 best_index = 0;
+      int best_error = INT_MAX;
+      for (u32 p = 0; p < 4; ++p)
+      {
+        int error = 0;
+        for (int c = 0; c < 3; ++c)
+          error += (texel[c] - palette[p][c]) * (texel[c] - palette[p][c]);
+        if (error < best_error)
+        {
+          best_error = error;
+          best_index = p;
+        }
+      }
+      indices |= best_index << (i * 2);
+    }
+  }
+
+  std::memcpy(dst, &color0, sizeof(color0));
+  std::memcpy(dst + 2, &color1, sizeof(color1));
+  std::memcpy(dst + 4, &indices, sizeof(indices));
+}
+
+void EncodeAlphaBlock(u8* dst, const u8* src, u32 src_stride)
+{
+  int min_alpha = 255;
+  int max_alpha = 0;
+  for (u32 i = 0; i < 16; ++i)
+  {
+    const int alpha = src[(i / 4) * src_stride + (i % 4) * 4 + 3];
+    min_alpha = std::min(min_alpha, alpha);
+    max_alpha = std::max(max_alpha, alpha);
+  }
+
+  // With alpha0 > alpha1, the block uses 6 interpolated values between them
+  u64 indices = 0;
+  if (max_alpha != min_alpha)
+  {
+    std::array<int, 8> palette;
+    palette[0] = max_alpha;
+    palette[1] = min_alpha;
+    for (int p = 1; p < 7; ++p)
+      palette[p + 1] = ((7 - p) * max_alpha + p * min_alpha) / 7;
+
+    for (u32 i = 0; i < 16; ++i)
+    {
+      const int alpha = src[(i / 4) * src_stride + (i % 4) * 4 + 3];
+      u64 best_index = 0;
+      for (u64 p = 1; p < 8; ++p)
+      {
+        if (std::abs(alpha - palette[p]) < std::abs(alpha - palette[best_index]))
+          best_index = p;
+      }
+      indices |= best_index << (i * 3);
+    }
+  }
+
+  dst[0] = static_cast<u8>(max_alpha);
+  dst[1] = static_cast<u8>(min_alpha);
+  for (int i = 0; i < 6; ++i)
+    dst[2 + i] = static_cast<u8>(indices >> (i * 8));
+}
+
+// Compresses an RGBA8 level. Blocks which go past the edge of the level repeat its last texels.
+HiresTexture::Level CompressLevel(const HiresTexture::Level& level, bool has_alpha)
+{
+  const u32 blocks_wide = (level.width + 3) / 4;
+  const u32 blocks_high = (level.height + 3) / 4;
+  const u32 block_size = has_alpha ? 16 : 8;
+
+  HiresTexture::Level compressed;
+  compressed.format = has_alpha ? AbstractTextureFormat::DXT5 : AbstractTextureFormat::DXT1;
+  compressed.width = level.width;
+  compressed.height = level.height;
+  compressed.row_length = blocks_wide * 4;
+  compressed.data.resize(static_cast<size_t>(blocks_wide) * blocks_high * block_size);
+
+  const u8* src = level.GetData();
+  u8* dst = compressed.data.data();
+  std::array<u8, 4 * 4 * 4> block;
+  for (u32 block_y = 0; block_y < blocks_high; ++block_y)
+  {
+    for (u32 block_x = 0; block_x < blocks_wide; ++block_x)
+    {
+      for (u32 y = 0; y < 4; ++y)
+      {
+        for (u32 x = 0; x < 4; ++x)
+        {
+          const u32 src_x = std::min(block_x * 4 + x, level.width - 1);
+          const u32 src_y = std::min(block_y * 4 + y, level.height - 1);
+          std::memcpy(&block[(y * 4 + x) * 4], src + (src_y * level.row_length + src_x) * 4, 4);
+        }
+      }
+
+      if (has_alpha)
+        EncodeDXT5Block(dst, block.data(), 4 * 4);
+      else
+        EncodeDXT1Block(dst, block.data(), 4 * 4);
+      dst += block_size;
+    }
+  }
+
+  return compressed;
+}
+}  // namespace
+
+void EncodeDXT1Block(u8* dst, const u8* src, u32 src_stride)
+{
+  EncodeColorBlock(dst, src, src_stride);
+}
+
+void EncodeDXT5Block(u8* dst, const u8* src, u32 src_stride)
+{
+  EncodeAlphaBlock(dst, src, src_stride);
+  EncodeColorBlock(dst + 8, src, src_stride);
+}
+
+HiresTexturePack::~HiresTexturePack()
+{
+  Unmap();
+}
+
+bool HiresTexturePack::Open(const std::string& path, u64 fingerprint)
+{
+  Unmap();
+  m_textures.clear();
+
+  if (!Map(path))
+    return false;
+
+  if (!ReadIndex(fingerprint))
+  {
+    Unmap();
+    m_textures.clear();
+    return false;
+  }
+
+  return true;
+}
+
+bool HiresTexturePack::ReadIndex(u64 fingerprint)
+{
+  PackHeader header;
+  if (m_size < sizeof(header))
+    return false;
+  std::memcpy(&header, m_data, sizeof(header));
+  if (header.magic != PACK_MAGIC || header.version != PACK_VERSION ||
+      header.fingerprint != fingerprint || header.index_offset > m_size ||
+      header.index_size > m_size - header.index_offset)
+  {
+    return false;
+  }
+
+  IndexReader reader(m_data + header.index_offset, header.index_size);
+  for (u32 i = 0; i < header.texture_count; ++i)
+  {
+    u16 name_length;
+    if (!reader.Read(&name_length))
+      return false;
+    std::string name(name_length, '\0');
+    u8 has_arbitrary_mipmaps;
+    u8 level_count;
+    if (!reader.ReadBytes(name.data(), name_length) || !reader.Read(&has_arbitrary_mipmaps) ||
+        !reader.Read(&level_count))
+    {
+      return false;
+    }
+
+    Texture& texture = m_textures[std::move(name)];
+    texture.has_arbitrary_mipmaps = has_arbitrary_mipmaps != 0;
+    for (u8 j = 0; j < level_count; ++j)
+    {
+      PackLevel level;
+      if (!reader.Read(&level) || level.offset > m_size || level.size > m_size - level.offset ||
+          !IsValidLevel(level))
+      {
+        return false;
+      }
+
+      texture.levels.push_back({static_cast<AbstractTextureFormat>(level.format), level.width,
+                                level.height, level.row_length, level.offset, level.size});
+    }
+  }
+
+  return true;
+}
+
+bool HiresTexturePack::GetTexture(const std::string& name,
+                                  std::vector<HiresTexture::Level>* levels,
+                                  bool* has_arbitrary_mipmaps) const
+{
+  const auto iter = m_textures.find(name);
+  if (iter == m_textures.end())
+    return false;
+
+  levels->clear();
+  for (const Level& level : iter->second.levels)
+  {
+    HiresTexture::Level& out = levels->emplace_back();
+    out.format = level.format;
+    out.width = level.width;
+    out.height = level.height;
+    out.row_length = level.row_length;
+    out.mapped_data = m_data + level.offset;
+    out.mapped_size = static_cast<size_t>(level.size);
+  }
+  *has_arbitrary_mipmaps = iter->second.has_arbitrary_mipmaps;
+  return true;
+}
+
+bool HiresTexturePack::Map(const std::string& path)
+{
+#ifdef _WIN32
+  const HANDLE file = CreateFileW(UTF8ToWString(path).c_str(), GENERIC_READ, FILE_SHARE_READ,
+                                  nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (file == INVALID_HANDLE_VALUE)
+    return false;
+  m_file_handle = file;
+
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+  {
+    Unmap();
+    return false;
+  }
+
+  m_mapping_handle = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (!m_mapping_handle)
+  {
+    Unmap();
+    return false;
+  }
+
+  m_data = static_cast<const u8*>(MapViewOfFile(m_mapping_handle, FILE_MAP_READ, 0, 0, 0));
+  if (!m_data)
+  {
+    Unmap();
+    return false;
+  }
+  m_size = static_cast<u64>(size.QuadPart);
+#else
+  const int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0)
+    return false;
+
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size == 0)
+  {
+    close(fd);
+    return false;
+  }
+
+  void* data = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED)
+    return false;
+
+  m_data = static_cast<const u8*>(data);
+  m_size = static_cast<u64>(st.st_size);
+#endif
+  return true;
+}
+
+void HiresTexturePack::Unmap()
+{
+#ifdef _WIN32
+  if (m_data)
+    UnmapViewOfFile(m_data);
+  if (m_mapping_handle)
+    CloseHandle(m_mapping_handle);
+  if (m_file_handle)
+    CloseHandle(m_file_handle);
+  m_mapping_handle = nullptr;
+  m_file_handle = nullptr;
+#else
+  if (m_data)
+    munmap(const_cast<u8*>(m_data), static_cast<size_t>(m_size));
+#endif
+  m_data = nullptr;
+  m_size = 0;
+}
+
+HiresTexturePack::Writer::~Writer()
+{
+  // Don't leave unfinished packs behind
+  if (m_file.IsOpen())
+  {
+    m_file.Close();
+    File::Delete(m_path + ".tmp");
+  }
+}
+
+bool HiresTexturePack::Writer::Open(const std::string& path, u64 fingerprint)
+{
+  m_path = path;
+  m_fingerprint = fingerprint;
+  m_index.clear();
+  m_texture_count = 0;
+
+  File::CreateFullPath(path);
+  if (!m_file.Open(path + ".tmp", "wb"))
+    return false;
+
+  // The real header is written by Finish, so an unfinished pack is never valid
+  const PackHeader header{};
+  return m_file.WriteBytes(&header, sizeof(header));
+}
+
+bool HiresTexturePack::Writer::AddTexture(const std::string& name,
+                                          const std::vector<HiresTexture::Level>& levels,
+                                          bool has_arbitrary_mipmaps, bool compress)
+{
+  if (name.size() > UINT16_MAX || levels.empty() || levels.size() > UINT8_MAX)
+    return false;
+
+  // Block compressed textures need the first level to be made of whole blocks
+  const HiresTexture::Level& first_level = levels[0];
+  compress = compress && first_level.format == AbstractTextureFormat::RGBA8 &&
+             first_level.width % 4 == 0 && first_level.height % 4 == 0;
+
+  bool has_alpha = false;
+  if (compress)
+  {
+    for (const HiresTexture::Level& level : levels)
+    {
+      const u8* data = level.GetData();
+      for (u32 y = 0; y < level.height && !has_alpha; ++y)
+      {
+        for (u32 x = 0; x < level.width; ++x)
+        {
+          if (data[(y * level.row_length + x) * 4 + 3] != 0xFF)
+          {
+            has_alpha = true;
+            break;
+          }
+        }
+      }
+    }
+  }
+
+  Append<u16>(&m_index, static_cast<u16>(name.size()));
+  m_index.insert(m_index.end(), name.begin(), name.end());
+  Append<u8>(&m_index, has_arbitrary_mipmaps);
+  Append<u8>(&m_index, static_cast<u8>(levels.size()));
+  for (const HiresTexture::Level& level : levels)
+  {
+    if (!WriteLevel(compress ? CompressLevel(level, has_alpha) : level))
+      return false;
+  }
+
+  m_texture_count++;
+  return true;
+}
+
+bool HiresTexturePack::Writer::WriteLevel(const HiresTexture::Level& level)
+{
+  static constexpr std::array<u8, LEVEL_ALIGNMENT> padding{};
+  const u64 offset = Common::AlignUp(m_file.Tell(), LEVEL_ALIGNMENT);
+  if (!m_file.WriteBytes(padding.data(), offset - m_file.Tell()) ||
+      !m_file.WriteBytes(level.GetData(), level.GetSize()))
+  {
+    return false;
+  }
+
+  const PackLevel pack_level{static_cast<u32>(level.format), level.width, level.height,
+                             level.row_length, offset, level.GetSize()};
+  Append(&m_index, pack_level);
+  return true;
+}
+
+bool HiresTexturePack::Writer::Finish()
+{
+  PackHeader header{};
+  header.magic = PACK_MAGIC;
+  header.version = PACK_VERSION;
+  header.fingerprint = m_fingerprint;
+  header.index_offset = m_file.Tell();
+  header.index_size = m_index.size();
+  header.texture_count = m_texture_count;
+
+  if (!m_file.WriteBytes(m_index.data(), m_index.size()) ||
+      !m_file.Seek(0, SEEK_SET) || !m_file.WriteBytes(&header, sizeof(header)) ||
+      !m_file.Close())
+  {
+    return false;
+  }
+
+  return File::Rename(m_path + ".tmp", m_path);
+}
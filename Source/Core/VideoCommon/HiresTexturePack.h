@@ -0,0 +1,97 @@
+// Copyright 2021 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/IOFile.h"
+#include "VideoCommon/HiresTextures.h"
+
+// A single file holding the custom textures of a game in the format they are uploaded in. It is
+// mapped into memory, so loading a texture from it needs neither decoding nor copying.
+//
+// Layout: a header, the data of every level, then an index which maps the texture names to the
+// offsets of their levels.
+class HiresTexturePack
+{
+public:
+  HiresTexturePack() = default;
+  ~HiresTexturePack();
+
+  HiresTexturePack(const HiresTexturePack&) = delete;
+  HiresTexturePack& operator=(const HiresTexturePack&) = delete;
+
+  // Fails if the file isn't a valid pack, or was created from a different set of textures
+  bool Open(const std::string& path, u64 fingerprint);
+
+  // Fills levels with the levels of the texture, which point into the pack
+  bool GetTexture(const std::string& name, std::vector<HiresTexture::Level>* levels,
+                  bool* has_arbitrary_mipmaps) const;
+
+  size_t GetTextureCount() const { return m_textures.size(); }
+
+  class Writer
+  {
+  public:
+    Writer() = default;
+    ~Writer();
+
+    Writer(const Writer&) = delete;
+    Writer& operator=(const Writer&) = delete;
+
+    // The pack is written to a temporary file, and only moved to path once it's finished
+    bool Open(const std::string& path, u64 fingerprint);
+
+    // RGBA8 levels are compressed to DXT1 or DXT5 if compress is set
+    bool AddTexture(const std::string& name, const std::vector<HiresTexture::Level>& levels,
+                    bool has_arbitrary_mipmaps, bool compress);
+    bool Finish();
+
+  private:
+    bool WriteLevel(const HiresTexture::Level& level);
+
+    File::IOFile m_file;
+    std::string m_path;
+    u64 m_fingerprint = 0;
+    std::vector<u8> m_index;
+    u32 m_texture_count = 0;
+  };
+
+private:
+  struct Level
+  {
+    AbstractTextureFormat format;
+    u32 width;
+    u32 height;
+    u32 row_length;
+    u64 offset;
+    u64 size;
+  };
+
+  struct Texture
+  {
+    bool has_arbitrary_mipmaps;
+    std::vector<Level> levels;
+  };
+
+  bool Map(const std::string& path);
+  void Unmap();
+  bool ReadIndex(u64 fingerprint);
+
+  const u8* m_data = nullptr;
+  u64 m_size = 0;
+#ifdef _WIN32
+  void* m_file_handle = nullptr;
+  void* m_mapping_handle = nullptr;
+#endif
+
+  std::unordered_map<std::string, Texture> m_textures;
+};
+
+// Compresses 4x4 blocks of RGBA8 texels
+void EncodeDXT1Block(u8* dst, const u8* src, u32 src_stride);
+void EncodeDXT5Block(u8* dst, const u8* src, u32 src_stride);
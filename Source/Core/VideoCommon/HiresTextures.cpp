@@ -4,6 +4,10 @@
 #include "VideoCommon/HiresTextures.h"
 
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <list>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -16,10 +20,10 @@
 
 #include <fmt/format.h>
 
+#include "Common/CPUDetect.h"
 #include "Common/CommonPaths.h"
 #include "Common/FileSearch.h"
 #include "Common/FileUtil.h"
-#include "Common/Flag.h"
 #include "Common/IOFile.h"
 #include "Common/Image.h"
 #include "Common/Logging/Log.h"
@@ -30,6 +34,7 @@
 #include "Common/Timer.h"
 #include "Core/Config/GraphicsSettings.h"
 #include "Core/ConfigManager.h"
+#include "VideoCommon/HiresTexturePack.h"
 #include "VideoCommon/OnScreenDisplay.h"
 #include "VideoCommon/VideoConfig.h"
 
@@ -42,11 +47,101 @@ struct DiskTexture
 constexpr std::string_view s_format_prefix{"tex1_"};
 
 static std::unordered_map<std::string, DiskTexture> s_textureMap;
-static std::unordered_map<std::string, std::shared_ptr<HiresTexture>> s_textureCache;
+
+namespace
+{
+enum class LoadState
+{
+  Queued,
+  Loading,
+  Loaded,
+  Failed,
+};
+
+struct CachedTexture
+{
+  LoadState state = LoadState::Queued;
+  // The native size of the texture, used to validate the custom texture
+  u32 width = 0;
+  u32 height = 0;
+  std::shared_ptr<HiresTexture> texture;
+  size_t size = 0;
+  // Only valid once the texture is loaded
+  std::list<std::string>::iterator lru_iter;
+};
+}  // namespace
+
+static std::unordered_map<std::string, CachedTexture> s_textureCache;
+// Names of the loaded textures, most recently used first
+static std::list<std::string> s_textureCacheLRU;
+static size_t s_textureCacheSize = 0;
+static size_t s_textureCacheBudget = 0;
 static std::mutex s_textureCacheMutex;
-static Common::Flag s_textureCacheAbortLoading;
 
-static std::thread s_prefetcher;
+// Textures the texture cache is waiting for are loaded before prefetched ones. New requests are
+// put in front, so the textures used by the current frame are loaded first.
+static std::deque<std::string> s_requests;
+static std::deque<std::string> s_prefetchRequests;
+static std::condition_variable s_requestsCondition;
+static bool s_stopLoaders = false;
+static std::vector<std::thread> s_loaders;
+static std::atomic<u32> s_loadCount{0};
+
+static size_t s_prefetchRemaining = 0;
+static u32 s_prefetchStartTime = 0;
+
+static std::shared_ptr<const HiresTexturePack> s_texturePack;
+
+static u64 CalculateTexturePackFingerprint(bool compress)
+{
+  std::vector<const std::pair<const std::string, DiskTexture>*> textures;
+  for (const auto& entry : s_textureMap)
+    textures.push_back(&entry);
+  std::sort(textures.begin(), textures.end(),
+            [](const auto* a, const auto* b) { return a->first < b->first; });
+
+  // Hashing the contents would mean reading every texture each time, so a texture that was edited
+  // is detected by its size and modification time instead
+  u64 fingerprint = compress;
+  for (const auto* texture : textures)
+  {
+    const File::FileInfo info(texture->second.path);
+    const u64 size = info.GetSize();
+    const s64 modification_time = info.GetModificationTime();
+    fingerprint = XXH64(texture->first.data(), texture->first.size(), fingerprint);
+    fingerprint = XXH64(texture->second.path.data(), texture->second.path.size(), fingerprint);
+    fingerprint = XXH64(&size, sizeof(size), fingerprint);
+    fingerprint = XXH64(&modification_time, sizeof(modification_time), fingerprint);
+  }
+  return fingerprint;
+}
+
+static void EraseCachedTexture(std::unordered_map<std::string, CachedTexture>::iterator iter)
+{
+  if (iter->second.state == LoadState::Loaded)
+  {
+    s_textureCacheSize -= iter->second.size;
+    s_textureCacheLRU.erase(iter->second.lru_iter);
+  }
+  s_textureCache.erase(iter);
+}
+
+static void StopLoaders()
+{
+  {
+    std::lock_guard<std::mutex> lk(s_textureCacheMutex);
+    s_stopLoaders = true;
+    s_requests.clear();
+    s_prefetchRequests.clear();
+    s_prefetchRemaining = 0;
+  }
+  s_requestsCondition.notify_all();
+
+  for (std::thread& loader : s_loaders)
+    loader.join();
+  s_loaders.clear();
+  s_stopLoaders = false;
+}
 
 void HiresTexture::Init()
 {
@@ -60,11 +155,7 @@ void HiresTexture::Shutdown()
 
 void HiresTexture::Update()
 {
-  if (s_prefetcher.joinable())
-  {
-    s_textureCacheAbortLoading.Set();
-    s_prefetcher.join();
-  }
+  StopLoaders();
 
   if (!g_ActiveConfig.bHiresTextures)
   {
@@ -72,11 +163,6 @@ void HiresTexture::Update()
     return;
   }
 
-  if (!g_ActiveConfig.bCacheHiresTextures)
-  {
-    s_textureCache.clear();
-  }
-
   const std::string& game_id = SConfig::GetInstance().GetGameID();
   const std::set<std::string> texture_directories =
       GetTextureDirectoriesWithGameId(File::GetUserPath(D_HIRESTEXTURES_IDX), game_id);
@@ -116,100 +202,213 @@ void HiresTexture::Update()
     }
   }
 
+  // Remove cached but deleted textures, and the ones which were still being loaded
+  auto iter = s_textureCache.begin();
+  while (iter != s_textureCache.end())
+  {
+    if (iter->second.state != LoadState::Loaded ||
+        s_textureMap.find(iter->first) == s_textureMap.end())
+    {
+      const auto erase_iter = iter++;
+      EraseCachedTexture(erase_iter);
+    }
+    else
+    {
+      iter++;
+    }
+  }
+
+  const size_t sys_mem = Common::MemPhysical();
   if (g_ActiveConfig.bCacheHiresTextures)
   {
-    // remove cached but deleted textures
-    auto iter = s_textureCache.begin();
-    while (iter != s_textureCache.end())
+    // keep 2GB memory for system stability if system RAM is 4GB+ - use half of memory in other
+    // cases
+    const size_t recommended_min_mem = 2 * size_t(1024 * 1024 * 1024);
+    s_textureCacheBudget =
+        (sys_mem / 2 < recommended_min_mem) ? (sys_mem / 2) : (sys_mem - recommended_min_mem);
+
+    for (const auto& entry : s_textureMap)
     {
-      if (s_textureMap.find(iter->first) == s_textureMap.end())
-      {
-        iter = s_textureCache.erase(iter);
-      }
-      else
-      {
-        iter++;
-      }
+      if (entry.first.find("_mip") == std::string::npos)
+        s_prefetchRequests.push_back(entry.first);
     }
+    s_prefetchRemaining = s_prefetchRequests.size();
+    s_prefetchStartTime = Common::Timer::GetTimeMs();
+  }
+  else
+  {
+    // Only keep the recently used textures around
+    s_textureCacheBudget = sys_mem / 16;
+  }
+
+  while (s_textureCacheSize > s_textureCacheBudget && !s_textureCacheLRU.empty())
+    EraseCachedTexture(s_textureCache.find(s_textureCacheLRU.back()));
 
-    s_textureCacheAbortLoading.Clear();
-    s_prefetcher = std::thread(Prefetch);
+  // Load the textures from the converted pack if it is up to date, or convert them otherwise.
+  // This has to be done before the loaders are started, as they read s_texturePack.
+  s_texturePack.reset();
+  if (g_ActiveConfig.bConvertHiresTextures && !s_textureMap.empty())
+  {
+    const bool compress = g_ActiveConfig.backend_info.bSupportsST3CTextures;
+    const u64 fingerprint = CalculateTexturePackFingerprint(compress);
+    const std::string pack_path =
+        File::GetUserPath(D_CACHE_IDX) + "HiresTextures" DIR_SEP + game_id + ".pack";
+
+    auto pack = std::make_shared<HiresTexturePack>();
+    if (pack->Open(pack_path, fingerprint))
+    {
+      INFO_LOG_FMT(VIDEO, "Loading {} custom textures from {}", pack->GetTextureCount(),
+                   pack_path);
+      s_texturePack = std::move(pack);
+    }
+    else
+    {
+      s_loaders.emplace_back(ConvertTextures, pack_path, fingerprint, compress);
+    }
   }
+
+  const int num_loaders = std::min(std::max(cpu_info.num_cores / 2, 1), 4);
+  for (int i = 0; i < num_loaders; ++i)
+    s_loaders.emplace_back(LoaderThread);
 }
 
 void HiresTexture::Clear()
 {
-  if (s_prefetcher.joinable())
-  {
-    s_textureCacheAbortLoading.Set();
-    s_prefetcher.join();
-  }
+  StopLoaders();
+  s_texturePack.reset();
   s_textureMap.clear();
   s_textureCache.clear();
+  s_textureCacheLRU.clear();
+  s_textureCacheSize = 0;
 }
 
-void HiresTexture::Prefetch()
+void HiresTexture::LoaderThread()
 {
-  Common::SetCurrentThreadName("Prefetcher");
-
-  size_t size_sum = 0;
-  const size_t sys_mem = Common::MemPhysical();
-  const size_t recommended_min_mem = 2 * size_t(1024 * 1024 * 1024);
-  // keep 2GB memory for system stability if system RAM is 4GB+ - use half of memory in other cases
-  const size_t max_mem =
-      (sys_mem / 2 < recommended_min_mem) ? (sys_mem / 2) : (sys_mem - recommended_min_mem);
+  Common::SetCurrentThreadName("Custom Texture Loader");
 
-  const u32 start_time = Common::Timer::GetTimeMs();
-  for (const auto& entry : s_textureMap)
+  std::unique_lock<std::mutex> lk(s_textureCacheMutex);
+  while (true)
   {
-    const std::string& base_filename = entry.first;
+    s_requestsCondition.wait(lk, [] {
+      return s_stopLoaders || !s_requests.empty() || !s_prefetchRequests.empty();
+    });
+    if (s_stopLoaders)
+      return;
 
-    if (base_filename.find("_mip") == std::string::npos)
+    const bool prefetch = s_requests.empty();
+    std::deque<std::string>& queue = prefetch ? s_prefetchRequests : s_requests;
+    const std::string base_filename = std::move(queue.front());
+    queue.pop_front();
+
+    if (prefetch && s_textureCacheSize >= s_textureCacheBudget)
     {
-      std::unique_lock<std::mutex> lk(s_textureCacheMutex);
+      OSD::AddMessage(
+          fmt::format("Custom Textures prefetching stopped after {:.1f} MB, the memory budget "
+                      "is used up",
+                      s_textureCacheSize / (1024.0 * 1024.0)),
+          10000);
+      s_prefetchRequests.clear();
+      s_prefetchRemaining = 0;
+      continue;
+    }
 
-      auto iter = s_textureCache.find(base_filename);
-      if (iter == s_textureCache.end())
+    // Textures which have been requested already are not prefetched again
+    auto [iter, inserted] = s_textureCache.try_emplace(base_filename);
+    if (prefetch ? inserted : iter->second.state == LoadState::Queued)
+    {
+      iter->second.state = LoadState::Loading;
+      const u32 width = iter->second.width;
+      const u32 height = iter->second.height;
+
+      // The texture is looked up again afterwards, as other threads may change the cache while
+      // it is unlocked.
+      lk.unlock();
+      std::shared_ptr<HiresTexture> texture = Load(base_filename, width, height);
+      lk.lock();
+      if (s_stopLoaders)
+        return;
+
+      CachedTexture& entry = s_textureCache.find(base_filename)->second;
+      if (texture)
       {
-        // unlock while loading a texture. This may result in a race condition where
-        // we'll load a texture twice, but it reduces the stuttering a lot.
-        lk.unlock();
-        std::unique_ptr<HiresTexture> texture = Load(base_filename, 0, 0);
-        lk.lock();
-        if (texture)
-        {
-          std::shared_ptr<HiresTexture> ptr(std::move(texture));
-          iter = s_textureCache.insert(iter, std::make_pair(base_filename, ptr));
-        }
+        entry.state = LoadState::Loaded;
+        entry.texture = std::move(texture);
+        // Levels mapped from a texture pack are left to the OS and don't count
+        for (const Level& l : entry.texture->m_levels)
+          entry.size += l.data.size();
+        s_textureCacheSize += entry.size;
+
+        // Prefetched textures go to the back, so they don't push out the ones in use
+        const auto lru_position = prefetch ? s_textureCacheLRU.end() : s_textureCacheLRU.begin();
+        entry.lru_iter = s_textureCacheLRU.insert(lru_position, base_filename);
+        while (s_textureCacheSize > s_textureCacheBudget && s_textureCacheLRU.size() > 1)
+          EraseCachedTexture(s_textureCache.find(s_textureCacheLRU.back()));
       }
-      if (iter != s_textureCache.end())
+      else
       {
-        for (const Level& l : iter->second->m_levels)
-          size_sum += l.data.size();
+        entry.state = LoadState::Failed;
       }
+      s_loadCount++;
     }
 
-    if (s_textureCacheAbortLoading.IsSet())
+    if (prefetch && s_prefetchRemaining != 0 && --s_prefetchRemaining == 0)
     {
-      return;
+      const u32 stop_time = Common::Timer::GetTimeMs();
+      OSD::AddMessage(fmt::format("Custom Textures loaded, {:.1f} MB in {:.1f}s",
+                                  s_textureCacheSize / (1024.0 * 1024.0),
+                                  (stop_time - s_prefetchStartTime) / 1000.0),
+                      10000);
     }
+  }
+}
+
+void HiresTexture::ConvertTextures(const std::string& path, u64 fingerprint, bool compress)
+{
+  Common::SetCurrentThreadName("Custom Texture Converter");
+
+  std::vector<std::string> names;
+  for (const auto& entry : s_textureMap)
+  {
+    if (entry.first.find("_mip") == std::string::npos)
+      names.push_back(entry.first);
+  }
+  std::sort(names.begin(), names.end());
+
+  HiresTexturePack::Writer writer;
+  if (!writer.Open(path, fingerprint))
+  {
+    ERROR_LOG_FMT(VIDEO, "Failed to create custom texture pack {}", path);
+    return;
+  }
 
-    if (size_sum > max_mem)
+  const u32 start_time = Common::Timer::GetTimeMs();
+  for (const std::string& name : names)
+  {
     {
-      Config::SetCurrent(Config::GFX_HIRES_TEXTURES, false);
+      std::lock_guard<std::mutex> lk(s_textureCacheMutex);
+      if (s_stopLoaders)
+        return;
+    }
 
-      OSD::AddMessage(
-          fmt::format(
-              "Custom Textures prefetching after {:.1f} MB aborted, not enough RAM available",
-              size_sum / (1024.0 * 1024.0)),
-          10000);
+    const std::unique_ptr<HiresTexture> texture = Load(name, 0, 0);
+    if (texture &&
+        !writer.AddTexture(name, texture->m_levels, texture->HasArbitraryMipmaps(), compress))
+    {
+      ERROR_LOG_FMT(VIDEO, "Failed to write custom texture pack {}", path);
       return;
     }
   }
 
+  if (!writer.Finish())
+  {
+    ERROR_LOG_FMT(VIDEO, "Failed to write custom texture pack {}", path);
+    return;
+  }
+
   const u32 stop_time = Common::Timer::GetTimeMs();
-  OSD::AddMessage(fmt::format("Custom Textures loaded, {:.1f} MB in {:.1f}s",
-                              size_sum / (1024.0 * 1024.0), (stop_time - start_time) / 1000.0),
+  OSD::AddMessage(fmt::format("Custom Textures converted in {:.1f}s, they will be loaded from "
+                              "the converted pack from now on",
+                              (stop_time - start_time) / 1000.0),
                   10000);
 }
 
@@ -261,27 +460,60 @@ u32 HiresTexture::CalculateMipCount(u32 width, u32 height)
   return mip_count;
 }
 
-std::shared_ptr<HiresTexture> HiresTexture::Search(TextureInfo& texture_info)
+std::shared_ptr<HiresTexture> HiresTexture::Search(TextureInfo& texture_info,
+                                                   std::string* pending_name)
 {
   const std::string base_filename = GenBaseName(texture_info);
+  if (base_filename.empty())
+    return nullptr;
 
   std::lock_guard<std::mutex> lk(s_textureCacheMutex);
 
-  auto iter = s_textureCache.find(base_filename);
-  if (iter != s_textureCache.end())
+  const auto [iter, inserted] = s_textureCache.try_emplace(base_filename);
+  CachedTexture& entry = iter->second;
+  if (inserted)
   {
-    return iter->second;
+    entry.width = texture_info.GetRawWidth();
+    entry.height = texture_info.GetRawHeight();
+    s_requests.push_front(base_filename);
+    s_requestsCondition.notify_one();
   }
 
-  std::shared_ptr<HiresTexture> ptr(
-      Load(base_filename, texture_info.GetRawWidth(), texture_info.GetRawHeight()));
+  if (entry.state == LoadState::Loaded)
+  {
+    s_textureCacheLRU.splice(s_textureCacheLRU.begin(), s_textureCacheLRU, entry.lru_iter);
+    return entry.texture;
+  }
+
+  if (entry.state != LoadState::Failed)
+    *pending_name = base_filename;
+  return nullptr;
+}
 
-  if (ptr && g_ActiveConfig.bCacheHiresTextures)
+std::shared_ptr<HiresTexture> HiresTexture::Lookup(const std::string& base_filename, bool* pending)
+{
+  std::lock_guard<std::mutex> lk(s_textureCacheMutex);
+
+  // The texture may have been evicted again already, in which case it is not waited on anymore
+  const auto iter = s_textureCache.find(base_filename);
+  if (iter == s_textureCache.end())
   {
-    s_textureCache[base_filename] = ptr;
+    *pending = false;
+    return nullptr;
   }
 
-  return ptr;
+  CachedTexture& entry = iter->second;
+  *pending = entry.state == LoadState::Queued || entry.state == LoadState::Loading;
+  if (entry.state != LoadState::Loaded)
+    return nullptr;
+
+  s_textureCacheLRU.splice(s_textureCacheLRU.begin(), s_textureCacheLRU, entry.lru_iter);
+  return entry.texture;
+}
+
+u32 HiresTexture::GetLoadCount()
+{
+  return s_loadCount.load();
 }
 
 std::unique_ptr<HiresTexture> HiresTexture::Load(const std::string& base_filename, u32 width,
@@ -292,6 +524,17 @@ std::unique_ptr<HiresTexture> HiresTexture::Load(const std::string& base_filenam
   if (filename_iter == s_textureMap.end())
     return nullptr;
 
+  // Textures in the converted pack only need to be pointed at
+  if (s_texturePack)
+  {
+    std::unique_ptr<HiresTexture> ret = std::unique_ptr<HiresTexture>(new HiresTexture());
+    if (s_texturePack->GetTexture(base_filename, &ret->m_levels, &ret->m_has_arbitrary_mipmaps))
+    {
+      ret->m_pack = s_texturePack;
+      return ret;
+    }
+  }
+
   // Try to load level 0 (and any mipmaps) from a DDS file.
   // If this fails, it's fine, we'll just load level0 again using SOIL.
   // Can't use make_unique due to private constructor.
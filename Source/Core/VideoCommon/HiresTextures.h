@@ -12,6 +12,7 @@
 #include "VideoCommon/TextureConfig.h"
 #include "VideoCommon/TextureInfo.h"
 
+class HiresTexturePack;
 enum class TextureFormat;
 
 std::set<std::string> GetTextureDirectoriesWithGameId(const std::string& root_directory,
@@ -25,7 +26,18 @@ public:
   static void Clear();
   static void Shutdown();
 
-  static std::shared_ptr<HiresTexture> Search(TextureInfo& texture_info);
+  // Returns the custom texture for the texture if it has been loaded. Otherwise, it is queued to
+  // be loaded in the background, and pending_name is set to the name to look it up with later.
+  static std::shared_ptr<HiresTexture> Search(TextureInfo& texture_info,
+                                              std::string* pending_name);
+
+  // Returns the custom texture with the given name if it has finished loading, and sets pending
+  // while it is still being loaded.
+  static std::shared_ptr<HiresTexture> Lookup(const std::string& base_filename, bool* pending);
+
+  // Incremented every time a custom texture finishes loading, so textures which are waiting on
+  // one only have to be looked up again when it changes.
+  static u32 GetLoadCount();
 
   static std::string GenBaseName(TextureInfo& texture_info, bool dump = false);
 
@@ -43,6 +55,13 @@ public:
     u32 width = 0;
     u32 height = 0;
     u32 row_length = 0;
+
+    // Used instead of data for levels which point into a texture pack
+    const u8* mapped_data = nullptr;
+    size_t mapped_size = 0;
+
+    const u8* GetData() const { return mapped_data ? mapped_data : data.data(); }
+    size_t GetSize() const { return mapped_data ? mapped_size : data.size(); }
   };
   std::vector<Level> m_levels;
 
@@ -52,8 +71,11 @@ private:
   static bool LoadDDSTexture(HiresTexture* tex, const std::string& filename);
   static bool LoadDDSTexture(Level& level, const std::string& filename, u32 mip_level);
   static bool LoadTexture(Level& level, const std::vector<u8>& buffer);
-  static void Prefetch();
+  static void LoaderThread();
+  static void ConvertTextures(const std::string& path, u64 fingerprint, bool compress);
 
   HiresTexture() {}
   bool m_has_arbitrary_mipmaps;
+  // Keeps the pack mapped while the levels point into it
+  std::shared_ptr<const HiresTexturePack> m_pack;
 };
@@ -10,10 +10,16 @@
 // Note that it IS NOT GENERALLY POSSIBLE to precompile display lists! You can compile them as they
 // are while interpreting them, and hope that the vertex format doesn't change, though, if you do
 // it right when they are called. The reason is that the vertex format affects the sizes of the
-// vertices.
+// vertices. DisplayListCache does exactly that, and only reuses a compiled list if the vertex
+// format is the same as when it was compiled.
 
 #include "VideoCommon/OpcodeDecoding.h"
 
+#include <utility>
+
+#include <xxhash.h>
+
+#include "Common/Assert.h"
 #include "Common/CommonTypes.h"
 #include "Common/Logging/Log.h"
 #include "Core/FifoPlayer/FifoRecorder.h"
@@ -22,6 +28,7 @@
 #include "VideoCommon/CPMemory.h"
 #include "VideoCommon/CommandProcessor.h"
 #include "VideoCommon/DataReader.h"
+#include "VideoCommon/DisplayListCache.h"
 #include "VideoCommon/Fifo.h"
 #include "VideoCommon/Statistics.h"
 #include "VideoCommon/VertexLoaderManager.h"
@@ -33,6 +40,110 @@ namespace
 {
 bool s_is_fifo_error_seen = false;
 
+DisplayListCache s_display_list_cache;
+
+// A display list whose commands are collected by Run while it is interpreted.
+struct DisplayListRecording
+{
+  const u8* list_start;
+  DisplayListCache::Entry entry;
+  bool valid = true;
+};
+DisplayListRecording* s_recording = nullptr;
+
+void RecordCommand(const u8* start, const u8* end)
+{
+  if (!s_recording->valid)
+    return;
+
+  DisplayListCache::Command command;
+  if (!DisplayListCache::DecodeCommand(s_recording->list_start, start, end, &command))
+    s_recording->valid = false;
+  else if (command.opcode != GX_NOP)
+    s_recording->entry.commands.push_back(command);
+}
+
+// Hashes the state which determines the size of vertices.
+u64 GetCPStateHash()
+{
+  const u64 hash = XXH64(&g_main_cp_state.vtx_desc, sizeof(g_main_cp_state.vtx_desc), 0);
+  return XXH64(g_main_cp_state.vtx_attr, sizeof(g_main_cp_state.vtx_attr), hash);
+}
+
+void ReplayDisplayList(const DisplayListCache::Entry& entry, u8* start_address, u32 size)
+{
+  u8* const end_address = start_address + size;
+  for (const DisplayListCache::Command& command : entry.commands)
+  {
+    u8* const data = start_address + command.data_offset;
+    switch (command.opcode)
+    {
+    case GX_LOAD_CP_REG:
+      LoadCPReg(command.sub_cmd, command.value, false);
+      INCSTAT(g_stats.this_frame.num_cp_loads);
+      break;
+
+    case GX_LOAD_XF_REG:
+      LoadXFReg(command.count, command.value, DataReader(data, end_address));
+      INCSTAT(g_stats.this_frame.num_xf_loads);
+      break;
+
+    case GX_LOAD_INDX_A:
+    case GX_LOAD_INDX_B:
+    case GX_LOAD_INDX_C:
+    case GX_LOAD_INDX_D:
+      LoadIndexedXF(command.value, (command.opcode / 8) + 8);
+      break;
+
+    case GX_LOAD_BP_REG:
+      LoadBPReg(command.value);
+      INCSTAT(g_stats.this_frame.num_bp_loads);
+      break;
+
+    default:
+    {
+      const int bytes = VertexLoaderManager::RunVertices(
+          command.opcode & GX_VAT_MASK, (command.opcode & GX_PRIMITIVE_MASK) >> GX_PRIMITIVE_SHIFT,
+          command.count, DataReader(data, end_address), false);
+      DEBUG_ASSERT(bytes == static_cast<int>(command.data_size));
+    }
+    break;
+    }
+  }
+}
+
+// Replays the list from the display list cache if it was called before with the same contents and
+// vertex format, and otherwise interprets it and adds it to the cache.
+u32 RunCachedDisplayList(u32 address, u8* start_address, u32 size)
+{
+  const u64 hash = XXH64(start_address, size, 0);
+  const u64 cp_state_hash = GetCPStateHash();
+  if (const DisplayListCache::Entry* entry =
+          s_display_list_cache.Find(address, size, hash, cp_state_hash))
+  {
+    ReplayDisplayList(*entry, start_address, size);
+    INCSTAT(g_stats.this_frame.num_dlists_cached);
+    return entry->cycles;
+  }
+
+  DisplayListRecording recording{start_address};
+  recording.entry.hash = hash;
+  recording.entry.cp_state_hash = cp_state_hash;
+
+  u32 cycles = 0;
+  s_recording = &recording;
+  const u8* const end = Run(DataReader(start_address, start_address + size), &cycles, true);
+  s_recording = nullptr;
+
+  // Lists which end in the middle of a command are left to the interpreter.
+  if (recording.valid && end == start_address + size)
+  {
+    recording.entry.cycles = cycles;
+    s_display_list_cache.Insert(address, size, std::move(recording.entry));
+  }
+  return cycles;
+}
+
 u32 InterpretDisplayList(u32 address, u32 size)
 {
   u8* start_address;
@@ -50,7 +161,11 @@ u32 InterpretDisplayList(u32 address, u32 size)
     // temporarily swap dl and non-dl (small "hack" for the stats)
     g_stats.SwapDL();
 
-    Run(DataReader(start_address, start_address + size), &cycles, true);
+    // The FIFO recorder needs to see every command of the list.
+    if (g_record_fifo_data)
+      Run(DataReader(start_address, start_address + size), &cycles, true);
+    else
+      cycles = RunCachedDisplayList(address, start_address, size);
     INCSTAT(g_stats.this_frame.num_dlists_called);
 
     // un-swap
@@ -60,16 +175,18 @@ u32 InterpretDisplayList(u32 address, u32 size)
   return cycles;
 }
 
-void InterpretDisplayListPreprocess(u32 address, u32 size)
+u32 InterpretDisplayListPreprocess(u32 address, u32 size)
 {
   u8* const start_address = Memory::GetPointer(address);
 
   Fifo::PushFifoAuxBuffer(start_address, size);
 
   if (start_address == nullptr)
-    return;
+    return 0;
 
-  Run<true>(DataReader(start_address, start_address + size), nullptr, true);
+  u32 cycles = 0;
+  Run<true>(DataReader(start_address, start_address + size), &cycles, true);
+  return cycles;
 }
 }  // Anonymous namespace
 
@@ -78,6 +195,7 @@ bool g_record_fifo_data = false;
 void Init()
 {
   s_is_fifo_error_seen = false;
+  s_display_list_cache.Clear();
 }
 
 template <bool is_preprocess>
@@ -191,7 +309,7 @@ u8* Run(DataReader src, u32* cycles, bool in_display_list)
       else
       {
         if constexpr (is_preprocess)
-          InterpretDisplayListPreprocess(address, count);
+          total_cycles += 6 + InterpretDisplayListPreprocess(address, count);
         else
           total_cycles += 6 + InterpretDisplayList(address, count);
       }
@@ -267,6 +385,9 @@ u8* Run(DataReader src, u32* cycles, bool in_display_list)
     // Display lists get added directly into the FIFO stream
     if constexpr (!is_preprocess)
     {
+      if (s_recording != nullptr && in_display_list)
+        RecordCommand(opcode_start, src.GetPointer());
+
       if (g_record_fifo_data && cmd_byte != GX_CMD_CALL_DL)
       {
         const u8* const opcode_end = src.GetPointer();
@@ -37,6 +37,7 @@
 #include "Common/StringUtil.h"
 #include "Common/Thread.h"
 #include "Common/Timer.h"
+#include "Common/Tracing.h"
 
 #include "Core/Config/NetplaySettings.h"
 #include "Core/Config/SYSCONFSettings.h"
@@ -1236,6 +1237,8 @@ void Renderer::UpdateWidescreenHeuristic()
 
 void Renderer::Swap(u32 xfb_addr, u32 fb_width, u32 fb_stride, u32 fb_height, u64 ticks)
 {
+  TRACE_SCOPE("gpu", "Renderer::Swap");
+
   if (SConfig::GetInstance().bWii)
     m_is_game_widescreen = Config::Get(Config::SYSCONF_WIDESCREEN);
 
@@ -1308,6 +1311,7 @@ void Renderer::Swap(u32 xfb_addr, u32 fb_width, u32 fb_stride, u32 fb_height, u6
 
         // Present to the window system.
         {
+          TRACE_SCOPE("gpu", "Present");
           std::lock_guard<std::mutex> guard(m_swap_mutex);
           PresentBackbuffer();
         }
@@ -3,9 +3,14 @@
 
 #include "VideoCommon/ShaderCache.h"
 
+#include <xxhash.h>
+
 #include "Common/Assert.h"
+#include "Common/FileSearch.h"
 #include "Common/FileUtil.h"
 #include "Common/MsgHandler.h"
+#include "Common/StringUtil.h"
+#include "Common/Tracing.h"
 #include "Core/ConfigManager.h"
 
 #include "VideoCommon/FramebufferManager.h"
@@ -23,6 +28,75 @@ std::unique_ptr<VideoCommon::ShaderCache> g_shader_cache;
 
 namespace VideoCommon
 {
+constexpr u32 PIPELINE_UID_CACHE_MAGIC = 0x44495550;  // PUID
+constexpr size_t PIPELINE_UID_CACHE_HEADER_SIZE = sizeof(u32) + sizeof(u32);
+constexpr char SHARED_PIPELINE_UID_CACHE_NAME[] = "shared.uidcache";
+
+static std::string GetPipelineUIDCachePath(std::string_view name)
+{
+  return File::GetUserPath(D_CACHE_IDX) + std::string(name);
+}
+
+static u64 HashSerializedPipelineUid(const SerializedGXPipelineUid& uid)
+{
+  return XXH64(&uid, sizeof(uid), 0);
+}
+
+// Calls on_uid for each UID in a pipeline UID cache file. Returns false if the file is missing,
+// has the wrong version, or is truncated. If file is open afterwards, it is positioned at the end
+// of the last complete UID.
+template <typename Func>
+static bool ReadPipelineUIDCache(File::IOFile& file, const std::string& filename,
+                                 const char* open_mode, Func on_uid)
+{
+  if (!file.Open(filename, open_mode))
+    return false;
+
+  u32 existing_magic;
+  u32 existing_version;
+  if (!file.ReadBytes(&existing_magic, sizeof(existing_magic)) ||
+      !file.ReadBytes(&existing_version, sizeof(existing_version)) ||
+      existing_magic != PIPELINE_UID_CACHE_MAGIC || existing_version != GX_PIPELINE_UID_VERSION)
+  {
+    return false;
+  }
+
+  // Ensure the expected size matches the actual size of the file. If it doesn't, it means
+  // the cache file may be corrupted, and we should not proceed with loading potentially
+  // garbage or invalid UIDs.
+  const u64 file_size = file.GetSize();
+  const size_t uid_count = static_cast<size_t>(file_size - PIPELINE_UID_CACHE_HEADER_SIZE) /
+                           sizeof(SerializedGXPipelineUid);
+  const size_t expected_size =
+      uid_count * sizeof(SerializedGXPipelineUid) + PIPELINE_UID_CACHE_HEADER_SIZE;
+  if (file_size != expected_size)
+    return false;
+
+  for (size_t i = 0; i < uid_count; i++)
+  {
+    SerializedGXPipelineUid serialized_uid;
+    if (!file.ReadBytes(&serialized_uid, sizeof(serialized_uid)))
+      return false;
+
+    on_uid(serialized_uid);
+  }
+
+  // If the file is opened for reading and writing, we must seek to the end before writing.
+  return file.Seek(expected_size, SEEK_SET);
+}
+
+// Creates an empty pipeline UID cache file, which is left open for appending.
+static bool CreatePipelineUIDCache(File::IOFile& file, const std::string& filename)
+{
+  file.Close();
+  if (!file.Open(filename, "wb"))
+    return false;
+
+  // Write the version identifier.
+  return file.WriteBytes(&PIPELINE_UID_CACHE_MAGIC, sizeof(PIPELINE_UID_CACHE_MAGIC)) &&
+         file.WriteBytes(&GX_PIPELINE_UID_VERSION, sizeof(GX_PIPELINE_UID_VERSION));
+}
+
 ShaderCache::ShaderCache() : m_api_type{APIType::Nothing}
 {
 }
@@ -348,17 +422,18 @@ void ShaderCache::LoadCaches()
       LoadShaderCache<ShaderStage::Geometry, GeometryShaderUid>(m_gs_cache, m_api_type, "gs",
                                                                 false);
 
-    // Specialized shaders, gameid-specific.
+    // Specialized shaders, gameid-specific unless they are shared between games.
     LoadShaderCache<ShaderStage::Vertex, VertexShaderUid>(m_vs_cache, m_api_type, "specialized-vs",
-                                                          true);
+                                                          !g_ActiveConfig.bSharedShaderCache);
     LoadShaderCache<ShaderStage::Pixel, PixelShaderUid>(m_ps_cache, m_api_type, "specialized-ps",
-                                                        true);
+                                                        !g_ActiveConfig.bSharedShaderCache);
   }
 
   if (g_ActiveConfig.backend_info.bSupportsPipelineCacheData)
   {
     LoadPipelineCache<GXPipelineUid, SerializedGXPipelineUid>(
-        m_gx_pipeline_cache, m_gx_pipeline_disk_cache, m_api_type, "specialized-pipeline", true);
+        m_gx_pipeline_cache, m_gx_pipeline_disk_cache, m_api_type, "specialized-pipeline",
+        !g_ActiveConfig.bSharedShaderCache);
     LoadPipelineCache<GXUberPipelineUid, SerializedGXUberPipelineUid>(
         m_gx_uber_pipeline_cache, m_gx_uber_pipeline_disk_cache, m_api_type, "uber-pipeline",
         false);
@@ -416,6 +491,8 @@ void ShaderCache::CompileMissingPipelines()
 
 std::unique_ptr<AbstractShader> ShaderCache::CompileVertexShader(const VertexShaderUid& uid) const
 {
+  TRACE_SCOPE("shader", "ShaderCache::CompileVertexShader");
+
   const ShaderCode source_code =
       GenerateVertexShaderCode(m_api_type, m_host_config, uid.GetUidData());
   return g_renderer->CreateShaderFromSource(ShaderStage::Vertex, source_code.GetBuffer());
@@ -424,6 +501,8 @@ std::unique_ptr<AbstractShader> ShaderCache::CompileVertexShader(const VertexSha
 std::unique_ptr<AbstractShader>
 ShaderCache::CompileVertexUberShader(const UberShader::VertexShaderUid& uid) const
 {
+  TRACE_SCOPE("shader", "ShaderCache::CompileVertexUberShader");
+
   const ShaderCode source_code =
       UberShader::GenVertexShader(m_api_type, m_host_config, uid.GetUidData());
   return g_renderer->CreateShaderFromSource(ShaderStage::Vertex, source_code.GetBuffer());
@@ -431,6 +510,8 @@ ShaderCache::CompileVertexUberShader(const UberShader::VertexShaderUid& uid) con
 
 std::unique_ptr<AbstractShader> ShaderCache::CompilePixelShader(const PixelShaderUid& uid) const
 {
+  TRACE_SCOPE("shader", "ShaderCache::CompilePixelShader");
+
   const ShaderCode source_code =
       GeneratePixelShaderCode(m_api_type, m_host_config, uid.GetUidData());
   return g_renderer->CreateShaderFromSource(ShaderStage::Pixel, source_code.GetBuffer());
@@ -439,6 +520,8 @@ std::unique_ptr<AbstractShader> ShaderCache::CompilePixelShader(const PixelShade
 std::unique_ptr<AbstractShader>
 ShaderCache::CompilePixelUberShader(const UberShader::PixelShaderUid& uid) const
 {
+  TRACE_SCOPE("shader", "ShaderCache::CompilePixelUberShader");
+
   const ShaderCode source_code =
       UberShader::GenPixelShader(m_api_type, m_host_config, uid.GetUidData());
   return g_renderer->CreateShaderFromSource(ShaderStage::Pixel, source_code.GetBuffer());
@@ -723,81 +806,109 @@ ShaderCache::InsertGXUberPipeline(const GXUberPipelineUid& config,
 
 void ShaderCache::LoadPipelineUIDCache()
 {
-  constexpr u32 CACHE_FILE_MAGIC = 0x44495550;  // PUID
-  constexpr size_t CACHE_HEADER_SIZE = sizeof(u32) + sizeof(u32);
-  std::string filename =
-      File::GetUserPath(D_CACHE_IDX) + SConfig::GetInstance().GetGameID() + ".uidcache";
-  if (m_gx_pipeline_uid_cache_file.Open(filename, "rb+"))
+  // Without a game, there is only the shared cache.
+  const std::string& game_id = SConfig::GetInstance().GetGameID();
+  if (!game_id.empty())
   {
-    // If an existing case exists, validate the version before reading entries.
-    u32 existing_magic;
-    u32 existing_version;
-    bool uid_file_valid = false;
-    if (m_gx_pipeline_uid_cache_file.ReadBytes(&existing_magic, sizeof(existing_magic)) &&
-        m_gx_pipeline_uid_cache_file.ReadBytes(&existing_version, sizeof(existing_version)) &&
-        existing_magic == CACHE_FILE_MAGIC && existing_version == GX_PIPELINE_UID_VERSION)
-    {
-      // Ensure the expected size matches the actual size of the file. If it doesn't, it means
-      // the cache file may be corrupted, and we should not proceed with loading potentially
-      // garbage or invalid UIDs.
-      const u64 file_size = m_gx_pipeline_uid_cache_file.GetSize();
-      const size_t uid_count =
-          static_cast<size_t>(file_size - CACHE_HEADER_SIZE) / sizeof(SerializedGXPipelineUid);
-      const size_t expected_size = uid_count * sizeof(SerializedGXPipelineUid) + CACHE_HEADER_SIZE;
-      uid_file_valid = file_size == expected_size;
-      if (uid_file_valid)
-      {
-        for (size_t i = 0; i < uid_count; i++)
-        {
-          SerializedGXPipelineUid serialized_uid;
-          if (m_gx_pipeline_uid_cache_file.ReadBytes(&serialized_uid, sizeof(serialized_uid)))
-          {
-            // This just adds the pipeline to the map, it is compiled later.
-            AddSerializedGXPipelineUID(serialized_uid);
-          }
-          else
-          {
-            uid_file_valid = false;
-            break;
-          }
-        }
-      }
+    const std::string filename = GetPipelineUIDCachePath(game_id + ".uidcache");
 
-      // We open the file for reading and writing, so we must seek to the end before writing.
-      if (uid_file_valid)
-        uid_file_valid = m_gx_pipeline_uid_cache_file.Seek(expected_size, SEEK_SET);
-    }
-
-    // If the file is invalid, close it. We re-open and truncate it below.
-    if (!uid_file_valid)
-      m_gx_pipeline_uid_cache_file.Close();
-  }
+    // This just adds the pipelines to the map, they are compiled later.
+    const bool uid_file_valid =
+        ReadPipelineUIDCache(m_gx_pipeline_uid_cache_file, filename, "rb+",
+                             [this](const auto& uid) { AddSerializedGXPipelineUID(uid); });
 
-  // If the file is not open, it means it was either corrupted or didn't exist.
-  if (!m_gx_pipeline_uid_cache_file.IsOpen())
-  {
-    if (m_gx_pipeline_uid_cache_file.Open(filename, "wb"))
+    // If the file is invalid or doesn't exist, re-create it.
+    if (!uid_file_valid && CreatePipelineUIDCache(m_gx_pipeline_uid_cache_file, filename))
     {
-      // Write the version identifier.
-      m_gx_pipeline_uid_cache_file.WriteBytes(&CACHE_FILE_MAGIC, sizeof(GX_PIPELINE_UID_VERSION));
-      m_gx_pipeline_uid_cache_file.WriteBytes(&GX_PIPELINE_UID_VERSION,
-                                              sizeof(GX_PIPELINE_UID_VERSION));
-
       // Write any current UIDs out to the file.
       // This way, if we load a UID cache where the data was incomplete (e.g. Dolphin crashed),
       // we don't lose the existing UIDs which were previously at the beginning.
       for (const auto& it : m_gx_pipeline_cache)
         AppendGXPipelineUID(it.first);
     }
+
+    INFO_LOG_FMT(VIDEO, "Read {} pipeline UIDs from {}", m_gx_pipeline_cache.size(), filename);
   }
 
-  INFO_LOG_FMT(VIDEO, "Read {} pipeline UIDs from {}", m_gx_pipeline_cache.size(), filename);
+  if (g_ActiveConfig.bSharedShaderCache)
+    LoadSharedPipelineUIDCache();
+}
+
+void ShaderCache::LoadSharedPipelineUIDCache()
+{
+  // The UIDs of other games are only remembered here, so that they aren't written again. Which of
+  // them are compiled is up to the shared pipeline cache, or PrecompileSharedPipelines.
+  const std::string filename = GetPipelineUIDCachePath(SHARED_PIPELINE_UID_CACHE_NAME);
+  m_shared_pipeline_uids.clear();
+  const bool uid_file_valid =
+      ReadPipelineUIDCache(m_shared_pipeline_uid_cache_file, filename, "rb+",
+                           [this](const SerializedGXPipelineUid& uid) {
+                             m_shared_pipeline_uids.insert(HashSerializedPipelineUid(uid));
+                           });
+  if (!uid_file_valid)
+  {
+    m_shared_pipeline_uids.clear();
+    CreatePipelineUIDCache(m_shared_pipeline_uid_cache_file, filename);
+  }
+
+  INFO_LOG_FMT(VIDEO, "Read {} shared pipeline UIDs from {}", m_shared_pipeline_uids.size(),
+               filename);
+
+  // Merge this game's UIDs into the shared cache.
+  for (const auto& it : m_gx_pipeline_cache)
+  {
+    SerializedGXPipelineUid disk_uid;
+    SerializePipelineUid(it.first, disk_uid);
+    AppendSharedGXPipelineUID(disk_uid);
+  }
+}
+
+size_t ShaderCache::PrecompileSharedPipelines()
+{
+  if (!g_ActiveConfig.bShaderCache || !g_ActiveConfig.bSharedShaderCache ||
+      !m_shared_pipeline_uid_cache_file.IsOpen())
+  {
+    return 0;
+  }
+
+  // Bring in the UIDs of games which were played before the shared cache was enabled.
+  const std::string shared_filename = GetPipelineUIDCachePath(SHARED_PIPELINE_UID_CACHE_NAME);
+  for (const std::string& filename :
+       Common::DoFileSearch({File::GetUserPath(D_CACHE_IDX)}, {".uidcache"}))
+  {
+    if (PathToFileName(filename) == SHARED_PIPELINE_UID_CACHE_NAME)
+      continue;
+
+    File::IOFile file;
+    if (!ReadPipelineUIDCache(file, filename, "rb",
+                              [this](const auto& uid) { AppendSharedGXPipelineUID(uid); }))
+    {
+      WARN_LOG_FMT(VIDEO, "Failed to merge pipeline UIDs from {}", filename);
+    }
+  }
+
+  // Add every shared UID to the map, so that the ones which aren't in the pipeline cache yet get
+  // compiled.
+  m_shared_pipeline_uid_cache_file.Flush();
+  File::IOFile shared_file;
+  ReadPipelineUIDCache(shared_file, shared_filename, "rb",
+                       [this](const auto& uid) { AddSerializedGXPipelineUID(uid); });
+  shared_file.Close();
+
+  m_async_shader_compiler->ResizeWorkerThreads(g_ActiveConfig.GetShaderPrecompilerThreads());
+  CompileMissingPipelines();
+  WaitForAsyncCompiler();
+  m_async_shader_compiler->ResizeWorkerThreads(g_ActiveConfig.GetShaderCompilerThreads());
+
+  return m_gx_pipeline_cache.size();
 }
 
 void ShaderCache::ClosePipelineUIDCache()
 {
   // This is left as a method in case we need to append extra data to the file in the future.
   m_gx_pipeline_uid_cache_file.Close();
+  m_shared_pipeline_uid_cache_file.Close();
+  m_shared_pipeline_uids.clear();
 }
 
 void ShaderCache::AddSerializedGXPipelineUID(const SerializedGXPipelineUid& uid)
@@ -816,11 +927,13 @@ void ShaderCache::AddSerializedGXPipelineUID(const SerializedGXPipelineUid& uid)
 
 void ShaderCache::AppendGXPipelineUID(const GXPipelineUid& config)
 {
+  SerializedGXPipelineUid disk_uid;
+  SerializePipelineUid(config, disk_uid);
+  AppendSharedGXPipelineUID(disk_uid);
+
   if (!m_gx_pipeline_uid_cache_file.IsOpen())
     return;
 
-  SerializedGXPipelineUid disk_uid;
-  SerializePipelineUid(config, disk_uid);
   if (!m_gx_pipeline_uid_cache_file.WriteBytes(&disk_uid, sizeof(disk_uid)))
   {
     WARN_LOG_FMT(VIDEO, "Writing pipeline UID to cache failed, closing file.");
@@ -828,6 +941,21 @@ void ShaderCache::AppendGXPipelineUID(const GXPipelineUid& config)
   }
 }
 
+void ShaderCache::AppendSharedGXPipelineUID(const SerializedGXPipelineUid& disk_uid)
+{
+  if (!m_shared_pipeline_uid_cache_file.IsOpen())
+    return;
+
+  if (!m_shared_pipeline_uids.insert(HashSerializedPipelineUid(disk_uid)).second)
+    return;
+
+  if (!m_shared_pipeline_uid_cache_file.WriteBytes(&disk_uid, sizeof(disk_uid)))
+  {
+    WARN_LOG_FMT(VIDEO, "Writing pipeline UID to shared cache failed, closing file.");
+    m_shared_pipeline_uid_cache_file.Close();
+  }
+}
+
 void ShaderCache::QueueVertexShaderCompile(const VertexShaderUid& uid, u32 priority)
 {
   class VertexShaderWorkItem final : public AsyncShaderCompiler::WorkItem
@@ -11,6 +11,7 @@
 #include <optional>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 
 #include "Common/CommonTypes.h"
@@ -61,6 +62,11 @@ public:
   // Retrieves all pending shaders/pipelines from the async compiler.
   void RetrieveAsyncShaders();
 
+  // Merges the pipeline UID caches of all games into the shared one, and compiles every pipeline
+  // in it which isn't in the shared pipeline cache yet. Only does anything if the shader cache is
+  // shared between games. Returns the number of known pipelines.
+  size_t PrecompileSharedPipelines();
+
   // Accesses ShaderGen shader caches
   const AbstractPipeline* GetPipelineForUid(const GXPipelineUid& uid);
   const AbstractPipeline* GetUberPipelineForUid(const GXUberPipelineUid& uid);
@@ -119,6 +125,7 @@ private:
   void LoadCaches();
   void ClearCaches();
   void LoadPipelineUIDCache();
+  void LoadSharedPipelineUIDCache();
   void ClosePipelineUIDCache();
   void CompileMissingPipelines();
   void QueueUberShaderPipelines();
@@ -159,6 +166,7 @@ private:
                                                std::unique_ptr<AbstractPipeline> pipeline);
   void AddSerializedGXPipelineUID(const SerializedGXPipelineUid& uid);
   void AppendGXPipelineUID(const GXPipelineUid& config);
+  void AppendSharedGXPipelineUID(const SerializedGXPipelineUid& disk_uid);
 
   // ASync Compiler Methods
   void QueueVertexShaderCompile(const VertexShaderUid& uid, u32 priority);
@@ -227,6 +235,9 @@ private:
   std::map<GXUberPipelineUid, std::pair<std::unique_ptr<AbstractPipeline>, bool>>
       m_gx_uber_pipeline_cache;
   File::IOFile m_gx_pipeline_uid_cache_file;
+  // UIDs of all games, and the hashes of the ones in it, when the shader cache is shared.
+  File::IOFile m_shared_pipeline_uid_cache_file;
+  std::unordered_set<u64> m_shared_pipeline_uids;
   LinearDiskCache<SerializedGXPipelineUid, u8> m_gx_pipeline_disk_cache;
   LinearDiskCache<SerializedGXUberPipelineUid, u8> m_gx_uber_pipeline_disk_cache;
 
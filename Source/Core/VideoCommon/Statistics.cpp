@@ -14,6 +14,7 @@ Statistics g_stats;
 
 void Statistics::ResetFrame()
 {
+  last_frame = this_frame;
   this_frame = {};
 }
 
@@ -69,6 +70,7 @@ void Statistics::Display() const
   draw_statistic("vshaders alive", "%d", num_vertex_shaders_alive);
   draw_statistic("shaders changes", "%d", this_frame.num_shader_changes);
   draw_statistic("dlists called", "%d", this_frame.num_dlists_called);
+  draw_statistic("dlists from cache", "%d", this_frame.num_dlists_cached);
   draw_statistic("Primitive joins", "%d", this_frame.num_primitive_joins);
   draw_statistic("Draw calls", "%d", this_frame.num_draw_calls);
   draw_statistic("Primitives", "%d", this_frame.num_prims);
@@ -83,6 +85,17 @@ void Statistics::Display() const
   draw_statistic("Index streamed", "%i kB", this_frame.bytes_index_streamed / 1024);
   draw_statistic("Uniform streamed", "%i kB", this_frame.bytes_uniform_streamed / 1024);
   draw_statistic("Vertex Loaders", "%d", num_vertex_loaders);
+  if (g_ActiveConfig.bVertexLoaderCache)
+  {
+    const int vertex_cache_lookups =
+        this_frame.num_vertex_cache_hits + this_frame.num_vertex_cache_misses;
+    draw_statistic("Vertex cache hits", "%d / %d (%.1f%%)", this_frame.num_vertex_cache_hits,
+                   vertex_cache_lookups,
+                   vertex_cache_lookups ?
+                       100.0f * this_frame.num_vertex_cache_hits / vertex_cache_lookups :
+                       0.0f);
+    draw_statistic("Vertex cache size", "%i kB", vertex_cache_size / 1024);
+  }
   draw_statistic("EFB peeks:", "%d", this_frame.num_efb_peeks);
   draw_statistic("EFB pokes:", "%d", this_frame.num_efb_pokes);
 
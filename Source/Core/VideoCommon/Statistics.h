@@ -17,6 +17,7 @@ struct Statistics
   int num_textures_alive;
 
   int num_vertex_loaders;
+  int vertex_cache_size;
 
   std::array<float, 6> proj;
   std::array<float, 16> gproj;
@@ -40,6 +41,7 @@ struct Statistics
     int num_draw_calls;
 
     int num_dlists_called;
+    int num_dlists_cached;
 
     int bytes_vertex_streamed;
     int bytes_index_streamed;
@@ -58,8 +60,13 @@ struct Statistics
 
     int num_efb_peeks;
     int num_efb_pokes;
+
+    int num_vertex_cache_hits;
+    int num_vertex_cache_misses;
   };
   ThisFrame this_frame;
+  // The statistics of the last finished frame
+  ThisFrame last_frame;
   void ResetFrame();
   void SwapDL();
   void Display() const;
@@ -25,6 +25,7 @@
 #include "Common/Logging/Log.h"
 #include "Common/MathUtil.h"
 #include "Common/MemoryUtil.h"
+#include "Common/Tracing.h"
 
 #include "Core/Config/GraphicsSettings.h"
 #include "Core/ConfigManager.h"
@@ -117,6 +118,7 @@ bool TextureCacheBase::Initialize()
     return false;
   }
 
+  m_decode_pool.ResizeWorkerThreads(g_ActiveConfig.GetTextureDecodingThreads());
   return true;
 }
 
@@ -132,8 +134,10 @@ void TextureCacheBase::Invalidate()
   }
   textures_by_address.clear();
   textures_by_hash.clear();
+  textures_by_page.Clear();
 
   texture_pool.clear();
+  m_prefetch_queue.Clear();
 }
 
 void TextureCacheBase::ForceReload()
@@ -150,7 +154,8 @@ void TextureCacheBase::ForceReload()
 void TextureCacheBase::OnConfigChanged(const VideoConfig& config)
 {
   if (config.bHiresTextures != backup_config.hires_textures ||
-      config.bCacheHiresTextures != backup_config.cache_hires_textures)
+      config.bCacheHiresTextures != backup_config.cache_hires_textures ||
+      config.bConvertHiresTextures != backup_config.convert_hires_textures)
   {
     HiresTexture::Update();
   }
@@ -168,6 +173,8 @@ void TextureCacheBase::OnConfigChanged(const VideoConfig& config)
     TexDecoder_SetTexFmtOverlayOptions(config.bTexFmtOverlayEnable, config.bTexFmtOverlayCenter);
   }
 
+  m_decode_pool.ResizeWorkerThreads(config.GetTextureDecodingThreads());
+
   SetBackupConfig(config);
 }
 
@@ -252,6 +259,7 @@ void TextureCacheBase::SetBackupConfig(const VideoConfig& config)
   backup_config.texfmt_overlay_center = config.bTexFmtOverlayCenter;
   backup_config.hires_textures = config.bHiresTextures;
   backup_config.cache_hires_textures = config.bCacheHiresTextures;
+  backup_config.convert_hires_textures = config.bConvertHiresTextures;
   backup_config.stereo_3d = config.stereo_mode != StereoMode::Off;
   backup_config.efb_mono_depth = config.bStereoEFBMonoDepth;
   backup_config.gpu_texture_decoding = config.bEnableGPUTextureDecoding;
@@ -324,7 +332,7 @@ TextureCacheBase::ApplyPaletteToEntry(TCacheEntry* entry, const u8* palette, TLU
     g_renderer->EndUtilityDrawing();
   }
 
-  textures_by_address.emplace(decoded_entry->addr, decoded_entry);
+  AddToAddressCache(decoded_entry);
 
   return decoded_entry;
 }
@@ -371,7 +379,7 @@ TextureCacheBase::TCacheEntry* TextureCacheBase::ReinterpretEntry(const TCacheEn
   g_renderer->EndUtilityDrawing();
   reinterpreted_entry->texture->FinishedRendering();
 
-  textures_by_address.emplace(reinterpreted_entry->addr, reinterpreted_entry);
+  AddToAddressCache(reinterpreted_entry);
 
   return reinterpreted_entry;
 }
@@ -682,7 +690,6 @@ void TextureCacheBase::DoLoadState(PointerWrap& p)
     // to update the point in the state state. We'll just throw it away if it's invalid.
     auto tex = DeserializeTexture(p);
     TCacheEntry* entry = new TCacheEntry(std::move(tex->texture), std::move(tex->framebuffer));
-    entry->textures_by_hash_iter = textures_by_hash.end();
     entry->DoState(p);
     if (entry->texture && commit_state)
       id_map.emplace(i, entry);
@@ -715,7 +722,7 @@ void TextureCacheBase::DoLoadState(PointerWrap& p)
 
     TCacheEntry* entry = GetEntry(id);
     if (entry)
-      textures_by_address.emplace(addr, entry);
+      AddToAddressCache(entry);
   }
 
   // Fill in hash map.
@@ -729,7 +736,7 @@ void TextureCacheBase::DoLoadState(PointerWrap& p)
 
     TCacheEntry* entry = GetEntry(id);
     if (entry)
-      entry->textures_by_hash_iter = textures_by_hash.emplace(hash, entry);
+      AddToHashCache(entry, hash);
   }
 }
 
@@ -1193,7 +1200,10 @@ TextureCacheBase::TCacheEntry* TextureCacheBase::Load(const u32 stage)
   // if this stage was not invalidated by changes to texture registers, keep the current texture
   if (IsValidBindPoint(stage) && bound_textures[stage])
   {
-    return bound_textures[stage];
+    TCacheEntry* entry = bound_textures[stage];
+    if (!entry->pending_custom_tex.empty())
+      LoadPendingCustomTexture(entry);
+    return entry;
   }
 
   TextureInfo texture_info = TextureInfo::FromStage(stage);
@@ -1203,6 +1213,9 @@ TextureCacheBase::TCacheEntry* TextureCacheBase::Load(const u32 stage)
   if (!entry)
     return nullptr;
 
+  if (!entry->pending_custom_tex.empty())
+    LoadPendingCustomTexture(entry);
+
   entry->frameCount = FRAMECOUNT_INVALID;
   bound_textures[stage] = entry;
 
@@ -1213,6 +1226,13 @@ TextureCacheBase::TCacheEntry* TextureCacheBase::Load(const u32 stage)
   return entry;
 }
 
+static TexturePrefetchQueue::Key GetPrefetchKey(const TextureInfo& texture_info)
+{
+  return {texture_info.GetRawAddress(),     texture_info.GetTextureFormat(),
+          texture_info.GetTlutFormat(),     texture_info.GetExpandedWidth(),
+          texture_info.GetExpandedHeight(), texture_info.GetLevelCount()};
+}
+
 TextureCacheBase::TCacheEntry*
 TextureCacheBase::GetTexture(const int textureCacheSafetyColorSampleSize, TextureInfo& texture_info)
 {
@@ -1255,22 +1275,8 @@ TextureCacheBase::GetTexture(const int textureCacheSafetyColorSampleSize, Textur
         texture_info.GetRawAddress(), texture_info.GetFullLevelSize(), MemoryUpdate::TEXTURE_MAP);
   }
 
-  // TODO: This doesn't hash GB tiles for preloaded RGBA8 textures (instead, it's hashing more data
-  // from the low tmem bank than it should)
-  base_hash = Common::GetHash64(texture_info.GetData(), texture_info.GetTextureSize(),
-                                textureCacheSafetyColorSampleSize);
-  u32 palette_size = 0;
-  if (texture_info.GetPaletteSize())
-  {
-    palette_size = *texture_info.GetPaletteSize();
-    full_hash =
-        base_hash ^ Common::GetHash64(texture_info.GetTlutAddress(), *texture_info.GetPaletteSize(),
-                                      textureCacheSafetyColorSampleSize);
-  }
-  else
-  {
-    full_hash = base_hash;
-  }
+  full_hash = CalculateTextureHash(texture_info, textureCacheSafetyColorSampleSize, &base_hash);
+  const u32 palette_size = texture_info.GetPaletteSize().value_or(0);
 
   // Search the texture cache for textures by address
   //
@@ -1489,10 +1495,13 @@ TextureCacheBase::GetTexture(const int textureCacheSafetyColorSampleSize, Textur
     InvalidateTexture(oldest_entry);
   }
 
+  // If the custom texture is still being loaded, the native texture is used until it's done
   std::shared_ptr<HiresTexture> hires_tex;
+  std::string pending_custom_tex;
+  const u32 custom_tex_load_count = HiresTexture::GetLoadCount();
   if (g_ActiveConfig.bHiresTextures)
   {
-    hires_tex = HiresTexture::Search(texture_info);
+    hires_tex = HiresTexture::Search(texture_info, &pending_custom_tex);
 
     if (hires_tex)
     {
@@ -1530,12 +1539,13 @@ TextureCacheBase::GetTexture(const int textureCacheSafetyColorSampleSize, Textur
   if (hires_tex)
   {
     const auto& level = hires_tex->m_levels[0];
-    entry->texture->Load(0, level.width, level.height, level.row_length, level.data.data(),
-                         level.data.size());
+    entry->texture->Load(0, level.width, level.height, level.row_length, level.GetData(),
+                         level.GetSize());
   }
 
   // Initialized to null because only software loading uses this buffer
   u8* dst_buffer = nullptr;
+  bool mips_decoded = false;
 
   if (!hires_tex)
   {
@@ -1566,7 +1576,13 @@ TextureCacheBase::GetTexture(const int textureCacheSafetyColorSampleSize, Textur
 
       CheckTempSize(total_texture_size);
       dst_buffer = temp;
-      if (!(texture_info.GetTextureFormat() == TextureFormat::RGBA8 && texture_info.IsFromTmem()))
+      if (texture_info.GetTextureFormat() == TextureFormat::RGBA8 && texture_info.IsFromTmem())
+      {
+        TexDecoder_DecodeRGBA8FromTmem(dst_buffer, texture_info.GetData(),
+                                       texture_info.GetTmemOddAddress(), expanded_width,
+                                       expanded_height);
+      }
+      else if (decode_on_gpu)
       {
         TexDecoder_Decode(dst_buffer, texture_info.GetData(), expanded_width, expanded_height,
                           texture_info.GetTextureFormat(), texture_info.GetTlutAddress(),
@@ -1574,9 +1590,10 @@ TextureCacheBase::GetTexture(const int textureCacheSafetyColorSampleSize, Textur
       }
       else
       {
-        TexDecoder_DecodeRGBA8FromTmem(dst_buffer, texture_info.GetData(),
-                                       texture_info.GetTmemOddAddress(), expanded_width,
-                                       expanded_height);
+        // The mipmaps won't be decoded on the GPU either, so decode all levels in one go
+        if (!m_prefetch_queue.Take(GetPrefetchKey(texture_info), full_hash, dst_buffer))
+          DecodeLevels(dst_buffer, texture_info);
+        mips_decoded = true;
       }
 
       entry->texture->Load(0, width, height, expanded_width, dst_buffer, decoded_texture_size);
@@ -1587,25 +1604,27 @@ TextureCacheBase::GetTexture(const int textureCacheSafetyColorSampleSize, Textur
     }
   }
 
-  iter = textures_by_address.emplace(texture_info.GetRawAddress(), entry);
+  entry->SetGeneralParameters(texture_info.GetRawAddress(), texture_info.GetTextureSize(),
+                              full_format, false);
+  iter = AddToAddressCache(entry);
   if (textureCacheSafetyColorSampleSize == 0 ||
       std::max(texture_info.GetTextureSize(), palette_size) <=
           (u32)textureCacheSafetyColorSampleSize * 8)
   {
-    entry->textures_by_hash_iter = textures_by_hash.emplace(full_hash, entry);
+    AddToHashCache(entry, full_hash);
   }
 
-  entry->SetGeneralParameters(texture_info.GetRawAddress(), texture_info.GetTextureSize(),
-                              full_format, false);
   entry->SetDimensions(texture_info.GetRawWidth(), texture_info.GetRawHeight(),
                        texture_info.GetLevelCount());
   entry->SetHashes(base_hash, full_hash);
   entry->is_custom_tex = hires_tex != nullptr;
+  entry->pending_custom_tex = std::move(pending_custom_tex);
+  entry->pending_custom_tex_load_count = custom_tex_load_count;
   entry->memory_stride = entry->BytesPerRow();
   entry->SetNotCopy();
 
   std::string basename;
-  if (g_ActiveConfig.bDumpTextures && !hires_tex)
+  if (g_ActiveConfig.bDumpTextures && !hires_tex && entry->pending_custom_tex.empty())
   {
     basename = HiresTexture::GenBaseName(texture_info, true);
   }
@@ -1616,7 +1635,7 @@ TextureCacheBase::GetTexture(const int textureCacheSafetyColorSampleSize, Textur
     {
       const auto& level = hires_tex->m_levels[level_index];
       entry->texture->Load(level_index, level.width, level.height, level.row_length,
-                           level.data.data(), level.data.size());
+                           level.GetData(), level.GetSize());
     }
   }
   else
@@ -1638,9 +1657,12 @@ TextureCacheBase::GetTexture(const int textureCacheSafetyColorSampleSize, Textur
         // No need to call CheckTempSize here, as the whole buffer is preallocated at the beginning
         const u32 decoded_mip_size =
             mip_level->GetExpandedWidth() * sizeof(u32) * mip_level->GetExpandedHeight();
-        TexDecoder_Decode(dst_buffer, mip_level->GetData(), mip_level->GetExpandedWidth(),
-                          mip_level->GetExpandedHeight(), texture_info.GetTextureFormat(),
-                          texture_info.GetTlutAddress(), texture_info.GetTlutFormat());
+        if (!mips_decoded)
+        {
+          TexDecoder_Decode(dst_buffer, mip_level->GetData(), mip_level->GetExpandedWidth(),
+                            mip_level->GetExpandedHeight(), texture_info.GetTextureFormat(),
+                            texture_info.GetTlutAddress(), texture_info.GetTlutFormat());
+        }
         entry->texture->Load(level, mip_level->GetRawWidth(), mip_level->GetRawHeight(),
                              mip_level->GetExpandedWidth(), dst_buffer, decoded_mip_size);
 
@@ -1655,7 +1677,7 @@ TextureCacheBase::GetTexture(const int textureCacheSafetyColorSampleSize, Textur
   entry->has_arbitrary_mips = hires_tex ? hires_tex->HasArbitraryMipmaps() :
                                           arbitrary_mip_detector.HasArbitraryMipmaps(dst_buffer);
 
-  if (g_ActiveConfig.bDumpTextures && !hires_tex)
+  if (g_ActiveConfig.bDumpTextures && !hires_tex && entry->pending_custom_tex.empty())
   {
     for (u32 level = 0; level < texLevels; ++level)
     {
@@ -1674,6 +1696,178 @@ TextureCacheBase::GetTexture(const int textureCacheSafetyColorSampleSize, Textur
   return entry;
 }
 
+void TextureCacheBase::LoadPendingCustomTexture(TCacheEntry* entry)
+{
+  const u32 load_count = HiresTexture::GetLoadCount();
+  if (entry->pending_custom_tex_load_count == load_count)
+    return;
+  entry->pending_custom_tex_load_count = load_count;
+
+  bool pending = false;
+  const std::shared_ptr<HiresTexture> hires_tex =
+      HiresTexture::Lookup(entry->pending_custom_tex, &pending);
+  if (pending)
+    return;
+  entry->pending_custom_tex.clear();
+
+  // Textures which were partially updated by EFB copies keep their native texture, as the copies
+  // would be lost otherwise.
+  if (!hires_tex || !entry->references.empty())
+    return;
+
+  const auto& first_level = hires_tex->m_levels[0];
+  const TextureConfig config(first_level.width, first_level.height,
+                             static_cast<u32>(hires_tex->m_levels.size()), 1, 1,
+                             hires_tex->GetFormat(), 0);
+  std::optional<TexPoolEntry> new_texture = AllocateTexture(config);
+  if (!new_texture)
+  {
+    ERROR_LOG_FMT(VIDEO, "Failed to allocate texture for custom texture {}x{}", config.width,
+                  config.height);
+    return;
+  }
+
+  for (u32 level_index = 0; level_index != config.levels; ++level_index)
+  {
+    const auto& level = hires_tex->m_levels[level_index];
+    new_texture->texture->Load(level_index, level.width, level.height, level.row_length,
+                               level.GetData(), level.GetSize());
+  }
+  new_texture->texture->FinishedRendering();
+
+  entry->texture.swap(new_texture->texture);
+  entry->framebuffer.swap(new_texture->framebuffer);
+  entry->is_custom_tex = true;
+  entry->has_arbitrary_mips = hires_tex->HasArbitraryMipmaps();
+
+  // The native texture can be reused for other textures now
+  auto old_config = new_texture->texture->GetConfig();
+  texture_pool.emplace(old_config, TexPoolEntry(std::move(new_texture->texture),
+                                                std::move(new_texture->framebuffer)));
+}
+
+u64 TextureCacheBase::CalculateTextureHash(const TextureInfo& texture_info, int color_sample_size,
+                                           u64* base_hash)
+{
+  return CalculateTextureHash(texture_info, texture_info.GetData(), texture_info.GetTlutAddress(),
+                              color_sample_size, base_hash);
+}
+
+u64 TextureCacheBase::CalculateTextureHash(const TextureInfo& texture_info, const u8* data,
+                                           const u8* tlut, int color_sample_size, u64* base_hash)
+{
+  // TODO: This doesn't hash GB tiles for preloaded RGBA8 textures (instead, it's hashing more data
+  // from the low tmem bank than it should)
+  *base_hash = Common::GetHash64(data, texture_info.GetTextureSize(), color_sample_size);
+  if (!texture_info.GetPaletteSize())
+    return *base_hash;
+
+  return *base_hash ^ Common::GetHash64(tlut, *texture_info.GetPaletteSize(), color_sample_size);
+}
+
+// Returns the decoding jobs for all levels of the texture, with src and tlut pointing to copies of
+// the texture data and the palette.
+static std::vector<TextureDecodePool::Job> GetDecodeJobs(u8* dst, const TextureInfo& texture_info,
+                                                         const u8* src, const u8* tlut)
+{
+  std::vector<TextureDecodePool::Job> jobs;
+  jobs.reserve(texture_info.GetLevelCount());
+  jobs.push_back({dst, src, texture_info.GetExpandedWidth(), texture_info.GetExpandedHeight(),
+                  texture_info.GetTextureFormat(), tlut, texture_info.GetTlutFormat()});
+  dst += texture_info.GetExpandedWidth() * sizeof(u32) * texture_info.GetExpandedHeight();
+
+  for (u32 level = 1; level < texture_info.GetLevelCount(); ++level)
+  {
+    const TextureInfo::MipLevel* mip_level = texture_info.GetMipMapLevel(level - 1);
+    jobs.push_back({dst, src + (mip_level->GetData() - texture_info.GetData()),
+                    mip_level->GetExpandedWidth(), mip_level->GetExpandedHeight(),
+                    texture_info.GetTextureFormat(), tlut, texture_info.GetTlutFormat()});
+    dst += mip_level->GetExpandedWidth() * sizeof(u32) * mip_level->GetExpandedHeight();
+  }
+
+  return jobs;
+}
+
+size_t TextureCacheBase::GetDecodedLevelsSize(const TextureInfo& texture_info)
+{
+  size_t size = texture_info.GetExpandedWidth() * sizeof(u32) * texture_info.GetExpandedHeight();
+  for (u32 level = 1; level < texture_info.GetLevelCount(); ++level)
+  {
+    const TextureInfo::MipLevel* mip_level = texture_info.GetMipMapLevel(level - 1);
+    size += mip_level->GetExpandedWidth() * sizeof(u32) * mip_level->GetExpandedHeight();
+  }
+  return size;
+}
+
+void TextureCacheBase::DecodeLevels(u8* dst, const TextureInfo& texture_info)
+{
+  const std::vector<TextureDecodePool::Job> jobs =
+      GetDecodeJobs(dst, texture_info, texture_info.GetData(), texture_info.GetTlutAddress());
+  m_decode_pool.Decode(jobs.data(), jobs.size());
+}
+
+void TextureCacheBase::PrefetchTexture(u32 stage)
+{
+  // Only large textures are worth the copies and the hand-off to another thread
+  constexpr u32 MIN_PREFETCH_TEXELS = 128 * 128;
+
+  if (m_decode_pool.GetWorkerThreadCount() == 0 || g_ActiveConfig.bHiresTextures ||
+      g_ActiveConfig.UseGPUTextureDecoding())
+  {
+    return;
+  }
+
+  const TextureInfo texture_info = TextureInfo::FromStage(stage);
+  if (!texture_info.GetData() || texture_info.IsFromTmem() ||
+      texture_info.GetExpandedWidth() * texture_info.GetExpandedHeight() < MIN_PREFETCH_TEXELS ||
+      (texture_info.GetPaletteSize() && !IsValidTLUTFormat(texture_info.GetTlutFormat())))
+  {
+    return;
+  }
+
+  const u32 address = texture_info.GetRawAddress();
+  if (m_prefetch_queue.Contains(address))
+    return;
+
+  // Hashing the texture to find out whether the cache already has it would cost as much as the
+  // hash that is calculated again when the texture is loaded. Instead, textures are skipped if the
+  // cache has one of the same format and size at the address, which is most likely the same
+  // texture. The hash of a prefetched texture is calculated on the worker thread, and checked when
+  // the texture is taken.
+  const TextureAndTLUTFormat format(texture_info.GetTextureFormat(), texture_info.GetTlutFormat());
+  const auto range = textures_by_address.equal_range(address);
+  if (std::any_of(range.first, range.second, [&](const auto& entry) {
+        return entry.second->IsCopy() ||
+               (entry.second->format == format &&
+                entry.second->native_width == texture_info.GetRawWidth() &&
+                entry.second->native_height == texture_info.GetRawHeight());
+      }))
+  {
+    return;
+  }
+
+  // Emulated memory can change while the texture is being decoded, so decode from a copy
+  TexturePrefetchQueue::Texture texture;
+  texture.src.assign(texture_info.GetData(),
+                     texture_info.GetData() + texture_info.GetFullLevelSize());
+  if (texture_info.GetPaletteSize())
+  {
+    texture.tlut.assign(texture_info.GetTlutAddress(),
+                        texture_info.GetTlutAddress() + *texture_info.GetPaletteSize());
+  }
+  texture.dst.resize(GetDecodedLevelsSize(texture_info));
+  texture.jobs =
+      GetDecodeJobs(texture.dst.data(), texture_info, texture.src.data(), texture.tlut.data());
+
+  const int color_sample_size = g_ActiveConfig.iSafeTextureCache_ColorSamples;
+  m_prefetch_queue.Prefetch(GetPrefetchKey(texture_info), std::move(texture),
+                            [texture_info, color_sample_size](const u8* src, const u8* tlut) {
+                              u64 base_hash;
+                              return CalculateTextureHash(texture_info, src, tlut,
+                                                          color_sample_size, &base_hash);
+                            });
+}
+
 static void GetDisplayRectForXFBEntry(TextureCacheBase::TCacheEntry* entry, u32 width, u32 height,
                                       MathUtil::Rectangle<int>* display_rect)
 {
@@ -1741,7 +1935,7 @@ TextureCacheBase::GetXFBTexture(u32 address, u32 width, u32 height, u32 stride,
   entry->texture->FinishedRendering();
 
   // Insert into the texture cache so we can re-use it next frame, if needed.
-  textures_by_address.emplace(entry->addr, entry);
+  AddToAddressCache(entry);
   SETSTAT(g_stats.num_textures_alive, static_cast<int>(textures_by_address.size()));
   INCSTAT(g_stats.num_textures_uploaded);
 
@@ -1985,6 +2179,8 @@ void TextureCacheBase::CopyRenderTargetToTexture(
     float gamma, bool clamp_top, bool clamp_bottom,
     const CopyFilterCoefficients::Values& filter_coefficients)
 {
+  TRACE_SCOPE("gpu", "EFB copy");
+
   // Emulation methods:
   //
   // - EFB to RAM:
@@ -2272,11 +2468,7 @@ void TextureCacheBase::CopyRenderTargetToTexture(
 
       // Do not load textures by hash, if they were at least partly overwritten by an efb copy.
       // In this case, comparing the hash is not enough to check, if two textures are identical.
-      if (overlapping_entry->textures_by_hash_iter != textures_by_hash.end())
-      {
-        textures_by_hash.erase(overlapping_entry->textures_by_hash_iter);
-        overlapping_entry->textures_by_hash_iter = textures_by_hash.end();
-      }
+      RemoveFromHashCache(overlapping_entry);
     }
     ++iter.first;
   }
@@ -2299,7 +2491,7 @@ void TextureCacheBase::CopyRenderTargetToTexture(
   {
     const u64 hash = entry->CalculateHash();
     entry->SetHashes(hash, hash);
-    textures_by_address.emplace(dstAddr, entry);
+    AddToAddressCache(entry);
   }
 }
 
@@ -2434,7 +2626,6 @@ TextureCacheBase::TCacheEntry* TextureCacheBase::AllocateCacheEntry(const Textur
 
   TCacheEntry* cacheEntry =
       new TCacheEntry(std::move(alloc->texture), std::move(alloc->framebuffer));
-  cacheEntry->textures_by_hash_iter = textures_by_hash.end();
   cacheEntry->id = last_entry_id++;
   return cacheEntry;
 }
@@ -2505,17 +2696,39 @@ TextureCacheBase::GetTexCacheIter(TextureCacheBase::TCacheEntry* entry)
   return textures_by_address.end();
 }
 
+TextureCacheBase::TexAddrCache::iterator TextureCacheBase::AddToAddressCache(TCacheEntry* entry)
+{
+  textures_by_page.Add(entry->addr, entry->size_in_bytes, entry);
+  return textures_by_address.emplace(entry->addr, entry);
+}
+
+void TextureCacheBase::AddToHashCache(TCacheEntry* entry, u64 hash)
+{
+  textures_by_hash.emplace(hash, entry);
+  entry->textures_by_hash_key = hash;
+}
+
+void TextureCacheBase::RemoveFromHashCache(TCacheEntry* entry)
+{
+  if (!entry->textures_by_hash_key)
+    return;
+
+  const auto range = textures_by_hash.equal_range(*entry->textures_by_hash_key);
+  const auto iter = std::find_if(range.first, range.second,
+                                 [entry](const auto& it) { return it.second == entry; });
+  if (iter != range.second)
+    textures_by_hash.erase(iter);
+  entry->textures_by_hash_key.reset();
+}
+
 std::pair<TextureCacheBase::TexAddrCache::iterator, TextureCacheBase::TexAddrCache::iterator>
 TextureCacheBase::FindOverlappingTextures(u32 addr, u32 size_in_bytes)
 {
   // We index by the starting address only, so there is no way to query all textures
-  // which end after the given addr. But the GC textures have a limited size, so we
-  // look for all textures which have a start address bigger than addr minus the maximal
-  // texture size. But this yields false-positives which must be checked later on.
-
-  // 1024 x 1024 texel times 8 nibbles per texel
-  constexpr u32 max_texture_size = 1024 * 1024 * 4;
-  u32 lower_addr = addr > max_texture_size ? addr - max_texture_size : 0;
+  // which end after the given addr. The page index knows where the textures that contain addr
+  // start, so we look for all textures which start between there and the end of the range.
+  // This still yields false-positives which must be checked later on.
+  const u32 lower_addr = textures_by_page.GetLowestOverlappingAddress(addr);
   auto begin = textures_by_address.lower_bound(lower_addr);
   auto end = textures_by_address.upper_bound(addr + size_in_bytes);
 
@@ -2529,12 +2742,7 @@ TextureCacheBase::InvalidateTexture(TexAddrCache::iterator iter, bool discard_pe
     return textures_by_address.end();
 
   TCacheEntry* entry = iter->second;
-
-  if (entry->textures_by_hash_iter != textures_by_hash.end())
-  {
-    textures_by_hash.erase(entry->textures_by_hash_iter);
-    entry->textures_by_hash_iter = textures_by_hash.end();
-  }
+  RemoveFromHashCache(entry);
 
   for (size_t i = 0; i < bound_textures.size(); ++i)
   {
@@ -2578,6 +2786,8 @@ TextureCacheBase::InvalidateTexture(TexAddrCache::iterator iter, bool discard_pe
   texture_pool.emplace(config,
                        TexPoolEntry(std::move(entry->texture), std::move(entry->framebuffer)));
 
+  textures_by_page.Remove(entry->addr, entry->size_in_bytes, entry);
+
   // Don't delete if there's a pending EFB copy, as we need the TCacheEntry alive.
   if (!entry->pending_efb_copy)
     delete entry;
@@ -19,8 +19,10 @@
 #include "VideoCommon/AbstractTexture.h"
 #include "VideoCommon/BPMemory.h"
 #include "VideoCommon/TextureConfig.h"
+#include "VideoCommon/TextureDecodePool.h"
 #include "VideoCommon/TextureDecoder.h"
 #include "VideoCommon/TextureInfo.h"
+#include "VideoCommon/TexturePageIndex.h"
 
 class AbstractFramebuffer;
 class AbstractStagingTexture;
@@ -115,9 +117,13 @@ public:
     // used to delete textures which haven't been used for TEXTURE_KILL_THRESHOLD frames
     int frameCount = FRAMECOUNT_INVALID;
 
-    // Keep an iterator to the entry in textures_by_hash, so it does not need to be searched when
-    // removing the cache entry
-    std::multimap<u64, TCacheEntry*>::iterator textures_by_hash_iter;
+    // Name of the custom texture which is still being loaded for this texture, and the custom
+    // texture load count at the time it was last looked up
+    std::string pending_custom_tex;
+    u32 pending_custom_tex_load_count = 0;
+
+    // The key of the entry in textures_by_hash, if it is in there
+    std::optional<u64> textures_by_hash_key;
 
     // This is used to keep track of both:
     //   * efb copies used by this partially updated texture
@@ -217,6 +223,9 @@ public:
   static void InvalidateAllBindPoints() { valid_bind_points.reset(); }
   static bool IsValidBindPoint(u32 i) { return valid_bind_points.test(i); }
   TCacheEntry* GetTexture(const int textureCacheSafetyColorSampleSize, TextureInfo& texture_info);
+  // Starts decoding the texture of the stage on the decoding threads, so that it is ready by the
+  // time it is loaded. Called when the texture address of a stage is written.
+  void PrefetchTexture(u32 stage);
   TCacheEntry* GetXFBTexture(u32 address, u32 width, u32 height, u32 stride,
                              MathUtil::Rectangle<int>* display_rect);
 
@@ -273,9 +282,17 @@ protected:
 
 private:
   using TexAddrCache = std::multimap<u32, TCacheEntry*>;
-  using TexHashCache = std::multimap<u64, TCacheEntry*>;
+  using TexHashCache = std::unordered_multimap<u64, TCacheEntry*>;
   using TexPool = std::unordered_multimap<TextureConfig, TexPoolEntry>;
 
+  static u64 CalculateTextureHash(const TextureInfo& texture_info, int color_sample_size,
+                                  u64* base_hash);
+  // Hashes copies of the texture data and the palette instead of emulated memory
+  static u64 CalculateTextureHash(const TextureInfo& texture_info, const u8* data, const u8* tlut,
+                                  int color_sample_size, u64* base_hash);
+  static size_t GetDecodedLevelsSize(const TextureInfo& texture_info);
+  void DecodeLevels(u8* dst, const TextureInfo& texture_info);
+
   bool CreateUtilityTextures();
 
   void SetBackupConfig(const VideoConfig& config);
@@ -290,6 +307,9 @@ private:
                                        TLUTFormat tlutfmt);
   void StitchXFBCopy(TCacheEntry* entry_to_update);
 
+  // Replaces the texture of the entry with its custom texture once that has been loaded
+  void LoadPendingCustomTexture(TCacheEntry* entry);
+
   void DumpTexture(TCacheEntry* entry, std::string basename, unsigned int level, bool is_arbitrary);
   void CheckTempSize(size_t required_size);
 
@@ -298,6 +318,12 @@ private:
   TexPool::iterator FindMatchingTextureFromPool(const TextureConfig& config);
   TexAddrCache::iterator GetTexCacheIter(TCacheEntry* entry);
 
+  // Adds the entry to textures_by_address and the page index, using its current address and size
+  TexAddrCache::iterator AddToAddressCache(TCacheEntry* entry);
+
+  void AddToHashCache(TCacheEntry* entry, u64 hash);
+  void RemoveFromHashCache(TCacheEntry* entry);
+
   // Return all possible overlapping textures. As addr+size of the textures is not
   // indexed, this may return false positives.
   std::pair<TexAddrCache::iterator, TexAddrCache::iterator>
@@ -332,6 +358,7 @@ private:
 
   TexAddrCache textures_by_address;
   TexHashCache textures_by_hash;
+  TexturePageIndex<TCacheEntry> textures_by_page;
   TexPool texture_pool;
   u64 last_entry_id = 0;
 
@@ -343,6 +370,7 @@ private:
     bool texfmt_overlay_center;
     bool hires_textures;
     bool cache_hires_textures;
+    bool convert_hires_textures;
     bool copy_cache_enable;
     bool stereo_3d;
     bool efb_mono_depth;
@@ -370,6 +398,10 @@ private:
   // We store this in the class so that the same staging texture can be used for multiple
   // readbacks, saving the overhead of allocating a new buffer every time.
   std::unique_ptr<AbstractStagingTexture> m_readback_texture;
+
+  TextureDecodePool m_decode_pool;
+  // Holds all levels of textures decoded ahead of time, laid out like they are in temp
+  TexturePrefetchQueue m_prefetch_queue{m_decode_pool};
 };
 
 extern std::unique_ptr<TextureCacheBase> g_texture_cache;
@@ -0,0 +1,236 @@
+// Copyright 2021 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "VideoCommon/TextureDecodePool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <utility>
+
+#include "Common/Event.h"
+#include "Common/Thread.h"
+
+// Number of decoded texels per band. Bands of 64 KiB are large enough to amortize the
+// synchronization, and small enough to spread a 256x256 texture over a few threads.
+constexpr u32 TEXELS_PER_BAND = 0x4000;
+
+struct TextureDecodePool::Batch
+{
+  struct Band
+  {
+    const Job* job;
+    u32 first_row;
+    u32 num_rows;
+  };
+
+  std::vector<Band> bands;
+  std::atomic<size_t> next_band{0};
+  std::atomic<size_t> remaining_bands{0};
+  std::mutex done_lock;
+  std::condition_variable done_cv;
+
+  // Decodes bands until there are none left. Returns true if this finished the batch.
+  bool Run()
+  {
+    size_t finished = 0;
+    for (size_t i = next_band++; i < bands.size(); i = next_band++)
+    {
+      const Band& band = bands[i];
+      TexDecoder_DecodeRows(band.job->dst, band.job->src, band.job->width, band.first_row,
+                            band.num_rows, band.job->format, band.job->tlut,
+                            band.job->tlut_format);
+      ++finished;
+    }
+
+    return finished != 0 && remaining_bands.fetch_sub(finished) == finished;
+  }
+};
+
+TextureDecodePool::~TextureDecodePool()
+{
+  StopWorkerThreads();
+}
+
+void TextureDecodePool::ResizeWorkerThreads(u32 num_threads)
+{
+  if (num_threads == m_worker_threads.size())
+    return;
+
+  StopWorkerThreads();
+
+  for (u32 i = 0; i < num_threads; ++i)
+    m_worker_threads.emplace_back(&TextureDecodePool::WorkerThreadRun, this);
+}
+
+void TextureDecodePool::StopWorkerThreads()
+{
+  {
+    std::lock_guard lk(m_tasks_lock);
+    m_exit = true;
+  }
+  m_tasks_cv.notify_all();
+
+  for (std::thread& thread : m_worker_threads)
+    thread.join();
+  m_worker_threads.clear();
+
+  // Run whatever is left, so that nobody waits for a task forever
+  for (auto& task : m_tasks)
+    task();
+  m_tasks.clear();
+  m_exit = false;
+}
+
+void TextureDecodePool::WorkerThreadRun()
+{
+  Common::SetCurrentThreadName("Texture decoding thread");
+
+  std::unique_lock lk(m_tasks_lock);
+  while (true)
+  {
+    m_tasks_cv.wait(lk, [this] { return m_exit || !m_tasks.empty(); });
+    if (m_exit)
+      return;
+
+    std::function<void()> task = std::move(m_tasks.front());
+    m_tasks.pop_front();
+
+    lk.unlock();
+    task();
+    lk.lock();
+  }
+}
+
+void TextureDecodePool::QueueTask(std::function<void()> task)
+{
+  if (m_worker_threads.empty())
+  {
+    task();
+    return;
+  }
+
+  {
+    std::lock_guard lk(m_tasks_lock);
+    m_tasks.push_back(std::move(task));
+  }
+  m_tasks_cv.notify_one();
+}
+
+void TextureDecodePool::Decode(const Job* jobs, size_t count)
+{
+  auto batch = std::make_shared<Batch>();
+  for (size_t i = 0; i < count; ++i)
+  {
+    const Job& job = jobs[i];
+    const u32 block_height = TexDecoder_GetBlockHeightInTexels(job.format);
+    const u32 rows_per_band =
+        std::max(TEXELS_PER_BAND / std::max(job.width, 1u) / block_height, 1u) * block_height;
+    for (u32 row = 0; row < job.height; row += rows_per_band)
+      batch->bands.push_back({&job, row, std::min(rows_per_band, job.height - row)});
+  }
+
+  // The overlay is drawn over whole textures, so it isn't worth splitting them up
+  if (m_worker_threads.empty() || batch->bands.size() < 2 || TexDecoder_IsTexFmtOverlayEnabled())
+  {
+    for (size_t i = 0; i < count; ++i)
+    {
+      TexDecoder_Decode(jobs[i].dst, jobs[i].src, jobs[i].width, jobs[i].height, jobs[i].format,
+                        jobs[i].tlut, jobs[i].tlut_format);
+    }
+    return;
+  }
+
+  batch->remaining_bands = batch->bands.size();
+
+  const size_t helpers = std::min(m_worker_threads.size(), batch->bands.size() - 1);
+  for (size_t i = 0; i < helpers; ++i)
+  {
+    QueueTask([batch] {
+      if (batch->Run())
+      {
+        std::lock_guard lk(batch->done_lock);
+        batch->done_cv.notify_one();
+      }
+    });
+  }
+
+  // Help out instead of waiting
+  if (batch->Run())
+    return;
+
+  std::unique_lock lk(batch->done_lock);
+  batch->done_cv.wait(lk, [&batch] { return batch->remaining_bands.load() == 0; });
+}
+
+struct TexturePrefetchQueue::Entry
+{
+  Key key;
+  Texture texture;
+  u64 hash = 0;
+  Common::Event done;
+};
+
+bool TexturePrefetchQueue::Key::operator==(const Key& other) const
+{
+  return address == other.address && format == other.format && tlut_format == other.tlut_format &&
+         width == other.width && height == other.height && levels == other.levels;
+}
+
+bool TexturePrefetchQueue::Contains(u32 address) const
+{
+  return std::any_of(m_entries.begin(), m_entries.end(),
+                     [address](const auto& entry) { return entry->key.address == address; });
+}
+
+void TexturePrefetchQueue::Prefetch(const Key& key, Texture texture, HashFunction hash)
+{
+  if (m_entries.size() == MAX_TEXTURES)
+    m_entries.erase(m_entries.begin());
+
+  auto entry = std::make_shared<Entry>();
+  entry->key = key;
+  entry->texture = std::move(texture);
+  m_entries.push_back(entry);
+
+  m_pool.QueueTask([entry = std::move(entry), hash = std::move(hash)] {
+    Texture& tex = entry->texture;
+    entry->hash = hash(tex.src.data(), tex.tlut.data());
+    for (const TextureDecodePool::Job& job : tex.jobs)
+    {
+      TexDecoder_Decode(job.dst, job.src, job.width, job.height, job.format, job.tlut,
+                        job.tlut_format);
+    }
+    entry->done.Set();
+  });
+}
+
+bool TexturePrefetchQueue::Take(const Key& key, u64 hash, u8* dst)
+{
+  const auto iter =
+      std::find_if(m_entries.begin(), m_entries.end(),
+                   [&key](const auto& entry) { return entry->key.address == key.address; });
+  if (iter == m_entries.end())
+    return false;
+
+  // The prefetched texture is stale either way once the texture at the address has been loaded
+  const std::shared_ptr<Entry> entry = std::move(*iter);
+  m_entries.erase(iter);
+
+  // The texture registers may have changed after the address was written
+  if (!(entry->key == key))
+    return false;
+
+  entry->done.Wait();
+  if (entry->hash != hash)
+    return false;
+
+  std::memcpy(dst, entry->texture.dst.data(), entry->texture.dst.size());
+  return true;
+}
+
+void TexturePrefetchQueue::Clear()
+{
+  m_entries.clear();
+}
@@ -0,0 +1,118 @@
+// Copyright 2021 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "VideoCommon/TextureDecoder.h"
+
+// Decodes textures on a set of worker threads. Textures are split into bands of block rows, which
+// the worker threads and the calling thread decode in parallel.
+class TextureDecodePool
+{
+public:
+  struct Job
+  {
+    u8* dst;
+    const u8* src;
+    u32 width;
+    u32 height;
+    TextureFormat format;
+    const u8* tlut;
+    TLUTFormat tlut_format;
+  };
+
+  TextureDecodePool() = default;
+  ~TextureDecodePool();
+
+  TextureDecodePool(const TextureDecodePool&) = delete;
+  TextureDecodePool& operator=(const TextureDecodePool&) = delete;
+
+  void ResizeWorkerThreads(u32 num_threads);
+  u32 GetWorkerThreadCount() const { return static_cast<u32>(m_worker_threads.size()); }
+
+  // Decodes the jobs like TexDecoder_Decode would, and returns once all of them are done.
+  void Decode(const Job* jobs, size_t count);
+
+  // Runs the task on one of the worker threads, or right away if there are none.
+  void QueueTask(std::function<void()> task);
+
+private:
+  struct Batch;
+
+  void WorkerThreadRun();
+  void StopWorkerThreads();
+
+  std::vector<std::thread> m_worker_threads;
+  std::mutex m_tasks_lock;
+  std::condition_variable m_tasks_cv;
+  std::deque<std::function<void()>> m_tasks;
+  bool m_exit = false;
+};
+
+// Textures decoded ahead of time on the worker threads of a TextureDecodePool. Their data is hashed
+// on the worker thread as well. A prefetched texture is only handed out for a texture with the same
+// hash, which catches changes to the texture or its palette after it was prefetched.
+class TexturePrefetchQueue
+{
+public:
+  // Maximum number of prefetched textures which haven't been taken yet
+  static constexpr size_t MAX_TEXTURES = 16;
+
+  // Everything apart from the data that decides how a texture is decoded
+  struct Key
+  {
+    u32 address;
+    TextureFormat format;
+    TLUTFormat tlut_format;
+    u32 width;
+    u32 height;
+    u32 levels;
+
+    bool operator==(const Key& other) const;
+  };
+
+  // Copies of the texture data and the palette, and the buffer for the decoded levels. The jobs
+  // have to point into these buffers.
+  struct Texture
+  {
+    std::vector<u8> src;
+    std::vector<u8> tlut;
+    std::vector<u8> dst;
+    std::vector<TextureDecodePool::Job> jobs;
+  };
+
+  // Hashes the copied texture data and palette
+  using HashFunction = std::function<u64(const u8* src, const u8* tlut)>;
+
+  explicit TexturePrefetchQueue(TextureDecodePool& pool) : m_pool(pool) {}
+
+  TexturePrefetchQueue(const TexturePrefetchQueue&) = delete;
+  TexturePrefetchQueue& operator=(const TexturePrefetchQueue&) = delete;
+
+  bool Contains(u32 address) const;
+
+  // Hashes and decodes the texture on a worker thread. The oldest texture is dropped if there are
+  // already MAX_TEXTURES.
+  void Prefetch(const Key& key, Texture texture, HashFunction hash);
+
+  // Copies the decoded levels to dst if the texture prefetched at the key's address has the same
+  // key and hash. That texture is dropped either way.
+  bool Take(const Key& key, u64 hash, u8* dst);
+
+  void Clear();
+
+private:
+  struct Entry;
+
+  TextureDecodePool& m_pool;
+  std::vector<std::shared_ptr<Entry>> m_entries;
+};
@@ -8,6 +8,7 @@
 #include "Common/CommonTypes.h"
 #include "Common/MsgHandler.h"
 #include "Common/Swap.h"
+#include "Common/Tracing.h"
 
 #include "VideoCommon/LookUpTables.h"
 #include "VideoCommon/TextureDecoder.h"
@@ -259,6 +260,11 @@ void TexDecoder_SetTexFmtOverlayOptions(bool enable, bool center)
   TexFmt_Overlay_Center = center;
 }
 
+bool TexDecoder_IsTexFmtOverlayEnabled()
+{
+  return TexFmt_Overlay_Enable;
+}
+
 static const char* texfmt[] = {
     // pixel
     "I4",
@@ -376,12 +382,25 @@ static void TexDecoder_DrawOverlay(u8* dst, int width, int height, TextureFormat
 void TexDecoder_Decode(u8* dst, const u8* src, int width, int height, TextureFormat texformat,
                        const u8* tlut, TLUTFormat tlutfmt)
 {
+  TRACE_SCOPE("texture", "TexDecoder_Decode");
+
   _TexDecoder_DecodeImpl((u32*)dst, src, width, height, texformat, tlut, tlutfmt);
 
   if (TexFmt_Overlay_Enable)
     TexDecoder_DrawOverlay(dst, width, height, texformat);
 }
 
+void TexDecoder_DecodeRows(u8* dst, const u8* src, int width, int first_row, int num_rows,
+                           TextureFormat texformat, const u8* tlut, TLUTFormat tlutfmt)
+{
+  // Textures are stored as rows of blocks, so the rows can be decoded like a smaller texture
+  const int block_height = TexDecoder_GetBlockHeightInTexels(texformat);
+  const int block_row_size = TexDecoder_GetTextureSizeInBytes(width, block_height, texformat);
+  _TexDecoder_DecodeImpl(reinterpret_cast<u32*>(dst) + first_row * width,
+                         src + first_row / block_height * block_row_size, width, num_rows,
+                         texformat, tlut, tlutfmt);
+}
+
 static inline u32 DecodePixel_IA8(u16 val)
 {
   int a = val & 0xFF;
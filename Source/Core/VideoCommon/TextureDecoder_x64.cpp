@@ -302,6 +302,45 @@ static void TexDecoder_DecodeImpl_I4_SSSE3(u32* dst, const u8* src, int width, i
   }
 }
 
+FUNCTION_TARGET_AVX2
+static void TexDecoder_DecodeImpl_I4_AVX2(u32* dst, const u8* src, int width, int height,
+                                          TextureFormat texformat, const u8* tlut,
+                                          TLUTFormat tlutfmt, int Wsteps4, int Wsteps8)
+{
+  const __m128i kMask_x0f = _mm_set1_epi32(0x0f0f0f0fL);
+  const __m128i kMask_xf0 = _mm_set1_epi32(0xf0f0f0f0L);
+
+  // Same expansion as the SSSE3 decoder, but a whole row of 8 texels is shuffled out of the copy
+  // of the expanded nibbles in each lane, so two rows take two shuffles and two stores.
+  const __m256i mask_row0 =
+      _mm256_setr_epi8(0, 0, 0, 0, 8, 8, 8, 8, 1, 1, 1, 1, 9, 9, 9, 9,  //
+                       2, 2, 2, 2, 10, 10, 10, 10, 3, 3, 3, 3, 11, 11, 11, 11);
+  const __m256i mask_row1 =
+      _mm256_setr_epi8(4, 4, 4, 4, 12, 12, 12, 12, 5, 5, 5, 5, 13, 13, 13, 13,  //
+                       6, 6, 6, 6, 14, 14, 14, 14, 7, 7, 7, 7, 15, 15, 15, 15);
+  for (int y = 0; y < height; y += 8)
+  {
+    for (int x = 0, yStep = (y / 8) * Wsteps8; x < width; x += 8, yStep++)
+    {
+      for (int iy = 0, xStep = 4 * yStep; iy < 8; iy += 2, xStep++)
+      {
+        const __m128i r0 = _mm_loadl_epi64((const __m128i*)(src + 8 * xStep));
+        const __m128i i1 = _mm_and_si128(r0, kMask_xf0);
+        const __m128i i11 = _mm_or_si128(i1, _mm_srli_epi16(i1, 4));
+        const __m128i i2 = _mm_and_si128(r0, kMask_x0f);
+        const __m128i i22 = _mm_or_si128(i2, _mm_slli_epi16(i2, 4));
+
+        // (low nibbles of bytes 7..0, high nibbles of bytes 7..0) in both lanes
+        const __m256i base = _mm256_broadcastsi128_si256(_mm_unpacklo_epi64(i11, i22));
+        _mm256_storeu_si256((__m256i*)(dst + (y + iy) * width + x),
+                            _mm256_shuffle_epi8(base, mask_row0));
+        _mm256_storeu_si256((__m256i*)(dst + (y + iy + 1) * width + x),
+                            _mm256_shuffle_epi8(base, mask_row1));
+      }
+    }
+  }
+}
+
 static void TexDecoder_DecodeImpl_I4(u32* dst, const u8* src, int width, int height,
                                      TextureFormat texformat, const u8* tlut, TLUTFormat tlutfmt,
                                      int Wsteps4, int Wsteps8)
@@ -424,6 +463,28 @@ static void TexDecoder_DecodeImpl_I8_SSSE3(u32* dst, const u8* src, int width, i
   }
 }
 
+FUNCTION_TARGET_AVX2
+static void TexDecoder_DecodeImpl_I8_AVX2(u32* dst, const u8* src, int width, int height,
+                                          TextureFormat texformat, const u8* tlut,
+                                          TLUTFormat tlutfmt, int Wsteps4, int Wsteps8)
+{
+  // Expands a whole row of 8 texels with one shuffle, using the copy of the row in each lane
+  const __m256i mask = _mm256_setr_epi8(0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3,  //
+                                        4, 4, 4, 4, 5, 5, 5, 5, 6, 6, 6, 6, 7, 7, 7, 7);
+  for (int y = 0; y < height; y += 4)
+  {
+    for (int x = 0, yStep = (y / 4) * Wsteps8; x < width; x += 8, yStep++)
+    {
+      for (int iy = 0, xStep = 4 * yStep; iy < 4; ++iy, xStep++)
+      {
+        const __m256i r =
+            _mm256_broadcastq_epi64(_mm_loadl_epi64((const __m128i*)(src + 8 * xStep)));
+        _mm256_storeu_si256((__m256i*)(dst + (y + iy) * width + x), _mm256_shuffle_epi8(r, mask));
+      }
+    }
+  }
+}
+
 static void TexDecoder_DecodeImpl_I8(u32* dst, const u8* src, int width, int height,
                                      TextureFormat texformat, const u8* tlut, TLUTFormat tlutfmt,
                                      int Wsteps4, int Wsteps8)
@@ -603,6 +664,33 @@ static void TexDecoder_DecodeImpl_IA8_SSSE3(u32* dst, const u8* src, int width,
   }
 }
 
+FUNCTION_TARGET_AVX2
+static void TexDecoder_DecodeImpl_IA8_AVX2(u32* dst, const u8* src, int width, int height,
+                                           TextureFormat texformat, const u8* tlut,
+                                           TLUTFormat tlutfmt, int Wsteps4, int Wsteps8)
+{
+  // Same shuffle as the SSSE3 version, but for two rows of a block at a time
+  const __m256i mask = _mm256_setr_epi8(1, 1, 1, 0, 3, 3, 3, 2, 5, 5, 5, 4, 7, 7, 7, 6,  //
+                                        9, 9, 9, 8, 11, 11, 11, 10, 13, 13, 13, 12, 15, 15, 15, 14);
+  for (int y = 0; y < height; y += 4)
+  {
+    for (int x = 0, yStep = (y / 4) * Wsteps4; x < width; x += 4, yStep++)
+    {
+      for (int iy = 0, xStep = 4 * yStep; iy < 4; iy += 2, xStep += 2)
+      {
+        // Load two rows of 4x 16-bit IA8 samples, and shuffle each row in its own lane
+        const __m256i r0 = _mm256_permute4x64_epi64(
+            _mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)(src + 8 * xStep))),
+            _MM_SHUFFLE(1, 1, 0, 0));
+        const __m256i r1 = _mm256_shuffle_epi8(r0, mask);
+        _mm_storeu_si128((__m128i*)(dst + (y + iy) * width + x), _mm256_castsi256_si128(r1));
+        _mm_storeu_si128((__m128i*)(dst + (y + iy + 1) * width + x),
+                         _mm256_extracti128_si256(r1, 1));
+      }
+    }
+  }
+}
+
 static void TexDecoder_DecodeImpl_IA8(u32* dst, const u8* src, int width, int height,
                                       TextureFormat texformat, const u8* tlut, TLUTFormat tlutfmt,
                                       int Wsteps4, int Wsteps8)
@@ -773,6 +861,110 @@ static void TexDecoder_DecodeImpl_RGB565(u32* dst, const u8* src, int width, int
   }
 }
 
+// Loads two rows of a block of 16-bit big-endian texels, zero-extended to 32 bits each.
+FUNCTION_TARGET_AVX2
+static inline __m256i Load16BitTexelsx8_AVX2(const u8* src)
+{
+  const __m128i swap_mask = _mm_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14);
+  return _mm256_cvtepu16_epi32(_mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)src), swap_mask));
+}
+
+// Stores 8 texels to two rows of a block.
+FUNCTION_TARGET_AVX2
+static inline void StoreTexelsx8_AVX2(u32* dst, int width, __m256i texels)
+{
+  _mm_storeu_si128((__m128i*)dst, _mm256_castsi256_si128(texels));
+  _mm_storeu_si128((__m128i*)(dst + width), _mm256_extracti128_si256(texels, 1));
+}
+
+FUNCTION_TARGET_AVX2
+static void TexDecoder_DecodeImpl_RGB565_AVX2(u32* dst, const u8* src, int width, int height,
+                                              TextureFormat texformat, const u8* tlut,
+                                              TLUTFormat tlutfmt, int Wsteps4, int Wsteps8)
+{
+  const __m256i kMask_x1f = _mm256_set1_epi32(0x1f);
+  const __m256i kMask_x3f = _mm256_set1_epi32(0x3f);
+  const __m256i kAlpha = _mm256_set1_epi32(0xFF000000);
+  for (int y = 0; y < height; y += 4)
+  {
+    for (int x = 0, yStep = (y / 4) * Wsteps4; x < width; x += 4, yStep++)
+    {
+      for (int iy = 0, xStep = 4 * yStep; iy < 4; iy += 2, xStep += 2)
+      {
+        const __m256i val = Load16BitTexelsx8_AVX2(src + 8 * xStep);
+
+        // r = Convert5To8((val >> 11) & 0x1f), and likewise for g and b
+        const __m256i r5 = _mm256_and_si256(_mm256_srli_epi32(val, 11), kMask_x1f);
+        const __m256i r = _mm256_or_si256(_mm256_slli_epi32(r5, 3), _mm256_srli_epi32(r5, 2));
+        const __m256i g6 = _mm256_and_si256(_mm256_srli_epi32(val, 5), kMask_x3f);
+        const __m256i g = _mm256_or_si256(_mm256_slli_epi32(g6, 2), _mm256_srli_epi32(g6, 4));
+        const __m256i b5 = _mm256_and_si256(val, kMask_x1f);
+        const __m256i b = _mm256_or_si256(_mm256_slli_epi32(b5, 3), _mm256_srli_epi32(b5, 2));
+
+        const __m256i abgr =
+            _mm256_or_si256(_mm256_or_si256(r, _mm256_slli_epi32(g, 8)),
+                            _mm256_or_si256(_mm256_slli_epi32(b, 16), kAlpha));
+        StoreTexelsx8_AVX2(dst + (y + iy) * width + x, width, abgr);
+      }
+    }
+  }
+}
+
+FUNCTION_TARGET_AVX2
+static void TexDecoder_DecodeImpl_RGB5A3_AVX2(u32* dst, const u8* src, int width, int height,
+                                              TextureFormat texformat, const u8* tlut,
+                                              TLUTFormat tlutfmt, int Wsteps4, int Wsteps8)
+{
+  const __m256i kMask_x1f = _mm256_set1_epi32(0x1f);
+  const __m256i kMask_x0f = _mm256_set1_epi32(0x0f);
+  const __m256i kMask_x07 = _mm256_set1_epi32(0x07);
+  const __m256i kAlpha = _mm256_set1_epi32(0xFF000000);
+
+  // Unlike the SSSE3 version, both encodings are always decoded and the texels are picked
+  // afterwards, which avoids the scalar path for blocks mixing RGB555 and RGBA4443 texels.
+  for (int y = 0; y < height; y += 4)
+  {
+    for (int x = 0, yStep = (y / 4) * Wsteps4; x < width; x += 4, yStep++)
+    {
+      for (int iy = 0, xStep = 4 * yStep; iy < 4; iy += 2, xStep += 2)
+      {
+        const __m256i val = Load16BitTexelsx8_AVX2(src + 8 * xStep);
+
+        // RGB555: Swizzle bits: 00012345 -> 12345123
+        const __m256i r5 = _mm256_and_si256(_mm256_srli_epi32(val, 10), kMask_x1f);
+        const __m256i r = _mm256_or_si256(_mm256_slli_epi32(r5, 3), _mm256_srli_epi32(r5, 2));
+        const __m256i g5 = _mm256_and_si256(_mm256_srli_epi32(val, 5), kMask_x1f);
+        const __m256i g = _mm256_or_si256(_mm256_slli_epi32(g5, 3), _mm256_srli_epi32(g5, 2));
+        const __m256i b5 = _mm256_and_si256(val, kMask_x1f);
+        const __m256i b = _mm256_or_si256(_mm256_slli_epi32(b5, 3), _mm256_srli_epi32(b5, 2));
+        const __m256i rgb555 =
+            _mm256_or_si256(_mm256_or_si256(r, _mm256_slli_epi32(g, 8)),
+                            _mm256_or_si256(_mm256_slli_epi32(b, 16), kAlpha));
+
+        // RGBA4443: Swizzle bits: 00001234 -> 12341234, and 00000123 -> 12312312 for alpha
+        const __m256i r4 = _mm256_and_si256(_mm256_srli_epi32(val, 8), kMask_x0f);
+        const __m256i g4 = _mm256_and_si256(_mm256_srli_epi32(val, 4), kMask_x0f);
+        const __m256i b4 = _mm256_and_si256(val, kMask_x0f);
+        const __m256i a3 = _mm256_and_si256(_mm256_srli_epi32(val, 12), kMask_x07);
+        const __m256i a =
+            _mm256_or_si256(_mm256_slli_epi32(a3, 5),
+                            _mm256_or_si256(_mm256_slli_epi32(a3, 2), _mm256_srli_epi32(a3, 1)));
+        const __m256i rgb4 = _mm256_or_si256(_mm256_or_si256(r4, _mm256_slli_epi32(g4, 8)),
+                                             _mm256_slli_epi32(b4, 16));
+        const __m256i rgba4443 =
+            _mm256_or_si256(_mm256_or_si256(rgb4, _mm256_slli_epi32(rgb4, 4)),
+                            _mm256_slli_epi32(a, 24));
+
+        // The top bit of each texel selects the encoding
+        const __m256 is_rgb555 = _mm256_castsi256_ps(_mm256_slli_epi32(val, 16));
+        const __m256i rgba = _mm256_castps_si256(_mm256_blendv_ps(
+            _mm256_castsi256_ps(rgba4443), _mm256_castsi256_ps(rgb555), is_rgb555));
+        StoreTexelsx8_AVX2(dst + (y + iy) * width + x, width, rgba);
+      }
+    }
+  }
+}
+
 FUNCTION_TARGET_SSSE3
 static void TexDecoder_DecodeImpl_RGB5A3_SSSE3(u32* dst, const u8* src, int width, int height,
                                                TextureFormat texformat, const u8* tlut,
@@ -1412,6 +1604,73 @@ static void TexDecoder_DecodeImpl_CMPR(u32* dst, const u8* src, int width, int h
   }
 }
 
+FUNCTION_TARGET_AVX2
+static void DecodeDXTBlock_AVX2(u32* dst, const DXTBlock* src, int pitch)
+{
+  const u16 c1 = Common::swap16(src->color1);
+  const u16 c2 = Common::swap16(src->color2);
+  const int blue1 = Convert5To8(c1 & 0x1F);
+  const int blue2 = Convert5To8(c2 & 0x1F);
+  const int green1 = Convert6To8((c1 >> 5) & 0x3F);
+  const int green2 = Convert6To8((c2 >> 5) & 0x3F);
+  const int red1 = Convert5To8((c1 >> 11) & 0x1F);
+  const int red2 = Convert5To8((c2 >> 11) & 0x1F);
+
+  u32 color2, color3;
+  if (c1 > c2)
+  {
+    color2 = MakeRGBA(DXTBlend(red2, red1), DXTBlend(green2, green1), DXTBlend(blue2, blue1), 255);
+    color3 = MakeRGBA(DXTBlend(red1, red2), DXTBlend(green1, green2), DXTBlend(blue1, blue2), 255);
+  }
+  else
+  {
+    // color3 is the same as color2 (average of both colors), but transparent.
+    color2 = MakeRGBA((red1 + red2) / 2, (green1 + green2) / 2, (blue1 + blue2) / 2, 255);
+    color3 = color2 & 0x00FFFFFF;
+  }
+  const __m256i colors = _mm256_setr_epi32(MakeRGBA(red1, green1, blue1, 255),
+                                           MakeRGBA(red2, green2, blue2, 255), color2, color3, 0, 0,
+                                           0, 0);
+
+  // Each row is a byte of 2-bit indices, starting with the leftmost texel in the top bits.
+  // Two rows are looked up at a time, one in each lane.
+  u32 lines;
+  std::memcpy(&lines, src->lines, sizeof(lines));
+  const __m256i shifts = _mm256_setr_epi32(6, 4, 2, 0, 14, 12, 10, 8);
+  const __m256i kMask_x03 = _mm256_set1_epi32(3);
+  for (int row = 0; row < 4; row += 2)
+  {
+    const __m256i indices =
+        _mm256_and_si256(_mm256_srlv_epi32(_mm256_set1_epi32(lines >> (row * 8)), shifts),
+                         kMask_x03);
+    const __m256i texels = _mm256_permutevar8x32_epi32(colors, indices);
+    _mm_storeu_si128((__m128i*)(dst + row * pitch), _mm256_castsi256_si128(texels));
+    _mm_storeu_si128((__m128i*)(dst + (row + 1) * pitch), _mm256_extracti128_si256(texels, 1));
+  }
+}
+
+FUNCTION_TARGET_AVX2
+static void TexDecoder_DecodeImpl_CMPR_AVX2(u32* dst, const u8* src, int width, int height,
+                                            TextureFormat texformat, const u8* tlut,
+                                            TLUTFormat tlutfmt, int Wsteps4, int Wsteps8)
+{
+  // Computing the 4 colors of a block is cheap compared to looking up the 16 texels, so only the
+  // lookups are vectorized.
+  for (int y = 0; y < height; y += 8)
+  {
+    for (int x = 0, yStep = (y / 8) * Wsteps8; x < width; x += 8, yStep++)
+    {
+      for (int z = 0, xStep = 2 * yStep; z < 2; ++z, xStep++)
+      {
+        const DXTBlock* blocks = reinterpret_cast<const DXTBlock*>(src) + 2 * xStep;
+        u32* dst32 = dst + (y + z * 4) * width + x;
+        DecodeDXTBlock_AVX2(dst32, blocks, width);
+        DecodeDXTBlock_AVX2(dst32 + 4, blocks + 1, width);
+      }
+    }
+  }
+}
+
 void _TexDecoder_DecodeImpl(u32* dst, const u8* src, int width, int height, TextureFormat texformat,
                             const u8* tlut, TLUTFormat tlutfmt)
 {
@@ -1425,7 +1684,10 @@ void _TexDecoder_DecodeImpl(u32* dst, const u8* src, int width, int height, Text
     break;
 
   case TextureFormat::I4:
-    if (cpu_info.bSSSE3)
+    if (cpu_info.bAVX2)
+      TexDecoder_DecodeImpl_I4_AVX2(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
+                                    Wsteps8);
+    else if (cpu_info.bSSSE3)
       TexDecoder_DecodeImpl_I4_SSSE3(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
                                      Wsteps8);
     else
@@ -1433,7 +1695,10 @@ void _TexDecoder_DecodeImpl(u32* dst, const u8* src, int width, int height, Text
     break;
 
   case TextureFormat::I8:
-    if (cpu_info.bSSSE3)
+    if (cpu_info.bAVX2)
+      TexDecoder_DecodeImpl_I8_AVX2(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
+                                    Wsteps8);
+    else if (cpu_info.bSSSE3)
       TexDecoder_DecodeImpl_I8_SSSE3(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
                                      Wsteps8);
     else
@@ -1449,7 +1714,10 @@ void _TexDecoder_DecodeImpl(u32* dst, const u8* src, int width, int height, Text
     break;
 
   case TextureFormat::IA8:
-    if (cpu_info.bSSSE3)
+    if (cpu_info.bAVX2)
+      TexDecoder_DecodeImpl_IA8_AVX2(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
+                                     Wsteps8);
+    else if (cpu_info.bSSSE3)
       TexDecoder_DecodeImpl_IA8_SSSE3(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
                                       Wsteps8);
     else
@@ -1463,12 +1731,19 @@ void _TexDecoder_DecodeImpl(u32* dst, const u8* src, int width, int height, Text
     break;
 
   case TextureFormat::RGB565:
-    TexDecoder_DecodeImpl_RGB565(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
-                                 Wsteps8);
+    if (cpu_info.bAVX2)
+      TexDecoder_DecodeImpl_RGB565_AVX2(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
+                                        Wsteps8);
+    else
+      TexDecoder_DecodeImpl_RGB565(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
+                                   Wsteps8);
     break;
 
   case TextureFormat::RGB5A3:
-    if (cpu_info.bSSSE3)
+    if (cpu_info.bAVX2)
+      TexDecoder_DecodeImpl_RGB5A3_AVX2(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
+                                        Wsteps8);
+    else if (cpu_info.bSSSE3)
       TexDecoder_DecodeImpl_RGB5A3_SSSE3(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
                                          Wsteps8);
     else
@@ -1486,7 +1761,12 @@ void _TexDecoder_DecodeImpl(u32* dst, const u8* src, int width, int height, Text
     break;
 
   case TextureFormat::CMPR:
-    TexDecoder_DecodeImpl_CMPR(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4, Wsteps8);
+    if (cpu_info.bAVX2)
+      TexDecoder_DecodeImpl_CMPR_AVX2(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
+                                      Wsteps8);
+    else
+      TexDecoder_DecodeImpl_CMPR(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
+                                 Wsteps8);
     break;
 
   case TextureFormat::XFB:
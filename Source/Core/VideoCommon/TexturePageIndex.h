@@ -0,0 +1,86 @@
+// Copyright 2021 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+
+// Buckets the memory ranges of textures by the pages they cover. The texture cache only indexes
+// textures by their start address, so this is used to find out how far back it has to look for
+// textures which overlap an address.
+template <typename T>
+class TexturePageIndex
+{
+public:
+  static constexpr u32 PAGE_SHIFT = 16;
+
+  void Add(u32 address, u32 size, const T* texture)
+  {
+    ForEachPage(address, size,
+                [&](u32 page) { m_pages[page].push_back({address, size, texture}); });
+  }
+
+  void Remove(u32 address, u32 size, const T* texture)
+  {
+    ForEachPage(address, size, [&](u32 page) {
+      const auto page_iter = m_pages.find(page);
+      if (page_iter == m_pages.end())
+        return;
+
+      std::vector<Range>& ranges = page_iter->second;
+      const auto iter = std::find_if(ranges.begin(), ranges.end(), [texture](const Range& range) {
+        return range.texture == texture;
+      });
+      if (iter == ranges.end())
+        return;
+
+      *iter = ranges.back();
+      ranges.pop_back();
+      if (ranges.empty())
+        m_pages.erase(page_iter);
+    });
+  }
+
+  void Clear() { m_pages.clear(); }
+
+  // Returns the lowest start address of the textures which contain address, or address itself if
+  // there are none. All textures overlapping a range which starts at address start at or after it.
+  u32 GetLowestOverlappingAddress(u32 address) const
+  {
+    const auto page_iter = m_pages.find(address >> PAGE_SHIFT);
+    if (page_iter == m_pages.end())
+      return address;
+
+    u32 lowest_address = address;
+    for (const Range& range : page_iter->second)
+    {
+      if (range.address < lowest_address && range.address + range.size > address)
+        lowest_address = range.address;
+    }
+    return lowest_address;
+  }
+
+  size_t GetPageCount() const { return m_pages.size(); }
+
+private:
+  struct Range
+  {
+    u32 address;
+    u32 size;
+    const T* texture;
+  };
+
+  template <typename F>
+  static void ForEachPage(u32 address, u32 size, F f)
+  {
+    const u32 last_address = address + std::max(size, 1u) - 1;
+    for (u32 page = address >> PAGE_SHIFT; page <= last_address >> PAGE_SHIFT; ++page)
+      f(page);
+  }
+
+  std::unordered_map<u32, std::vector<Range>> m_pages;
+};
@@ -0,0 +1,63 @@
+// Copyright 2021 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "VideoCommon/VertexLoaderCache.h"
+
+// Keys seen only once are forgotten after this many, so that a stream of one-off draws can't grow
+// the set without bound.
+constexpr size_t MAX_SEEN_KEYS = 8192;
+
+const VertexLoaderCache::Entry* VertexLoaderCache::Find(u64 key)
+{
+  const auto iter = m_entries.find(key);
+  if (iter == m_entries.end())
+    return nullptr;
+
+  m_lru.splice(m_lru.begin(), m_lru, iter->second.lru_iter);
+  return &iter->second.entry;
+}
+
+bool VertexLoaderCache::MarkSeen(u64 key)
+{
+  if (m_seen.erase(key))
+    return true;
+
+  if (m_seen.size() >= MAX_SEEN_KEYS)
+    m_seen.clear();
+  m_seen.insert(key);
+  return false;
+}
+
+VertexLoaderCache::Entry* VertexLoaderCache::Insert(u64 key, size_t size)
+{
+  if (size > m_budget)
+    return nullptr;
+
+  const auto existing = m_entries.find(key);
+  if (existing != m_entries.end())
+    Erase(existing);
+
+  while (m_size + size > m_budget && !m_lru.empty())
+    Erase(m_entries.find(m_lru.back()));
+
+  CachedEntry& cached = m_entries[key];
+  cached.entry.vertices.resize(size);
+  cached.lru_iter = m_lru.insert(m_lru.begin(), key);
+  m_size += size;
+  return &cached.entry;
+}
+
+void VertexLoaderCache::Clear()
+{
+  m_entries.clear();
+  m_lru.clear();
+  m_seen.clear();
+  m_size = 0;
+}
+
+void VertexLoaderCache::Erase(std::unordered_map<u64, CachedEntry>::iterator iter)
+{
+  m_size -= iter->second.entry.vertices.size();
+  m_lru.erase(iter->second.lru_iter);
+  m_entries.erase(iter);
+}
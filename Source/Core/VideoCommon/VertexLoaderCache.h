@@ -0,0 +1,64 @@
+// Copyright 2021 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <list>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+
+// Keeps the output of the vertex loaders for draws which have been seen before, keyed by a hash of
+// everything the output depends on. Static geometry which is drawn every frame then only has to be
+// converted once. Entries are evicted in least recently used order once the budget is exceeded.
+class VertexLoaderCache
+{
+public:
+  struct Entry
+  {
+    std::vector<u8> vertices;
+    int count = 0;
+
+    // The zfreeze state the vertex loader wrote for the last (up to) three vertices.
+    // position_matrix_index[i] corresponds to VertexLoaderManager::position_matrix_index[i + 1].
+    std::array<std::array<float, 4>, 3> position_cache{};
+    std::array<u32, 3> position_matrix_index{};
+  };
+
+  explicit VertexLoaderCache(size_t budget) : m_budget(budget) {}
+
+  // Returns the entry for key and marks it as the most recently used one, or nullptr.
+  const Entry* Find(u64 key);
+
+  // Returns whether key has been passed to this before. Draws are only inserted the second time
+  // they are seen, so that geometry which changes every frame doesn't evict everything else.
+  bool MarkSeen(u64 key);
+
+  // Adds an entry for key with room for size bytes of vertices, evicting old entries to stay within
+  // the budget. Returns nullptr if the entry would not fit on its own.
+  Entry* Insert(u64 key, size_t size);
+
+  void Clear();
+
+  size_t GetSize() const { return m_size; }
+  size_t GetEntryCount() const { return m_entries.size(); }
+
+private:
+  struct CachedEntry
+  {
+    Entry entry;
+    std::list<u64>::iterator lru_iter;
+  };
+
+  void Erase(std::unordered_map<u64, CachedEntry>::iterator iter);
+
+  std::unordered_map<u64, CachedEntry> m_entries;
+  std::list<u64> m_lru;
+  std::unordered_set<u64> m_seen;
+  size_t m_size = 0;
+  size_t m_budget;
+};
@@ -4,6 +4,7 @@
 #include "VideoCommon/VertexLoaderManager.h"
 
 #include <algorithm>
+#include <cstring>
 #include <iterator>
 #include <memory>
 #include <mutex>
@@ -12,9 +13,12 @@
 #include <utility>
 #include <vector>
 
+#include <xxhash.h>
+
 #include "Common/Assert.h"
 #include "Common/CommonTypes.h"
 #include "Common/Logging/Log.h"
+#include "Common/Tracing.h"
 
 #include "Core/DolphinAnalytics.h"
 #include "Core/HW/Memmap.h"
@@ -28,8 +32,14 @@
 #include "VideoCommon/RenderBase.h"
 #include "VideoCommon/Statistics.h"
 #include "VideoCommon/VertexLoaderBase.h"
+#include "VideoCommon/VertexLoaderCache.h"
+#include "VideoCommon/VertexLoader_Color.h"
+#include "VideoCommon/VertexLoader_Normal.h"
+#include "VideoCommon/VertexLoader_Position.h"
+#include "VideoCommon/VertexLoader_TextCoord.h"
 #include "VideoCommon/VertexManagerBase.h"
 #include "VideoCommon/VertexShaderManager.h"
+#include "VideoCommon/VideoConfig.h"
 
 namespace VertexLoaderManager
 {
@@ -49,10 +59,19 @@ static VertexLoaderMap s_vertex_loader_map;
 // TODO - change into array of pointers. Keep a map of all seen so far.
 
 u8* cached_arraybases[NUM_VERTEX_COMPONENT_ARRAYS];
+size_t cached_arraysizes[NUM_VERTEX_COMPONENT_ARRAYS];
+
+// Converted vertices of draws which repeat, for when the vertex loader cache is enabled.
+constexpr size_t VERTEX_CACHE_BUDGET = 32 * 1024 * 1024;
+// Below this, running the vertex loader is cheaper than hashing the draw.
+constexpr int VERTEX_CACHE_MIN_VERTICES = 16;
+static VertexLoaderCache s_vertex_cache(VERTEX_CACHE_BUDGET);
 
 void Init()
 {
   MarkAllDirty();
+  s_vertex_cache.Clear();
+  SETSTAT(g_stats.vertex_cache_size, 0);
   for (auto& map_entry : g_main_cp_state.vertex_loaders)
     map_entry = nullptr;
   for (auto& map_entry : g_preprocess_cp_state.vertex_loaders)
@@ -65,6 +84,25 @@ void Clear()
   std::lock_guard<std::mutex> lk(s_vertex_loader_map_lock);
   s_vertex_loader_map.clear();
   s_native_vertex_map.clear();
+  s_vertex_cache.Clear();
+}
+
+// Returns how many bytes of RAM or EXRAM there are from ptr on, or 0 if it points elsewhere
+static size_t GetEmulatedMemorySize(const u8* ptr)
+{
+  const auto size_in_region = [ptr](const u8* base, size_t region_size) -> size_t {
+    if (!base || ptr < base || static_cast<size_t>(ptr - base) >= region_size)
+      return 0;
+    return region_size - static_cast<size_t>(ptr - base);
+  };
+  return std::max(size_in_region(Memory::m_pRAM, Memory::GetRamSizeReal()),
+                  size_in_region(Memory::m_pEXRAM, Memory::GetExRamSizeReal()));
+}
+
+static void UpdateVertexArrayPointer(int array)
+{
+  cached_arraybases[array] = Memory::GetPointer(g_main_cp_state.array_bases[array]);
+  cached_arraysizes[array] = GetEmulatedMemorySize(cached_arraybases[array]);
 }
 
 void UpdateVertexArrayPointers()
@@ -80,24 +118,21 @@ void UpdateVertexArrayPointers()
   //       12 through 15 are used for loading data into xfmem.
   // We also only update the array base if the vertex description states we are going to use it.
   if (IsIndexed(g_main_cp_state.vtx_desc.low.Position))
-    cached_arraybases[ARRAY_POSITION] =
-        Memory::GetPointer(g_main_cp_state.array_bases[ARRAY_POSITION]);
+    UpdateVertexArrayPointer(ARRAY_POSITION);
 
   if (IsIndexed(g_main_cp_state.vtx_desc.low.Normal))
-    cached_arraybases[ARRAY_NORMAL] = Memory::GetPointer(g_main_cp_state.array_bases[ARRAY_NORMAL]);
+    UpdateVertexArrayPointer(ARRAY_NORMAL);
 
-  for (size_t i = 0; i < g_main_cp_state.vtx_desc.low.Color.Size(); i++)
+  for (u32 i = 0; i < g_main_cp_state.vtx_desc.low.Color.Size(); i++)
   {
     if (IsIndexed(g_main_cp_state.vtx_desc.low.Color[i]))
-      cached_arraybases[ARRAY_COLOR0 + i] =
-          Memory::GetPointer(g_main_cp_state.array_bases[ARRAY_COLOR0 + i]);
+      UpdateVertexArrayPointer(ARRAY_COLOR0 + i);
   }
 
-  for (size_t i = 0; i < g_main_cp_state.vtx_desc.high.TexCoord.Size(); i++)
+  for (u32 i = 0; i < g_main_cp_state.vtx_desc.high.TexCoord.Size(); i++)
   {
     if (IsIndexed(g_main_cp_state.vtx_desc.high.TexCoord[i]))
-      cached_arraybases[ARRAY_TEXCOORD0 + i] =
-          Memory::GetPointer(g_main_cp_state.array_bases[ARRAY_TEXCOORD0 + i]);
+      UpdateVertexArrayPointer(ARRAY_TEXCOORD0 + i);
   }
 
   g_main_cp_state.bases_dirty = false;
@@ -239,6 +274,180 @@ static VertexLoaderBase* RefreshLoader(int vtx_attr_group, bool preprocess = fal
   return loader;
 }
 
+// Hashes the part of a vertex array which is referenced by the indices of one attribute.
+// src points at the first index of the attribute in the first vertex, and element_size is the
+// number of bytes read from the array per index. Returns false if that part is not in RAM.
+static bool HashIndexedArray(u64* hash, int array, DataReader src, int count, u32 vertex_size,
+                             VertexComponentFormat format, u32 num_indices, u32 element_size)
+{
+  const bool is_16bit = format == VertexComponentFormat::Index16;
+  bool any_index = false;
+  u32 min_index = UINT32_MAX;
+  u32 max_index = 0;
+  for (int i = 0; i < count; ++i)
+  {
+    for (u32 j = 0; j < num_indices; ++j)
+    {
+      const int offset = i * vertex_size + j * (is_16bit ? 2 : 1);
+      const u32 index = is_16bit ? src.Peek<u16>(offset) : src.Peek<u8>(offset);
+
+      // Vertices whose position index is all ones are skipped without reading the array.
+      if (array == ARRAY_POSITION && index == (is_16bit ? 0xFFFFu : 0xFFu))
+        continue;
+
+      min_index = std::min(min_index, index);
+      max_index = std::max(max_index, index);
+      any_index = true;
+    }
+  }
+  if (!any_index)
+    return true;
+
+  // Only the elements from the lowest to the highest index are hashed. Where they are in the
+  // array is part of the key, since the same data at another index is a different draw.
+  const u32 stride = g_main_cp_state.array_strides[array];
+  const size_t offset = static_cast<size_t>(min_index) * stride;
+  const size_t size = static_cast<size_t>(max_index - min_index) * stride + element_size;
+  if (offset > cached_arraysizes[array] || size > cached_arraysizes[array] - offset)
+    return false;
+
+  *hash = XXH64(&min_index, sizeof(min_index), *hash);
+  *hash = XXH64(&stride, sizeof(stride), *hash);
+  *hash = XXH64(cached_arraybases[array] + offset, size, *hash);
+  return true;
+}
+
+bool GetVertexCacheKey(u64* key, const VertexLoaderBase* loader, const TVtxDesc& vtx_desc,
+                       const VAT& vtx_attr, DataReader src, int count)
+{
+  const u32 vertex_size = loader->m_vertex_size;
+  u64 hash = XXH64(&loader, sizeof(loader), count);
+  hash = XXH64(src.GetPointer(), static_cast<size_t>(count) * vertex_size, hash);
+
+  // Matrix indices come first and are never indexed.
+  u32 offset = vtx_desc.low.PosMatIdx ? 1 : 0;
+  for (auto texmtxidx : vtx_desc.low.TexMatIdx)
+  {
+    if (texmtxidx)
+      offset++;
+  }
+
+  const auto hash_attribute = [&](int array, VertexComponentFormat format, u32 size,
+                                  u32 element_size) {
+    const u32 attribute_offset = offset;
+    offset += size;
+    if (!IsIndexed(format) || size == 0)
+      return true;
+
+    DataReader indices = src;
+    indices.Skip(attribute_offset);
+    const u32 num_indices = format == VertexComponentFormat::Index16 ? size / 2 : size;
+    return HashIndexedArray(&hash, array, indices, count, vertex_size, format, num_indices,
+                            element_size);
+  };
+
+  const auto& g0 = vtx_attr.g0;
+  if (!hash_attribute(
+          ARRAY_POSITION, vtx_desc.low.Position,
+          VertexLoader_Position::GetSize(vtx_desc.low.Position, g0.PosFormat, g0.PosElements),
+          VertexLoader_Position::GetSize(VertexComponentFormat::Direct, g0.PosFormat,
+                                         g0.PosElements)))
+  {
+    return false;
+  }
+
+  // With NormalIndex3, each of the three indices reads one vector at an offset into the element,
+  // so the whole element still covers what is read.
+  if (!hash_attribute(ARRAY_NORMAL, vtx_desc.low.Normal,
+                      VertexLoader_Normal::GetSize(vtx_desc.low.Normal, g0.NormalFormat,
+                                                   g0.NormalElements, g0.NormalIndex3),
+                      VertexLoader_Normal::GetSize(VertexComponentFormat::Direct, g0.NormalFormat,
+                                                   g0.NormalElements, false)))
+  {
+    return false;
+  }
+
+  for (u32 i = 0; i < vtx_desc.low.Color.Size(); i++)
+  {
+    const ColorFormat format = vtx_attr.GetColorFormat(i);
+    if (!hash_attribute(ARRAY_COLOR0 + i, vtx_desc.low.Color[i],
+                        VertexLoader_Color::GetSize(vtx_desc.low.Color[i], format),
+                        VertexLoader_Color::GetSize(VertexComponentFormat::Direct, format)))
+    {
+      return false;
+    }
+  }
+
+  for (u32 i = 0; i < vtx_desc.high.TexCoord.Size(); i++)
+  {
+    const VertexComponentFormat tc = vtx_desc.high.TexCoord[i];
+    const ComponentFormat format = vtx_attr.GetTexFormat(i);
+    const auto elements = vtx_attr.GetTexElements(i);
+    if (!hash_attribute(
+            ARRAY_TEXCOORD0 + i, tc, VertexLoader_TextCoord::GetSize(tc, format, elements),
+            VertexLoader_TextCoord::GetSize(VertexComponentFormat::Direct, format, elements)))
+    {
+      return false;
+    }
+  }
+
+  *key = hash;
+  return true;
+}
+
+// Runs the loader, or copies its output from the vertex loader cache if the same vertices have
+// been loaded before. Draws are added to the cache the second time they are seen.
+static int RunVerticesCached(VertexLoaderBase* loader, int vtx_attr_group, DataReader src,
+                             DataReader dst, int count)
+{
+  u64 key;
+  if (!GetVertexCacheKey(&key, loader, g_main_cp_state.vtx_desc,
+                         g_main_cp_state.vtx_attr[vtx_attr_group], src, count))
+  {
+    return loader->RunVertices(src, dst, count);
+  }
+
+  // The loader only updates the zfreeze state for the last three vertices.
+  const int zfreeze_vertices = std::min(count, 3);
+  const bool has_posmtx = loader->m_native_vtx_decl.posmtx.enable;
+
+  if (const VertexLoaderCache::Entry* entry = s_vertex_cache.Find(key))
+  {
+    std::memcpy(dst.GetPointer(), entry->vertices.data(), entry->vertices.size());
+    for (int i = 0; i < zfreeze_vertices; ++i)
+    {
+      std::copy(entry->position_cache[i].begin(), entry->position_cache[i].end(),
+                position_cache[i]);
+      if (has_posmtx)
+        position_matrix_index[i + 1] = entry->position_matrix_index[i];
+    }
+    loader->m_numLoadedVertices += count;
+    INCSTAT(g_stats.this_frame.num_vertex_cache_hits);
+    return entry->count;
+  }
+
+  INCSTAT(g_stats.this_frame.num_vertex_cache_misses);
+  const int loaded = loader->RunVertices(src, dst, count);
+  if (!s_vertex_cache.MarkSeen(key))
+    return loaded;
+
+  const size_t size = static_cast<size_t>(loaded) * loader->m_native_vtx_decl.stride;
+  VertexLoaderCache::Entry* entry = s_vertex_cache.Insert(key, size);
+  if (!entry)
+    return loaded;
+
+  std::memcpy(entry->vertices.data(), dst.GetPointer(), size);
+  entry->count = loaded;
+  for (int i = 0; i < zfreeze_vertices; ++i)
+  {
+    std::copy(std::begin(position_cache[i]), std::end(position_cache[i]),
+              entry->position_cache[i].begin());
+    entry->position_matrix_index[i] = position_matrix_index[i + 1];
+  }
+  SETSTAT(g_stats.vertex_cache_size, s_vertex_cache.GetSize());
+  return loaded;
+}
+
 int RunVertices(int vtx_attr_group, int primitive, int count, DataReader src, bool is_preprocess)
 {
   if (!count)
@@ -253,6 +462,8 @@ int RunVertices(int vtx_attr_group, int primitive, int count, DataReader src, bo
   if (is_preprocess)
     return size;
 
+  TRACE_SCOPE("gpu", "RunVertices");
+
   // If the native vertex format changed, force a flush.
   if (loader->m_native_vertex_format != s_current_vtx_fmt ||
       loader->m_native_components != g_current_components)
@@ -271,7 +482,10 @@ int RunVertices(int vtx_attr_group, int primitive, int count, DataReader src, bo
   DataReader dst = g_vertex_manager->PrepareForAdditionalData(
       primitive, count, loader->m_native_vtx_decl.stride, cullall);
 
-  count = loader->RunVertices(src, dst, count);
+  if (g_ActiveConfig.bVertexLoaderCache && count >= VERTEX_CACHE_MIN_VERTICES)
+    count = RunVerticesCached(loader, vtx_attr_group, src, dst, count);
+  else
+    count = loader->RunVertices(src, dst, count);
 
   g_vertex_manager->AddIndices(primitive, count);
   g_vertex_manager->FlushData(count, loader->m_native_vtx_decl.stride);
@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <cstddef>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -12,6 +13,7 @@
 
 class DataReader;
 class NativeVertexFormat;
+class VertexLoaderBase;
 struct PortableVertexDeclaration;
 
 namespace VertexLoaderManager
@@ -41,8 +43,16 @@ NativeVertexFormat* GetCurrentVertexFormat();
 
 // Resolved pointers to array bases. Used by vertex loaders.
 extern u8* cached_arraybases[NUM_VERTEX_COMPONENT_ARRAYS];
+// How many bytes of emulated memory follow each array base, or 0 if it isn't in RAM.
+extern size_t cached_arraysizes[NUM_VERTEX_COMPONENT_ARRAYS];
 void UpdateVertexArrayPointers();
 
+// Computes the key under which the vertex loader cache keeps the output of loader for count
+// vertices at src. It covers the vertices and the vertex array data they index, and the loader
+// itself stands for the vertex description and VAT. Returns false if the draw can't be cached.
+bool GetVertexCacheKey(u64* key, const VertexLoaderBase* loader, const TVtxDesc& vtx_desc,
+                       const VAT& vtx_attr, DataReader src, int count);
+
 // Position cache for zfreeze (3 vertices, 4 floats each to allow SIMD overwrite).
 // These arrays are in reverse order.
 extern float position_cache[3][4];
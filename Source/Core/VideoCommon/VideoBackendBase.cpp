@@ -47,6 +47,7 @@
 #include "VideoCommon/PixelEngine.h"
 #include "VideoCommon/PixelShaderManager.h"
 #include "VideoCommon/RenderBase.h"
+#include "VideoCommon/ShaderCache.h"
 #include "VideoCommon/TextureCacheBase.h"
 #include "VideoCommon/VertexLoaderManager.h"
 #include "VideoCommon/VertexManagerBase.h"
@@ -271,6 +272,19 @@ void VideoBackendBase::PopulateBackendInfoFromUI()
     PopulateBackendInfo();
 }
 
+bool VideoBackendBase::PrecompileSharedShaderCache(const WindowSystemInfo& wsi)
+{
+  PopulateBackendInfo();
+  if (!g_video_backend->Initialize(wsi))
+    return false;
+
+  const size_t count = g_shader_cache->PrecompileSharedPipelines();
+  NOTICE_LOG_FMT(VIDEO, "Precompiled {} pipelines into the shared shader cache", count);
+
+  g_video_backend->Shutdown();
+  return true;
+}
+
 void VideoBackendBase::DoState(PointerWrap& p)
 {
   if (!SConfig::GetInstance().bCPUThread)
@@ -67,6 +67,10 @@ public:
   // Called by the UI thread when the graphics config is opened.
   static void PopulateBackendInfoFromUI();
 
+  // Compiles the pipelines of all games into the shared shader cache of the active backend, without
+  // running a game. Returns false if the backend failed to initialize.
+  static bool PrecompileSharedShaderCache(const WindowSystemInfo& wsi);
+
   // Wrapper function which pushes the event to the GPU thread.
   void DoState(PointerWrap& p);
 
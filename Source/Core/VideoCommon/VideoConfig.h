@@ -65,6 +65,7 @@ struct VideoConfig final
   AspectMode suggested_aspect_mode;
   bool bCrop;  // Aspect ratio controls.
   bool bShaderCache;
+  bool bSharedShaderCache;
 
   // Enhancements
   u32 iMultisamples;
@@ -98,6 +99,7 @@ struct VideoConfig final
   bool bDumpBaseTextures;
   bool bHiresTextures;
   bool bCacheHiresTextures;
+  bool bConvertHiresTextures;
   bool bDumpEFBTarget;
   bool bDumpXFBTarget;
   bool bDumpFramesAsImages;
@@ -130,6 +132,7 @@ struct VideoConfig final
   float fAspectRatioHackW, fAspectRatioHackH;
   bool bEnablePixelLighting;
   bool bFastDepthCalc;
+  bool bVertexLoaderCache;
   bool bVertexRounding;
   int iEFBAccessTileSize;
   int iLog;           // CONF_ bits
@@ -156,6 +159,7 @@ struct VideoConfig final
   bool bDumpObjects;
   bool bDumpTevStages;
   bool bDumpTevTextureFetches;
+  int iSWRasterizerThreads;  // <= 0 selects one thread per CPU core
 
   // Enable API validation layers, currently only supported with Vulkan.
   bool bEnableValidationLayer;
@@ -177,6 +181,11 @@ struct VideoConfig final
   int iShaderCompilerThreads;
   int iShaderPrecompilerThreads;
 
+  // Number of threads used to decode textures on the CPU.
+  // 0 decodes textures on the GPU thread only.
+  // -1 uses an automatic number based on the CPU threads.
+  int iTextureDecodingThreads;
+
   // Static config per API
   // TODO: Move this out of VideoConfig
   struct
@@ -241,6 +250,7 @@ struct VideoConfig final
   bool UsingUberShaders() const;
   u32 GetShaderCompilerThreads() const;
   u32 GetShaderPrecompilerThreads() const;
+  u32 GetTextureDecodingThreads() const;
 };
 
 extern VideoConfig g_Config;
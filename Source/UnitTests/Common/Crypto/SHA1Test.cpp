@@ -0,0 +1,53 @@
+// Copyright 2021 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <string_view>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Common/CommonTypes.h"
+#include "Common/Crypto/SHA1.h"
+
+static Common::SHA1::Digest Digest(std::string_view msg)
+{
+  return Common::SHA1::CalculateDigest(msg.data(), msg.size());
+}
+
+TEST(SHA1, KnownDigests)
+{
+  EXPECT_EQ(Digest(""), (Common::SHA1::Digest{0xda, 0x39, 0xa3, 0xee, 0x5e, 0x6b, 0x4b,
+                                              0x0d, 0x32, 0x55, 0xbf, 0xef, 0x95, 0x60,
+                                              0x18, 0x90, 0xaf, 0xd8, 0x07, 0x09}));
+  EXPECT_EQ(Digest("abc"), (Common::SHA1::Digest{0xa9, 0x99, 0x3e, 0x36, 0x47, 0x06, 0x81,
+                                                 0x6a, 0xba, 0x3e, 0x25, 0x71, 0x78, 0x50,
+                                                 0xc2, 0x6c, 0x9c, 0xd0, 0xd8, 0x9d}));
+  EXPECT_EQ(Digest("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq"),
+            (Common::SHA1::Digest{0x84, 0x98, 0x3e, 0x44, 0x1c, 0x3b, 0xd2, 0x6e, 0xba, 0xae,
+                                  0x4a, 0xa1, 0xf9, 0x51, 0x29, 0xe5, 0xe5, 0x46, 0x70, 0xf1}));
+
+  const std::vector<u8> million_a(1000000, 'a');
+  EXPECT_EQ(Common::SHA1::CalculateDigest(million_a.data(), million_a.size()),
+            (Common::SHA1::Digest{0x34, 0xaa, 0x97, 0x3c, 0xd4, 0xc4, 0xda, 0xa4, 0xf6, 0x1e,
+                                  0xeb, 0x2b, 0xdb, 0xad, 0x27, 0x31, 0x65, 0x34, 0x01, 0x6f}));
+}
+
+TEST(SHA1, IncrementalMatchesSingleCall)
+{
+  std::vector<u8> data(0x400);
+  for (size_t i = 0; i < data.size(); ++i)
+    data[i] = static_cast<u8>(i * 13);
+
+  for (const size_t chunk_size : {1, 7, 55, 56, 63, 64, 65, 200})
+  {
+    for (const size_t size : {0, 55, 56, 64, 119, 120, 0x400})
+    {
+      const auto context = Common::SHA1::CreateContext();
+      for (size_t offset = 0; offset < size; offset += chunk_size)
+        context->Update(data.data() + offset, std::min(chunk_size, size - offset));
+
+      EXPECT_EQ(Common::SHA1::CalculateDigest(data.data(), size), context->Finish())
+          << "chunk size " << chunk_size << ", size " << size;
+    }
+  }
+}
@@ -0,0 +1,68 @@
+// Copyright 2021 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "Common/FileUtil.h"
+#include "Common/Tracing.h"
+
+namespace
+{
+std::string WriteTrace()
+{
+  const std::string directory = File::CreateTempDir();
+  const std::string path = directory + "/trace.json";
+  std::string json;
+  EXPECT_TRUE(Common::Tracing::WriteChromeTrace(path));
+  EXPECT_TRUE(File::ReadFileToString(path, json));
+  File::DeleteDirRecursively(directory);
+  return json;
+}
+}  // namespace
+
+TEST(Tracing, RecordsScopesWhileEnabled)
+{
+  Common::Tracing::Start();
+  Common::Tracing::SetCurrentThreadName("Test \"Thread\"");
+  {
+    TRACE_SCOPE("test", "Outer");
+    TRACE_SCOPE("test", "Inner");
+  }
+  Common::Tracing::Stop();
+
+  const std::string json = WriteTrace();
+  EXPECT_NE(std::string::npos, json.find(R"("name":"Outer","cat":"test","ph":"X")"));
+  EXPECT_NE(std::string::npos, json.find(R"("name":"Inner","cat":"test","ph":"X")"));
+  EXPECT_NE(std::string::npos, json.find(R"("args":{"name":"Test \"Thread\""})"));
+}
+
+TEST(Tracing, IgnoresScopesWhileDisabled)
+{
+  Common::Tracing::Start();
+  Common::Tracing::Stop();
+  {
+    TRACE_SCOPE("test", "Disabled");
+  }
+
+  EXPECT_FALSE(Common::Tracing::IsEnabled());
+  EXPECT_EQ(std::string::npos, WriteTrace().find("Disabled"));
+}
+
+TEST(Tracing, StartDiscardsPreviousEvents)
+{
+  Common::Tracing::Start();
+  {
+    TRACE_SCOPE("test", "Old");
+  }
+  Common::Tracing::Start();
+  {
+    TRACE_SCOPE("test", "New");
+  }
+  Common::Tracing::Stop();
+
+  const std::string json = WriteTrace();
+  EXPECT_EQ(std::string::npos, json.find("\"Old\""));
+  EXPECT_NE(std::string::npos, json.find("\"New\""));
+}
@@ -6,9 +6,12 @@
 #include <array>
 #include <bitset>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include "Common/Config/Config.h"
 #include "Common/FileUtil.h"
+#include "Common/Random.h"
 #include "Core/ConfigManager.h"
 #include "Core/Core.h"
 #include "Core/CoreTiming.h"
@@ -361,3 +364,97 @@ TEST(CoreTiming, Overclocking)
   SConfig::GetInstance().m_OCFactor = 1.0;
   AdvanceAndCheck(4, MAX_SLICE_LENGTH);
 }
+
+namespace ManyEventsTest
+{
+static u64 s_events_ran = 0;
+static s64 s_last_time = 0;
+
+static void CountCallback(u64 userdata, s64 lateness)
+{
+  // Events must run in the order of their scheduled time, which is passed as userdata
+  EXPECT_LE(s_last_time, static_cast<s64>(userdata));
+  s_last_time = static_cast<s64>(userdata);
+  ++s_events_ran;
+}
+
+static void UnexpectedCallback(u64 userdata, s64 lateness)
+{
+  ADD_FAILURE() << "Removed event ran";
+}
+
+static void RunUntil(u64 event_count)
+{
+  for (int i = 0; i < 1000000 && s_events_ran < event_count; ++i)
+  {
+    PowerPC::ppcState.downcount = 0;
+    CoreTiming::Advance();
+  }
+}
+}  // namespace ManyEventsTest
+
+TEST(CoreTiming, RemoveEventAmongManyEvents)
+{
+  using namespace ManyEventsTest;
+
+  ScopeInit guard;
+  ASSERT_TRUE(guard.UserDirectoryExists());
+
+  CoreTiming::EventType* cb_a = CoreTiming::RegisterEvent("callbackA", CountCallback);
+  CoreTiming::EventType* cb_b = CoreTiming::RegisterEvent("callbackB", UnexpectedCallback);
+  CoreTiming::EventType* cb_c = CoreTiming::RegisterEvent("callbackC", CountCallback);
+
+  // Enter slice 0
+  CoreTiming::Advance();
+
+  s_events_ran = 0;
+  s_last_time = 0;
+  Common::Random::PRNG rng{0};
+  for (int i = 0; i < 1000; ++i)
+  {
+    for (CoreTiming::EventType* type : {cb_a, cb_b, cb_c})
+    {
+      const s64 cycles = rng.GenerateValue<u32>() % 100000;
+      CoreTiming::ScheduleEvent(cycles, type, CoreTiming::GetTicks() + cycles);
+    }
+  }
+
+  CoreTiming::RemoveEvent(cb_b);
+  RunUntil(2000);
+  EXPECT_EQ(2000u, s_events_ran);
+}
+
+TEST(CoreTiming, ScheduleFromOtherThreads)
+{
+  using namespace ManyEventsTest;
+
+  constexpr int THREAD_COUNT = 4;
+  constexpr int EVENTS_PER_THREAD = 1000;
+
+  ScopeInit guard;
+  ASSERT_TRUE(guard.UserDirectoryExists());
+
+  CoreTiming::EventType* cb_a = CoreTiming::RegisterEvent("callbackA", CountCallback);
+
+  // Enter slice 0
+  CoreTiming::Advance();
+
+  s_events_ran = 0;
+  s_last_time = 0;
+  std::vector<std::thread> threads;
+  for (int i = 0; i < THREAD_COUNT; ++i)
+  {
+    threads.emplace_back([cb_a] {
+      for (int j = 0; j < EVENTS_PER_THREAD; ++j)
+      {
+        // All events use the same time, so that the order in which they are moved doesn't matter
+        CoreTiming::ScheduleEvent(1000, cb_a, 1000, CoreTiming::FromThread::NON_CPU);
+      }
+    });
+  }
+  for (std::thread& thread : threads)
+    thread.join();
+
+  RunUntil(THREAD_COUNT * EVENTS_PER_THREAD);
+  EXPECT_EQ(static_cast<u64>(THREAD_COUNT * EVENTS_PER_THREAD), s_events_ran);
+}
@@ -0,0 +1,193 @@
+// Copyright 2021 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <map>
+#include <set>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Core/PowerPC/JitCommon/JitBase.h"
+#include "Core/PowerPC/JitCommon/JitCache.h"
+#include "Core/PowerPC/JitInterface.h"
+#include "Core/PowerPC/PowerPC.h"
+
+#include <gtest/gtest.h>
+
+namespace
+{
+class TestBlockCache final : public JitBaseBlockCache
+{
+public:
+  explicit TestBlockCache(JitBase& jit) : JitBaseBlockCache(jit) {}
+
+  // Maps exit pointers to the block they are currently linked to
+  std::map<u8*, const JitBlock*> links;
+
+private:
+  void WriteLinkBlock(const JitBlock::LinkData& source, const JitBlock* dest) override
+  {
+    if (dest)
+      links[source.exitPtrs] = dest;
+    else
+      links.erase(source.exitPtrs);
+  }
+};
+
+class TestJit final : public JitBase
+{
+public:
+  TestJit() : blocks(*this) { blocks.Init(); }
+  ~TestJit() override { blocks.Shutdown(); }
+
+  void Init() override {}
+  void Shutdown() override {}
+  void ClearCache() override { blocks.Clear(); }
+  void Run() override {}
+  void SingleStep() override {}
+  const char* GetName() const override { return "TestJit"; }
+
+  TestBlockCache* GetBlockCache() override { return &blocks; }
+  void Jit(u32 em_address) override {}
+  const CommonAsmRoutinesBase* GetAsmRoutines() override { return nullptr; }
+  bool HandleFault(uintptr_t access_address, SContext* ctx) override { return false; }
+
+  TestBlockCache blocks;
+};
+
+// Adds a block covering instruction_count instructions starting at address,
+// with one exit to each of the given addresses.
+JitBlock* AddBlock(TestBlockCache& cache, u32 address, u32 instruction_count,
+                   const std::vector<u32>& exits = {})
+{
+  JitBlock* block = cache.AllocateBlock(address);
+  block->checkedEntry = nullptr;
+  block->normalEntry = nullptr;
+  block->codeSize = 0;
+  block->originalSize = instruction_count;
+
+  for (u32 exit_address : exits)
+  {
+    JitBlock::LinkData link_data;
+    link_data.exitAddress = exit_address;
+    // Any unique pointer will do, since nothing is written to it
+    link_data.exitPtrs = reinterpret_cast<u8*>(block) + block->linkData.size();
+    link_data.linkStatus = false;
+    link_data.call = false;
+    block->linkData.push_back(link_data);
+  }
+
+  std::set<u32> physical_addresses;
+  for (u32 i = 0; i < instruction_count; ++i)
+    physical_addresses.insert(address + i * 4);
+
+  cache.FinalizeBlock(*block, true, physical_addresses);
+  return block;
+}
+
+size_t CountBlocks(TestBlockCache& cache)
+{
+  size_t count = 0;
+  cache.RunOnBlocks([&count](const JitBlock&) { ++count; });
+  return count;
+}
+}  // namespace
+
+TEST(JitCache, Lookup)
+{
+  TestJit jit;
+  TestBlockCache& cache = jit.blocks;
+
+  JitBlock* a = AddBlock(cache, 0x80001000, 8);
+  JitBlock* b = AddBlock(cache, 0x80001020, 8);
+
+  EXPECT_EQ(a, cache.GetBlockFromStartAddress(0x80001000, 0));
+  EXPECT_EQ(b, cache.GetBlockFromStartAddress(0x80001020, 0));
+  EXPECT_EQ(nullptr, cache.GetBlockFromStartAddress(0x80001004, 0));
+  EXPECT_EQ(nullptr,
+            cache.GetBlockFromStartAddress(0x80001000, JitBaseBlockCache::JIT_CACHE_MSR_MASK));
+  EXPECT_EQ(2u, CountBlocks(cache));
+}
+
+TEST(JitCache, EraseOnlyOverlappingBlocks)
+{
+  TestJit jit;
+  TestBlockCache& cache = jit.blocks;
+
+  AddBlock(cache, 0x80001000, 8);
+  // This block crosses into the next macro block
+  AddBlock(cache, 0x800010F0, 16);
+  AddBlock(cache, 0x80001200, 4);
+
+  cache.ErasePhysicalRange(0x80001100, 0x20);
+  EXPECT_NE(nullptr, cache.GetBlockFromStartAddress(0x80001000, 0));
+  EXPECT_EQ(nullptr, cache.GetBlockFromStartAddress(0x800010F0, 0));
+  EXPECT_NE(nullptr, cache.GetBlockFromStartAddress(0x80001200, 0));
+  EXPECT_EQ(2u, CountBlocks(cache));
+
+  cache.ErasePhysicalRange(0, 0xFFFFFFFF);
+  EXPECT_EQ(0u, CountBlocks(cache));
+}
+
+TEST(JitCache, Linking)
+{
+  TestJit jit;
+  TestBlockCache& cache = jit.blocks;
+
+  JitBlock* a = AddBlock(cache, 0x80001000, 4, {0x80002000, 0x80003000});
+  EXPECT_TRUE(cache.links.empty());
+
+  // Compiling the destination links the exits that jump to it
+  JitBlock* b = AddBlock(cache, 0x80002000, 4, {0x80001000});
+  ASSERT_EQ(2u, cache.links.size());
+  EXPECT_EQ(b, cache.links[a->linkData[0].exitPtrs]);
+  EXPECT_EQ(a, cache.links[b->linkData[0].exitPtrs]);
+  EXPECT_TRUE(a->linkData[0].linkStatus);
+  EXPECT_FALSE(a->linkData[1].linkStatus);
+
+  // Destroying a block unlinks everything that jumps to it
+  cache.ErasePhysicalRange(0x80002000, 4);
+  ASSERT_EQ(0u, cache.links.size());
+  EXPECT_FALSE(a->linkData[0].linkStatus);
+
+  // Recompiling it links the exit again
+  b = AddBlock(cache, 0x80002000, 4);
+  ASSERT_EQ(1u, cache.links.size());
+  EXPECT_EQ(b, cache.links[a->linkData[0].exitPtrs]);
+}
+
+TEST(JitCache, TierUp)
+{
+  TestJit jit;
+  TestBlockCache& cache = jit.blocks;
+  JitInterface::SetJit(&jit);
+
+  // Once a cold block has run often enough, it is destroyed so that it gets recompiled as hot
+  AddBlock(cache, 0x80001000, 8);
+  PC = 0x80001000;
+  JitInterface::CompileHotBlock();
+  EXPECT_EQ(1u, jit.js.hotBlockAddresses.count(0x80001000));
+  EXPECT_EQ(nullptr, cache.GetBlockFromStartAddress(0x80001000, 0));
+
+  // A block that is already hot isn't recompiled again
+  JitBlock* hot = AddBlock(cache, 0x80001000, 8);
+  JitInterface::CompileHotBlock();
+  EXPECT_EQ(hot, cache.GetBlockFromStartAddress(0x80001000, 0));
+
+  // Forced invalidations don't change the code, so the block stays hot
+  cache.InvalidateICache(0x80001000, 32, true);
+  EXPECT_EQ(1u, jit.js.hotBlockAddresses.count(0x80001000));
+
+  // Modified code starts out cold again
+  AddBlock(cache, 0x80001000, 8);
+  cache.InvalidateICache(0x80001000, 32, false);
+  EXPECT_EQ(0u, jit.js.hotBlockAddresses.count(0x80001000));
+
+  // And so does everything after the cache has been cleared
+  PC = 0x80002000;
+  JitInterface::CompileHotBlock();
+  EXPECT_EQ(1u, jit.js.hotBlockAddresses.count(0x80002000));
+  cache.Clear();
+  EXPECT_TRUE(jit.js.hotBlockAddresses.empty());
+
+  JitInterface::SetJit(nullptr);
+}
@@ -0,0 +1,110 @@
+// Copyright 2021 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "Common/CommonTypes.h"
+#include "Common/FileUtil.h"
+#include "Core/PowerPC/JitCommon/JitProfileCache.h"
+#include "Core/PowerPC/PPCAnalyst.h"
+
+namespace
+{
+JitProfileCache::BlockProfile MakeProfile(u32 address, u32 first_instruction)
+{
+  PPCAnalyst::CodeBuffer buffer(2);
+  buffer[0].address = address;
+  buffer[0].inst.hex = first_instruction;
+  buffer[1].address = address + 4;
+  buffer[1].inst.hex = 0x4E800020;  // blr
+
+  PPCAnalyst::CodeBlock block{};
+  block.m_address = address;
+  block.m_num_instructions = 2;
+  return JitProfileCache::CreateProfile(block, buffer, 4);
+}
+}  // namespace
+
+TEST(JitProfileCache, ProfilesDependOnCode)
+{
+  const auto a = MakeProfile(0x80003000, 0x38600000);  // li r3, 0
+  EXPECT_EQ(a, MakeProfile(0x80003000, 0x38600000));
+  EXPECT_NE(a, MakeProfile(0x80003000, 0x38600001));
+  EXPECT_NE(a, MakeProfile(0x80004000, 0x38600000));
+}
+
+TEST(JitProfileCache, StoredProfilesArePersistent)
+{
+  const std::string directory = File::CreateTempDir();
+  ASSERT_FALSE(directory.empty());
+  const std::string filename = directory + "/GALE01.jitprofile";
+
+  const auto first = MakeProfile(0x80003000, 0x38600000);
+  const auto updated = MakeProfile(0x80003000, 0x38600001);
+  const auto other = MakeProfile(0x80004000, 0x38600000);
+
+  {
+    JitProfileCache cache;
+    cache.Open(filename);
+    EXPECT_EQ(0u, cache.GetProfileCount());
+    cache.Store(0x80003000, 0, first);
+    cache.Store(0x80004000, 0x30, other);
+    cache.Store(0x80003000, 0, updated);
+  }
+
+  JitProfileCache cache;
+  cache.Open(filename);
+  EXPECT_EQ(2u, cache.GetProfileCount());
+  ASSERT_NE(nullptr, cache.Find(0x80003000, 0));
+  EXPECT_EQ(updated, *cache.Find(0x80003000, 0));
+  ASSERT_NE(nullptr, cache.Find(0x80004000, 0x30));
+  EXPECT_EQ(other, *cache.Find(0x80004000, 0x30));
+  EXPECT_EQ(nullptr, cache.Find(0x80004000, 0));
+  cache.Close();
+
+  File::DeleteDirRecursively(directory);
+}
+
+TEST(JitProfileCache, RemovedProfilesStayRemoved)
+{
+  const std::string directory = File::CreateTempDir();
+  ASSERT_FALSE(directory.empty());
+  const std::string filename = directory + "/GALE01.jitprofile";
+
+  const auto stale = MakeProfile(0x80003000, 0x38600000);
+  const auto kept = MakeProfile(0x80004000, 0x38600000);
+  const auto recompiled = MakeProfile(0x80005000, 0x38600000);
+
+  {
+    JitProfileCache cache;
+    cache.Open(filename);
+    cache.Store(0x80003000, 0, stale);
+    cache.Store(0x80004000, 0, kept);
+    cache.Store(0x80005000, 0, recompiled);
+
+    cache.Remove(0x80003000, 0);
+    EXPECT_EQ(nullptr, cache.Find(0x80003000, 0));
+    EXPECT_EQ(2u, cache.GetProfileCount());
+
+    // A block which gets hot again after its profile was removed is stored again
+    cache.Remove(0x80005000, 0);
+    cache.Store(0x80005000, 0, recompiled);
+
+    // Removing something which isn't there does nothing
+    cache.Remove(0x80006000, 0);
+  }
+
+  JitProfileCache cache;
+  cache.Open(filename);
+  EXPECT_EQ(2u, cache.GetProfileCount());
+  EXPECT_EQ(nullptr, cache.Find(0x80003000, 0));
+  ASSERT_NE(nullptr, cache.Find(0x80004000, 0));
+  EXPECT_EQ(kept, *cache.Find(0x80004000, 0));
+  ASSERT_NE(nullptr, cache.Find(0x80005000, 0));
+  EXPECT_EQ(recompiled, *cache.Find(0x80005000, 0));
+  cache.Close();
+
+  File::DeleteDirRecursively(directory);
+}
@@ -0,0 +1,106 @@
+// Copyright 2021 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/Random.h"
+#include "Core/Rewind.h"
+#include "Core/State.h"
+
+// The generated states consist of a single section
+static const State::StateSections WHOLE_STATE{0};
+
+// Generates a sequence of states in which a few pages change between consecutive states,
+// which is roughly what happens to emulated memory between two frames.
+class StateGenerator
+{
+public:
+  explicit StateGenerator(size_t size) : m_state(size)
+  {
+    m_rng.Generate(m_state.data(), m_state.size() / 4);
+  }
+
+  const std::vector<u8>& Next()
+  {
+    for (int i = 0; i < 16; ++i)
+      m_state[m_rng.GenerateValue<u32>() % m_state.size()] = m_rng.GenerateValue<u8>();
+    return m_state;
+  }
+
+private:
+  Common::Random::PRNG m_rng{0};
+  std::vector<u8> m_state;
+};
+
+TEST(Rewind, PopReturnsSnapshotsInReverseOrder)
+{
+  constexpr size_t SNAPSHOT_COUNT = Rewind::SnapshotRing::KEYFRAME_INTERVAL * 2 + 5;
+
+  Rewind::SnapshotRing ring(256 << 20);
+  StateGenerator generator(0x40000);
+
+  std::vector<std::vector<u8>> states;
+  for (size_t i = 0; i < SNAPSHOT_COUNT; ++i)
+  {
+    states.push_back(generator.Next());
+    ring.Push(states.back(), WHOLE_STATE);
+  }
+  EXPECT_EQ(SNAPSHOT_COUNT, ring.GetSnapshotCount());
+
+  for (size_t i = SNAPSHOT_COUNT; i-- > 0;)
+  {
+    std::vector<u8> state;
+    ASSERT_TRUE(ring.Pop(&state));
+    EXPECT_EQ(states[i], state) << "snapshot " << i;
+  }
+
+  std::vector<u8> state;
+  EXPECT_FALSE(ring.Pop(&state));
+  EXPECT_EQ(0u, ring.GetMemoryUsage());
+}
+
+TEST(Rewind, PushAfterPop)
+{
+  Rewind::SnapshotRing ring(256 << 20);
+  StateGenerator generator(0x10000);
+
+  std::vector<u8> state;
+  for (size_t i = 0; i < Rewind::SnapshotRing::KEYFRAME_INTERVAL + 3; ++i)
+    ring.Push(generator.Next(), WHOLE_STATE);
+  for (int i = 0; i < 5; ++i)
+    ASSERT_TRUE(ring.Pop(&state));
+
+  const std::vector<u8> expected = generator.Next();
+  ring.Push(expected, WHOLE_STATE);
+  ring.Push(generator.Next(), WHOLE_STATE);
+
+  ASSERT_TRUE(ring.Pop(&state));
+  ASSERT_TRUE(ring.Pop(&state));
+  EXPECT_EQ(expected, state);
+}
+
+TEST(Rewind, MemoryBudget)
+{
+  constexpr size_t BUDGET = 0x400000;
+
+  Rewind::SnapshotRing ring(BUDGET);
+  StateGenerator generator(0x40000);
+
+  std::vector<u8> newest;
+  for (size_t i = 0; i < Rewind::SnapshotRing::KEYFRAME_INTERVAL * 20; ++i)
+  {
+    newest = generator.Next();
+    ring.Push(newest, WHOLE_STATE);
+  }
+
+  EXPECT_LE(ring.GetMemoryUsage(), BUDGET);
+  EXPECT_LT(ring.GetSnapshotCount(), Rewind::SnapshotRing::KEYFRAME_INTERVAL * 20);
+  EXPECT_GE(ring.GetSnapshotCount(), Rewind::SnapshotRing::KEYFRAME_INTERVAL);
+
+  std::vector<u8> state;
+  ASSERT_TRUE(ring.Pop(&state));
+  EXPECT_EQ(newest, state);
+}
@@ -0,0 +1,143 @@
+// Copyright 2021 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <cstring>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/FileUtil.h"
+#include "Common/IOFile.h"
+#include "Common/Random.h"
+#include "Core/State.h"
+
+namespace
+{
+// Offsets of fields in the extended header
+constexpr size_t BLOCK_SIZE_OFFSET = 12;
+constexpr size_t UNCOMPRESSED_SIZE_OFFSET = 16;
+
+// Something that isn't part of the compressed data in front of it, like the StateHeader
+constexpr u32 PREFIX = 0x12345678;
+
+class StateCompressionTest : public testing::Test
+{
+protected:
+  StateCompressionTest() : m_directory(File::CreateTempDir()), m_path(m_directory + "/test.sav")
+  {
+  }
+
+  ~StateCompressionTest() override { File::DeleteDirRecursively(m_directory); }
+
+  void Write(const std::vector<u8>& state)
+  {
+    File::IOFile f(m_path, "wb");
+    ASSERT_TRUE(f.WriteArray(&PREFIX, 1));
+    ASSERT_TRUE(State::WriteCompressedState(f, state.data(), state.size()));
+  }
+
+  bool Read(std::vector<u8>* state)
+  {
+    File::IOFile f(m_path, "rb");
+    u32 prefix;
+    if (!f.ReadArray(&prefix, 1) || prefix != PREFIX || !State::IsCompressedState(f))
+      return false;
+    return State::ReadCompressedState(f, state);
+  }
+
+  template <typename T>
+  void Patch(size_t offset, T value)
+  {
+    File::IOFile f(m_path, "r+b");
+    ASSERT_TRUE(f.Seek(sizeof(PREFIX) + offset, SEEK_SET));
+    ASSERT_TRUE(f.WriteArray(&value, 1));
+  }
+
+  std::string m_directory;
+  std::string m_path;
+};
+}  // namespace
+
+TEST_F(StateCompressionTest, RoundTrip)
+{
+  Common::Random::PRNG rng{0};
+
+  // Empty, smaller than a block, exactly one block, and several blocks with a partial last one
+  for (const size_t size : {size_t(0), size_t(1), size_t(0x100000), size_t(0x280123)})
+  {
+    std::vector<u8> state(size);
+    rng.Generate(state.data(), state.size() / 2);  // The rest compresses well
+
+    Write(state);
+    std::vector<u8> result;
+    ASSERT_TRUE(Read(&result)) << size;
+    EXPECT_EQ(state, result) << size;
+  }
+}
+
+TEST_F(StateCompressionTest, CompressesRedundantData)
+{
+  const std::vector<u8> state(0x300000, 0xAB);
+  Write(state);
+  EXPECT_LT(File::GetSize(m_path), state.size() / 100);
+}
+
+TEST_F(StateCompressionTest, UncompressedStateIsNotDetected)
+{
+  // An uncompressed state continues with the version cookie instead of the extended header
+  File::IOFile f(m_path, "wb");
+  const u32 data[] = {PREFIX, 0xBAADBABE + 150, 0, 0, 0, 0};
+  ASSERT_TRUE(f.WriteArray(data, std::size(data)));
+  f.Close();
+
+  std::vector<u8> result;
+  EXPECT_FALSE(Read(&result));
+}
+
+TEST_F(StateCompressionTest, RejectsCorruptHeaders)
+{
+  std::vector<u8> state(0x180000);
+  for (size_t i = 0; i < state.size(); ++i)
+    state[i] = static_cast<u8>(i * 7);
+
+  std::vector<u8> result;
+
+  // A huge size must be rejected before anything of that size is allocated
+  Write(state);
+  Patch<u64>(UNCOMPRESSED_SIZE_OFFSET, 0xFFFFFFFFFFFF0000);
+  EXPECT_FALSE(Read(&result));
+
+  // Claiming more blocks than the file can contain
+  Write(state);
+  Patch<u32>(BLOCK_SIZE_OFFSET, 1);
+  EXPECT_FALSE(Read(&result));
+
+  // A size that doesn't match the compressed blocks
+  Write(state);
+  Patch<u64>(UNCOMPRESSED_SIZE_OFFSET, state.size() - 1);
+  EXPECT_FALSE(Read(&result));
+
+  Write(state);
+  Patch<u32>(BLOCK_SIZE_OFFSET, 0);
+  EXPECT_FALSE(Read(&result));
+}
+
+TEST_F(StateCompressionTest, RejectsTruncatedFile)
+{
+  std::vector<u8> state(0x180000);
+  for (size_t i = 0; i < state.size(); ++i)
+    state[i] = static_cast<u8>(i * 7);
+  Write(state);
+
+  {
+    File::IOFile f(m_path, "r+b");
+    ASSERT_TRUE(f.Resize(f.GetSize() - 10));
+  }
+
+  std::vector<u8> result;
+  EXPECT_FALSE(Read(&result));
+}
@@ -0,0 +1,157 @@
+// Copyright 2021 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/Random.h"
+#include "Core/State.h"
+
+static const State::StateSections WHOLE{0};
+
+static std::vector<u8> RandomBuffer(Common::Random::PRNG& rng, size_t size)
+{
+  std::vector<u8> buffer(size);
+  rng.Generate(buffer.data(), buffer.size());
+  return buffer;
+}
+
+TEST(StateDelta, UnchangedStateOnlyStoresHeader)
+{
+  Common::Random::PRNG rng{0};
+  const std::vector<u8> keyframe = RandomBuffer(rng, 0x10000);
+
+  const std::vector<u8> delta = State::CreateDelta(keyframe, WHOLE, keyframe, WHOLE);
+  EXPECT_LT(delta.size(), 0x100u);
+
+  std::vector<u8> state;
+  ASSERT_TRUE(State::ApplyDelta(keyframe, delta, &state));
+  EXPECT_EQ(keyframe, state);
+}
+
+TEST(StateDelta, RoundTrip)
+{
+  Common::Random::PRNG rng{0};
+  const std::vector<u8> keyframe = RandomBuffer(rng, 0x10123);
+
+  std::vector<u8> modified = keyframe;
+  modified[0] ^= 1;
+  modified[0x5555] ^= 1;
+  modified.back() ^= 1;
+
+  const std::vector<u8> delta = State::CreateDelta(keyframe, WHOLE, modified, WHOLE);
+  EXPECT_LT(delta.size(), keyframe.size() / 4);
+
+  std::vector<u8> state;
+  ASSERT_TRUE(State::ApplyDelta(keyframe, delta, &state));
+  EXPECT_EQ(modified, state);
+}
+
+TEST(StateDelta, SizeChange)
+{
+  Common::Random::PRNG rng{0};
+  const std::vector<u8> keyframe = RandomBuffer(rng, 0x8000);
+
+  for (const size_t size : {size_t(0x4000), size_t(0x8001), size_t(0xA345)})
+  {
+    std::vector<u8> modified = keyframe;
+    modified.resize(size);
+    for (size_t i = keyframe.size(); i < size; ++i)
+      modified[i] = static_cast<u8>(i);
+
+    std::vector<u8> state;
+    const std::vector<u8> delta = State::CreateDelta(keyframe, WHOLE, modified, WHOLE);
+    ASSERT_TRUE(State::ApplyDelta(keyframe, delta, &state));
+    EXPECT_EQ(modified, state);
+  }
+}
+
+TEST(StateDelta, RejectsWrongKeyframe)
+{
+  Common::Random::PRNG rng{0};
+  const std::vector<u8> keyframe = RandomBuffer(rng, 0x4000);
+  const std::vector<u8> other_keyframe = RandomBuffer(rng, 0x3000);
+
+  const std::vector<u8> delta = State::CreateDelta(keyframe, WHOLE, keyframe, WHOLE);
+
+  std::vector<u8> state;
+  EXPECT_FALSE(State::ApplyDelta(other_keyframe, delta, &state));
+
+  std::vector<u8> truncated = State::CreateDelta(keyframe, WHOLE, RandomBuffer(rng, 0x4000), WHOLE);
+  truncated.resize(truncated.size() - 1);
+  EXPECT_FALSE(State::ApplyDelta(keyframe, truncated, &state));
+}
+
+TEST(StateDelta, SectionChangesSize)
+{
+  Common::Random::PRNG rng{0};
+
+  // A small section followed by a large one, like the CoreTiming events followed by memory
+  std::vector<u8> keyframe = RandomBuffer(rng, 0x40100);
+  const State::StateSections keyframe_sections{0, 0x100};
+
+  // Growing the first section shifts the second one, which is otherwise unchanged
+  std::vector<u8> modified = keyframe;
+  modified.insert(modified.begin() + 0x100, 0x23, 0xAB);
+  modified[0x123 + 0x20000] ^= 1;
+  const State::StateSections sections{0, 0x123};
+
+  const std::vector<u8> delta = State::CreateDelta(keyframe, keyframe_sections, modified, sections);
+  EXPECT_LT(delta.size(), 0x3000u);
+
+  std::vector<u8> state;
+  ASSERT_TRUE(State::ApplyDelta(keyframe, delta, &state));
+  EXPECT_EQ(modified, state);
+
+  // Shrinking it works the same way
+  std::vector<u8> shrunk = modified;
+  shrunk.erase(shrunk.begin() + 0x10, shrunk.begin() + 0x50);
+  const State::StateSections shrunk_sections{0, 0xE3};
+
+  const std::vector<u8> shrunk_delta =
+      State::CreateDelta(modified, sections, shrunk, shrunk_sections);
+  EXPECT_LT(shrunk_delta.size(), 0x3000u);
+  ASSERT_TRUE(State::ApplyDelta(modified, shrunk_delta, &state));
+  EXPECT_EQ(shrunk, state);
+
+  // Mismatched sections fall back to comparing the whole buffers
+  ASSERT_TRUE(
+      State::ApplyDelta(keyframe, State::CreateDelta(keyframe, WHOLE, modified, sections), &state));
+  EXPECT_EQ(modified, state);
+}
+
+TEST(StateDelta, RejectsInvalidSections)
+{
+  Common::Random::PRNG rng{0};
+  const std::vector<u8> keyframe = RandomBuffer(rng, 0x4000);
+  std::vector<u8> delta =
+      State::CreateDelta(keyframe, {0, 0x1000}, RandomBuffer(rng, 0x4000), {0, 0x2000});
+
+  // The offset of the second section in the state, right after the header
+  constexpr size_t SECTION_OFFSET = 32 + 3 * sizeof(u64);
+  const u64 out_of_range = 0x5000;
+  std::memcpy(delta.data() + SECTION_OFFSET, &out_of_range, sizeof(u64));
+
+  std::vector<u8> state;
+  EXPECT_FALSE(State::ApplyDelta(keyframe, delta, &state));
+}
+
+TEST(StateDelta, RejectsHugeState)
+{
+  Common::Random::PRNG rng{0};
+  const std::vector<u8> keyframe = RandomBuffer(rng, 0x4000);
+  std::vector<u8> delta = State::CreateDelta(keyframe, WHOLE, keyframe, WHOLE);
+
+  // The state size in the header. The sections are still valid for it, so only the size cap stops
+  // the state from being allocated.
+  constexpr size_t STATE_SIZE_OFFSET = 16;
+  const u64 huge_size = u64(1) << 40;
+  std::memcpy(delta.data() + STATE_SIZE_OFFSET, &huge_size, sizeof(u64));
+
+  std::vector<u8> state;
+  EXPECT_FALSE(State::ApplyDelta(keyframe, delta, &state));
+  EXPECT_TRUE(state.empty());
+}
@@ -0,0 +1,77 @@
+// Copyright 2021 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <gtest/gtest.h>
+
+#include "Common/CommonTypes.h"
+#include "DiscIO/BlockCache.h"
+
+using DiscIO::BlockCache;
+
+TEST(BlockCache, FindReturnsInsertedEntries)
+{
+  BlockCache cache(16, 4);
+  EXPECT_EQ(nullptr, cache.Find(1));
+
+  BlockCache::Entry* entry = cache.Insert(1);
+  ASSERT_NE(nullptr, entry);
+  EXPECT_EQ(16u, entry->data.size());
+  entry->data[0] = 0xAB;
+  entry->valid_count = 3;
+
+  BlockCache::Entry* found = cache.Find(1);
+  ASSERT_NE(nullptr, found);
+  EXPECT_EQ(0xAB, found->data[0]);
+  EXPECT_EQ(3u, found->valid_count);
+
+  EXPECT_EQ(1u, cache.GetStats().hits);
+  EXPECT_EQ(1u, cache.GetStats().misses);
+}
+
+TEST(BlockCache, EvictsLeastRecentlyUsed)
+{
+  BlockCache cache(16, 3);
+  for (u64 i = 0; i < 3; ++i)
+    cache.Insert(i);
+
+  // Using 0 makes 1 the least recently used entry
+  EXPECT_NE(nullptr, cache.Find(0));
+  cache.Insert(3);
+
+  EXPECT_EQ(3u, cache.GetSize());
+  EXPECT_EQ(1u, cache.GetStats().evictions);
+  EXPECT_EQ(nullptr, cache.Find(1));
+  EXPECT_NE(nullptr, cache.Find(0));
+  EXPECT_NE(nullptr, cache.Find(2));
+  EXPECT_NE(nullptr, cache.Find(3));
+}
+
+TEST(BlockCache, InsertingCachedIndexKeepsEntry)
+{
+  BlockCache cache(16, 2);
+  cache.Insert(5)->valid_count = 7;
+  cache.Insert(5);
+
+  EXPECT_EQ(1u, cache.GetSize());
+  EXPECT_EQ(7u, cache.Find(5)->valid_count);
+}
+
+TEST(BlockCache, CapacityAndEntrySizeChanges)
+{
+  BlockCache cache(16, 8);
+  for (u64 i = 0; i < 8; ++i)
+    cache.Insert(i);
+
+  cache.SetCapacity(2);
+  EXPECT_EQ(2u, cache.GetSize());
+  EXPECT_NE(nullptr, cache.Find(7));
+  EXPECT_NE(nullptr, cache.Find(6));
+
+  cache.Erase(7);
+  EXPECT_EQ(nullptr, cache.Find(7));
+  EXPECT_EQ(16u, cache.Insert(7)->data.size());
+
+  cache.SetEntrySize(32);
+  EXPECT_EQ(0u, cache.GetSize());
+  EXPECT_EQ(32u, cache.Insert(0)->data.size());
+}
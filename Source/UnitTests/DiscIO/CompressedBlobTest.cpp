@@ -0,0 +1,122 @@
+// Copyright 2021 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/FileUtil.h"
+#include "Common/IOFile.h"
+#include "Common/Random.h"
+#include "DiscIO/Blob.h"
+#include "DiscIO/CompressedBlob.h"
+
+namespace
+{
+constexpr u32 BLOCK_SIZE = 0x4000;
+constexpr u64 NUM_BLOCKS = 37;
+
+class CompressedBlobTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    m_directory = File::CreateTempDir();
+    ASSERT_FALSE(m_directory.empty());
+
+    // Alternate between blocks that compress well and blocks that are stored as-is
+    Common::Random::PRNG rng{0};
+    m_data.resize(NUM_BLOCKS * BLOCK_SIZE);
+    for (u64 block = 0; block < NUM_BLOCKS; ++block)
+    {
+      u8* data = m_data.data() + block * BLOCK_SIZE;
+      if (block % 3 == 0)
+        rng.Generate(data, BLOCK_SIZE);
+      else
+        std::fill(data, data + BLOCK_SIZE, static_cast<u8>(block));
+    }
+
+    const std::string plain_path = m_directory + "/test.iso";
+    m_gcz_path = m_directory + "/test.gcz";
+    ASSERT_TRUE(File::IOFile(plain_path, "wb").WriteBytes(m_data.data(), m_data.size()));
+
+    std::unique_ptr<DiscIO::BlobReader> plain = DiscIO::CreateBlobReader(plain_path);
+    ASSERT_NE(nullptr, plain);
+    ASSERT_TRUE(DiscIO::ConvertToGCZ(plain.get(), plain_path, m_gcz_path, 0, BLOCK_SIZE,
+                                     [](const std::string&, float) { return true; }));
+  }
+
+  void TearDown() override { File::DeleteDirRecursively(m_directory); }
+
+  std::unique_ptr<DiscIO::CompressedBlobReader> Open() const
+  {
+    return DiscIO::CompressedBlobReader::Create(File::IOFile(m_gcz_path, "rb"), m_gcz_path);
+  }
+
+  std::string m_directory;
+  std::string m_gcz_path;
+  std::vector<u8> m_data;
+};
+}  // namespace
+
+TEST_F(CompressedBlobTest, SingleBlocks)
+{
+  std::unique_ptr<DiscIO::CompressedBlobReader> reader = Open();
+  ASSERT_NE(nullptr, reader);
+  EXPECT_EQ(m_data.size(), reader->GetDataSize());
+
+  // Backwards, so that nothing is read ahead
+  std::vector<u8> block(BLOCK_SIZE);
+  for (u64 i = NUM_BLOCKS; i-- > 0;)
+  {
+    ASSERT_TRUE(reader->GetBlock(i, block.data())) << i;
+    EXPECT_TRUE(std::equal(block.begin(), block.end(), m_data.begin() + i * BLOCK_SIZE)) << i;
+  }
+}
+
+TEST_F(CompressedBlobTest, MultipleBlocks)
+{
+  std::unique_ptr<DiscIO::CompressedBlobReader> reader = Open();
+  ASSERT_NE(nullptr, reader);
+
+  std::vector<u8> data(m_data.size());
+  ASSERT_TRUE(reader->ReadMultipleAlignedBlocks(0, NUM_BLOCKS, data.data()));
+  EXPECT_EQ(m_data, data);
+
+  // Neither starting nor ending at the start or end of the file
+  data.assign(7 * BLOCK_SIZE, 0);
+  ASSERT_TRUE(reader->ReadMultipleAlignedBlocks(5, 7, data.data()));
+  EXPECT_TRUE(std::equal(data.begin(), data.end(), m_data.begin() + 5 * BLOCK_SIZE));
+}
+
+TEST_F(CompressedBlobTest, SequentialAndRandomReads)
+{
+  for (const u32 read_ahead_blocks : {0u, 4u})
+  {
+    std::unique_ptr<DiscIO::CompressedBlobReader> reader = Open();
+    ASSERT_NE(nullptr, reader);
+    reader->SetReadAheadBlocks(read_ahead_blocks);
+
+    // Reads that don't line up with the blocks, which read ahead if there are worker threads
+    std::vector<u8> data(m_data.size());
+    for (u64 offset = 0; offset < data.size(); offset += 0x1234)
+    {
+      const u64 size = std::min<u64>(0x1234, data.size() - offset);
+      ASSERT_TRUE(reader->Read(offset, size, data.data() + offset)) << offset;
+    }
+    EXPECT_EQ(m_data, data) << read_ahead_blocks;
+
+    Common::Random::PRNG rng{read_ahead_blocks};
+    for (int i = 0; i < 100; ++i)
+    {
+      const u64 offset = rng.GenerateValue<u32>() % (m_data.size() - 0x3000);
+      std::vector<u8> buffer(0x3000);
+      ASSERT_TRUE(reader->Read(offset, buffer.size(), buffer.data())) << offset;
+      EXPECT_TRUE(std::equal(buffer.begin(), buffer.end(), m_data.begin() + offset)) << offset;
+    }
+  }
+}
@@ -0,0 +1,139 @@
+// Copyright 2021 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/FileUtil.h"
+#include "Common/IOFile.h"
+#include "Common/Random.h"
+#include "DiscIO/Blob.h"
+#include "DiscIO/WIABlob.h"
+
+namespace
+{
+constexpr int CHUNK_SIZE = 0x8000;
+constexpr u64 NUM_CHUNKS = 40;
+// The last chunk is only partially filled
+constexpr u64 DATA_SIZE = (NUM_CHUNKS - 1) * CHUNK_SIZE + 0x1234;
+
+class WIABlobTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    m_directory = File::CreateTempDir();
+    ASSERT_FALSE(m_directory.empty());
+
+    // The data isn't a disc, so all of it is stored as raw data. The start is left empty so that it
+    // can't be mistaken for a disc header.
+    Common::Random::PRNG rng{0};
+    m_data.resize(DATA_SIZE);
+    for (u64 chunk = 1; chunk < NUM_CHUNKS; ++chunk)
+    {
+      u8* data = m_data.data() + chunk * CHUNK_SIZE;
+      const size_t size = std::min<u64>(CHUNK_SIZE, DATA_SIZE - chunk * CHUNK_SIZE);
+      if (chunk % 3 == 0)
+        rng.Generate(data, size);
+      else
+        std::fill(data, data + size, static_cast<u8>(chunk));
+    }
+
+    const std::string plain_path = m_directory + "/test.iso";
+    m_rvz_path = m_directory + "/test.rvz";
+    ASSERT_TRUE(File::IOFile(plain_path, "wb").WriteBytes(m_data.data(), m_data.size()));
+
+    std::unique_ptr<DiscIO::BlobReader> plain = DiscIO::CreateBlobReader(plain_path);
+    ASSERT_NE(nullptr, plain);
+    ASSERT_TRUE(DiscIO::ConvertToWIAOrRVZ(plain.get(), plain_path, m_rvz_path, true,
+                                          DiscIO::WIARVZCompressionType::Zstd, 5, CHUNK_SIZE,
+                                          [](const std::string&, float) { return true; }));
+  }
+
+  void TearDown() override { File::DeleteDirRecursively(m_directory); }
+
+  std::unique_ptr<DiscIO::RVZFileReader> Open(u64 cache_size, u32 read_ahead_blocks) const
+  {
+    std::unique_ptr<DiscIO::RVZFileReader> reader =
+        DiscIO::RVZFileReader::Create(File::IOFile(m_rvz_path, "rb"), m_rvz_path);
+    if (reader)
+    {
+      reader->SetDecompressedCacheSize(cache_size);
+      reader->SetReadAheadBlocks(read_ahead_blocks);
+    }
+    return reader;
+  }
+
+  // Reads the whole image front to back in pieces which don't line up with the chunks
+  void ReadSequentially(DiscIO::BlobReader* reader)
+  {
+    std::vector<u8> data(m_data.size());
+    for (u64 offset = 0; offset < data.size(); offset += 0x1234)
+    {
+      const u64 size = std::min<u64>(0x1234, data.size() - offset);
+      ASSERT_TRUE(reader->Read(offset, size, data.data() + offset)) << offset;
+    }
+    EXPECT_EQ(m_data, data);
+  }
+
+  void ReadRandomly(DiscIO::BlobReader* reader, u64 seed)
+  {
+    Common::Random::PRNG rng{seed};
+    std::vector<u8> buffer(0x3000);
+    for (int i = 0; i < 100; ++i)
+    {
+      const u64 offset = rng.GenerateValue<u32>() % (m_data.size() - buffer.size());
+      ASSERT_TRUE(reader->Read(offset, buffer.size(), buffer.data())) << offset;
+      EXPECT_TRUE(std::equal(buffer.begin(), buffer.end(), m_data.begin() + offset)) << offset;
+    }
+  }
+
+  std::string m_directory;
+  std::string m_rvz_path;
+  std::vector<u8> m_data;
+};
+}  // namespace
+
+TEST_F(WIABlobTest, CachedChunks)
+{
+  // Every chunk fits, so reading everything again only hits the cache
+  std::unique_ptr<DiscIO::RVZFileReader> reader = Open(NUM_CHUNKS * CHUNK_SIZE * 2, 0);
+  ASSERT_NE(nullptr, reader);
+  EXPECT_EQ(m_data.size(), reader->GetDataSize());
+  ReadSequentially(reader.get());
+  ReadSequentially(reader.get());
+  ReadRandomly(reader.get(), 0);
+
+  // Only a single chunk fits, so every other chunk that is read evicts the one before it. This
+  // includes reads which span two chunks.
+  reader->SetDecompressedCacheSize(0);
+  ReadRandomly(reader.get(), 1);
+  ReadSequentially(reader.get());
+}
+
+TEST_F(WIABlobTest, ReadAhead)
+{
+  // Sequential reads take over the chunks that the workers have decompressed or are still working
+  // on, and decompress the ones that no worker has started on yet themselves
+  for (const u64 cache_size : {u64(NUM_CHUNKS * CHUNK_SIZE * 2), u64(0)})
+  {
+    std::unique_ptr<DiscIO::RVZFileReader> reader = Open(cache_size, 4);
+    ASSERT_NE(nullptr, reader);
+    ReadSequentially(reader.get());
+    ReadRandomly(reader.get(), cache_size);
+    ReadSequentially(reader.get());
+  }
+
+  // Destroying the reader has to wait for the chunks that are still being read ahead
+  std::unique_ptr<DiscIO::RVZFileReader> reader = Open(0, 4);
+  ASSERT_NE(nullptr, reader);
+  std::vector<u8> data(CHUNK_SIZE * 2);
+  ASSERT_TRUE(reader->Read(0, data.size(), data.data()));
+  EXPECT_TRUE(std::equal(data.begin(), data.end(), m_data.begin()));
+  reader.reset();
+}
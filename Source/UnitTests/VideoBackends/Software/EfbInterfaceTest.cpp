@@ -0,0 +1,85 @@
+// Copyright 2021 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <cstring>
+#include <vector>
+
+#include "Common/CPUDetect.h"
+#include "Common/CommonTypes.h"
+#include "Common/Random.h"
+#include "VideoBackends/Software/EfbInterface.h"
+#include "VideoCommon/BPMemory.h"
+#include "VideoCommon/VideoCommon.h"
+
+#include <fmt/format.h>
+#include <gtest/gtest.h>
+
+#ifdef _M_X86
+namespace
+{
+struct BlendInput
+{
+  u8 src[4];
+  u8 dst[4];
+};
+
+// Blends every input over the EFB with every combination of blend factors and returns the
+// resulting EFB colors.
+std::vector<u32> BlendAll(const std::vector<BlendInput>& inputs)
+{
+  std::vector<u32> results;
+  for (u32 src_factor = 0; src_factor < 8; src_factor++)
+  {
+    for (u32 dst_factor = 0; dst_factor < 8; dst_factor++)
+    {
+      bpmem.blendmode.srcfactor = static_cast<SrcBlendFactor>(src_factor);
+      bpmem.blendmode.dstfactor = static_cast<DstBlendFactor>(dst_factor);
+
+      for (size_t i = 0; i < inputs.size(); i++)
+      {
+        const u16 x = static_cast<u16>(i % EFB_WIDTH);
+        const u16 y = static_cast<u16>(i / EFB_WIDTH % EFB_HEIGHT);
+        BlendInput input = inputs[i];
+        EfbInterface::SetColor(x, y, input.dst);
+        EfbInterface::BlendTev(x, y, input.src);
+        results.push_back(EfbInterface::GetColor(x, y));
+      }
+    }
+  }
+  return results;
+}
+}  // namespace
+
+// The SSE4.1 blender must give the same results as the scalar loop it replaces
+TEST(EfbInterface, SSE41BlendMatchesScalar)
+{
+  if (!cpu_info.bSSE4_1)
+    return;
+
+  Common::Random::PRNG rng{0};
+  std::vector<BlendInput> inputs(0x1000);
+  rng.Generate(inputs.data(), inputs.size() * sizeof(BlendInput));
+
+  // RGB8 keeps all bits of the blended color, RGBA6 stores a destination alpha
+  for (PixelFormat format : {PixelFormat::RGB8_Z24, PixelFormat::RGBA6_Z24})
+  {
+    std::memset(&bpmem, 0, sizeof(bpmem));
+    bpmem.zcontrol.pixel_format = format;
+    bpmem.blendmode.blendenable = true;
+    bpmem.blendmode.colorupdate = true;
+    bpmem.blendmode.alphaupdate = true;
+
+    cpu_info.bSSE4_1 = false;
+    const std::vector<u32> expected = BlendAll(inputs);
+    cpu_info.bSSE4_1 = true;
+    const std::vector<u32> actual = BlendAll(inputs);
+
+    for (size_t i = 0; i < expected.size(); i++)
+    {
+      ASSERT_EQ(expected[i], actual[i])
+          << fmt::format("format {} src factor {} dst factor {} input {}", format,
+                         i / inputs.size() / 8, i / inputs.size() % 8, i % inputs.size());
+    }
+  }
+}
+#endif
@@ -0,0 +1,141 @@
+// Copyright 2021 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <cstring>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/Random.h"
+#include "VideoBackends/Software/EfbInterface.h"
+#include "VideoBackends/Software/NativeVertexFormat.h"
+#include "VideoBackends/Software/Rasterizer.h"
+#include "VideoCommon/BPMemory.h"
+#include "VideoCommon/VideoCommon.h"
+#include "VideoCommon/VideoConfig.h"
+
+#include <gtest/gtest.h>
+
+namespace
+{
+// Passes the rasterized vertex color through a single TEV stage and alpha blends it over the EFB,
+// with a depth test, so that the result depends on the order in which triangles are drawn.
+void SetUpPipeline()
+{
+  std::memset(&bpmem, 0, sizeof(bpmem));
+  bpmem.genMode.numcolchans = 1;
+  bpmem.scissorBR.x = EFB_WIDTH - 1;
+  bpmem.scissorBR.y = EFB_HEIGHT - 1;
+
+  bpmem.combiners[0].colorC.a = TevColorArg::Zero;
+  bpmem.combiners[0].colorC.b = TevColorArg::Zero;
+  bpmem.combiners[0].colorC.c = TevColorArg::Zero;
+  bpmem.combiners[0].colorC.d = TevColorArg::RasColor;
+  bpmem.combiners[0].colorC.clamp = true;
+  bpmem.combiners[0].alphaC.a = TevAlphaArg::Zero;
+  bpmem.combiners[0].alphaC.b = TevAlphaArg::Zero;
+  bpmem.combiners[0].alphaC.c = TevAlphaArg::Zero;
+  bpmem.combiners[0].alphaC.d = TevAlphaArg::RasAlpha;
+  bpmem.combiners[0].alphaC.clamp = true;
+
+  // Swap table 0 is the identity
+  bpmem.tevksel[0].swap1 = 0;
+  bpmem.tevksel[0].swap2 = 1;
+  bpmem.tevksel[1].swap1 = 2;
+  bpmem.tevksel[1].swap2 = 3;
+
+  bpmem.alpha_test.comp0 = CompareMode::Always;
+  bpmem.alpha_test.comp1 = CompareMode::Always;
+
+  bpmem.zmode.testenable = true;
+  bpmem.zmode.func = CompareMode::LEqual;
+  bpmem.zmode.updateenable = true;
+
+  bpmem.blendmode.blendenable = true;
+  bpmem.blendmode.colorupdate = true;
+  bpmem.blendmode.alphaupdate = true;
+  bpmem.blendmode.srcfactor = SrcBlendFactor::SrcAlpha;
+  bpmem.blendmode.dstfactor = DstBlendFactor::InvSrcAlpha;
+}
+
+std::vector<OutputVertexData> GenerateTriangles()
+{
+  Common::Random::PRNG rng{0};
+  std::vector<OutputVertexData> vertices(100 * 3);
+  for (OutputVertexData& vertex : vertices)
+  {
+    vertex.screenPosition.x = static_cast<float>(rng.GenerateValue<u32>() % EFB_WIDTH);
+    vertex.screenPosition.y = static_cast<float>(rng.GenerateValue<u32>() % EFB_HEIGHT);
+    vertex.screenPosition.z = static_cast<float>(rng.GenerateValue<u32>() & 0xFFFFFF);
+    vertex.projectedPosition.w = 1.0f;
+    for (u8& component : vertex.color[0])
+      component = rng.GenerateValue<u8>();
+  }
+  return vertices;
+}
+
+std::vector<u32> Render(int num_threads, const std::vector<OutputVertexData>& vertices)
+{
+  SetUpPipeline();
+  for (u16 y = 0; y < EFB_HEIGHT; y++)
+  {
+    for (u16 x = 0; x < EFB_WIDTH; x++)
+    {
+      u8 black[4] = {};
+      EfbInterface::SetColor(x, y, black);
+      EfbInterface::SetDepth(x, y, 0xFFFFFF);
+    }
+  }
+
+  // Start drawing right away, so that restarted workers are still starting up at the first Flush
+  g_ActiveConfig.iSWRasterizerThreads = num_threads;
+  Rasterizer::Init();
+
+  // The triangles have random winding, so draw them both ways. Only one of them covers pixels.
+  for (size_t i = 0; i < vertices.size(); i += 3)
+  {
+    Rasterizer::DrawTriangleFrontFace(&vertices[i], &vertices[i + 1], &vertices[i + 2]);
+    Rasterizer::DrawTriangleFrontFace(&vertices[i], &vertices[i + 2], &vertices[i + 1]);
+
+    // Flush every now and then, so that the workers get woken up several times
+    if (i % 30 == 27)
+      Rasterizer::Flush();
+  }
+  Rasterizer::Flush();
+
+  std::vector<u32> efb;
+  efb.reserve(EFB_WIDTH * EFB_HEIGHT * 2);
+  for (u16 y = 0; y < EFB_HEIGHT; y++)
+  {
+    for (u16 x = 0; x < EFB_WIDTH; x++)
+    {
+      efb.push_back(EfbInterface::GetColor(x, y));
+      efb.push_back(EfbInterface::GetDepth(x, y));
+    }
+  }
+  return efb;
+}
+}  // namespace
+
+TEST(Rasterizer, MultithreadedMatchesSingleThreaded)
+{
+  const std::vector<OutputVertexData> vertices = GenerateTriangles();
+
+  const std::vector<u32> expected = Render(1, vertices);
+  size_t drawn = 0;
+  for (size_t i = 0; i < expected.size(); i += 2)
+    drawn += expected[i] != 0;
+  ASSERT_GT(drawn, expected.size() / 4);
+
+  // Rendering more than once also covers restarting the worker threads
+  for (int run = 0; run < 2; run++)
+  {
+    const std::vector<u32> actual = Render(4, vertices);
+    for (size_t i = 0; i < expected.size(); i++)
+    {
+      ASSERT_EQ(expected[i], actual[i]) << "run " << run << " pixel " << i / 2 % EFB_WIDTH << ","
+                                        << i / 2 / EFB_WIDTH;
+    }
+  }
+
+  Rasterizer::Shutdown();
+}
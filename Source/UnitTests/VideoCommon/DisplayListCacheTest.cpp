@@ -0,0 +1,81 @@
+// Copyright 2021 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <array>
+
+#include <gtest/gtest.h>
+
+#include "Common/CommonTypes.h"
+#include "VideoCommon/DisplayListCache.h"
+#include "VideoCommon/OpcodeDecoding.h"
+
+TEST(DisplayListCache, DecodeCommands)
+{
+  // BP write, XF write of two words, NOP, and a triangle list of 3 vertices of 4 bytes each
+  const std::array<u8, 37> list{
+      // BP
+      0x61, 0x49, 0x00, 0x12, 0x34,
+      // XF
+      0x10, 0x00, 0x01, 0x10, 0x20, 0xAA, 0xAA, 0xAA, 0xAA, 0xBB, 0xBB, 0xBB, 0xBB,
+      // NOP
+      0x00,
+      // Triangles
+      0x92, 0x00, 0x03, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12,
+      // Padding
+      0x00, 0x00, 0x00};
+  DisplayListCache::Command command;
+
+  ASSERT_TRUE(DisplayListCache::DecodeCommand(list.data(), &list[0], &list[5], &command));
+  EXPECT_EQ(OpcodeDecoder::GX_LOAD_BP_REG, command.opcode);
+  EXPECT_EQ(0x49001234u, command.value);
+
+  ASSERT_TRUE(DisplayListCache::DecodeCommand(list.data(), &list[5], &list[18], &command));
+  EXPECT_EQ(OpcodeDecoder::GX_LOAD_XF_REG, command.opcode);
+  EXPECT_EQ(2, command.count);
+  EXPECT_EQ(0x1020u, command.value);
+  EXPECT_EQ(10u, command.data_offset);
+  EXPECT_EQ(8u, command.data_size);
+
+  ASSERT_TRUE(DisplayListCache::DecodeCommand(list.data(), &list[18], &list[19], &command));
+  EXPECT_EQ(OpcodeDecoder::GX_NOP, command.opcode);
+
+  ASSERT_TRUE(DisplayListCache::DecodeCommand(list.data(), &list[19], &list[34], &command));
+  EXPECT_EQ(0x92, command.opcode);
+  EXPECT_EQ(3, command.count);
+  EXPECT_EQ(22u, command.data_offset);
+  EXPECT_EQ(12u, command.data_size);
+}
+
+TEST(DisplayListCache, RejectsUnknownOpcodes)
+{
+  const std::array<u8, 1> list{0x03};
+  DisplayListCache::Command command;
+
+  EXPECT_FALSE(DisplayListCache::DecodeCommand(list.data(), &list[0], list.data() + 1, &command));
+}
+
+TEST(DisplayListCache, FindChecksContentsAndCPState)
+{
+  DisplayListCache cache;
+  DisplayListCache::Entry entry;
+  entry.hash = 1;
+  entry.cp_state_hash = 2;
+  entry.cycles = 100;
+  cache.Insert(0x80001000, 0x40, entry);
+
+  const DisplayListCache::Entry* found = cache.Find(0x80001000, 0x40, 1, 2);
+  ASSERT_NE(nullptr, found);
+  EXPECT_EQ(100u, found->cycles);
+
+  EXPECT_EQ(nullptr, cache.Find(0x80001000, 0x40, 3, 2));
+  EXPECT_EQ(nullptr, cache.Find(0x80001000, 0x40, 1, 3));
+  EXPECT_EQ(nullptr, cache.Find(0x80001000, 0x60, 1, 2));
+  EXPECT_EQ(nullptr, cache.Find(0x80002000, 0x40, 1, 2));
+
+  // A list with new contents at the same address replaces the old one
+  entry.hash = 3;
+  cache.Insert(0x80001000, 0x40, entry);
+  EXPECT_EQ(1u, cache.GetEntryCount());
+  EXPECT_EQ(nullptr, cache.Find(0x80001000, 0x40, 1, 2));
+  EXPECT_NE(nullptr, cache.Find(0x80001000, 0x40, 3, 2));
+}
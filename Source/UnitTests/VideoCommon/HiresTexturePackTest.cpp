@@ -0,0 +1,345 @@
+// Copyright 2021 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Common/CommonPaths.h"
+#include "Common/CommonTypes.h"
+#include "Common/FileUtil.h"
+#include "Common/IOFile.h"
+#include "Common/Random.h"
+#include "VideoCommon/HiresTexturePack.h"
+
+namespace
+{
+using Block = std::array<u8, 4 * 4 * 4>;
+
+std::array<int, 3> DecodeRGB565(u16 color)
+{
+  const int r = (color >> 11) & 0x1F;
+  const int g = (color >> 5) & 0x3F;
+  const int b = color & 0x1F;
+  return {(r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2)};
+}
+
+// Decodes a four color DXT1 block, or the color part of a DXT5 block
+void DecodeColorBlock(const u8* src, Block* dst)
+{
+  u16 color0, color1;
+  u32 indices;
+  std::memcpy(&color0, src, sizeof(color0));
+  std::memcpy(&color1, src + 2, sizeof(color1));
+  std::memcpy(&indices, src + 4, sizeof(indices));
+
+  const std::array<int, 3> c0 = DecodeRGB565(color0);
+  const std::array<int, 3> c1 = DecodeRGB565(color1);
+  for (u32 i = 0; i < 16; ++i)
+  {
+    const u32 index = (indices >> (i * 2)) & 3;
+    for (int c = 0; c < 3; ++c)
+    {
+      const int palette[4] = {c0[c], c1[c], (2 * c0[c] + c1[c]) / 3, (c0[c] + 2 * c1[c]) / 3};
+      (*dst)[i * 4 + c] = static_cast<u8>(palette[index]);
+    }
+  }
+}
+
+void DecodeAlphaBlock(const u8* src, Block* dst)
+{
+  const int alpha0 = src[0];
+  const int alpha1 = src[1];
+  u64 indices = 0;
+  for (int i = 0; i < 6; ++i)
+    indices |= u64(src[2 + i]) << (i * 8);
+
+  for (u32 i = 0; i < 16; ++i)
+  {
+    const int index = static_cast<int>((indices >> (i * 3)) & 7);
+    int alpha;
+    if (index < 2)
+      alpha = index == 0 ? alpha0 : alpha1;
+    else if (alpha0 > alpha1)
+      alpha = ((8 - index) * alpha0 + (index - 1) * alpha1) / 7;
+    else
+      alpha = index == 6 ? 0 : index == 7 ? 255 : ((6 - index) * alpha0 + (index - 1) * alpha1) / 5;
+    (*dst)[i * 4 + 3] = static_cast<u8>(alpha);
+  }
+}
+
+int MaxError(const Block& a, const Block& b, int channels)
+{
+  int max_error = 0;
+  for (u32 i = 0; i < 16; ++i)
+  {
+    for (int c = 0; c < channels; ++c)
+      max_error = std::max(max_error, std::abs(a[i * 4 + c] - b[i * 4 + c]));
+  }
+  return max_error;
+}
+}  // namespace
+
+TEST(HiresTexturePack, DXT1SolidBlock)
+{
+  Block block;
+  for (u32 i = 0; i < 16; ++i)
+  {
+    block[i * 4] = 0xFF;
+    block[i * 4 + 1] = 0x80;
+    block[i * 4 + 2] = 0x00;
+    block[i * 4 + 3] = 0xFF;
+  }
+
+  std::array<u8, 8> encoded;
+  EncodeDXT1Block(encoded.data(), block.data(), 16);
+
+  Block decoded = block;
+  DecodeColorBlock(encoded.data(), &decoded);
+  // 0x80 isn't representable with 6 bits of green
+  EXPECT_LE(MaxError(block, decoded, 3), 2);
+}
+
+TEST(HiresTexturePack, DXT5Gradient)
+{
+  // A gradient between two colors can be represented well by both formats
+  Block block;
+  for (u32 i = 0; i < 16; ++i)
+  {
+    block[i * 4] = static_cast<u8>(i * 16);
+    block[i * 4 + 1] = static_cast<u8>(255 - i * 16);
+    block[i * 4 + 2] = 0x40;
+    block[i * 4 + 3] = static_cast<u8>(i * 17);
+  }
+
+  std::array<u8, 16> encoded;
+  EncodeDXT5Block(encoded.data(), block.data(), 16);
+
+  Block decoded;
+  DecodeAlphaBlock(encoded.data(), &decoded);
+  DecodeColorBlock(encoded.data() + 8, &decoded);
+  EXPECT_LE(MaxError(block, decoded, 3), 48);
+  for (u32 i = 0; i < 16; ++i)
+    EXPECT_LE(std::abs(block[i * 4 + 3] - decoded[i * 4 + 3]), 19) << "texel " << i;
+}
+
+TEST(HiresTexturePack, DXT1RandomBlocksStayInRange)
+{
+  // The endpoints lie within the bounds of the colors, so every decoded color does too, apart
+  // from the precision lost by truncating the endpoints to 5 or 6 bits
+  constexpr std::array<int, 3> TOLERANCE{7, 3, 7};
+
+  Common::Random::PRNG rng{0};
+  for (int i = 0; i < 1000; ++i)
+  {
+    // Each channel spans a random part of its range, so that the bounds mean something
+    Block block;
+    for (int c = 0; c < 4; ++c)
+    {
+      const u8 a = rng.GenerateValue<u8>();
+      const u8 b = rng.GenerateValue<u8>();
+      const int low = std::min(a, b);
+      const int range = std::max(a, b) - low + 1;
+      for (u32 j = 0; j < 16; ++j)
+        block[j * 4 + c] = static_cast<u8>(low + rng.GenerateValue<u32>() % range);
+    }
+
+    std::array<u8, 8> encoded;
+    EncodeDXT1Block(encoded.data(), block.data(), 16);
+    Block decoded = block;
+    DecodeColorBlock(encoded.data(), &decoded);
+
+    u16 color0, color1;
+    std::memcpy(&color0, encoded.data(), sizeof(color0));
+    std::memcpy(&color1, encoded.data() + 2, sizeof(color1));
+    EXPECT_GE(color0, color1);
+
+    for (int c = 0; c < 3; ++c)
+    {
+      int min = 255;
+      int max = 0;
+      for (u32 j = 0; j < 16; ++j)
+      {
+        min = std::min<int>(min, block[j * 4 + c]);
+        max = std::max<int>(max, block[j * 4 + c]);
+      }
+      for (u32 j = 0; j < 16; ++j)
+      {
+        EXPECT_GE(decoded[j * 4 + c], min - TOLERANCE[c]) << "block " << i << ", channel " << c;
+        EXPECT_LE(decoded[j * 4 + c], max + TOLERANCE[c]) << "block " << i << ", channel " << c;
+      }
+    }
+  }
+}
+
+TEST(HiresTexturePack, RoundTrip)
+{
+  const std::string directory = File::CreateTempDir();
+  const std::string path = directory + DIR_SEP "test.pack";
+
+  // Opaque and translucent textures which can be compressed, and one which can't because its size
+  // isn't a multiple of the block size
+  Common::Random::PRNG rng{0};
+  const auto make_level = [&rng](u32 width, u32 height, bool opaque) {
+    HiresTexture::Level level;
+    level.width = width;
+    level.height = height;
+    level.row_length = width;
+    level.data.resize(width * height * 4);
+    rng.Generate(level.data.data(), level.data.size());
+    for (size_t i = 3; opaque && i < level.data.size(); i += 4)
+      level.data[i] = 0xFF;
+    return level;
+  };
+  const std::vector<HiresTexture::Level> opaque{make_level(16, 8, true), make_level(8, 4, true)};
+  const std::vector<HiresTexture::Level> translucent{make_level(8, 8, false)};
+  const std::vector<HiresTexture::Level> odd_size{make_level(6, 3, false), make_level(3, 1, false)};
+
+  HiresTexturePack::Writer writer;
+  ASSERT_TRUE(writer.Open(path, 1234));
+  ASSERT_TRUE(writer.AddTexture("tex1_opaque", opaque, false, true));
+  ASSERT_TRUE(writer.AddTexture("tex1_translucent", translucent, false, true));
+  ASSERT_TRUE(writer.AddTexture("tex1_odd_size", odd_size, true, true));
+  ASSERT_TRUE(writer.AddTexture("tex1_uncompressed", opaque, false, false));
+  ASSERT_TRUE(writer.Finish());
+
+  {
+    HiresTexturePack pack;
+    ASSERT_TRUE(pack.Open(path, 1234));
+    EXPECT_EQ(4u, pack.GetTextureCount());
+
+    std::vector<HiresTexture::Level> levels;
+    bool has_arbitrary_mipmaps = true;
+    EXPECT_FALSE(pack.GetTexture("tex1_missing", &levels, &has_arbitrary_mipmaps));
+
+    ASSERT_TRUE(pack.GetTexture("tex1_opaque", &levels, &has_arbitrary_mipmaps));
+    EXPECT_FALSE(has_arbitrary_mipmaps);
+    ASSERT_EQ(2u, levels.size());
+    for (size_t i = 0; i < levels.size(); ++i)
+    {
+      EXPECT_EQ(AbstractTextureFormat::DXT1, levels[i].format) << "level " << i;
+      EXPECT_EQ(opaque[i].width, levels[i].width) << "level " << i;
+      EXPECT_EQ(opaque[i].height, levels[i].height) << "level " << i;
+      EXPECT_EQ(opaque[i].width, levels[i].row_length) << "level " << i;
+      ASSERT_EQ(opaque[i].width / 4 * opaque[i].height / 4 * 8, levels[i].GetSize());
+
+      // The first block of every level is the same as compressing it directly
+      Block block;
+      for (u32 y = 0; y < 4; ++y)
+        std::memcpy(&block[y * 16], &opaque[i].data[y * opaque[i].row_length * 4], 16);
+      std::array<u8, 8> encoded;
+      EncodeDXT1Block(encoded.data(), block.data(), 16);
+      EXPECT_EQ(0, std::memcmp(encoded.data(), levels[i].GetData(), encoded.size()));
+    }
+
+    ASSERT_TRUE(pack.GetTexture("tex1_translucent", &levels, &has_arbitrary_mipmaps));
+    ASSERT_EQ(1u, levels.size());
+    EXPECT_EQ(AbstractTextureFormat::DXT5, levels[0].format);
+    EXPECT_EQ(8u / 4 * 8 / 4 * 16, levels[0].GetSize());
+
+    // Levels which aren't compressed are stored as they are
+    const auto check_uncompressed = [&](const std::string& name,
+                                        const std::vector<HiresTexture::Level>& expected,
+                                        bool expected_arbitrary_mipmaps) {
+      ASSERT_TRUE(pack.GetTexture(name, &levels, &has_arbitrary_mipmaps)) << name;
+      EXPECT_EQ(expected_arbitrary_mipmaps, has_arbitrary_mipmaps) << name;
+      ASSERT_EQ(expected.size(), levels.size()) << name;
+      for (size_t i = 0; i < levels.size(); ++i)
+      {
+        EXPECT_EQ(AbstractTextureFormat::RGBA8, levels[i].format) << name;
+        EXPECT_EQ(expected[i].width, levels[i].width) << name;
+        EXPECT_EQ(expected[i].height, levels[i].height) << name;
+        EXPECT_EQ(expected[i].row_length, levels[i].row_length) << name;
+        ASSERT_EQ(expected[i].data.size(), levels[i].GetSize()) << name;
+        EXPECT_TRUE(std::equal(expected[i].data.begin(), expected[i].data.end(),
+                               levels[i].GetData()))
+            << name;
+      }
+    };
+    check_uncompressed("tex1_odd_size", odd_size, true);
+    check_uncompressed("tex1_uncompressed", opaque, false);
+  }
+
+  File::DeleteDirRecursively(directory);
+}
+
+TEST(HiresTexturePack, RejectsInvalidPacks)
+{
+  const std::string directory = File::CreateTempDir();
+  const std::string path = directory + DIR_SEP "invalid.pack";
+  {
+    File::IOFile file(path, "wb");
+    const std::array<u8, 64> garbage{1, 2, 3, 4};
+    file.WriteBytes(garbage.data(), garbage.size());
+  }
+
+  HiresTexturePack pack;
+  EXPECT_FALSE(pack.Open(path, 0));
+  EXPECT_FALSE(pack.Open(path + ".missing", 0));
+  EXPECT_EQ(0u, pack.GetTextureCount());
+
+  // An empty pack is valid, but only with the fingerprint it was written with
+  HiresTexturePack::Writer writer;
+  ASSERT_TRUE(writer.Open(path, 1234));
+  ASSERT_TRUE(writer.Finish());
+  EXPECT_FALSE(pack.Open(path, 4321));
+  EXPECT_TRUE(pack.Open(path, 1234));
+  EXPECT_EQ(0u, pack.GetTextureCount());
+
+  File::DeleteDirRecursively(directory);
+}
+
+TEST(HiresTexturePack, RejectsTruncatedLevels)
+{
+  const std::string directory = File::CreateTempDir();
+  const std::string path = directory + DIR_SEP "truncated.pack";
+
+  const auto write_pack = [&path](const HiresTexture::Level& level) {
+    HiresTexturePack::Writer writer;
+    return writer.Open(path, 1234) && writer.AddTexture("tex1_level", {level}, false, false) &&
+           writer.Finish();
+  };
+
+  HiresTexture::Level level;
+  level.width = 8;
+  level.height = 4;
+  level.row_length = 12;
+  level.data.resize(12 * 4 * 4);
+  HiresTexturePack pack;
+  ASSERT_TRUE(write_pack(level));
+  EXPECT_TRUE(pack.Open(path, 1234));
+
+  // The size has to cover the row length rather than just the width
+  level.data.resize(12 * 3 * 4 + 8 * 4);
+  ASSERT_TRUE(write_pack(level));
+  EXPECT_FALSE(pack.Open(path, 1234));
+  EXPECT_EQ(0u, pack.GetTextureCount());
+
+  // Two rows of DXT1 blocks
+  level.format = AbstractTextureFormat::DXT1;
+  level.height = 5;
+  level.row_length = 8;
+  level.data.resize(8 / 4 * 8 * 2);
+  ASSERT_TRUE(write_pack(level));
+  EXPECT_TRUE(pack.Open(path, 1234));
+  level.data.resize(8 / 4 * 8);
+  ASSERT_TRUE(write_pack(level));
+  EXPECT_FALSE(pack.Open(path, 1234));
+
+  // A row length smaller than the width, or a format which texture packs don't contain
+  level.data.resize(0x1000);
+  level.row_length = 4;
+  ASSERT_TRUE(write_pack(level));
+  EXPECT_FALSE(pack.Open(path, 1234));
+  level.row_length = 8;
+  level.format = AbstractTextureFormat::D32F;
+  ASSERT_TRUE(write_pack(level));
+  EXPECT_FALSE(pack.Open(path, 1234));
+
+  File::DeleteDirRecursively(directory);
+}
@@ -0,0 +1,67 @@
+// Copyright 2021 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <array>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/Random.h"
+#include "VideoCommon/TextureDecoder.h"
+
+constexpr std::array<TextureFormat, 11> RANDOM_TEXTURE_FORMATS = {
+    TextureFormat::I4,     TextureFormat::I8,    TextureFormat::IA4, TextureFormat::IA8,
+    TextureFormat::RGB565, TextureFormat::RGB5A3, TextureFormat::RGBA8, TextureFormat::C4,
+    TextureFormat::C8,     TextureFormat::C14X2, TextureFormat::CMPR,
+};
+
+// A texture and palette filled with random data, which every format can decode.
+struct RandomTexture
+{
+  // Large enough for the palette of C14X2 textures
+  static constexpr size_t TLUT_SIZE = 0x4000 * sizeof(u16);
+
+  RandomTexture(TextureFormat format_, u32 width_, u32 height_)
+      : format(format_), width(width_), height(height_),
+        src(TexDecoder_GetTextureSizeInBytes(width, height, format)), tlut(TLUT_SIZE)
+  {
+    Common::Random::PRNG rng{static_cast<u64>(format) << 32 | width << 16 | height};
+    rng.Generate(src.data(), src.size());
+    rng.Generate(tlut.data(), tlut.size());
+  }
+
+  void Decode(u8* dst) const
+  {
+    TexDecoder_Decode(dst, src.data(), width, height, format, tlut.data(), TLUTFormat::RGB5A3);
+  }
+
+  std::vector<u8> Decode() const
+  {
+    std::vector<u8> dst(width * height * sizeof(u32));
+    Decode(dst.data());
+    return dst;
+  }
+
+  // Decodes the texture one texel at a time, using the generic code. Like the texture registers,
+  // the texel decoder takes the width minus one.
+  std::vector<u8> DecodeTexels() const
+  {
+    std::vector<u8> dst(width * height * sizeof(u32));
+    for (u32 t = 0; t < height; ++t)
+    {
+      for (u32 s = 0; s < width; ++s)
+      {
+        TexDecoder_DecodeTexel(&dst[(t * width + s) * sizeof(u32)], src.data(), s, t,
+                               width - 1, format, tlut.data(), TLUTFormat::RGB5A3);
+      }
+    }
+    return dst;
+  }
+
+  TextureFormat format;
+  u32 width;
+  u32 height;
+  std::vector<u8> src;
+  std::vector<u8> tlut;
+};
@@ -0,0 +1,126 @@
+// Copyright 2021 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Common/CommonTypes.h"
+#include "Common/Hash.h"
+#include "VideoCommon/TextureDecodePool.h"
+#include "VideoCommon/TextureDecoder.h"
+
+#include "RandomTexture.h"
+
+namespace
+{
+struct TestTexture : RandomTexture
+{
+  TestTexture(TextureFormat format_, u32 width_, u32 height_)
+      : RandomTexture(format_, width_, height_), dst(width * height * sizeof(u32))
+  {
+  }
+
+  TextureDecodePool::Job GetJob()
+  {
+    return {dst.data(), src.data(), width, height, format, tlut.data(), TLUTFormat::RGB5A3};
+  }
+
+  std::vector<u8> dst;
+};
+}  // namespace
+
+TEST(TextureDecodePool, MatchesSerialDecoding)
+{
+  TextureDecodePool pool;
+  pool.ResizeWorkerThreads(4);
+
+  for (TextureFormat format : RANDOM_TEXTURE_FORMATS)
+  {
+    for (u32 size : {8u, 64u, 256u, 1024u})
+    {
+      // Non-square textures make sure the bands are cut at block row boundaries
+      TestTexture texture(format, size, size / 2 < 8 ? 8 : size / 2);
+      const TextureDecodePool::Job job = texture.GetJob();
+      pool.Decode(&job, 1);
+
+      EXPECT_EQ(texture.Decode(), texture.dst)
+          << "format " << static_cast<int>(format) << ", width " << size;
+    }
+  }
+}
+
+TEST(TextureDecodePool, DecodesMipChains)
+{
+  TextureDecodePool pool;
+  pool.ResizeWorkerThreads(2);
+
+  std::vector<TestTexture> levels;
+  for (u32 size = 512; size >= 8; size /= 2)
+    levels.emplace_back(TextureFormat::CMPR, size, size);
+
+  std::vector<TextureDecodePool::Job> jobs;
+  for (TestTexture& level : levels)
+    jobs.push_back(level.GetJob());
+  pool.Decode(jobs.data(), jobs.size());
+
+  for (const TestTexture& level : levels)
+    EXPECT_EQ(level.Decode(), level.dst) << "width " << level.width;
+}
+
+TEST(TextureDecodePool, QueueTaskWithoutWorkers)
+{
+  TextureDecodePool pool;
+  bool ran = false;
+  pool.QueueTask([&ran] { ran = true; });
+  EXPECT_TRUE(ran);
+}
+
+TEST(TextureDecodePool, PrefetchIsCheckedAgainstTheTexture)
+{
+  constexpr u32 ADDRESS = 0x80001000;
+  constexpr u32 SIZE = 256;
+
+  TextureDecodePool pool;
+  pool.ResizeWorkerThreads(2);
+  TexturePrefetchQueue queue(pool);
+
+  // The texture memory and the palette which the prefetched textures are copied from
+  TestTexture texture(TextureFormat::C8, SIZE, SIZE);
+  const TexturePrefetchQueue::Key key{ADDRESS, texture.format, TLUTFormat::RGB5A3, SIZE, SIZE, 1};
+  const auto hash = [&texture](const u8* src, const u8* tlut) {
+    return u64(Common::HashAdler32(src, texture.src.size())) << 32 |
+           Common::HashAdler32(tlut, texture.tlut.size());
+  };
+  const auto prefetch = [&] {
+    TexturePrefetchQueue::Texture copy{texture.src, texture.tlut, texture.dst, {}};
+    copy.jobs.push_back({copy.dst.data(), copy.src.data(), SIZE, SIZE, texture.format,
+                         copy.tlut.data(), TLUTFormat::RGB5A3});
+    queue.Prefetch(key, std::move(copy), hash);
+    EXPECT_TRUE(queue.Contains(ADDRESS));
+  };
+
+  prefetch();
+  ASSERT_TRUE(queue.Take(key, hash(texture.src.data(), texture.tlut.data()), texture.dst.data()));
+  EXPECT_EQ(texture.Decode(), texture.dst);
+  EXPECT_FALSE(queue.Contains(ADDRESS));
+
+  // The texture memory changes after the prefetch
+  prefetch();
+  texture.src[texture.src.size() / 2] ^= 0xFF;
+  EXPECT_FALSE(queue.Take(key, hash(texture.src.data(), texture.tlut.data()), texture.dst.data()));
+  EXPECT_FALSE(queue.Contains(ADDRESS));
+
+  // So does the palette
+  prefetch();
+  texture.tlut[0] ^= 0xFF;
+  EXPECT_FALSE(queue.Take(key, hash(texture.src.data(), texture.tlut.data()), texture.dst.data()));
+
+  // The texture is set up with a different size
+  prefetch();
+  TexturePrefetchQueue::Key resized = key;
+  resized.height /= 2;
+  EXPECT_FALSE(
+      queue.Take(resized, hash(texture.src.data(), texture.tlut.data()), texture.dst.data()));
+  EXPECT_FALSE(queue.Contains(ADDRESS));
+}
@@ -0,0 +1,68 @@
+// Copyright 2021 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <array>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Common/CPUDetect.h"
+#include "Common/CommonTypes.h"
+#include "VideoCommon/TextureDecoder.h"
+
+#include "RandomTexture.h"
+
+namespace
+{
+// Overrides the CPU features used by the texture decoders for the lifetime of the object.
+class ScopedCPUFeatures
+{
+public:
+  explicit ScopedCPUFeatures(bool avx2) : m_saved_info(cpu_info)
+  {
+    cpu_info.bAVX2 = avx2 && m_saved_info.bAVX2;
+  }
+  ~ScopedCPUFeatures() { cpu_info = m_saved_info; }
+
+private:
+  CPUInfo m_saved_info;
+};
+}  // namespace
+
+TEST(TextureDecoder, MatchesTexelDecoding)
+{
+  for (bool avx2 : {false, true})
+  {
+    ScopedCPUFeatures features(avx2);
+    for (TextureFormat format : RANDOM_TEXTURE_FORMATS)
+    {
+      for (u32 size : {8u, 16u, 64u})
+      {
+        const RandomTexture texture(format, size, size * 2);
+        EXPECT_EQ(texture.DecodeTexels(), texture.Decode())
+            << "format " << static_cast<int>(format) << ", width " << size << ", AVX2 "
+            << cpu_info.bAVX2;
+      }
+    }
+  }
+}
+
+// RGB5A3 blocks which mix both encodings take a different path in the SIMD decoders.
+TEST(TextureDecoder, RGB5A3MixedBlocks)
+{
+  RandomTexture texture(TextureFormat::RGB5A3, 32, 32);
+  for (size_t i = 0; i < texture.src.size(); i += 2)
+  {
+    // Every block has at least one texel of each encoding
+    if (i % 8 == 0)
+      texture.src[i] |= 0x80;
+    else if (i % 8 == 2)
+      texture.src[i] &= 0x7F;
+  }
+
+  for (bool avx2 : {false, true})
+  {
+    ScopedCPUFeatures features(avx2);
+    EXPECT_EQ(texture.DecodeTexels(), texture.Decode()) << "AVX2 " << cpu_info.bAVX2;
+  }
+}
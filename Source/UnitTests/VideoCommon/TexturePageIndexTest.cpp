@@ -0,0 +1,81 @@
+// Copyright 2021 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Common/CommonTypes.h"
+#include "Common/Random.h"
+#include "VideoCommon/TexturePageIndex.h"
+
+namespace
+{
+struct Texture
+{
+  u32 address;
+  u32 size;
+};
+
+using Index = TexturePageIndex<Texture>;
+
+bool Overlaps(const Texture& texture, u32 address, u32 size)
+{
+  return texture.address < address + size && texture.address + texture.size > address;
+}
+}  // namespace
+
+TEST(TexturePageIndex, LowestOverlappingAddress)
+{
+  const Texture a{0x1000, 0x30000};
+  const Texture b{0x20000, 0x100};
+  const Texture c{0x40000, 0x20000};
+
+  Index index;
+  index.Add(a.address, a.size, &a);
+  index.Add(b.address, b.size, &b);
+  index.Add(c.address, c.size, &c);
+
+  EXPECT_EQ(0x1000u, index.GetLowestOverlappingAddress(0x1000));
+  EXPECT_EQ(0x1000u, index.GetLowestOverlappingAddress(0x20080));
+  EXPECT_EQ(0x1000u, index.GetLowestOverlappingAddress(0x30FFF));
+  // a ends in the same page, but doesn't contain the address
+  EXPECT_EQ(0x31000u, index.GetLowestOverlappingAddress(0x31000));
+  EXPECT_EQ(0x40000u, index.GetLowestOverlappingAddress(0x5FFFF));
+  EXPECT_EQ(0x60000u, index.GetLowestOverlappingAddress(0x60000));
+
+  index.Remove(a.address, a.size, &a);
+  EXPECT_EQ(0x20000u, index.GetLowestOverlappingAddress(0x20080));
+  EXPECT_EQ(0x20100u, index.GetLowestOverlappingAddress(0x20100));
+  EXPECT_EQ(0x10000u, index.GetLowestOverlappingAddress(0x10000));
+  EXPECT_EQ(3u, index.GetPageCount());
+
+  index.Clear();
+  EXPECT_EQ(0u, index.GetPageCount());
+}
+
+TEST(TexturePageIndex, MatchesFullScan)
+{
+  Common::Random::PRNG rng{0};
+  std::vector<Texture> textures(1000);
+  Index index;
+  for (Texture& texture : textures)
+  {
+    texture.address = rng.GenerateValue<u32>() % 0x1000000 & ~31u;
+    texture.size = (32 + rng.GenerateValue<u32>() % 0x80000) & ~31u;
+    index.Add(texture.address, texture.size, &texture);
+  }
+
+  for (int i = 0; i < 1000; ++i)
+  {
+    const u32 address = rng.GenerateValue<u32>() % 0x1100000;
+    u32 expected = address;
+    for (const Texture& texture : textures)
+    {
+      if (Overlaps(texture, address, 1))
+        expected = std::min(expected, texture.address);
+    }
+    ASSERT_EQ(expected, index.GetLowestOverlappingAddress(address)) << "address " << address;
+  }
+}
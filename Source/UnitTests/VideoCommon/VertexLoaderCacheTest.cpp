@@ -0,0 +1,144 @@
+// Copyright 2021 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <array>
+#include <memory>
+
+#include <gtest/gtest.h>
+
+#include "Common/CommonTypes.h"
+#include "VideoCommon/CPMemory.h"
+#include "VideoCommon/DataReader.h"
+#include "VideoCommon/VertexLoaderBase.h"
+#include "VideoCommon/VertexLoaderCache.h"
+#include "VideoCommon/VertexLoaderManager.h"
+
+namespace
+{
+// Three vertices whose positions index the middle of an array of XYZ float positions
+class VertexCacheKeyTest : public testing::Test
+{
+protected:
+  static constexpr u32 STRIDE = 3 * sizeof(float);
+
+  void SetUp() override
+  {
+    m_vtx_desc.low.Hex = 0;
+    m_vtx_desc.high.Hex = 0;
+    m_vtx_desc.low.Position = VertexComponentFormat::Index8;
+    m_vtx_attr.g0.Hex = 0;
+    m_vtx_attr.g1.Hex = 0;
+    m_vtx_attr.g2.Hex = 0;
+    m_vtx_attr.g0.PosElements = CoordComponentCount::XYZ;
+    m_vtx_attr.g0.PosFormat = ComponentFormat::Float;
+    m_loader = VertexLoaderBase::CreateVertexLoader(m_vtx_desc, m_vtx_attr);
+
+    for (size_t i = 0; i < m_array.size(); ++i)
+      m_array[i] = static_cast<u8>(i);
+    VertexLoaderManager::cached_arraybases[ARRAY_POSITION] = m_array.data();
+    VertexLoaderManager::cached_arraysizes[ARRAY_POSITION] = m_array.size();
+    g_main_cp_state.array_strides[ARRAY_POSITION] = STRIDE;
+  }
+
+  u64 GetKey()
+  {
+    u64 key = 0;
+    EXPECT_TRUE(VertexLoaderManager::GetVertexCacheKey(
+        &key, m_loader.get(), m_vtx_desc, m_vtx_attr,
+        DataReader(m_indices.data(), m_indices.data() + m_indices.size()), 3));
+    return key;
+  }
+
+  TVtxDesc m_vtx_desc;
+  VAT m_vtx_attr;
+  std::unique_ptr<VertexLoaderBase> m_loader;
+  std::array<u8, 3> m_indices{4, 6, 5};
+  std::array<u8, 16 * STRIDE> m_array;
+};
+}  // namespace
+
+TEST(VertexLoaderCache, InsertsOnSecondSighting)
+{
+  VertexLoaderCache cache(1024);
+
+  EXPECT_EQ(nullptr, cache.Find(1));
+  EXPECT_FALSE(cache.MarkSeen(1));
+  EXPECT_TRUE(cache.MarkSeen(1));
+
+  VertexLoaderCache::Entry* entry = cache.Insert(1, 16);
+  ASSERT_NE(nullptr, entry);
+  entry->vertices[0] = 0x42;
+  entry->count = 2;
+
+  const VertexLoaderCache::Entry* found = cache.Find(1);
+  ASSERT_NE(nullptr, found);
+  EXPECT_EQ(0x42, found->vertices[0]);
+  EXPECT_EQ(2, found->count);
+  EXPECT_EQ(16u, cache.GetSize());
+}
+
+TEST(VertexLoaderCache, EvictsLeastRecentlyUsed)
+{
+  VertexLoaderCache cache(300);
+
+  ASSERT_NE(nullptr, cache.Insert(1, 100));
+  ASSERT_NE(nullptr, cache.Insert(2, 100));
+  ASSERT_NE(nullptr, cache.Insert(3, 100));
+
+  // Using 1 makes 2 the least recently used entry
+  EXPECT_NE(nullptr, cache.Find(1));
+  ASSERT_NE(nullptr, cache.Insert(4, 100));
+
+  EXPECT_NE(nullptr, cache.Find(1));
+  EXPECT_EQ(nullptr, cache.Find(2));
+  EXPECT_NE(nullptr, cache.Find(3));
+  EXPECT_NE(nullptr, cache.Find(4));
+  EXPECT_EQ(300u, cache.GetSize());
+  EXPECT_EQ(3u, cache.GetEntryCount());
+}
+
+TEST(VertexLoaderCache, RejectsEntriesLargerThanBudget)
+{
+  VertexLoaderCache cache(100);
+
+  ASSERT_NE(nullptr, cache.Insert(1, 50));
+  EXPECT_EQ(nullptr, cache.Insert(2, 101));
+  EXPECT_NE(nullptr, cache.Find(1));
+  EXPECT_EQ(50u, cache.GetSize());
+}
+
+TEST(VertexLoaderCache, ReinsertReplacesEntry)
+{
+  VertexLoaderCache cache(100);
+
+  ASSERT_NE(nullptr, cache.Insert(1, 50));
+  ASSERT_NE(nullptr, cache.Insert(1, 20));
+  EXPECT_EQ(1u, cache.GetEntryCount());
+  EXPECT_EQ(20u, cache.GetSize());
+
+  cache.Clear();
+  EXPECT_EQ(nullptr, cache.Find(1));
+  EXPECT_EQ(0u, cache.GetSize());
+  EXPECT_FALSE(cache.MarkSeen(1));
+}
+
+TEST_F(VertexCacheKeyTest, MissesWhenIndexedDataChanges)
+{
+  VertexLoaderCache cache(1024);
+  ASSERT_NE(nullptr, cache.Insert(GetKey(), 16));
+  EXPECT_NE(nullptr, cache.Find(GetKey()));
+
+  m_array[5 * STRIDE + 4] ^= 1;
+  EXPECT_EQ(nullptr, cache.Find(GetKey()));
+}
+
+TEST_F(VertexCacheKeyTest, HitsWhenDataOutsideIndexedRangeChanges)
+{
+  VertexLoaderCache cache(1024);
+  ASSERT_NE(nullptr, cache.Insert(GetKey(), 16));
+
+  m_array[4 * STRIDE - 1] ^= 1;
+  m_array[7 * STRIDE] ^= 1;
+  m_array[m_array.size() - 1] ^= 1;
+  EXPECT_NE(nullptr, cache.Find(GetKey()));
+}